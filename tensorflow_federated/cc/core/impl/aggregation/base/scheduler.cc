@@ -20,15 +20,20 @@
 #include <deque>
 #include <functional>
 #include <memory>
+#include <optional>
 #include <queue>
 #include <thread>  // NOLINT(build/c++11)
 #include <utility>
 #include <vector>
 
 #include "absl/base/thread_annotations.h"
+#include "absl/strings/string_view.h"
 #include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
 #include "tensorflow_federated/cc/core/impl/aggregation/base/monitoring.h"
 #include "tensorflow_federated/cc/core/impl/aggregation/base/move_to_lambda.h"
+#include "tensorflow_federated/cc/core/impl/base/thread_pool_stats.h"
 
 namespace tensorflow_federated {
 
@@ -99,10 +104,12 @@ class WorkerImpl : public Worker, public LifetimeTracker {
 // Implementation of thread pools.
 class ThreadPoolScheduler : public Scheduler {
  public:
-  explicit ThreadPoolScheduler(std::size_t thread_count)
-      : idle_condition_(absl::Condition(IdleCondition, this)),
+  ThreadPoolScheduler(std::size_t thread_count, absl::string_view name)
+      : stats_(GetThreadPoolStats(name)),
+        idle_condition_(absl::Condition(IdleCondition, this)),
         active_count_(thread_count) {
     TFF_CHECK(thread_count > 0) << "invalid thread_count";
+    stats_->AddThreads(thread_count);
 
     // Create threads.
     for (int i = 0; i < thread_count; ++i) {
@@ -125,11 +132,19 @@ class ThreadPoolScheduler : public Scheduler {
                                       "one of its running threads";
       thread.join();
     }
+    stats_->RemoveThreads(threads_.size());
   }
 
   void Schedule(std::function<void()> task) override {
+    QueuedTask queued_task{std::move(task)};
+    if (ThreadPoolStatsEnabled()) {
+      queued_task.scheduled_time = absl::Now();
+    }
     absl::MutexLock lock(&busy_);
-    todo_.push(std::move(task));
+    todo_.push(std::move(queued_task));
+    if (todo_.back().scheduled_time.has_value()) {
+      stats_->RecordScheduled(todo_.size());
+    }
     // Wake up a *single* thread to handle this task.
     work_available_cond_var_.Signal();
   }
@@ -147,6 +162,7 @@ class ThreadPoolScheduler : public Scheduler {
   void PerThreadActivity() {
     for (;;) {
       std::function<void()> task;
+      std::optional<absl::Time> start_time;
       {
         absl::MutexLock lock(&busy_);
         --active_count_;
@@ -160,15 +176,32 @@ class ThreadPoolScheduler : public Scheduler {
 
         // Destructor invariant
         TFF_CHECK(!threads_should_join_);
-        task = std::move(todo_.front());
-        todo_.pop();
         ++active_count_;
+        if (todo_.front().scheduled_time.has_value()) {
+          start_time = absl::Now();
+          stats_->RecordStarted(*start_time - *todo_.front().scheduled_time,
+                                active_count_);
+        }
+        task = std::move(todo_.front().task);
+        todo_.pop();
       }
 
       task();
+      if (start_time.has_value()) {
+        stats_->RecordCompleted(absl::Now() - *start_time);
+      }
     }
   }
 
+  struct QueuedTask {
+    std::function<void()> task;
+    // Only set if the task was recorded in `stats_` when it was scheduled.
+    std::optional<absl::Time> scheduled_time;
+  };
+
+  // Process-wide telemetry for pools with this pool's name.
+  ThreadPoolStats* const stats_;
+
   // A vector of threads allocated for execution.
   std::vector<std::thread> threads_;
 
@@ -189,7 +222,7 @@ class ThreadPoolScheduler : public Scheduler {
   bool threads_should_join_ ABSL_GUARDED_BY(busy_) = false;
 
   // Queue of tasks with work to do.
-  std::queue<std::function<void()>> todo_ ABSL_GUARDED_BY(busy_);
+  std::queue<QueuedTask> todo_ ABSL_GUARDED_BY(busy_);
 
   // The number of threads currently doing work in this pool.
   std::size_t active_count_ ABSL_GUARDED_BY(busy_);
@@ -201,8 +234,9 @@ std::unique_ptr<Worker> Scheduler::CreateWorker() {
   return std::make_unique<WorkerImpl>(this);
 }
 
-std::unique_ptr<Scheduler> CreateThreadPoolScheduler(std::size_t thread_count) {
-  return std::make_unique<ThreadPoolScheduler>(thread_count);
+std::unique_ptr<Scheduler> CreateThreadPoolScheduler(std::size_t thread_count,
+                                                     absl::string_view name) {
+  return std::make_unique<ThreadPoolScheduler>(thread_count, name);
 }
 
 }  // namespace tensorflow_federated
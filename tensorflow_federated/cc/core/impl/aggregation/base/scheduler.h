@@ -29,6 +29,8 @@
 #include <functional>
 #include <memory>
 
+#include "absl/strings/string_view.h"
+
 namespace tensorflow_federated {
 
 /**
@@ -100,8 +102,13 @@ class Scheduler {
 
 /**
  * Creates a scheduler using a fixed-size pool of threads to run tasks.
+ *
+ * While SetThreadPoolStatsEnabled(true) is in effect, the scheduler reports
+ * queue depth, queueing and run times and active workers to the process-wide
+ * ThreadPoolStats for `name` (see thread_pool_stats.h).
  */
-std::unique_ptr<Scheduler> CreateThreadPoolScheduler(std::size_t thread_count);
+std::unique_ptr<Scheduler> CreateThreadPoolScheduler(
+    std::size_t thread_count, absl::string_view name = "AggregationScheduler");
 
 }  // namespace tensorflow_federated
 
@@ -26,6 +26,7 @@
 #include "absl/synchronization/mutex.h"
 #include "absl/time/clock.h"
 #include "absl/time/time.h"
+#include "tensorflow_federated/cc/core/impl/base/thread_pool_stats.h"
 
 namespace tensorflow_federated {
 namespace base {
@@ -97,6 +98,32 @@ TEST(ThreadPool, StressTest) {
   ASSERT_EQ(atomic_counter, kThreads * kIterations);
 }
 
+TEST(ThreadPool, ReportsStats) {
+  ThreadPoolStats* stats = GetThreadPoolStats("scheduler_test_stats");
+  SetThreadPoolStatsEnabled(true);
+  {
+    auto pool = CreateThreadPoolScheduler(2, "scheduler_test_stats");
+    EXPECT_EQ(stats->Snapshot().num_threads, 2);
+    for (int i = 0; i < 10; ++i) {
+      pool->Schedule([] { absl::SleepFor(absl::Milliseconds(1)); });
+    }
+    pool->WaitUntilIdle();
+  }
+  ThreadPoolStatsSnapshot snapshot = stats->Snapshot();
+  EXPECT_EQ(snapshot.num_threads, 0);
+  EXPECT_EQ(snapshot.scheduled_tasks, 10);
+  EXPECT_EQ(snapshot.started_tasks, 10);
+  EXPECT_EQ(snapshot.completed_tasks, 10);
+  EXPECT_EQ(snapshot.queue_depth, 0);
+  EXPECT_EQ(snapshot.active_workers, 0);
+  EXPECT_GE(snapshot.max_active_workers, 1);
+  EXPECT_LE(snapshot.max_active_workers, 2);
+  EXPECT_EQ(snapshot.queue_time_us.count, 10);
+  EXPECT_EQ(snapshot.run_time_us.count, 10);
+  EXPECT_GE(snapshot.run_time_us.sum, 10 * 1000);
+  SetThreadPoolStatsEnabled(false);
+}
+
 TEST(Worker, TasksAreExecutedSequentially) {
   auto pool = CreateThreadPoolScheduler(3);
   auto worker = pool->CreateWorker();
@@ -0,0 +1,258 @@
+/*
+ * Copyright 2026 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "tensorflow_federated/cc/core/impl/base/thread_pool_stats.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+
+namespace tensorflow_federated {
+
+namespace {
+
+std::atomic<bool> stats_enabled{false};
+
+// Returns the shard the current thread records into.
+int ThisThreadShard() {
+  static std::atomic<int> next_shard{0};
+  thread_local const int shard =
+      next_shard.fetch_add(1, std::memory_order_relaxed) % kNumStatsShards;
+  return shard;
+}
+
+class ThreadPoolStatsRegistry {
+ public:
+  static ThreadPoolStatsRegistry& Get() {
+    // Intentionally leaked so that pools destroyed during static destruction
+    // can still report into their stats.
+    static ThreadPoolStatsRegistry* registry = new ThreadPoolStatsRegistry();
+    return *registry;
+  }
+
+  ThreadPoolStats* GetOrCreate(absl::string_view name) {
+    absl::MutexLock lock(&mutex_);
+    std::unique_ptr<ThreadPoolStats>& stats = stats_[std::string(name)];
+    if (stats == nullptr) {
+      stats = std::make_unique<ThreadPoolStats>(name);
+    }
+    return stats.get();
+  }
+
+  std::vector<ThreadPoolStatsSnapshot> SnapshotAll() {
+    absl::MutexLock lock(&mutex_);
+    std::vector<ThreadPoolStatsSnapshot> snapshots;
+    snapshots.reserve(stats_.size());
+    for (const auto& [name, stats] : stats_) {
+      snapshots.push_back(stats->Snapshot());
+    }
+    return snapshots;
+  }
+
+  void ResetAll() {
+    absl::MutexLock lock(&mutex_);
+    for (const auto& [name, stats] : stats_) {
+      stats->Reset();
+    }
+  }
+
+ private:
+  absl::Mutex mutex_;
+  // Ordered so that snapshots are sorted by name.
+  std::map<std::string, std::unique_ptr<ThreadPoolStats>> stats_
+      ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace
+
+Histogram::Histogram(int64_t base) {
+  bucket_limits_[0] = 0;
+  int64_t limit = 1;
+  for (int i = 1; i < kNumBuckets - 1; ++i) {
+    bucket_limits_[i] = limit;
+    limit *= base;
+  }
+  bucket_limits_[kNumBuckets - 1] = std::numeric_limits<int64_t>::max();
+}
+
+void Histogram::Record(int64_t value) {
+  if (value < 0) {
+    value = 0;
+  }
+  int bucket = 0;
+  while (value > bucket_limits_[bucket]) {
+    ++bucket;
+  }
+  Shard& shard = shards_[ThisThreadShard()];
+  shard.bucket_counts[bucket].fetch_add(1, std::memory_order_relaxed);
+  shard.sum.fetch_add(value, std::memory_order_relaxed);
+}
+
+HistogramSnapshot Histogram::Snapshot() const {
+  HistogramSnapshot snapshot;
+  snapshot.bucket_limits.assign(bucket_limits_.begin(), bucket_limits_.end());
+  snapshot.bucket_counts.assign(kNumBuckets, 0);
+  for (const Shard& shard : shards_) {
+    for (int i = 0; i < kNumBuckets; ++i) {
+      const int64_t count =
+          shard.bucket_counts[i].load(std::memory_order_relaxed);
+      snapshot.bucket_counts[i] += count;
+      snapshot.count += count;
+    }
+    snapshot.sum += shard.sum.load(std::memory_order_relaxed);
+  }
+  return snapshot;
+}
+
+void Histogram::Reset() {
+  for (Shard& shard : shards_) {
+    for (std::atomic<int64_t>& bucket_count : shard.bucket_counts) {
+      bucket_count.store(0, std::memory_order_relaxed);
+    }
+    shard.sum.store(0, std::memory_order_relaxed);
+  }
+}
+
+ThreadPoolStats::ThreadPoolStats(absl::string_view name) : name_(name) {}
+
+void ThreadPoolStats::UpdateMax(std::atomic<int64_t>& max, int64_t value) {
+  int64_t current = max.load(std::memory_order_relaxed);
+  while (value > current &&
+         !max.compare_exchange_weak(current, value,
+                                    std::memory_order_relaxed)) {
+  }
+}
+
+void ThreadPoolStats::AddThreads(int64_t num_threads) {
+  num_threads_.fetch_add(num_threads, std::memory_order_relaxed);
+}
+
+void ThreadPoolStats::RemoveThreads(int64_t num_threads) {
+  num_threads_.fetch_sub(num_threads, std::memory_order_relaxed);
+}
+
+void ThreadPoolStats::RecordScheduled(int64_t queue_depth) {
+  counters_[ThisThreadShard()].scheduled.fetch_add(1,
+                                                   std::memory_order_relaxed);
+  UpdateMax(max_queue_depth_, queue_depth);
+  queue_depth_histogram_.Record(queue_depth);
+}
+
+void ThreadPoolStats::RecordRejected() {
+  counters_[ThisThreadShard()].rejected.fetch_add(1,
+                                                  std::memory_order_relaxed);
+}
+
+void ThreadPoolStats::RecordStarted(absl::Duration queue_time,
+                                    int64_t active_workers) {
+  counters_[ThisThreadShard()].started.fetch_add(1, std::memory_order_relaxed);
+  UpdateMax(max_active_workers_, active_workers);
+  queue_time_us_.Record(absl::ToInt64Microseconds(queue_time));
+}
+
+void ThreadPoolStats::RecordCompleted(absl::Duration run_time) {
+  counters_[ThisThreadShard()].completed.fetch_add(1,
+                                                   std::memory_order_relaxed);
+  run_time_us_.Record(absl::ToInt64Microseconds(run_time));
+}
+
+ThreadPoolStats::TaskCounts ThreadPoolStats::SumCounters() const {
+  TaskCounts counts;
+  for (const CounterShard& shard : counters_) {
+    counts.scheduled += shard.scheduled.load(std::memory_order_relaxed);
+    counts.started += shard.started.load(std::memory_order_relaxed);
+    counts.completed += shard.completed.load(std::memory_order_relaxed);
+    counts.rejected += shard.rejected.load(std::memory_order_relaxed);
+  }
+  return counts;
+}
+
+ThreadPoolStatsSnapshot ThreadPoolStats::Snapshot() const {
+  ThreadPoolStatsSnapshot snapshot;
+  snapshot.name = name_;
+  snapshot.num_threads = num_threads_.load(std::memory_order_relaxed);
+  const TaskCounts counts = SumCounters();
+  {
+    absl::MutexLock lock(&reset_mutex_);
+    snapshot.scheduled_tasks = counts.scheduled - reset_counts_.scheduled;
+    snapshot.started_tasks = counts.started - reset_counts_.started;
+    snapshot.completed_tasks = counts.completed - reset_counts_.completed;
+    snapshot.rejected_tasks = counts.rejected - reset_counts_.rejected;
+  }
+  // The shards are read one at a time, so a task which moves on while they
+  // are read may be missed by one counter and seen by the next.
+  snapshot.queue_depth =
+      std::max<int64_t>(counts.scheduled - counts.started, 0);
+  snapshot.active_workers =
+      std::max<int64_t>(counts.started - counts.completed, 0);
+  snapshot.max_queue_depth =
+      std::max(max_queue_depth_.load(std::memory_order_relaxed),
+               snapshot.queue_depth);
+  snapshot.max_active_workers =
+      std::max(max_active_workers_.load(std::memory_order_relaxed),
+               snapshot.active_workers);
+  snapshot.queue_depth_histogram = queue_depth_histogram_.Snapshot();
+  snapshot.queue_time_us = queue_time_us_.Snapshot();
+  snapshot.run_time_us = run_time_us_.Snapshot();
+  return snapshot;
+}
+
+void ThreadPoolStats::Reset() {
+  const TaskCounts counts = SumCounters();
+  {
+    absl::MutexLock lock(&reset_mutex_);
+    reset_counts_ = counts;
+  }
+  max_queue_depth_.store(
+      std::max<int64_t>(counts.scheduled - counts.started, 0),
+      std::memory_order_relaxed);
+  max_active_workers_.store(
+      std::max<int64_t>(counts.started - counts.completed, 0),
+      std::memory_order_relaxed);
+  queue_depth_histogram_.Reset();
+  queue_time_us_.Reset();
+  run_time_us_.Reset();
+}
+
+void SetThreadPoolStatsEnabled(bool enabled) {
+  stats_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool ThreadPoolStatsEnabled() {
+  return stats_enabled.load(std::memory_order_relaxed);
+}
+
+ThreadPoolStats* GetThreadPoolStats(absl::string_view name) {
+  return ThreadPoolStatsRegistry::Get().GetOrCreate(name);
+}
+
+std::vector<ThreadPoolStatsSnapshot> GetAllThreadPoolStats() {
+  return ThreadPoolStatsRegistry::Get().SnapshotAll();
+}
+
+void ResetAllThreadPoolStats() { ThreadPoolStatsRegistry::Get().ResetAll(); }
+
+}  // namespace tensorflow_federated
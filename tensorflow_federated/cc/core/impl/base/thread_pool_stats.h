@@ -0,0 +1,232 @@
+/*
+ * Copyright 2026 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef THIRD_PARTY_TENSORFLOW_FEDERATED_CC_CORE_IMPL_BASE_THREAD_POOL_STATS_H_
+#define THIRD_PARTY_TENSORFLOW_FEDERATED_CC_CORE_IMPL_BASE_THREAD_POOL_STATS_H_
+
+/**
+ * Overview
+ * ========
+ *
+ * Process-wide telemetry for thread pools. Each pool reports into a
+ * ThreadPoolStats object looked up by the pool's name; pools created with the
+ * same name share (and so aggregate into) the same object. The stats outlive
+ * the pools, so counters accumulate over the life of the process until
+ * ResetAllThreadPoolStats is called.
+ *
+ * Pools only record tasks while SetThreadPoolStatsEnabled(true) is in effect,
+ * so that the clock reads and counter updates are not paid by default. Thread
+ * counts are always kept. Counters and histograms are sharded by recording
+ * thread and summed when read, so recording threads do not contend on shared
+ * cache lines.
+ */
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "absl/base/optimization.h"
+#include "absl/base/thread_annotations.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+
+namespace tensorflow_federated {
+
+/**
+ * Number of shards of each counter and histogram. Threads are spread over the
+ * shards round-robin, in the order they first record a value.
+ */
+inline constexpr int kNumStatsShards = 16;
+
+/**
+ * A point-in-time copy of a Histogram.
+ *
+ * `bucket_limits[i]` is the inclusive upper bound of bucket `i`; the last
+ * bucket is unbounded and its limit is the maximum int64 value.
+ */
+struct HistogramSnapshot {
+  std::vector<int64_t> bucket_limits;
+  std::vector<int64_t> bucket_counts;
+  int64_t count = 0;
+  int64_t sum = 0;
+};
+
+/**
+ * A lock-free histogram of non-negative values with power-of-`base` bucket
+ * limits: 0, 1, base, base^2, ... The histogram is safe to record into from
+ * multiple threads concurrently.
+ */
+class Histogram {
+ public:
+  static constexpr int kNumBuckets = 16;
+
+  explicit Histogram(int64_t base);
+
+  Histogram(Histogram const&) = delete;
+  Histogram& operator=(Histogram const&) = delete;
+
+  void Record(int64_t value);
+  HistogramSnapshot Snapshot() const;
+  void Reset();
+
+ private:
+  struct ABSL_CACHELINE_ALIGNED Shard {
+    // The total count is derived from these when snapshotting, saving an
+    // atomic increment per recorded value.
+    std::array<std::atomic<int64_t>, kNumBuckets> bucket_counts{};
+    std::atomic<int64_t> sum{0};
+  };
+
+  std::array<int64_t, kNumBuckets> bucket_limits_;
+  std::array<Shard, kNumStatsShards> shards_;
+};
+
+/**
+ * A point-in-time copy of a ThreadPoolStats.
+ */
+struct ThreadPoolStatsSnapshot {
+  std::string name;
+  // Threads currently owned by live pools with this name.
+  int64_t num_threads = 0;
+  // Tasks accepted, started and finished by the pools.
+  int64_t scheduled_tasks = 0;
+  int64_t started_tasks = 0;
+  int64_t completed_tasks = 0;
+  // Tasks refused because the pool was closed.
+  int64_t rejected_tasks = 0;
+  // Tasks currently queued, and the most ever queued at once.
+  int64_t queue_depth = 0;
+  int64_t max_queue_depth = 0;
+  // Workers currently running a task, and the most ever running at once.
+  int64_t active_workers = 0;
+  int64_t max_active_workers = 0;
+  // The queue depth observed by each newly scheduled task, including itself.
+  HistogramSnapshot queue_depth_histogram;
+  // Microseconds from a task being scheduled to it starting.
+  HistogramSnapshot queue_time_us;
+  // Microseconds a task ran for.
+  HistogramSnapshot run_time_us;
+};
+
+/**
+ * Counters, gauges and histograms describing the thread pools of one name.
+ *
+ * All methods are thread-safe, and the Record methods are lock-free, so pools
+ * may call them on every task. The queue depth and active worker gauges are
+ * derived from the task counters when snapshotting; their peaks are tracked
+ * from the values the pools report.
+ */
+class ThreadPoolStats {
+ public:
+  explicit ThreadPoolStats(absl::string_view name);
+
+  ThreadPoolStats(ThreadPoolStats const&) = delete;
+  ThreadPoolStats& operator=(ThreadPoolStats const&) = delete;
+
+  const std::string& name() const { return name_; }
+
+  // Adjusts the thread gauge when a pool starts or stops threads.
+  void AddThreads(int64_t num_threads);
+  void RemoveThreads(int64_t num_threads);
+
+  // Records a task being added to a queue, leaving `queue_depth` tasks queued
+  // in the pool.
+  void RecordScheduled(int64_t queue_depth);
+  // Records a task refused because the pool was closed.
+  void RecordRejected();
+  // Records a task being taken off a queue to run, `queue_time` after it was
+  // scheduled, while `active_workers` of the pool's workers are running tasks.
+  void RecordStarted(absl::Duration queue_time, int64_t active_workers);
+  // Records a task finishing after running for `run_time`. Only tasks recorded
+  // by `RecordStarted` may be recorded here, and only those recorded by
+  // `RecordScheduled` may be recorded by `RecordStarted`.
+  void RecordCompleted(absl::Duration run_time);
+
+  ThreadPoolStatsSnapshot Snapshot() const;
+
+  // Zeroes counters, peaks and histograms. Gauges describing the current
+  // state (threads, queue depth and active workers) are kept.
+  void Reset();
+
+ private:
+  struct TaskCounts {
+    int64_t scheduled = 0;
+    int64_t started = 0;
+    int64_t completed = 0;
+    int64_t rejected = 0;
+  };
+
+  struct ABSL_CACHELINE_ALIGNED CounterShard {
+    std::atomic<int64_t> scheduled{0};
+    std::atomic<int64_t> started{0};
+    std::atomic<int64_t> completed{0};
+    std::atomic<int64_t> rejected{0};
+  };
+
+  static void UpdateMax(std::atomic<int64_t>& max, int64_t value);
+  // Sums the counters of every shard.
+  TaskCounts SumCounters() const;
+
+  const std::string name_;
+  std::atomic<int64_t> num_threads_{0};
+  // Never reset, so that the gauges can be derived from them.
+  std::array<CounterShard, kNumStatsShards> counters_;
+  // The counters at the last `Reset`, subtracted from reported counters.
+  mutable absl::Mutex reset_mutex_;
+  TaskCounts reset_counts_ ABSL_GUARDED_BY(reset_mutex_);
+  // Only written when a pool reports a new peak.
+  std::atomic<int64_t> max_queue_depth_{0};
+  std::atomic<int64_t> max_active_workers_{0};
+  Histogram queue_depth_histogram_{/*base=*/2};
+  Histogram queue_time_us_{/*base=*/4};
+  Histogram run_time_us_{/*base=*/4};
+};
+
+/**
+ * Enables or disables recording of tasks by every pool. Disabled by default.
+ * Tasks already queued when this changes are recorded, or not, as they were
+ * when scheduled.
+ */
+void SetThreadPoolStatsEnabled(bool enabled);
+
+/**
+ * Returns whether pools record their tasks.
+ */
+bool ThreadPoolStatsEnabled();
+
+/**
+ * Returns the process-wide stats for pools named `name`, creating them if
+ * needed. The returned object is never destroyed.
+ */
+ThreadPoolStats* GetThreadPoolStats(absl::string_view name);
+
+/**
+ * Returns snapshots of the stats of every pool name seen so far, sorted by
+ * name.
+ */
+std::vector<ThreadPoolStatsSnapshot> GetAllThreadPoolStats();
+
+/**
+ * Resets the stats of every pool name seen so far.
+ */
+void ResetAllThreadPoolStats();
+
+}  // namespace tensorflow_federated
+
+#endif  // THIRD_PARTY_TENSORFLOW_FEDERATED_CC_CORE_IMPL_BASE_THREAD_POOL_STATS_H_
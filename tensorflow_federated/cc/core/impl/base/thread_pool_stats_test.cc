@@ -0,0 +1,162 @@
+/*
+ * Copyright 2026 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "tensorflow_federated/cc/core/impl/base/thread_pool_stats.h"
+
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "googlemock/include/gmock/gmock.h"
+#include "googletest/include/gtest/gtest.h"
+#include "absl/time/time.h"
+
+namespace tensorflow_federated {
+namespace {
+
+using ::testing::ElementsAre;
+
+TEST(HistogramTest, BucketsArePowersOfBase) {
+  Histogram histogram(/*base=*/4);
+  HistogramSnapshot snapshot = histogram.Snapshot();
+  ASSERT_EQ(snapshot.bucket_limits.size(), Histogram::kNumBuckets);
+  EXPECT_EQ(snapshot.bucket_limits[0], 0);
+  EXPECT_EQ(snapshot.bucket_limits[1], 1);
+  EXPECT_EQ(snapshot.bucket_limits[2], 4);
+  EXPECT_EQ(snapshot.bucket_limits[3], 16);
+  EXPECT_EQ(snapshot.bucket_limits.back(),
+            std::numeric_limits<int64_t>::max());
+}
+
+TEST(HistogramTest, RecordsIntoInclusiveBuckets) {
+  Histogram histogram(/*base=*/2);
+  for (int64_t value : {-1, 0, 1, 2, 3, 4, 5}) {
+    histogram.Record(value);
+  }
+  histogram.Record(std::numeric_limits<int64_t>::max());
+  HistogramSnapshot snapshot = histogram.Snapshot();
+  std::vector<int64_t> expected(Histogram::kNumBuckets, 0);
+  expected[0] = 2;   // -1 (clamped), 0
+  expected[1] = 1;   // 1
+  expected[2] = 1;   // 2
+  expected[3] = 2;   // 3, 4
+  expected[4] = 1;   // 5
+  expected.back() = 1;
+  EXPECT_EQ(snapshot.bucket_counts, expected);
+  EXPECT_EQ(snapshot.count, 8);
+}
+
+TEST(ThreadPoolStatsTest, TracksTaskLifecycle) {
+  ThreadPoolStats stats("lifecycle");
+  stats.AddThreads(2);
+  stats.RecordScheduled(/*queue_depth=*/1);
+  stats.RecordScheduled(/*queue_depth=*/2);
+  stats.RecordRejected();
+  ThreadPoolStatsSnapshot snapshot = stats.Snapshot();
+  EXPECT_EQ(snapshot.name, "lifecycle");
+  EXPECT_EQ(snapshot.num_threads, 2);
+  EXPECT_EQ(snapshot.scheduled_tasks, 2);
+  EXPECT_EQ(snapshot.rejected_tasks, 1);
+  EXPECT_EQ(snapshot.queue_depth, 2);
+  EXPECT_EQ(snapshot.max_queue_depth, 2);
+  EXPECT_EQ(snapshot.queue_depth_histogram.count, 2);
+
+  stats.RecordStarted(absl::Microseconds(3), /*active_workers=*/1);
+  stats.RecordStarted(absl::Microseconds(5), /*active_workers=*/2);
+  snapshot = stats.Snapshot();
+  EXPECT_EQ(snapshot.queue_depth, 0);
+  EXPECT_EQ(snapshot.active_workers, 2);
+  EXPECT_EQ(snapshot.max_active_workers, 2);
+  EXPECT_EQ(snapshot.queue_time_us.count, 2);
+  EXPECT_EQ(snapshot.queue_time_us.sum, 8);
+
+  stats.RecordCompleted(absl::Milliseconds(1));
+  snapshot = stats.Snapshot();
+  EXPECT_EQ(snapshot.active_workers, 1);
+  EXPECT_EQ(snapshot.max_active_workers, 2);
+  EXPECT_EQ(snapshot.completed_tasks, 1);
+  EXPECT_EQ(snapshot.run_time_us.sum, 1000);
+}
+
+TEST(ThreadPoolStatsTest, ResetKeepsCurrentState) {
+  ThreadPoolStats stats("reset");
+  stats.AddThreads(1);
+  stats.RecordScheduled(/*queue_depth=*/1);
+  stats.RecordScheduled(/*queue_depth=*/2);
+  stats.RecordStarted(absl::ZeroDuration(), /*active_workers=*/1);
+  stats.Reset();
+  ThreadPoolStatsSnapshot snapshot = stats.Snapshot();
+  EXPECT_EQ(snapshot.num_threads, 1);
+  EXPECT_EQ(snapshot.scheduled_tasks, 0);
+  EXPECT_EQ(snapshot.started_tasks, 0);
+  EXPECT_EQ(snapshot.queue_depth, 1);
+  EXPECT_EQ(snapshot.max_queue_depth, 1);
+  EXPECT_EQ(snapshot.active_workers, 1);
+  EXPECT_EQ(snapshot.max_active_workers, 1);
+  EXPECT_EQ(snapshot.queue_time_us.count, 0);
+}
+
+TEST(ThreadPoolStatsTest, SumsRecordsFromManyThreads) {
+  constexpr int kNumThreads = 2 * kNumStatsShards;
+  constexpr int kTasksPerThread = 1000;
+  ThreadPoolStats stats("many_threads");
+  std::vector<std::thread> threads;
+  for (int i = 0; i < kNumThreads; ++i) {
+    threads.emplace_back([&stats]() {
+      for (int j = 0; j < kTasksPerThread; ++j) {
+        stats.RecordScheduled(/*queue_depth=*/1);
+        stats.RecordStarted(absl::Microseconds(1), /*active_workers=*/1);
+        stats.RecordCompleted(absl::Microseconds(2));
+      }
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  ThreadPoolStatsSnapshot snapshot = stats.Snapshot();
+  EXPECT_EQ(snapshot.scheduled_tasks, kNumThreads * kTasksPerThread);
+  EXPECT_EQ(snapshot.completed_tasks, kNumThreads * kTasksPerThread);
+  EXPECT_EQ(snapshot.queue_depth, 0);
+  EXPECT_EQ(snapshot.active_workers, 0);
+  EXPECT_EQ(snapshot.queue_time_us.count, kNumThreads * kTasksPerThread);
+  EXPECT_EQ(snapshot.run_time_us.sum, 2 * kNumThreads * kTasksPerThread);
+}
+
+TEST(ThreadPoolStatsTest, IsDisabledByDefault) {
+  EXPECT_FALSE(ThreadPoolStatsEnabled());
+  SetThreadPoolStatsEnabled(true);
+  EXPECT_TRUE(ThreadPoolStatsEnabled());
+  SetThreadPoolStatsEnabled(false);
+}
+
+TEST(ThreadPoolStatsTest, RegistrySharesStatsByName) {
+  ThreadPoolStats* first = GetThreadPoolStats("registry_b");
+  EXPECT_EQ(GetThreadPoolStats("registry_b"), first);
+  EXPECT_NE(GetThreadPoolStats("registry_a"), first);
+  first->RecordRejected();
+  std::vector<std::string> names;
+  for (const ThreadPoolStatsSnapshot& snapshot : GetAllThreadPoolStats()) {
+    names.push_back(snapshot.name);
+  }
+  EXPECT_THAT(names, ElementsAre("registry_a", "registry_b"));
+  ResetAllThreadPoolStats();
+  EXPECT_EQ(first->Snapshot().rejected_tasks, 0);
+}
+
+}  // namespace
+}  // namespace tensorflow_federated
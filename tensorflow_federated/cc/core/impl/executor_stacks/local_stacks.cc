@@ -30,12 +30,13 @@ namespace tensorflow_federated {
 absl::StatusOr<std::shared_ptr<Executor>> CreateLocalExecutor(
     const CardinalityMap& cardinalities,
     std::function<absl::StatusOr<std::shared_ptr<Executor>>(int32_t)>
-        leaf_executor_fn) {
+        leaf_executor_fn,
+    std::shared_ptr<MemoryBudget> memory_budget) {
   std::shared_ptr<Executor> leaf_executor =
       CreateReferenceResolvingExecutor(CreateSequenceExecutor(
           CreateReferenceResolvingExecutor(TFF_TRY(leaf_executor_fn(-1)))));
   return CreateReferenceResolvingExecutor(TFF_TRY(CreateFederatingExecutor(
       /*server_child=*/leaf_executor, /*client_child=*/leaf_executor,
-      cardinalities)));
+      cardinalities, std::move(memory_budget))));
 }
 }  // namespace tensorflow_federated
@@ -23,6 +23,7 @@ limitations under the License
 #include "absl/status/statusor.h"
 #include "tensorflow_federated/cc/core/impl/executors/cardinalities.h"
 #include "tensorflow_federated/cc/core/impl/executors/executor.h"
+#include "tensorflow_federated/cc/core/impl/executors/memory_budget.h"
 #include "tensorflow_federated/cc/core/impl/executors/tensorflow_executor.h"
 
 namespace tensorflow_federated {
@@ -32,11 +33,18 @@ namespace tensorflow_federated {
 // to execute non-federated computations embedded in TFF's computation protos,
 // e.g. TensorFlow graphs or Jax computations.
 
+// The federated values held by the stack are charged to `memory_budget`; see
+// `CreateFederatingExecutor`.
+//
 // Returns an absl::Status if construction fails, and a shared_ptr to an
 // instance of Executor if construction succeeds.
 absl::StatusOr<std::shared_ptr<Executor>> CreateLocalExecutor(
     const CardinalityMap& cardinalities,
     std::function<absl::StatusOr<std::shared_ptr<Executor>>(int32_t)>
-        leaf_executor_fn = CreateTensorFlowExecutor);
+        leaf_executor_fn =
+            [](int32_t max_concurrent_computation_calls) {
+              return CreateTensorFlowExecutor(max_concurrent_computation_calls);
+            },
+    std::shared_ptr<MemoryBudget> memory_budget = nullptr);
 }  // namespace tensorflow_federated
 #endif  // THIRD_PARTY_TENSORFLOW_FEDERATED_CC_CORE_IMPL_EXECUTOR_STACKS_LOCAL_STACKS_H_
@@ -15,11 +15,13 @@ limitations under the License
 
 #include "tensorflow_federated/cc/core/impl/executors/composing_executor.h"
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
 #include <functional>
 #include <future>  // NOLINT
 #include <memory>
+#include <numeric>
 #include <optional>
 #include <string>
 #include <thread>  // NOLINT
@@ -30,6 +32,7 @@ limitations under the License
 
 #include "absl/base/attributes.h"
 #include "absl/base/thread_annotations.h"
+#include "absl/functional/function_ref.h"
 #include "absl/log/check.h"
 #include "absl/log/log.h"
 #include "absl/status/status.h"
@@ -43,6 +46,7 @@ limitations under the License
 #include "tensorflow_federated/cc/core/impl/executors/computations.h"
 #include "tensorflow_federated/cc/core/impl/executors/executor.h"
 #include "tensorflow_federated/cc/core/impl/executors/federated_intrinsics.h"
+#include "tensorflow_federated/cc/core/impl/executors/memory_budget.h"
 #include "tensorflow_federated/cc/core/impl/executors/status_macros.h"
 #include "tensorflow_federated/cc/core/impl/executors/threading.h"
 #include "tensorflow_federated/cc/core/impl/executors/value_validation.h"
@@ -69,14 +73,24 @@ inline std::shared_ptr<OwnedValueId> ShareValueId(OwnedValueId&& id) {
 // (3) both.
 class UnplacedInner {
  public:
-  explicit UnplacedInner(std::shared_ptr<v0::Value> proto)
-      : proto_(std::move(proto)) {}
-  explicit UnplacedInner(v0::Value proto)
-      : proto_(std::make_shared<v0::Value>(std::move(proto))) {}
-  explicit UnplacedInner(std::shared_ptr<OwnedValueId> embedded)
-      : embedded_(std::move(embedded)) {}
-  explicit UnplacedInner(OwnedValueId embedded)
-      : embedded_(std::make_shared<OwnedValueId>(std::move(embedded))) {}
+  // The bytes of the proto representation, once it exists, are charged to
+  // `memory_budget` for the lifetime of this value.
+  UnplacedInner(std::shared_ptr<v0::Value> proto,
+                std::shared_ptr<MemoryBudget> memory_budget)
+      : memory_budget_(std::move(memory_budget)),
+        proto_charge_(memory_budget_->Charge(proto->ByteSizeLong())),
+        proto_(std::move(proto)) {}
+  UnplacedInner(v0::Value proto, std::shared_ptr<MemoryBudget> memory_budget)
+      : UnplacedInner(std::make_shared<v0::Value>(std::move(proto)),
+                      std::move(memory_budget)) {}
+  UnplacedInner(std::shared_ptr<OwnedValueId> embedded,
+                std::shared_ptr<MemoryBudget> memory_budget)
+      : memory_budget_(std::move(memory_budget)),
+        embedded_(std::move(embedded)) {}
+  UnplacedInner(OwnedValueId embedded,
+                std::shared_ptr<MemoryBudget> memory_budget)
+      : memory_budget_(std::move(memory_budget)),
+        embedded_(std::make_shared<OwnedValueId>(std::move(embedded))) {}
   // NOTE: all constructors must set either `proto` OR (inclusive) `embedded`.
   // Internals assume that at least one of these values is set.
 
@@ -108,6 +122,8 @@ class UnplacedInner {
       auto proto_or_status =
           server.Materialize(embedded_.value().value()->ref());
       if (proto_or_status.ok()) {
+        proto_charge_ =
+            memory_budget_->Charge(proto_or_status.value().ByteSizeLong());
         proto_ =
             std::make_shared<v0::Value>(std::move(proto_or_status.value()));
       } else {
@@ -164,7 +180,9 @@ class UnplacedInner {
     }
   }
 
+  const std::shared_ptr<MemoryBudget> memory_budget_;
   absl::Mutex mutex_;
+  std::shared_ptr<const MemoryCharge> proto_charge_ ABSL_GUARDED_BY(mutex_);
   std::optional<absl::StatusOr<std::shared_ptr<v0::Value>>> proto_
       ABSL_GUARDED_BY(mutex_);
   std::optional<absl::StatusOr<std::shared_ptr<OwnedValueId>>> embedded_
@@ -176,6 +194,9 @@ class UnplacedInner {
 using Unplaced = std::shared_ptr<UnplacedInner>;
 using Server = std::shared_ptr<OwnedValueId>;
 using Clients = std::shared_ptr<std::vector<std::shared_ptr<OwnedValueId>>>;
+// The number of clients held by each child's part of a clients-placed value
+// restricted by `CreateClientsSubset`.
+using ClientCounts = std::shared_ptr<const std::vector<int32_t>>;
 using Structure = std::shared_ptr<std::vector<ExecutorValue>>;
 struct TypedFederatedIntrinsic {
   // The Federated Intrinsic.
@@ -220,6 +241,17 @@ class ExecutorValue {
   inline static ExecutorValue CreateClientsPlaced(Clients client_values) {
     return ExecutorValue(std::move(client_values), ValueType::CLIENTS);
   }
+  // A clients-placed value whose children hold `client_counts` clients,
+  // rather than all of their clients.
+  inline static ExecutorValue CreateClientsPlaced(Clients client_values,
+                                                  ClientCounts client_counts) {
+    ExecutorValue value(std::move(client_values), ValueType::CLIENTS);
+    value.client_counts_ = std::move(client_counts);
+    return value;
+  }
+  // The number of clients held by each child, or nullptr if each child holds
+  // all of its clients.
+  inline const ClientCounts& client_counts() const { return client_counts_; }
   // Convenience constructor from an un-shared_ptr vector.
   inline static ExecutorValue CreateClientsPlaced(
       std::vector<std::shared_ptr<OwnedValueId>>&& client_values) {
@@ -308,9 +340,11 @@ class ExecutorValue {
 
   // Constructs an `ExecutorValue` from a provided proto, delegating creation
   // of federated values to `create_federated` and creating unrecognized
-  // values inside of the `unplaced_child` executor.
+  // values inside of the `unplaced_child` executor. Unplaced value protos are
+  // charged to `memory_budget`.
   static absl::StatusOr<ExecutorValue> FromProto(
       const v0::Value& value_pb, Executor& unplaced_child, int32_t num_clients,
+      const std::shared_ptr<MemoryBudget>& memory_budget,
       const std::function<absl::StatusOr<ExecutorValue>(
           FederatedKind, const v0::Value_Federated&)>& create_federated) {
     switch (value_pb.value_case()) {
@@ -325,7 +359,8 @@ class ExecutorValue {
         for (const auto& element_pb : value_pb.struct_().element()) {
           elements->emplace_back(TFF_TRY(
               ExecutorValue::FromProto(element_pb.value(), unplaced_child,
-                                       num_clients, create_federated)));
+                                       num_clients, memory_budget,
+                                       create_federated)));
         }
         return ExecutorValue::CreateStructure(std::move(elements));
       }
@@ -340,7 +375,7 @@ class ExecutorValue {
         ABSL_FALLTHROUGH_INTENDED;
       default: {
         return ExecutorValue::CreateUnplaced(
-            std::make_shared<UnplacedInner>(value_pb));
+            std::make_shared<UnplacedInner>(value_pb, memory_budget));
       }
     }
   }
@@ -354,6 +389,7 @@ class ExecutorValue {
   ExecutorValue() = delete;
   ValueVariant value_;
   ValueType type_;
+  ClientCounts client_counts_;
 };
 
 class ComposingExecutor : public ExecutorBase<ValueFuture> {
@@ -361,10 +397,12 @@ class ComposingExecutor : public ExecutorBase<ValueFuture> {
   explicit ComposingExecutor(std::shared_ptr<Executor> server,
                              std::vector<ComposingChild> children,
                              int32_t total_clients,
+                             std::shared_ptr<MemoryBudget> memory_budget,
                              int32_t threadpool_size = -1)
       : server_(std::move(server)),
         children_(std::move(children)),
         total_clients_(total_clients),
+        memory_budget_(std::move(memory_budget)),
         thread_pool_(
             // Use a threadpool with CPU * 4 or the user specified
             // maximum.
@@ -391,7 +429,8 @@ class ComposingExecutor : public ExecutorBase<ValueFuture> {
   absl::StatusOr<ValueFuture> CreateExecutorValue(
       const v0::Value& value_pb) final {
     return ReadyFuture(TFF_TRY(ExecutorValue::FromProto(
-        value_pb, *server_, total_clients_, [this](auto kind, const auto& v) {
+        value_pb, *server_, total_clients_, memory_budget_,
+        [this](auto kind, const auto& v) {
           return CreateFederatedValue(kind, v);
         })));
   }
@@ -406,6 +445,7 @@ class ComposingExecutor : public ExecutorBase<ValueFuture> {
           if (argument.has_value()) {
             arg = TFF_TRY(Wait(argument.value()));
           }
+          memory_budget_->WaitForCapacity();
 
           switch (fn.type()) {
             case ExecutorValue::ValueType::CLIENTS:
@@ -428,7 +468,8 @@ class ComposingExecutor : public ExecutorBase<ValueFuture> {
               }
               return ExecutorValue::CreateUnplaced(
                   std::make_shared<UnplacedInner>(
-                      TFF_TRY(server_->CreateCall(fn_id->ref(), arg_id))));
+                      TFF_TRY(server_->CreateCall(fn_id->ref(), arg_id)),
+                      memory_budget_));
             }
             case ExecutorValue::ValueType::INTRINSIC: {
               if (!arg.has_value()) {
@@ -459,7 +500,8 @@ class ComposingExecutor : public ExecutorBase<ValueFuture> {
                                               const uint32_t index) final {
     return Map(
         std::vector<ValueFuture>({value}),
-        [server = this->server_, index](std::vector<ExecutorValue>&& values)
+        [server = this->server_, memory_budget = this->memory_budget_,
+         index](std::vector<ExecutorValue>&& values)
             -> absl::StatusOr<ExecutorValue> {
           ExecutorValue& value = values[0];
           switch (value.type()) {
@@ -472,7 +514,8 @@ class ComposingExecutor : public ExecutorBase<ValueFuture> {
               auto id = TFF_TRY(value.unplaced()->Embedded(*server));
               return ExecutorValue::CreateUnplaced(
                   std::make_shared<UnplacedInner>(
-                      TFF_TRY(server->CreateSelection(id->ref(), index))));
+                      TFF_TRY(server->CreateSelection(id->ref(), index)),
+                      memory_budget));
             }
             case ExecutorValue::ValueType::INTRINSIC: {
               return absl::InvalidArgumentError("Cannot select from intrinsic");
@@ -494,15 +537,161 @@ class ComposingExecutor : public ExecutorBase<ValueFuture> {
     ExecutorValue value = TFF_TRY(Wait(std::move(value_fut)));
     ParallelTasks tasks(&thread_pool_);
     TFF_TRY(MaterializeValue(value, value_pb, tasks));
-    TFF_TRY(tasks.WaitAll());
+    TFF_TRY(tasks.WaitAllFailFast());
     return absl::OkStatus();
   }
 
+  absl::Status MaterializeClients(
+      ValueFuture value_fut, absl::Span<const int32_t> client_indices,
+      absl::FunctionRef<absl::Status(int32_t, v0::Value)> consume) final {
+    ExecutorValue value = TFF_TRY(Wait(std::move(value_fut)));
+    if (value.type() != ExecutorValue::ValueType::CLIENTS) {
+      return absl::InvalidArgumentError(
+          absl::StrCat("`MaterializeClients` expected a clients-placed value, "
+                       "found a value of type ",
+                       value.type()));
+    }
+    // Splits the requested clients by child, as indices local to each child.
+    // An empty list requests all the clients of a child.
+    std::vector<std::vector<int32_t>> indices_for_child(children_.size());
+    std::vector<bool> child_requested(children_.size(), client_indices.empty());
+    std::vector<int32_t> child_start(children_.size());
+    for (int32_t i = 0, start = 0; i < children_.size(); i++) {
+      child_start[i] = start;
+      start += NumClientsOfChild(value, i);
+    }
+    const int32_t num_clients = NumClients(value);
+    for (int32_t index : client_indices) {
+      if (index < 0 || index >= num_clients) {
+        return absl::InvalidArgumentError(absl::StrCat(
+            "Client index ", index, " is out of range for a value of ",
+            num_clients, " clients"));
+      }
+      int32_t child_index = std::upper_bound(child_start.begin(),
+                                             child_start.end(), index) -
+                            child_start.begin() - 1;
+      indices_for_child[child_index].push_back(index -
+                                               child_start[child_index]);
+      child_requested[child_index] = true;
+    }
+    // The children stream their clients concurrently; their calls to
+    // `consume` are serialized here. Once `consume` fails, clients which the
+    // other children still deliver are dropped.
+    absl::Mutex consume_mutex;
+    bool consume_failed = false;  // Guarded by `consume_mutex`.
+    ParallelTasks tasks(&thread_pool_);
+    for (int32_t i = 0; i < children_.size(); i++) {
+      if (!child_requested[i]) {
+        continue;
+      }
+      TFF_TRY(tasks.add_task([&value, &indices_for_child, &child_start,
+                              &consume, &consume_mutex, &consume_failed, i,
+                              child = children_[i]]() -> absl::Status {
+        return child.executor()->MaterializeClients(
+            value.clients()->at(i)->ref(), indices_for_child[i],
+            [&](int32_t local_index, v0::Value client_pb) -> absl::Status {
+              absl::MutexLock lock(&consume_mutex);
+              if (consume_failed) {
+                return absl::OkStatus();
+              }
+              absl::Status status =
+                  consume(child_start[i] + local_index, std::move(client_pb));
+              consume_failed = !status.ok();
+              return status;
+            });
+      }));
+    }
+    return tasks.WaitAllFailFast();
+  }
+
+  absl::StatusOr<ValueFuture> CreateClientsSubset(
+      ValueFuture value_fut, absl::Span<const int32_t> client_indices) final {
+    return ThreadRun(
+        [value_fut = std::move(value_fut),
+         client_indices = std::vector<int32_t>(client_indices.begin(),
+                                               client_indices.end()),
+         this]() -> absl::StatusOr<ExecutorValue> {
+          ExecutorValue value = TFF_TRY(Wait(value_fut));
+          return ClientsSubset(value, client_indices);
+        },
+        &thread_pool_);
+  }
+
  private:
+  absl::StatusOr<ExecutorValue> ClientsSubset(
+      const ExecutorValue& value, absl::Span<const int32_t> client_indices) {
+    if (value.type() != ExecutorValue::ValueType::CLIENTS) {
+      return absl::InvalidArgumentError(
+          absl::StrCat("`CreateClientsSubset` expected a clients-placed value, "
+                       "found a value of type ",
+                       value.type()));
+    }
+    // Each child restricts its part of the value to the requested clients it
+    // holds, as indices local to the child, in the order they were requested.
+    std::vector<int32_t> child_start(children_.size());
+    for (int32_t i = 0, start = 0; i < children_.size(); i++) {
+      child_start[i] = start;
+      start += NumClientsOfChild(value, i);
+    }
+    const int32_t num_clients = NumClients(value);
+    std::vector<std::vector<int32_t>> indices_for_child(children_.size());
+    int32_t last_child_index = 0;
+    for (int32_t index : client_indices) {
+      if (index < 0 || index >= num_clients) {
+        return absl::InvalidArgumentError(absl::StrCat(
+            "Client index ", index, " is out of range for a value of ",
+            num_clients, " clients"));
+      }
+      int32_t child_index = std::upper_bound(child_start.begin(),
+                                             child_start.end(), index) -
+                            child_start.begin() - 1;
+      // The clients are ordered by child, so the subset can only preserve the
+      // requested order if it visits the children in order.
+      if (child_index < last_child_index) {
+        return absl::InvalidArgumentError(
+            "`CreateClientsSubset` on a composing executor requires the "
+            "client indices of each child to be requested after those of the "
+            "previous children");
+      }
+      last_child_index = child_index;
+      indices_for_child[child_index].push_back(index -
+                                               child_start[child_index]);
+    }
+    Clients subset = NewClients();
+    auto client_counts = std::make_shared<std::vector<int32_t>>();
+    client_counts->reserve(children_.size());
+    for (int32_t i = 0; i < children_.size(); i++) {
+      subset->push_back(
+          ShareValueId(TFF_TRY(children_[i].executor()->CreateClientsSubset(
+              value.clients()->at(i)->ref(), indices_for_child[i]))));
+      client_counts->push_back(indices_for_child[i].size());
+    }
+    return ExecutorValue::CreateClientsPlaced(std::move(subset),
+                                              std::move(client_counts));
+  }
+
   Clients NewClients() const {
     return ::tensorflow_federated::NewClients(children_.size());
   }
 
+  // The number of clients held by the part of the clients-placed `value` in
+  // `children_[child_index]`.
+  int32_t NumClientsOfChild(const ExecutorValue& value,
+                            int32_t child_index) const {
+    return value.client_counts() != nullptr
+               ? value.client_counts()->at(child_index)
+               : children_[child_index].num_clients();
+  }
+
+  // The number of clients held by the clients-placed `value`.
+  int32_t NumClients(const ExecutorValue& value) const {
+    if (value.client_counts() == nullptr) {
+      return total_clients_;
+    }
+    return std::accumulate(value.client_counts()->begin(),
+                           value.client_counts()->end(), 0);
+  }
+
   absl::StatusOr<ExecutorValue> CreateFederatedValue(
       FederatedKind kind, const v0::Value_Federated& federated) {
     switch (kind) {
@@ -668,48 +857,86 @@ class ComposingExecutor : public ExecutorBase<ValueFuture> {
       child_result_ids.push_back(std::move(child_result_id));
     }
 
-    // Materialize and merge the results from each child executor.
+    // Materialize and merge the results from each child executor. The results
+    // are merged pairwise in a binary tree as they arrive: `pending[level]`
+    // holds a merge of 2^level results waiting for a sibling. Merges are
+    // issued outside of the lock, so that independent merges run
+    // concurrently and the tree is log2(children) merges deep.
     absl::Mutex mutex;
-    std::optional<OwnedValueId> current ABSL_GUARDED_BY(mutex) = std::nullopt;
+    std::vector<std::optional<OwnedValueId>> pending ABSL_GUARDED_BY(mutex);
 
     ParallelTasks materialize_tasks;
+    const CancellationToken& cancelled = materialize_tasks.cancellation_token();
 
     for (int32_t i = 0; i < children_.size(); i++) {
       TFF_TRY(materialize_tasks.add_task(
           [this, &child = children_[i].executor(),
-           &child_result_id = child_result_ids[i], &merge_id, &current,
-           &mutex]() -> absl::Status {
+           &child_result_id = child_result_ids[i], &merge_id, &pending, &mutex,
+           &cancelled]() -> absl::Status {
             v0::Value child_result =
                 TFF_TRY(child->Materialize(child_result_id));
+            if (cancelled.IsCancelled()) {
+              // Another child failed; the merged result will be discarded.
+              return absl::CancelledError("Aggregation cancelled.");
+            }
             if (!child_result.has_federated() ||
                 child_result.federated().type().placement().value().uri() !=
                     kServerUri) {
               return absl::InternalError(
                   "Child executor returned non-server-placed value");
             }
-            auto child_result_server_id = TFF_TRY(
+            OwnedValueId partial = TFF_TRY(
                 server_->CreateValue(child_result.federated().value(0)));
-
-            absl::MutexLock lock(&mutex);
-            if (current.has_value()) {
-              auto merge_arg = TFF_TRY(server_->CreateStruct(
-                  {current.value(), child_result_server_id}));
-              current =
-                  TFF_TRY(server_->CreateCall(merge_id->ref(), merge_arg));
-            } else {
-              current = std::move(child_result_server_id);
+            for (size_t level = 0;; level++) {
+              std::optional<OwnedValueId> sibling;
+              {
+                absl::MutexLock lock(&mutex);
+                if (pending.size() <= level) {
+                  pending.resize(level + 1);
+                }
+                if (!pending[level].has_value()) {
+                  pending[level] = std::move(partial);
+                  return absl::OkStatus();
+                }
+                sibling = std::exchange(pending[level], std::nullopt);
+              }
+              partial = TFF_TRY(
+                  MergeOnServer(merge_id->ref(), sibling.value(), partial));
             }
-            return absl::OkStatus();
           }));
     }
 
-    TFF_TRY(materialize_tasks.WaitAll());
+    TFF_TRY(materialize_tasks.WaitAllFailFast());
+
+    // Merge the subtrees left without a sibling, at most one per level.
+    std::optional<OwnedValueId> current = std::nullopt;
+    {
+      absl::MutexLock lock(&mutex);
+      for (std::optional<OwnedValueId>& subtree : pending) {
+        if (!subtree.has_value()) {
+          continue;
+        }
+        if (current.has_value()) {
+          current = TFF_TRY(MergeOnServer(merge_id->ref(), subtree.value(),
+                                          current.value()));
+        } else {
+          current = std::move(subtree);
+        }
+      }
+    }
 
     auto result =
         TFF_TRY(server_->CreateCall(report_id->ref(), current.value()));
     return ExecutorValue::CreateServerPlaced(ShareValueId(std::move(result)));
   }
 
+  // Calls `merge` on the server with the server values `first` and `second`.
+  absl::StatusOr<OwnedValueId> MergeOnServer(ValueId merge, ValueId first,
+                                             ValueId second) {
+    auto merge_arg = TFF_TRY(server_->CreateStruct({first, second}));
+    return TFF_TRY(server_->CreateCall(merge, merge_arg));
+  }
+
   absl::StatusOr<ExecutorValue> CallIntrinsicBroadcast(ExecutorValue&& arg) {
     auto traceme = Trace("CallIntrinsicBroadcast");
     if (arg.type() != ExecutorValue::ValueType::SERVER) {
@@ -748,7 +975,8 @@ class ComposingExecutor : public ExecutorBase<ValueFuture> {
         auto result = TFF_TRY(child->CreateCall(child_map, map_args));
         results->emplace_back(ShareValueId(std::move(result)));
       }
-      return ExecutorValue::CreateClientsPlaced(std::move(results));
+      return ExecutorValue::CreateClientsPlaced(std::move(results),
+                                                data.client_counts());
     } else if (data.type() == ExecutorValue::ValueType::SERVER) {
       auto embedded_fn = TFF_TRY(fn.Embed(*server_));
       auto res = TFF_TRY(
@@ -811,7 +1039,10 @@ class ComposingExecutor : public ExecutorBase<ValueFuture> {
           TFF_TRY(child->CreateCall(child_select_id, child_arg_id));
       child_result_ids.push_back(ShareValueId(std::move(child_result_id)));
     }
-    return ExecutorValue::CreateClientsPlaced(std::move(child_result_ids));
+    return ExecutorValue::CreateClientsPlaced(
+        std::make_shared<std::vector<std::shared_ptr<OwnedValueId>>>(
+            std::move(child_result_ids)),
+        keys.client_counts());
   }
 
   // Pushes `arg` containing structs of client-placed values into
@@ -867,7 +1098,33 @@ class ComposingExecutor : public ExecutorBase<ValueFuture> {
       pairs->push_back(ShareValueId(
           TFF_TRY(child->CreateCall(zip, arg_struct_in_child->ref()))));
     }
-    return ExecutorValue::CreateClientsPlaced(std::move(pairs));
+    // The children reject zipping values restricted to different clients.
+    return ExecutorValue::CreateClientsPlaced(std::move(pairs),
+                                              ZippedClientCounts(arg));
+  }
+
+  // Returns the client counts of the first clients-placed value in `arg` which
+  // is restricted by `CreateClientsSubset`, or `nullptr` if there is none. The
+  // children zip unrestricted all-equal values (e.g. a broadcast) with
+  // restricted ones, so the result holds the restricted clients.
+  static ClientCounts ZippedClientCounts(const ExecutorValue& arg) {
+    switch (arg.type()) {
+      case ExecutorValue::ValueType::CLIENTS: {
+        return arg.client_counts();
+      }
+      case ExecutorValue::ValueType::STRUCTURE: {
+        for (const ExecutorValue& element : *arg.structure()) {
+          ClientCounts client_counts = ZippedClientCounts(element);
+          if (client_counts != nullptr) {
+            return client_counts;
+          }
+        }
+        return nullptr;
+      }
+      default: {
+        return nullptr;
+      }
+    }
   }
 
   // Pushes `arg` containing structs of server-placed values into the `server_`
@@ -952,9 +1209,9 @@ class ComposingExecutor : public ExecutorBase<ValueFuture> {
                                             ValueId child_id,
                                             absl::Span<v0::Value*> protos_out,
                                             ParallelTasks& tasks) const {
-    CHECK(protos_out.size() == children_[child_index].num_clients());
     return tasks.add_task([child = children_[child_index], child_id,
                            protos_out]() -> absl::Status {
+      const int32_t num_clients = protos_out.size();
       v0::Value child_value = TFF_TRY(child.executor()->Materialize(child_id));
       if (!child_value.has_federated()) {
         return absl::InternalError(
@@ -970,17 +1227,17 @@ class ComposingExecutor : public ExecutorBase<ValueFuture> {
               child_value.federated().value_size(),
               ", but all-equal values must have only one value."));
         }
-        for (int32_t j = 0; j < child.num_clients(); j++) {
+        for (int32_t j = 0; j < num_clients; j++) {
           *(protos_out[j]) = child_value.federated().value(0);
         }
       } else {
-        if (child_value.federated().value_size() != child.num_clients()) {
+        if (child_value.federated().value_size() != num_clients) {
           return absl::InternalError(absl::StrCat(
-              "Composing child executor responsible for ", child.num_clients(),
+              "Composing child executor responsible for ", num_clients,
               " clients returned ", child_value.federated().value_size(),
               " client values."));
         }
-        for (int32_t j = 0; j < child.num_clients(); j++) {
+        for (int32_t j = 0; j < num_clients; j++) {
           *(protos_out[j]) =
               std::move(*child_value.mutable_federated()->mutable_value(j));
         }
@@ -998,12 +1255,13 @@ class ComposingExecutor : public ExecutorBase<ValueFuture> {
             federated_pb->mutable_value();
         // Ensure that the `values_pb` array does not grow, changing the
         // addresses to which `MaterializeChildClientValues` should load.
-        values_pb->Reserve(total_clients_);
+        const int32_t num_clients = NumClients(value);
+        values_pb->Reserve(num_clients);
         // Create `v0::Value`s for `MaterializeChildClientValues` to write to.
         // Note: we'd like to use `AddNAlreadyReserved`, but unfortunately that
         // method only exists for `RepeatedField`, not `RepeatedPtrField`.
         v0::Value null_value;
-        for (int32_t i = 0; i < total_clients_; i++) {
+        for (int32_t i = 0; i < num_clients; i++) {
           *values_pb->Add() = null_value;
         }
         federated_language::FederatedType* type_pb =
@@ -1017,11 +1275,11 @@ class ComposingExecutor : public ExecutorBase<ValueFuture> {
         v0::Value** client_start = values_pb->mutable_data();
         for (int32_t i = 0; i < children_.size(); i++) {
           absl::Span<v0::Value*> client_value_pointers(
-              client_start, children_[i].num_clients());
+              client_start, NumClientsOfChild(value, i));
           ValueId child_value_id = value.clients()->at(i)->ref();
           TFF_TRY(MaterializeChildClientValues(i, child_value_id,
                                                client_value_pointers, tasks));
-          client_start += children_[i].num_clients();
+          client_start += NumClientsOfChild(value, i);
         }
         return absl::OkStatus();
       }
@@ -1065,6 +1323,8 @@ class ComposingExecutor : public ExecutorBase<ValueFuture> {
   std::shared_ptr<Executor> server_;
   std::vector<ComposingChild> children_;
   int32_t total_clients_;
+  // Charged with the unplaced value protos held by this executor.
+  std::shared_ptr<MemoryBudget> memory_budget_;
 
   // IMPORTANT: The thread_pool_ must be the member of the class. This way the
   // thread_pool_ will be the first destructed, which will wait prevent new
@@ -1077,13 +1337,18 @@ class ComposingExecutor : public ExecutorBase<ValueFuture> {
 }  // namespace
 
 std::shared_ptr<Executor> CreateComposingExecutor(
-    std::shared_ptr<Executor> server, std::vector<ComposingChild> children) {
+    std::shared_ptr<Executor> server, std::vector<ComposingChild> children,
+    std::shared_ptr<MemoryBudget> memory_budget) {
   int32_t total_clients = 0;
   for (const auto& child : children) {
     total_clients += child.num_clients();
   }
+  if (memory_budget == nullptr) {
+    memory_budget = MemoryBudget::Create();
+  }
   return std::make_shared<ComposingExecutor>(
-      std::move(server), std::move(children), total_clients);
+      std::move(server), std::move(children), total_clients,
+      std::move(memory_budget));
 }
 
 }  // namespace tensorflow_federated
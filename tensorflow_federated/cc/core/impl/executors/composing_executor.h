@@ -24,6 +24,7 @@ limitations under the License
 #include "absl/status/statusor.h"
 #include "tensorflow_federated/cc/core/impl/executors/cardinalities.h"
 #include "tensorflow_federated/cc/core/impl/executors/executor.h"
+#include "tensorflow_federated/cc/core/impl/executors/memory_budget.h"
 #include "tensorflow_federated/cc/core/impl/executors/status_macros.h"
 
 namespace tensorflow_federated {
@@ -59,8 +60,14 @@ class ComposingChild {
 //
 // The `children` executors will be used for executing shards of federated
 // computations and must be able to resolve federated values and intrinsics.
+//
+// The unplaced value protos held by the executor are charged to
+// `memory_budget`, and calls are delayed while it is over its high-water mark.
+// If not provided, the executor accounts its memory in a budget without a
+// high-water mark.
 std::shared_ptr<Executor> CreateComposingExecutor(
-    std::shared_ptr<Executor> server, std::vector<ComposingChild> children);
+    std::shared_ptr<Executor> server, std::vector<ComposingChild> children,
+    std::shared_ptr<MemoryBudget> memory_budget = nullptr);
 
 }  // namespace tensorflow_federated
 
@@ -24,6 +24,7 @@ limitations under the License
 
 #include "googlemock/include/gmock/gmock.h"
 #include "googletest/include/gtest/gtest.h"
+#include "absl/container/flat_hash_map.h"
 #include "absl/status/status.h"
 #include "absl/types/span.h"
 #include "federated_language/proto/computation.pb.h"
@@ -36,6 +37,7 @@ limitations under the License
 #include "tensorflow_federated/cc/core/impl/executors/tensorflow_test_utils.h"
 #include "tensorflow_federated/cc/core/impl/executors/type_utils.h"
 #include "tensorflow_federated/cc/core/impl/executors/value_test_utils.h"
+#include "tensorflow_federated/cc/testing/protobuf_matchers.h"
 #include "tensorflow_federated/cc/testing/status_matchers.h"
 #include "tensorflow_federated/proto/v0/executor.pb.h"
 
@@ -159,6 +161,117 @@ TEST_F(ComposingExecutorTest, CreateMaterializeAtClients) {
   ExpectCreateMaterialize(ClientsV(values));
 }
 
+TEST_F(ComposingExecutorTest, MaterializeClientsSubset) {
+  // The clients 1 and 5 are held by the children 2 and 3.
+  const std::vector<int32_t> sampled = {1, 5};
+  std::vector<v0::Value> values;
+  for (uint32_t i = 0; i < mock_children_.size(); i++) {
+    const auto& child = mock_children_[i];
+    std::vector<v0::Value> child_values;
+    for (uint32_t j = 0; j < clients_per_child_[i]; j++) {
+      child_values.push_back(TensorV(static_cast<int32_t>(values.size())));
+      values.push_back(child_values.back());
+    }
+    ValueId child_id = child->ExpectCreateValue(ClientsV(child_values));
+    if (i >= 2) {
+      child->ExpectMaterialize(child_id, ClientsV(child_values));
+    }
+  }
+  TFF_ASSERT_OK_AND_ASSIGN(auto id,
+                           test_executor_->CreateValue(ClientsV(values)));
+  absl::flat_hash_map<int32_t, v0::Value> materialized;
+  TFF_ASSERT_OK(test_executor_->MaterializeClients(
+      id, sampled, [&](int32_t index, v0::Value value_pb) {
+        materialized.insert({index, std::move(value_pb)});
+        return absl::OkStatus();
+      }));
+  ASSERT_EQ(materialized.size(), sampled.size());
+  for (int32_t index : sampled) {
+    EXPECT_THAT(materialized[index], testing::EqualsProto(values[index]));
+  }
+  EXPECT_THAT(
+      test_executor_->MaterializeClients(
+          id, {static_cast<int32_t>(total_clients_)},
+          [](int32_t, v0::Value) { return absl::OkStatus(); }),
+      StatusIs(StatusCode::kInvalidArgument));
+}
+
+TEST_F(ComposingExecutorTest, MaterializeClientsStopsAfterConsumeFails) {
+  std::vector<v0::Value> values;
+  for (uint32_t i = 0; i < mock_children_.size(); i++) {
+    const auto& child = mock_children_[i];
+    std::vector<v0::Value> child_values;
+    for (uint32_t j = 0; j < clients_per_child_[i]; j++) {
+      child_values.push_back(TensorV(static_cast<int32_t>(values.size())));
+      values.push_back(child_values.back());
+    }
+    ValueId child_id = child->ExpectCreateValue(ClientsV(child_values));
+    // Children may already be materializing when `consume` fails.
+    child->ExpectMaterialize(child_id, ClientsV(child_values),
+                             ::testing::AtMost(1));
+  }
+  TFF_ASSERT_OK_AND_ASSIGN(auto id,
+                           test_executor_->CreateValue(ClientsV(values)));
+  int num_consumed = 0;
+  EXPECT_THAT(test_executor_->MaterializeClients(
+                  id, {},
+                  [&](int32_t, v0::Value) {
+                    num_consumed++;
+                    return absl::InternalError("consume failed");
+                  }),
+              StatusIs(StatusCode::kInternal));
+  EXPECT_EQ(num_consumed, 1);
+}
+
+TEST_F(ComposingExecutorTest, CreateClientsSubset) {
+  // The clients 1, 4 and 5 are held by the children 2 and 3.
+  const std::vector<std::vector<int32_t>> sampled_in_child = {
+      {}, {}, {0}, {1, 2}};
+  std::vector<v0::Value> values;
+  std::vector<v0::Value> sampled_values;
+  for (uint32_t i = 0; i < mock_children_.size(); i++) {
+    const auto& child = mock_children_[i];
+    std::vector<v0::Value> child_values;
+    for (uint32_t j = 0; j < clients_per_child_[i]; j++) {
+      child_values.push_back(TensorV(static_cast<int32_t>(values.size())));
+      values.push_back(child_values.back());
+    }
+    std::vector<v0::Value> child_sampled_values;
+    for (int32_t j : sampled_in_child[i]) {
+      child_sampled_values.push_back(child_values[j]);
+      sampled_values.push_back(child_values[j]);
+    }
+    ValueId child_id = child->ExpectCreateValue(ClientsV(child_values));
+    ValueId child_subset_id =
+        child->ExpectCreateClientsSubset(child_id, sampled_in_child[i]);
+    child->ExpectMaterialize(child_subset_id, ClientsV(child_sampled_values));
+  }
+  TFF_ASSERT_OK_AND_ASSIGN(auto id,
+                           test_executor_->CreateValue(ClientsV(values)));
+  TFF_ASSERT_OK_AND_ASSIGN(auto subset_id,
+                           test_executor_->CreateClientsSubset(id, {1, 4, 5}));
+  ExpectMaterialize(subset_id, ClientsV(sampled_values));
+}
+
+TEST_F(ComposingExecutorTest, CreateClientsSubsetFailsOnIndexOutOfOrder) {
+  std::vector<v0::Value> values;
+  for (uint32_t i = 0; i < mock_children_.size(); i++) {
+    std::vector<v0::Value> child_values;
+    for (uint32_t j = 0; j < clients_per_child_[i]; j++) {
+      child_values.push_back(TensorV(static_cast<int32_t>(values.size())));
+      values.push_back(child_values.back());
+    }
+    mock_children_[i]->ExpectCreateValue(ClientsV(child_values));
+  }
+  TFF_ASSERT_OK_AND_ASSIGN(auto id,
+                           test_executor_->CreateValue(ClientsV(values)));
+  // Client 5 is held by a later child than client 1.
+  TFF_ASSERT_OK_AND_ASSIGN(auto subset_id,
+                           test_executor_->CreateClientsSubset(id, {5, 1}));
+  EXPECT_THAT(test_executor_->Materialize(subset_id),
+              StatusIs(StatusCode::kInvalidArgument));
+}
+
 TEST_F(ComposingExecutorTest, CreateValueFailsWrongNumberClients) {
   EXPECT_THAT(test_executor_->CreateValue(ClientsV({})),
               StatusIs(StatusCode::kInvalidArgument));
@@ -377,15 +490,20 @@ TEST_F(ComposingExecutorTest, CreateCallFederatedAggregate) {
   auto result_from_child_on_server = mock_server_->ExpectCreateValue(
       result_from_child.federated().value(0),
       ::testing::Exactly(mock_children_.size()));
-  size_t num_total_merges = mock_children_.size() - 1;
-  auto prev_merge_result = result_from_child_on_server;
-  for (uint32_t i = 0; i < num_total_merges; i++) {
-    auto merge_arg = mock_server_->ExpectCreateStruct(
-        {prev_merge_result, result_from_child_on_server});
-    prev_merge_result = mock_server_->ExpectCreateCall(server_merge, merge_arg);
-  }
+  // The results of the four children are merged in a tree of two levels:
+  // two merges of pairs of children, then a merge of those.
+  ASSERT_EQ(mock_children_.size(), 4);
+  auto pair_merge_arg = mock_server_->ExpectCreateStruct(
+      {result_from_child_on_server, result_from_child_on_server},
+      ::testing::Exactly(2));
+  auto pair_merge_result = mock_server_->ExpectCreateCall(
+      server_merge, pair_merge_arg, ::testing::Exactly(2));
+  auto root_merge_arg = mock_server_->ExpectCreateStruct(
+      {pair_merge_result, pair_merge_result});
+  auto root_merge_result =
+      mock_server_->ExpectCreateCall(server_merge, root_merge_arg);
   auto post_report =
-      mock_server_->ExpectCreateCall(server_report, prev_merge_result);
+      mock_server_->ExpectCreateCall(server_report, root_merge_result);
   mock_server_->ExpectMaterialize(post_report, final_result_unfed);
   TFF_ASSERT_OK_AND_ASSIGN(auto controller_value,
                            test_executor_->CreateValue(value));
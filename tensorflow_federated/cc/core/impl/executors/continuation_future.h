@@ -0,0 +1,546 @@
+/* Copyright 2026, The TensorFlow Federated Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+     http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License
+==============================================================================*/
+
+#ifndef THIRD_PARTY_TENSORFLOW_FEDERATED_CC_CORE_IMPL_EXECUTORS_CONTINUATION_FUTURE_H_
+#define THIRD_PARTY_TENSORFLOW_FEDERATED_CC_CORE_IMPL_EXECUTORS_CONTINUATION_FUTURE_H_
+
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <cstddef>
+#include <functional>
+#include <future>  // NOLINT
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/log/check.h"
+#include "absl/log/log.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+#include "tensorflow_federated/cc/core/impl/executors/threading.h"
+
+namespace tensorflow_federated {
+
+template <typename T>
+class ContinuationPromise;
+
+namespace internal {
+
+// The state shared between a `ContinuationPromise` and its futures.
+template <typename T>
+struct ContinuationState {
+  absl::Mutex mutex;
+  std::optional<T> value ABSL_GUARDED_BY(mutex);
+  std::vector<std::function<void()>> callbacks ABSL_GUARDED_BY(mutex);
+  // Set (with release semantics) after `value` is written. `value` is never
+  // modified once `ready` is true, so it may be read without the mutex.
+  std::atomic<bool> ready{false};
+
+  bool has_value() ABSL_SHARED_LOCKS_REQUIRED(mutex) {
+    return value.has_value();
+  }
+};
+
+}  // namespace internal
+
+// A shared future which supports registering continuations.
+//
+// Unlike `std::shared_future`, a `ContinuationFuture` can run a callback when
+// its value becomes available (`OnReady`, `Then`, `WhenAll`), so code that
+// depends on pending values does not need to park a thread in `wait()`.
+// Callbacks registered before the value is set run on the thread that sets
+// the value; callbacks registered afterwards run immediately on the
+// registering thread. Callbacks must therefore be cheap and non-blocking, or
+// hand their work to a `ThreadPool`.
+//
+// The `valid`, `wait`, `wait_for` and `get` methods mirror
+// `std::shared_future`, so the `Wait`, `WaitAll` and `AllReady` helpers in
+// `threading.h` accept `ContinuationFuture`s as well.
+template <typename T>
+class ContinuationFuture {
+ public:
+  using value_type = T;
+
+  ContinuationFuture() = default;
+
+  bool valid() const { return state_ != nullptr; }
+
+  // Returns true iff the value has been set. Never blocks.
+  bool is_ready() const {
+    return state_->ready.load(std::memory_order_acquire);
+  }
+
+  // Blocks until the value has been set.
+  void wait() const {
+    if (is_ready()) {
+      return;
+    }
+    ScopedBlockingRegion blocking;
+    state_->mutex.LockWhen(absl::Condition(
+        state_.get(), &internal::ContinuationState<T>::has_value));
+    state_->mutex.Unlock();
+  }
+
+  // Blocks until the value has been set or `timeout` has elapsed.
+  template <typename Rep, typename Period>
+  std::future_status wait_for(
+      const std::chrono::duration<Rep, Period>& timeout) const {
+    if (is_ready()) {
+      return std::future_status::ready;
+    }
+    ScopedBlockingRegion blocking;
+    bool ready = state_->mutex.LockWhenWithTimeout(
+        absl::Condition(state_.get(),
+                        &internal::ContinuationState<T>::has_value),
+        absl::FromChrono(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(timeout)));
+    state_->mutex.Unlock();
+    return ready ? std::future_status::ready : std::future_status::timeout;
+  }
+
+  // Blocks until the value has been set and returns it.
+  const T& get() const ABSL_NO_THREAD_SAFETY_ANALYSIS {
+    wait();
+    return *state_->value;
+  }
+
+  // Runs `callback` once the value has been set.
+  void OnReady(std::function<void()> callback) const {
+    {
+      absl::MutexLock lock(&state_->mutex);
+      if (!state_->value.has_value()) {
+        state_->callbacks.push_back(std::move(callback));
+        return;
+      }
+    }
+    callback();
+  }
+
+  // Like `OnReady`, but passes `callback` a copy of this future.
+  //
+  // The registered callback holds no reference to this future's state, so a
+  // future whose promise is dropped without being set does not keep
+  // `callback` alive. `callback` may therefore capture state which refers back
+  // to this future without forming a reference cycle.
+  void WhenReady(std::function<void(const ContinuationFuture<T>&)> callback)
+      const {
+    OnReady([state = std::weak_ptr<internal::ContinuationState<T>>(state_),
+             callback = std::move(callback)]() {
+      // The state is alive while its callbacks run: either the promise
+      // setting the value or the caller of `OnReady` holds it.
+      callback(ContinuationFuture<T>(state.lock()));
+    });
+  }
+
+  // Returns a future for the result of `func(value)`, run once this future's
+  // value has been set.
+  //
+  // If `thread_pool` is `nullptr`, `func` runs inline on whichever thread
+  // resolves this future (or on the calling thread if already resolved).
+  // Otherwise `func` is scheduled on `thread_pool`.
+  template <typename Func,
+            typename Result = std::invoke_result_t<Func, const T&>>
+  ContinuationFuture<Result> Then(Func func,
+                                  ThreadPool* thread_pool = nullptr) const;
+
+ private:
+  template <typename U>
+  friend class ContinuationPromise;
+
+  explicit ContinuationFuture(
+      std::shared_ptr<internal::ContinuationState<T>> state)
+      : state_(std::move(state)) {}
+
+  std::shared_ptr<internal::ContinuationState<T>> state_;
+};
+
+// The producing side of a `ContinuationFuture`.
+//
+// Copies of a promise share the same state. The value must be set exactly
+// once; futures of a promise that is never set will never become ready.
+template <typename T>
+class ContinuationPromise {
+ public:
+  ContinuationPromise()
+      : state_(std::make_shared<internal::ContinuationState<T>>()) {}
+
+  ContinuationFuture<T> GetFuture() const {
+    return ContinuationFuture<T>(state_);
+  }
+
+  // Sets the value and runs any registered callbacks on this thread.
+  void SetValue(T value) {
+    std::vector<std::function<void()>> callbacks;
+    {
+      absl::MutexLock lock(&state_->mutex);
+      CHECK(!state_->value.has_value()) << "ContinuationPromise set twice";
+      state_->value.emplace(std::move(value));
+      state_->ready.store(true, std::memory_order_release);
+      callbacks.swap(state_->callbacks);
+    }
+    for (std::function<void()>& callback : callbacks) {
+      callback();
+    }
+  }
+
+ private:
+  std::shared_ptr<internal::ContinuationState<T>> state_;
+};
+
+// A `ContinuationFuture` which cancels the work producing its value once every
+// copy of it has been destroyed. See `CancellableFuture` and `MapCancellable`.
+template <typename T>
+using CancellableContinuationFuture =
+    CancellableFuture<T, ContinuationFuture<T>>;
+
+namespace internal {
+
+// Sets `value` on `promise`, then drops the task's references to the promise
+// and to `func`, in that order.
+//
+// A thread pool destroys a task only some time after it returns, so a task
+// which merely returned would keep its captures (and the shared state holding
+// `value`) alive after waiters have observed the result. Releasing them here
+// instead, and releasing `func` last, ensures that anything `func` keeps alive
+// (typically the executor which owns the values in `value`) outlives the
+// task's last reference to `value`.
+template <typename T, typename Func>
+void SetValueThenRelease(ContinuationPromise<T>& promise, T value,
+                         std::shared_ptr<Func>& func) {
+  {
+    ContinuationPromise<T> resolving = std::move(promise);
+    resolving.SetValue(std::move(value));
+  }
+  func.reset();
+}
+
+// Schedules `task` on `thread_pool`. If the pool rejects it, `promise` (which
+// `task` would otherwise have set) is resolved with the scheduling error
+// instead, so that waiters on its futures are not left hanging.
+//
+// The error path keeps its own reference to the promise only until `task`
+// starts, so `SetValueThenRelease` in `task` still drops the last reference.
+template <typename T, typename Task>
+void ScheduleOrFail(ThreadPool* thread_pool, Task task,
+                    ContinuationPromise<T> promise) {
+  auto on_error =
+      std::make_shared<std::optional<ContinuationPromise<T>>>(
+          std::move(promise));
+  absl::Status status = thread_pool->Schedule(
+      [task = std::move(task), on_error]() mutable {
+        on_error->reset();
+        task();
+      });
+  if (status.ok()) {
+    return;
+  }
+  if constexpr (std::is_constructible_v<T, absl::Status>) {
+    (*on_error)->SetValue(T(std::move(status)));
+  } else {
+    LOG(FATAL) << "Failed to schedule continuation: " << status;
+  }
+}
+
+// Like `ScheduleOrFail`, but schedules `task` on the process-wide default pool
+// (which never rejects tasks) if `thread_pool` is `nullptr`.
+template <typename T, typename Task>
+void ScheduleOnPool(ThreadPool* thread_pool, Task task,
+                    ContinuationPromise<T> promise) {
+  if (thread_pool != nullptr) {
+    ScheduleOrFail(thread_pool, std::move(task), std::move(promise));
+  } else {
+    ScheduleOnDefaultThreadPool(std::move(task));
+  }
+}
+
+}  // namespace internal
+
+template <typename T>
+template <typename Func, typename Result>
+ContinuationFuture<Result> ContinuationFuture<T>::Then(
+    Func func, ThreadPool* thread_pool) const {
+  ContinuationPromise<Result> promise;
+  ContinuationFuture<Result> result = promise.GetFuture();
+  // Wrapped in a `shared_ptr` so that the callback is copy-constructible even
+  // when `func` captures move-only values.
+  auto run = [promise, func = std::make_shared<Func>(std::move(func))](
+                 ContinuationFuture<T> source) mutable {
+    Result value = (*func)(source.get());
+    source = ContinuationFuture<T>();
+    internal::SetValueThenRelease(promise, std::move(value), func);
+  };
+  if (thread_pool == nullptr) {
+    WhenReady(std::move(run));
+  } else {
+    WhenReady([run = std::move(run), promise, thread_pool](
+                  const ContinuationFuture<T>& source) mutable {
+      internal::ScheduleOrFail(
+          thread_pool,
+          [run = std::move(run), source]() mutable { run(std::move(source)); },
+          std::move(promise));
+    });
+  }
+  return result;
+}
+
+// Converts an already-available value into a ready future.
+template <typename T>
+ContinuationFuture<T> ReadyContinuationFuture(T value) {
+  ContinuationPromise<T> promise;
+  promise.SetValue(std::move(value));
+  return promise.GetFuture();
+}
+
+// Runs `func` on another thread, returning a future to the result.
+//
+// If `thread_pool` is `nullptr`, `func` runs on the process-wide default pool.
+// Otherwise it is scheduled on `thread_pool`, with the same restrictions as
+// `ThreadRun`.
+template <typename Func, typename Result = std::invoke_result_t<Func>>
+ContinuationFuture<Result> Async(Func func, ThreadPool* thread_pool = nullptr) {
+  ContinuationPromise<Result> promise;
+  ContinuationFuture<Result> result = promise.GetFuture();
+  auto task = [promise, func = std::make_shared<Func>(std::move(func))]()
+                  mutable {
+    internal::SetValueThenRelease(promise, (*func)(), func);
+  };
+  internal::ScheduleOnPool(thread_pool, std::move(task), std::move(promise));
+  return result;
+}
+
+namespace internal {
+
+// Calls `done` with the values of all of `futures` once they have all
+// succeeded, or with the first error as soon as any of them fails. `done` is
+// called exactly once, on the thread resolving the last input (or the first
+// failing one), or on the calling thread if that has already happened.
+//
+// Each input's callback holds the join state, but the join state holds no
+// reference to the inputs, so inputs which are abandoned without being set
+// release it along with their own state.
+template <typename ExecutorValue, typename Done>
+void JoinAll(
+    std::vector<ContinuationFuture<absl::StatusOr<ExecutorValue>>> futures,
+    Done done) {
+  using InputFuture = ContinuationFuture<absl::StatusOr<ExecutorValue>>;
+  if (futures.empty()) {
+    done(absl::StatusOr<std::vector<ExecutorValue>>(
+        std::vector<ExecutorValue>()));
+    return;
+  }
+  struct Join {
+    Join(size_t size, Done done)
+        : values(size), remaining(size), done(std::move(done)) {}
+    // Each element is written only by the callback of the input at the same
+    // index, before it decrements `remaining`.
+    std::vector<std::optional<ExecutorValue>> values;
+    std::atomic<size_t> remaining;
+    std::atomic<bool> resolved{false};
+    Done done;
+  };
+  auto join = std::make_shared<Join>(futures.size(), std::move(done));
+  for (size_t i = 0; i < futures.size(); ++i) {
+    futures[i].WhenReady([join, i](const InputFuture& future) {
+      const absl::StatusOr<ExecutorValue>& result = future.get();
+      if (!result.ok()) {
+        if (!join->resolved.exchange(true)) {
+          join->done(result.status());
+        }
+        return;
+      }
+      join->values[i].emplace(result.value());
+      if (join->remaining.fetch_sub(1) != 1) {
+        return;
+      }
+      if (join->resolved.exchange(true)) {
+        return;
+      }
+      std::vector<ExecutorValue> values;
+      values.reserve(join->values.size());
+      for (std::optional<ExecutorValue>& value : join->values) {
+        values.emplace_back(std::move(*value));
+      }
+      join->done(std::move(values));
+    });
+  }
+}
+
+// Like `JoinAll`, but also holds the `keep_alive()` handles of `futures` until
+// `done` is called, so that no input is cancelled while it is still needed.
+template <typename ExecutorValue, typename Done>
+void JoinAllKeepingAlive(
+    std::vector<CancellableContinuationFuture<absl::StatusOr<ExecutorValue>>>
+        futures,
+    Done done) {
+  std::vector<ContinuationFuture<absl::StatusOr<ExecutorValue>>> inputs;
+  std::vector<std::shared_ptr<const void>> keep_alive;
+  inputs.reserve(futures.size());
+  keep_alive.reserve(futures.size());
+  for (const auto& future : futures) {
+    inputs.push_back(future.future());
+    keep_alive.push_back(future.keep_alive());
+  }
+  futures.clear();
+  JoinAll(std::move(inputs),
+          [keep_alive = std::move(keep_alive), done = std::move(done)](
+              absl::StatusOr<std::vector<ExecutorValue>> values) mutable {
+            keep_alive.clear();
+            done(std::move(values));
+          });
+}
+
+// Runs `lambda` on the joined values of `futures` and sets its result on the
+// returned future. `lambda` runs on `thread_pool` if it is not `nullptr`.
+// Otherwise it runs inline if `run_inline`, and on the process-wide default
+// pool if not.
+template <typename Func, typename ExecutorValue>
+ContinuationFuture<absl::StatusOr<ExecutorValue>> MapOn(
+    std::vector<ContinuationFuture<absl::StatusOr<ExecutorValue>>>&& futures,
+    Func lambda, ThreadPool* thread_pool, bool run_inline) {
+  using Result = absl::StatusOr<ExecutorValue>;
+  ContinuationPromise<Result> promise;
+  ContinuationFuture<Result> result = promise.GetFuture();
+  // The joined values are moved into `lambda` rather than read back from a
+  // shared future, so they are never copied.
+  JoinAll(std::move(futures),
+          [promise, thread_pool, run_inline,
+           lambda = std::make_shared<Func>(std::move(lambda))](
+              absl::StatusOr<std::vector<ExecutorValue>> values) mutable {
+            auto run = [promise, lambda, values = std::move(values)]() mutable {
+              Result value = values.ok()
+                                 ? (*lambda)(std::move(values).value())
+                                 : Result(values.status());
+              SetValueThenRelease(promise, std::move(value), lambda);
+            };
+            lambda.reset();
+            if (thread_pool == nullptr && run_inline) {
+              run();
+            } else {
+              ScheduleOnPool(thread_pool, std::move(run), std::move(promise));
+            }
+          });
+  return result;
+}
+
+}  // namespace internal
+
+// Returns a future which resolves to the values of all of `futures` once they
+// have all succeeded, or to the first error as soon as any of them fails.
+//
+// No thread is blocked while waiting: the result is set by the callback of
+// whichever input resolves last (or fails first).
+template <typename ExecutorValue>
+ContinuationFuture<absl::StatusOr<std::vector<ExecutorValue>>> WhenAll(
+    std::vector<ContinuationFuture<absl::StatusOr<ExecutorValue>>> futures) {
+  using Result = absl::StatusOr<std::vector<ExecutorValue>>;
+  ContinuationPromise<Result> promise;
+  ContinuationFuture<Result> result = promise.GetFuture();
+  internal::JoinAll(std::move(futures), [promise](Result values) mutable {
+    promise.SetValue(std::move(values));
+  });
+  return result;
+}
+
+// Like `WhenAll`, but for `CancellableContinuationFuture`s. The work producing
+// each of `futures` is not cancelled before the result is set, even if every
+// other copy of its future is dropped.
+template <typename ExecutorValue>
+ContinuationFuture<absl::StatusOr<std::vector<ExecutorValue>>> WhenAll(
+    std::vector<CancellableContinuationFuture<absl::StatusOr<ExecutorValue>>>
+        futures) {
+  using Result = absl::StatusOr<std::vector<ExecutorValue>>;
+  ContinuationPromise<Result> promise;
+  ContinuationFuture<Result> result = promise.GetFuture();
+  internal::JoinAllKeepingAlive(
+      std::move(futures),
+      [promise](Result values) mutable { promise.SetValue(std::move(values)); });
+  return result;
+}
+
+// Non-blocking counterpart of `Map` for `ContinuationFuture`s.
+//
+// Runs `lambda` on the successful results of `futures` once they have all
+// completed, without parking a thread while they are pending. If all of
+// `futures` are already complete, `lambda` runs on the current thread;
+// otherwise it runs on the thread that completes the last of them, or on
+// `thread_pool` if it is not `nullptr`. `lambda` must not block.
+template <typename Func, typename ExecutorValue>
+absl::StatusOr<ContinuationFuture<absl::StatusOr<ExecutorValue>>> Map(
+    std::vector<ContinuationFuture<absl::StatusOr<ExecutorValue>>>&& futures,
+    Func lambda, ThreadPool* thread_pool = nullptr) {
+  return internal::MapOn(std::move(futures), std::move(lambda), thread_pool,
+                         /*run_inline=*/true);
+}
+
+// Like `Map`, but for a `lambda` which may block (e.g. on an RPC or on another
+// executor). No thread is parked while `futures` are pending; once they have
+// all completed, `lambda` is scheduled on `thread_pool`, or on the
+// process-wide default pool if `thread_pool` is `nullptr`, as with `Async`.
+template <typename Func, typename ExecutorValue>
+ContinuationFuture<absl::StatusOr<ExecutorValue>> MapAsync(
+    std::vector<ContinuationFuture<absl::StatusOr<ExecutorValue>>>&& futures,
+    Func lambda, ThreadPool* thread_pool = nullptr) {
+  return internal::MapOn(std::move(futures), std::move(lambda), thread_pool,
+                         /*run_inline=*/false);
+}
+
+// Like `MapAsync`, but the returned future cancels `lambda`'s work once every
+// copy of it has been destroyed, as with `ThreadRunCancellable`.
+//
+// `lambda` is called as `lambda(token, values)`, where `token` is the
+// `CancellationToken` cancelled by the returned future. If the token is
+// cancelled before `lambda` starts, `lambda` is not run at all and the future
+// holds a `Cancelled` error. The work producing each of `futures` is not
+// cancelled until they have all completed.
+template <typename Func, typename ExecutorValue>
+CancellableContinuationFuture<absl::StatusOr<ExecutorValue>> MapCancellable(
+    std::vector<CancellableContinuationFuture<absl::StatusOr<ExecutorValue>>>
+        futures,
+    Func lambda, ThreadPool* thread_pool = nullptr) {
+  using Result = absl::StatusOr<ExecutorValue>;
+  CancellationToken token;
+  ContinuationPromise<Result> promise;
+  ContinuationFuture<Result> result = promise.GetFuture();
+  internal::JoinAllKeepingAlive(
+      std::move(futures),
+      [promise, token, thread_pool,
+       lambda = std::make_shared<Func>(std::move(lambda))](
+          absl::StatusOr<std::vector<ExecutorValue>> values) mutable {
+        auto run = [promise, token, lambda,
+                    values = std::move(values)]() mutable {
+          Result value =
+              !values.ok()         ? Result(values.status())
+              : token.IsCancelled() ? Result(absl::CancelledError(
+                                          "Value was disposed of before its "
+                                          "computation started."))
+                                    : (*lambda)(token, std::move(values).value());
+          internal::SetValueThenRelease(promise, std::move(value), lambda);
+        };
+        lambda.reset();
+        internal::ScheduleOnPool(thread_pool, std::move(run),
+                                 std::move(promise));
+      });
+  return CancellableContinuationFuture<Result>(std::move(result),
+                                               std::move(token));
+}
+
+}  // namespace tensorflow_federated
+
+#endif  // THIRD_PARTY_TENSORFLOW_FEDERATED_CC_CORE_IMPL_EXECUTORS_CONTINUATION_FUTURE_H_
@@ -0,0 +1,281 @@
+/* Copyright 2026, The TensorFlow Federated Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+     http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License
+==============================================================================*/
+
+#include "tensorflow_federated/cc/core/impl/executors/continuation_future.h"
+
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <cstdint>
+#include <future>  // NOLINT
+#include <memory>
+#include <thread>  // NOLINT
+#include <utility>
+#include <vector>
+
+#include "googlemock/include/gmock/gmock.h"
+#include "googletest/include/gtest/gtest.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/synchronization/notification.h"
+#include "tensorflow_federated/cc/core/impl/executors/threading.h"
+#include "tensorflow_federated/cc/testing/status_matchers.h"
+
+namespace tensorflow_federated {
+
+namespace {
+
+using ::absl::StatusCode;
+using IntFuture = ContinuationFuture<absl::StatusOr<int32_t>>;
+
+class ContinuationFutureTest : public ::testing::Test {};
+
+TEST_F(ContinuationFutureTest, ReadyFutureIsReady) {
+  IntFuture future = ReadyContinuationFuture(absl::StatusOr<int32_t>(1));
+  EXPECT_TRUE(future.is_ready());
+  EXPECT_EQ(future.wait_for(std::chrono::seconds(0)),
+            std::future_status::ready);
+  EXPECT_THAT(Wait(future), IsOkAndHolds(1));
+}
+
+TEST_F(ContinuationFutureTest, PendingFutureTimesOut) {
+  ContinuationPromise<absl::StatusOr<int32_t>> promise;
+  IntFuture future = promise.GetFuture();
+  EXPECT_FALSE(future.is_ready());
+  EXPECT_EQ(future.wait_for(std::chrono::milliseconds(1)),
+            std::future_status::timeout);
+  promise.SetValue(2);
+  EXPECT_THAT(Wait(future), IsOkAndHolds(2));
+}
+
+TEST_F(ContinuationFutureTest, ThenRunsOnResolvingThread) {
+  ContinuationPromise<absl::StatusOr<int32_t>> promise;
+  std::thread::id continuation_thread;
+  IntFuture doubled = promise.GetFuture().Then(
+      [&continuation_thread](
+          const absl::StatusOr<int32_t>& value) -> absl::StatusOr<int32_t> {
+        continuation_thread = std::this_thread::get_id();
+        return TFF_TRY(value) * 2;
+      });
+  EXPECT_FALSE(doubled.is_ready());
+  std::thread resolver([&promise]() { promise.SetValue(21); });
+  const std::thread::id resolver_id = resolver.get_id();
+  resolver.join();
+  EXPECT_THAT(Wait(doubled), IsOkAndHolds(42));
+  EXPECT_EQ(continuation_thread, resolver_id);
+}
+
+TEST_F(ContinuationFutureTest, ThenOnThreadPool) {
+  ThreadPool pool(/*num_threads=*/1, /*name=*/"test");
+  IntFuture doubled =
+      ReadyContinuationFuture(absl::StatusOr<int32_t>(4))
+          .Then(
+              [](const absl::StatusOr<int32_t>& value)
+                  -> absl::StatusOr<int32_t> { return TFF_TRY(value) * 2; },
+              &pool);
+  EXPECT_THAT(Wait(doubled), IsOkAndHolds(8));
+}
+
+TEST_F(ContinuationFutureTest, AsyncRunsOnAnotherThread) {
+  IntFuture future = Async([]() -> absl::StatusOr<int32_t> { return 3; });
+  EXPECT_THAT(Wait(future), IsOkAndHolds(3));
+}
+
+TEST_F(ContinuationFutureTest, AsyncOnClosedPoolFails) {
+  ThreadPool pool(/*num_threads=*/1, /*name=*/"test");
+  pool.Close();
+  IntFuture future =
+      Async([]() -> absl::StatusOr<int32_t> { return 3; }, &pool);
+  ASSERT_TRUE(future.is_ready());
+  EXPECT_THAT(Wait(future), StatusIs(StatusCode::kFailedPrecondition));
+}
+
+TEST_F(ContinuationFutureTest, ThenOnClosedPoolFails) {
+  ThreadPool pool(/*num_threads=*/1, /*name=*/"test");
+  pool.Close();
+  IntFuture doubled =
+      ReadyContinuationFuture(absl::StatusOr<int32_t>(4))
+          .Then(
+              [](const absl::StatusOr<int32_t>& value)
+                  -> absl::StatusOr<int32_t> { return TFF_TRY(value) * 2; },
+              &pool);
+  ASSERT_TRUE(doubled.is_ready());
+  EXPECT_THAT(Wait(doubled), StatusIs(StatusCode::kFailedPrecondition));
+}
+
+TEST_F(ContinuationFutureTest, WhenAllEmptyIsReady) {
+  auto all = WhenAll(std::vector<IntFuture>());
+  ASSERT_TRUE(all.is_ready());
+  EXPECT_THAT(all.get(), IsOkAndHolds(testing::IsEmpty()));
+}
+
+TEST_F(ContinuationFutureTest, WhenAllWaitsForLastInput) {
+  ContinuationPromise<absl::StatusOr<int32_t>> first;
+  ContinuationPromise<absl::StatusOr<int32_t>> second;
+  auto all = WhenAll(std::vector<IntFuture>{first.GetFuture(),
+                                            second.GetFuture()});
+  second.SetValue(2);
+  EXPECT_FALSE(all.is_ready());
+  first.SetValue(1);
+  ASSERT_TRUE(all.is_ready());
+  EXPECT_THAT(all.get(), IsOkAndHolds(testing::ElementsAre(1, 2)));
+}
+
+TEST_F(ContinuationFutureTest, WhenAllFailsOnFirstError) {
+  ContinuationPromise<absl::StatusOr<int32_t>> pending;
+  auto all = WhenAll(std::vector<IntFuture>{
+      pending.GetFuture(),
+      ReadyContinuationFuture(
+          absl::StatusOr<int32_t>(absl::UnimplementedError("")))});
+  // Resolves without waiting for `pending`.
+  ASSERT_TRUE(all.is_ready());
+  EXPECT_THAT(all.get(), StatusIs(StatusCode::kUnimplemented));
+  pending.SetValue(1);
+}
+
+TEST_F(ContinuationFutureTest, MapDoesNotBlockOnPendingInputs) {
+  ContinuationPromise<absl::StatusOr<int32_t>> promise;
+  auto mapped = Map(std::vector<IntFuture>{promise.GetFuture()},
+                    [](std::vector<int32_t>&& values)
+                        -> absl::StatusOr<int32_t> { return values[0] + 1; });
+  TFF_ASSERT_OK(mapped);
+  EXPECT_FALSE(mapped->is_ready());
+  promise.SetValue(1);
+  ASSERT_TRUE(mapped->is_ready());
+  EXPECT_THAT(Wait(*mapped), IsOkAndHolds(2));
+}
+
+TEST_F(ContinuationFutureTest, MapPropagatesInputError) {
+  auto mapped = Map(std::vector<IntFuture>{ReadyContinuationFuture(
+                        absl::StatusOr<int32_t>(absl::NotFoundError("")))},
+                    [](std::vector<int32_t>&& values)
+                        -> absl::StatusOr<int32_t> { return values[0]; });
+  TFF_ASSERT_OK(mapped);
+  EXPECT_THAT(Wait(*mapped), StatusIs(StatusCode::kNotFound));
+}
+
+TEST_F(ContinuationFutureTest, MapReleasesStateOfAbandonedInputs) {
+  auto captured = std::make_shared<int32_t>(0);
+  std::weak_ptr<int32_t> weak_captured = captured;
+  {
+    ContinuationPromise<absl::StatusOr<int32_t>> never_set;
+    auto mapped = Map(std::vector<IntFuture>{never_set.GetFuture()},
+                      [captured = std::move(captured)](
+                          std::vector<int32_t>&& values)
+                          -> absl::StatusOr<int32_t> { return values[0]; });
+    TFF_ASSERT_OK(mapped);
+  }
+  EXPECT_TRUE(weak_captured.expired());
+}
+
+// Counts the copies made of it, so tests can check that values are moved.
+struct CopyCounter {
+  explicit CopyCounter(std::shared_ptr<int32_t> copies)
+      : copies(std::move(copies)) {}
+  CopyCounter(const CopyCounter& other) : copies(other.copies) { ++*copies; }
+  CopyCounter(CopyCounter&&) = default;
+  CopyCounter& operator=(const CopyCounter& other) {
+    copies = other.copies;
+    ++*copies;
+    return *this;
+  }
+  CopyCounter& operator=(CopyCounter&&) = default;
+  std::shared_ptr<int32_t> copies;
+};
+
+TEST_F(ContinuationFutureTest, MapCopiesEachInputValueOnce) {
+  auto copies = std::make_shared<int32_t>(0);
+  ContinuationPromise<absl::StatusOr<CopyCounter>> first;
+  ContinuationPromise<absl::StatusOr<CopyCounter>> second;
+  auto mapped = Map(
+      std::vector<ContinuationFuture<absl::StatusOr<CopyCounter>>>{
+          first.GetFuture(), second.GetFuture()},
+      [](std::vector<CopyCounter>&& values) -> absl::StatusOr<CopyCounter> {
+        return std::move(values[0]);
+      });
+  TFF_ASSERT_OK(mapped);
+  first.SetValue(CopyCounter(copies));
+  second.SetValue(CopyCounter(copies));
+  ASSERT_TRUE(mapped->is_ready());
+  EXPECT_TRUE(mapped->get().ok());
+  // Each input is copied out of its shared future once; the joined values are
+  // then moved into the lambda.
+  EXPECT_EQ(*copies, 2);
+}
+
+TEST_F(ContinuationFutureTest, MapAsyncRunsOnThreadPool) {
+  ThreadPool pool(/*num_threads=*/1, /*name=*/"test");
+  ContinuationPromise<absl::StatusOr<int32_t>> promise;
+  std::thread::id lambda_thread;
+  IntFuture mapped = MapAsync(
+      std::vector<IntFuture>{promise.GetFuture()},
+      [&lambda_thread](std::vector<int32_t>&& values)
+          -> absl::StatusOr<int32_t> {
+        lambda_thread = std::this_thread::get_id();
+        return values[0] + 1;
+      },
+      &pool);
+  EXPECT_FALSE(mapped.is_ready());
+  promise.SetValue(1);
+  EXPECT_THAT(Wait(mapped), IsOkAndHolds(2));
+  EXPECT_NE(lambda_thread, std::this_thread::get_id());
+}
+
+TEST_F(ContinuationFutureTest, MapCancellableSkipsLambdaOnceDropped) {
+  using CancellableIntFuture =
+      CancellableContinuationFuture<absl::StatusOr<int32_t>>;
+  ContinuationPromise<absl::StatusOr<int32_t>> promise;
+  auto ran = std::make_shared<std::atomic<bool>>(false);
+  CancellableIntFuture input = promise.GetFuture();
+  IntFuture result;
+  {
+    CancellableIntFuture mapped = MapCancellable(
+        std::vector<CancellableIntFuture>{input},
+        [ran](const CancellationToken&,
+              std::vector<int32_t>&& values) -> absl::StatusOr<int32_t> {
+          ran->store(true);
+          return values[0];
+        });
+    result = mapped.future();
+  }
+  promise.SetValue(1);
+  EXPECT_THAT(Wait(result), StatusIs(StatusCode::kCancelled));
+  EXPECT_FALSE(ran->load());
+}
+
+TEST_F(ContinuationFutureTest, MapCancellableKeepsInputsUntilTheyResolve) {
+  using CancellableIntFuture =
+      CancellableContinuationFuture<absl::StatusOr<int32_t>>;
+  CancellationToken input_token;
+  ContinuationPromise<absl::StatusOr<int32_t>> promise;
+  CancellableIntFuture mapped;
+  {
+    CancellableIntFuture input(promise.GetFuture(), input_token);
+    mapped = MapCancellable(
+        std::vector<CancellableIntFuture>{input},
+        [](const CancellationToken&,
+           std::vector<int32_t>&& values) -> absl::StatusOr<int32_t> {
+          return values[0] + 1;
+        });
+  }
+  // Only the pending `MapCancellable` refers to the input now.
+  EXPECT_FALSE(input_token.IsCancelled());
+  promise.SetValue(1);
+  EXPECT_THAT(Wait(mapped), IsOkAndHolds(2));
+  EXPECT_TRUE(input_token.IsCancelled());
+}
+
+}  // namespace
+
+}  // namespace tensorflow_federated
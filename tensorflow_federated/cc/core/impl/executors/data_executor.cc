@@ -16,7 +16,6 @@ limitations under the License
 #include "tensorflow_federated/cc/core/impl/executors/data_executor.h"
 
 #include <cstdint>
-#include <future>  // NOLINT
 #include <memory>
 #include <optional>
 #include <utility>
@@ -25,6 +24,7 @@ limitations under the License
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/string_view.h"
+#include "tensorflow_federated/cc/core/impl/executors/continuation_future.h"
 #include "tensorflow_federated/cc/core/impl/executors/data_backend.h"
 #include "tensorflow_federated/cc/core/impl/executors/executor.h"
 #include "tensorflow_federated/cc/core/impl/executors/status_macros.h"
@@ -35,7 +35,9 @@ namespace tensorflow_federated {
 namespace {
 
 using SharedId = std::shared_ptr<const OwnedValueId>;
-using ValueFuture = std::shared_future<absl::StatusOr<SharedId>>;
+// Continuation futures let `CreateCall`, `CreateStruct` and `CreateSelection`
+// chain on pending values without blocking a thread per pending value.
+using ValueFuture = ContinuationFuture<absl::StatusOr<SharedId>>;
 
 class DataExecutor : public ExecutorBase<ValueFuture> {
  public:
@@ -57,11 +59,11 @@ class DataExecutor : public ExecutorBase<ValueFuture> {
       // be relatively small and inexpensive (currently just a URI).
       federated_language::Data data = value_pb.computation().data();
       federated_language::Type data_type = value_pb.computation().type();
-      return ThreadRun([this, data = std::move(data),
-                        data_type = std::move(data_type),
-                        this_keepalive =
-                            shared_from_this()]() -> absl::StatusOr<SharedId> {
-        Trace("DataExecutor::DataBackend::ResolveToValue");
+      return Async([this, data = std::move(data),
+                    data_type = std::move(data_type),
+                    this_keepalive =
+                        shared_from_this()]() -> absl::StatusOr<SharedId> {
+        auto trace = Trace("DataBackend::ResolveToValue");
         v0::Value resolved_value;
         TFF_TRY(data_backend_->ResolveToValue(data, data_type, resolved_value));
         OwnedValueId child_value = TFF_TRY(child_->CreateValue(resolved_value));
@@ -69,8 +71,8 @@ class DataExecutor : public ExecutorBase<ValueFuture> {
       });
     } else {
       OwnedValueId child_value = TFF_TRY(child_->CreateValue(value_pb));
-      return ReadyFuture(
-          std::make_shared<const OwnedValueId>(std::move(child_value)));
+      return ReadyContinuationFuture(absl::StatusOr<SharedId>(
+          std::make_shared<const OwnedValueId>(std::move(child_value))));
     }
   }
 
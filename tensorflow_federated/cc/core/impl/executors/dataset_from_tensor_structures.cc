@@ -126,14 +126,8 @@ absl::StatusOr<GraphWithOutput> DatasetFromTensorStructuresGraph(
     return absl::InvalidArgumentError(
         "Cannot create dataset from structure list of length zero.");
   }
+  TFF_TRY(CheckTensorStructures(tensor_structures));
   size_t elements_per_structure = tensor_structures[0].size();
-  for (const auto& structure : tensor_structures) {
-    if (structure.size() != elements_per_structure) {
-      return absl::InvalidArgumentError(absl::StrCat(
-          "Cannot create a dataset from tensor structures of different sizes ",
-          elements_per_structure, " and ", structure.size(), "."));
-    }
-  }
 
   // The following code generates a graph as follows:
   //
@@ -206,6 +200,26 @@ absl::StatusOr<GraphWithOutput> DatasetFromTensorStructuresGraph(
 
 }  // namespace
 
+absl::Status CheckTensorStructures(TensorStructuresSpan tensor_structures) {
+  if (tensor_structures.empty()) {
+    return absl::OkStatus();
+  }
+  size_t elements_per_structure = tensor_structures[0].size();
+  for (const auto& structure : tensor_structures) {
+    if (structure.size() != elements_per_structure) {
+      return absl::InvalidArgumentError(absl::StrCat(
+          "Cannot create a dataset from tensor structures of different sizes ",
+          elements_per_structure, " and ", structure.size(), "."));
+    }
+  }
+  for (size_t element_index = 0; element_index < elements_per_structure;
+       element_index++) {
+    TFF_TRY(
+        GetDtypeAndShapeForStructureElement(tensor_structures, element_index));
+  }
+  return absl::OkStatus();
+}
+
 absl::StatusOr<tf::Tensor> DatasetFromTensorStructures(
     TensorStructuresSpan tensor_structures) {
   GraphWithOutput graph_and_output_tensor_name =
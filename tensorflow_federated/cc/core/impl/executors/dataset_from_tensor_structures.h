@@ -18,6 +18,7 @@ limitations under the License
 
 #include <vector>
 
+#include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/types/span.h"
 #include "tensorflow/core/framework/graph.pb.h"
@@ -36,6 +37,13 @@ namespace tensorflow_federated {
 absl::StatusOr<tensorflow::Tensor> DatasetFromTensorStructures(
     absl::Span<const std::vector<tensorflow::Tensor>> tensor_structures);
 
+// Returns an error if the structures in `tensor_structures` do not all have the
+// same number of elements with matching dtypes and shapes, as required by
+// `DatasetFromTensorStructures`. Unlike `DatasetFromTensorStructures`, this
+// does not build a dataset, and accepts an empty list.
+absl::Status CheckTensorStructures(
+    absl::Span<const std::vector<tensorflow::Tensor>> tensor_structures);
+
 }  // namespace tensorflow_federated
 
 #endif  // THIRD_PARTY_TENSORFLOW_FEDERATED_CC_CORE_IMPL_EXECUTORS_DATASET_FROM_TENSOR_STRUCTURES_H_
@@ -208,6 +208,30 @@ TEST(DatasetFromTensorStructuresTest, FailsOnMismatchedRanks) {
               StatusIs(StatusCode::kInvalidArgument, HasSubstr("rank")));
 }
 
+TEST(CheckTensorStructuresTest, AcceptsMatchingStructures) {
+  EXPECT_THAT(CheckTensorStructures({
+                  {tf::Tensor(5), tf::Tensor("foo")},
+                  {tf::Tensor(6), tf::Tensor("bar")},
+              }),
+              IsOk());
+}
+
+TEST(CheckTensorStructuresTest, AcceptsNoStructures) {
+  EXPECT_THAT(CheckTensorStructures({}), IsOk());
+}
+
+TEST(CheckTensorStructuresTest, FailsOnMismatchedDataTypes) {
+  EXPECT_THAT(CheckTensorStructures({
+                  {
+                      tf::Tensor(5),
+                  },
+                  {
+                      tf::Tensor("foo"),
+                  },
+              }),
+              StatusIs(StatusCode::kInvalidArgument, HasSubstr("dtype")));
+}
+
 }  // namespace
 
 }  // namespace tensorflow_federated
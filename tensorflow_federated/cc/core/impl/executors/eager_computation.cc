@@ -88,7 +88,7 @@ absl::Status RemoveFunctionDef(const tensorflow::FunctionDef& function,
                               status);
     if (TF_GetCode(status) != TF_OK) {
       return absl::InternalError(absl::StrCat(
-          "FunctionDef could not be registered: ", TF_Message(status)));
+          "FunctionDef could not be removed: ", TF_Message(status)));
     }
   }
   return absl::OkStatus();
@@ -367,7 +367,8 @@ EagerComputation::EagerComputation(
 
 absl::Status EagerComputation::ExecuteFunction(
     TFE_Context* context, std::string func_name,
-    std::optional<std::string> device_name, absl::Span<TFE_TensorHandle*> args,
+    std::optional<std::string> device_name,
+    absl::Span<TFE_TensorHandle* const> args,
     std::vector<TFE_TensorHandle*>* outputs) {
   std::unique_ptr<TF_Status, decltype(&TF_DeleteStatus)> status(
       TF_NewStatus(), TF_DeleteStatus);
@@ -423,14 +424,7 @@ absl::Status EagerComputation::RemoveFunctions(TFE_Context* context) {
   std::unique_ptr<TF_Status, decltype(&TF_DeleteStatus)> status_ptr(
       TF_NewStatus(), TF_DeleteStatus);
 
-  TFE_ContextRemoveFunction(
-      context, main_function_def_.signature().name().c_str(), status_ptr.get());
-
-  TFF_TRY(RemoveFunctionDef(main_function_def_, context, status_ptr.get()));
-  for (const auto& func_def : function_defs_to_register_) {
-    TFF_TRY(RemoveFunctionDef(func_def, context, status_ptr.get()));
-  }
-  return absl::OkStatus();
+  return RemoveFunctionDef(main_function_def_, context, status_ptr.get());
 }
 
 absl::StatusOr<std::vector<TFE_TensorHandle*>> EagerComputation::Call(
@@ -441,17 +435,19 @@ absl::StatusOr<std::vector<TFE_TensorHandle*>> EagerComputation::Call(
 
   TFF_TRY(RegisterFunctions(context));
 
-  std::vector<TFE_TensorHandle*> outputs;
   std::vector<TFE_TensorHandle*> inputs;
   if (args.has_value()) {
     inputs = args.value();
   }
+  return CallRegistered(context, inputs, std::move(device_name));
+}
 
-  absl::Span<TFE_TensorHandle*> args_span(inputs);
-
+absl::StatusOr<std::vector<TFE_TensorHandle*>> EagerComputation::CallRegistered(
+    TFE_Context* context, absl::Span<TFE_TensorHandle* const> args,
+    std::optional<std::string> device_name) {
+  std::vector<TFE_TensorHandle*> outputs;
   TFF_TRY(ExecuteFunction(context, main_function_def_.signature().name(),
-                          device_name, args_span, &outputs));
-
+                          device_name, args, &outputs));
   return outputs;
 }
 
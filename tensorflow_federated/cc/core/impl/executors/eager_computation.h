@@ -73,17 +73,27 @@ class EagerComputation {
       TFE_Context* context, std::optional<std::vector<TFE_TensorHandle*>> args,
       std::optional<std::string> device_name = std::nullopt);
 
- private:
   // Registers the FunctionDefs owned by the class object with TF eager context
-  // provided in the input.
+  // provided in the input. Functions already registered are skipped.
   absl::Status RegisterFunctions(TFE_Context* context);
 
-  // Removes FunctionDef from context.
+  // As `Call`, but without registering the functions first. Requires that
+  // `RegisterFunctions` has been called with `context`, so that callers
+  // invoking the same computation many times register it only once.
+  absl::StatusOr<std::vector<TFE_TensorHandle*>> CallRegistered(
+      TFE_Context* context, absl::Span<TFE_TensorHandle* const> args,
+      std::optional<std::string> device_name = std::nullopt);
+
+  // Removes the main FunctionDef registered by `RegisterFunctions` from
+  // `context`, which is named uniquely for this computation. The functions of
+  // the graph's library keep their names, and may also be used by other
+  // computations registered with `context`, so they stay registered.
   absl::Status RemoveFunctions(TFE_Context* context);
 
+ private:
   absl::Status ExecuteFunction(TFE_Context* context, std::string func_name,
                                std::optional<std::string> device_name,
-                               absl::Span<TFE_TensorHandle*> args,
+                               absl::Span<TFE_TensorHandle* const> args,
                                std::vector<TFE_TensorHandle*>* outputs);
 
   tensorflow::FunctionDef main_function_def_;
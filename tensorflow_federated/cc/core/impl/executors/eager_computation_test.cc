@@ -253,6 +253,49 @@ TEST_F(EagerComputationTest, CallAdd) {
   TF_DeleteStatus(status);
 }
 
+TEST_F(EagerComputationTest, CallRegisteredRepeatedly) {
+  TF_Status* status = TF_NewStatus();
+  std::unique_ptr<TFE_ContextOptions, decltype(&TFE_DeleteContextOptions)> opts(
+      TFE_NewContextOptions(), TFE_DeleteContextOptions);
+  std::unique_ptr<TFE_Context, decltype(&TFE_DeleteContext)> context(
+      TFE_NewContext(opts.get(), status), TFE_DeleteContext);
+  EXPECT_EQ(TF_GetCode(status), TF_OK) << TF_Message(status);
+
+  tensorflow::Scope root = tensorflow::Scope::NewRootScope();
+  tensorflow::ops::Placeholder x(root, tensorflow::DT_FLOAT);
+  tensorflow::ops::Placeholder y(root, tensorflow::DT_FLOAT);
+  tensorflow::ops::AddV2 out(root, x, y);
+  auto fn = ComputationV(root, StructB({TensorB(x), TensorB(y)}), TensorB(out));
+  TFF_ASSERT_OK_AND_ASSIGN(auto comp,
+                           EagerComputation::FromProto(fn.tensorflow()));
+  TFF_ASSERT_OK(comp.RegisterFunctions(context.get()));
+
+  auto* t_x = FloatTensor(5.);
+  auto* t_y = FloatTensor(2.);
+  TFE_TensorHandle* th_x = TFE_NewTensorHandle(t_x, status);
+  EXPECT_EQ(TF_GetCode(status), TF_OK) << TF_Message(status);
+  TFE_TensorHandle* th_y = TFE_NewTensorHandle(t_y, status);
+  EXPECT_EQ(TF_GetCode(status), TF_OK) << TF_Message(status);
+  std::vector<TFE_TensorHandle*> args = {th_x, th_y};
+
+  for (int i = 0; i < 3; ++i) {
+    TFF_ASSERT_OK_AND_ASSIGN(auto result,
+                             comp.CallRegistered(context.get(), args));
+    ASSERT_EQ(1, result.size());
+    TF_Tensor* result_tensor = TFE_TensorHandleResolve(result[0], status);
+    EXPECT_EQ(TF_GetCode(status), TF_OK) << TF_Message(status);
+    EXPECT_EQ(7.0, *reinterpret_cast<float*>(TF_TensorData(result_tensor)));
+    TF_DeleteTensor(result_tensor);
+    TFE_DeleteTensorHandle(result[0]);
+  }
+
+  TF_DeleteTensor(t_x);
+  TFE_DeleteTensorHandle(th_x);
+  TF_DeleteTensor(t_y);
+  TFE_DeleteTensorHandle(th_y);
+  TF_DeleteStatus(status);
+}
+
 TEST_F(EagerComputationTest, CallAddExtraPlaceholder) {
   TF_Status* status = TF_NewStatus();
   std::unique_ptr<TFE_ContextOptions, decltype(&TFE_DeleteContextOptions)> opts(
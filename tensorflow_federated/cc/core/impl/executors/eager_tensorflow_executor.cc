@@ -0,0 +1,560 @@
+/* Copyright 2026, The TensorFlow Federated Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+     http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License
+==============================================================================*/
+
+#include "tensorflow_federated/cc/core/impl/executors/eager_tensorflow_executor.h"
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>  // NOLINT
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/log/check.h"
+#include "absl/log/log.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/types/span.h"
+#include "federated_language/proto/array.pb.h"
+#include "federated_language/proto/computation.pb.h"
+#include "tensorflow/c/eager/c_api.h"
+#include "tensorflow/c/tf_status.h"
+#include "tensorflow/c/tf_tensor.h"
+#include "tensorflow/c/tf_tensor_internal.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow_federated/cc/core/impl/executors/eager_computation.h"
+#include "tensorflow_federated/cc/core/impl/executors/executor.h"
+#include "tensorflow_federated/cc/core/impl/executors/status_macros.h"
+#include "tensorflow_federated/cc/core/impl/executors/tensor_serialization.h"
+#include "tensorflow_federated/cc/core/impl/executors/tensorflow_utils.h"
+#include "tensorflow_federated/cc/core/impl/executors/threading.h"
+#include "tensorflow_federated/proto/v0/executor.pb.h"
+
+namespace tensorflow_federated {
+
+namespace {
+
+using TFStatusPtr = std::unique_ptr<TF_Status, decltype(&TF_DeleteStatus)>;
+using TFTensorPtr = std::unique_ptr<TF_Tensor, decltype(&TF_DeleteTensor)>;
+
+// The eager context is shared by the executor and by every tensor handle and
+// function created in it, so that values outliving the executor can still be
+// used and deleted.
+using EagerContext = std::shared_ptr<TFE_Context>;
+
+// Tensor handles are shared by all values holding them, and deleted with the
+// last one.
+using TensorHandle = std::shared_ptr<TFE_TensorHandle>;
+
+TensorHandle OwnHandle(TFE_TensorHandle* handle, EagerContext context) {
+  return TensorHandle(
+      handle, [context = std::move(context)](TFE_TensorHandle* owned_handle) {
+        TFE_DeleteTensorHandle(owned_handle);
+      });
+}
+
+// Wraps `tensor` in a handle sharing its buffer.
+absl::StatusOr<TensorHandle> HandleFromTensor(const tensorflow::Tensor& tensor,
+                                              EagerContext context) {
+  absl::Status status;
+  TFTensorPtr tf_tensor(tensorflow::TF_TensorFromTensor(tensor, &status),
+                        TF_DeleteTensor);
+  if (!status.ok()) {
+    return absl::InternalError(
+        absl::StrCat("Failed to convert tensor: ", status.message()));
+  }
+  TFStatusPtr tf_status(TF_NewStatus(), TF_DeleteStatus);
+  TFE_TensorHandle* handle =
+      TFE_NewTensorHandle(tf_tensor.get(), tf_status.get());
+  if (TF_GetCode(tf_status.get()) != TF_OK) {
+    return absl::InternalError(absl::StrCat("Failed to create tensor handle: ",
+                                            TF_Message(tf_status.get())));
+  }
+  return OwnHandle(handle, std::move(context));
+}
+
+// Returns the tensor of `handle`, waiting for it to be computed. Local tensors
+// share the handle's buffer.
+absl::StatusOr<tensorflow::Tensor> TensorFromHandle(TFE_TensorHandle* handle) {
+  TFStatusPtr tf_status(TF_NewStatus(), TF_DeleteStatus);
+  TFTensorPtr tf_tensor(TFE_TensorHandleResolve(handle, tf_status.get()),
+                        TF_DeleteTensor);
+  if (TF_GetCode(tf_status.get()) != TF_OK) {
+    return absl::InternalError(absl::StrCat("Failed to resolve tensor handle: ",
+                                            TF_Message(tf_status.get())));
+  }
+  tensorflow::Tensor tensor;
+  absl::Status status = tensorflow::TF_TensorToTensor(tf_tensor.get(), &tensor);
+  if (!status.ok()) {
+    return absl::InternalError(
+        absl::StrCat("Failed to convert tensor: ", status.message()));
+  }
+  return tensor;
+}
+
+int32_t NumTensorsInBinding(
+    const federated_language::TensorFlow::Binding& binding) {
+  switch (binding.binding_case()) {
+    case federated_language::TensorFlow::Binding::kTensor:
+      return 1;
+    case federated_language::TensorFlow::Binding::kStruct: {
+      int32_t num_tensors = 0;
+      for (const auto& element : binding.struct_().element()) {
+        num_tensors += NumTensorsInBinding(element);
+      }
+      return num_tensors;
+    }
+    default:
+      return 0;
+  }
+}
+
+class EagerFunction;
+
+// Representation for values inside the eager TensorFlow executor.
+class ExecutorValue {
+ public:
+  enum class ValueType { TENSOR, STRUCT, COMPUTATION };
+
+  explicit ExecutorValue(TensorHandle handle) : value_(std::move(handle)) {}
+  explicit ExecutorValue(std::shared_ptr<std::vector<ExecutorValue>> elements)
+      : value_(std::move(elements)) {}
+  explicit ExecutorValue(std::shared_ptr<EagerFunction> function)
+      : value_(std::move(function)) {}
+
+  ValueType type() const {
+    if (std::holds_alternative<TensorHandle>(value_)) {
+      return ValueType::TENSOR;
+    } else if (std::holds_alternative<std::shared_ptr<EagerFunction>>(
+                   value_)) {
+      return ValueType::COMPUTATION;
+    } else {
+      return ValueType::STRUCT;
+    }
+  }
+
+  // Requires that `type()` is `ValueType::TENSOR`.
+  TFE_TensorHandle* handle() const {
+    return std::get<TensorHandle>(value_).get();
+  }
+
+  // Requires that `type()` is `ValueType::STRUCT`.
+  absl::Span<const ExecutorValue> elements() const {
+    return *std::get<std::shared_ptr<std::vector<ExecutorValue>>>(value_);
+  }
+
+  // Requires that `type()` is `ValueType::COMPUTATION`.
+  const std::shared_ptr<EagerFunction>& function() const {
+    return std::get<std::shared_ptr<EagerFunction>>(value_);
+  }
+
+  // Appends the handles of this value to `handles`, in the order of the
+  // tensors of `binding`.
+  absl::Status Bind(const federated_language::TensorFlow::Binding& binding,
+                    std::vector<TFE_TensorHandle*>& handles) const {
+    switch (type()) {
+      case ValueType::TENSOR: {
+        if (!binding.has_tensor()) {
+          return BindKindMismatch("tensor", binding);
+        }
+        handles.push_back(handle());
+        return absl::OkStatus();
+      }
+      case ValueType::STRUCT: {
+        if (!binding.has_struct_()) {
+          return BindKindMismatch("struct", binding);
+        }
+        if (binding.struct_().element_size() != elements().size()) {
+          return absl::InvalidArgumentError(
+              absl::StrCat("Attempted to bind struct with ", elements().size(),
+                           " fields to an argument struct with ",
+                           binding.struct_().element_size(), " fields."));
+        }
+        for (int i = 0; i < binding.struct_().element_size(); i++) {
+          TFF_TRY(elements()[i].Bind(binding.struct_().element(i), handles));
+        }
+        return absl::OkStatus();
+      }
+      case ValueType::COMPUTATION: {
+        return absl::InvalidArgumentError(
+            "Attempted to bind computation value as argument to a TensorFlow "
+            "computation. This is not supported.");
+      }
+    }
+  }
+
+  // Builds the value of `binding` from its tensors, taken from the front of
+  // `handles`.
+  static absl::StatusOr<ExecutorValue> FromHandlesAndBinding(
+      const federated_language::TensorFlow::Binding& binding,
+      absl::Span<TensorHandle>& handles) {
+    switch (binding.binding_case()) {
+      case federated_language::TensorFlow::Binding::kTensor: {
+        if (handles.empty()) {
+          return absl::InternalError(
+              "TensorFlow computation had fewer output tensors than expected.");
+        }
+        ExecutorValue value(std::move(handles.front()));
+        handles.remove_prefix(1);
+        return value;
+      }
+      case federated_language::TensorFlow::Binding::kStruct: {
+        auto elements = std::make_shared<std::vector<ExecutorValue>>();
+        elements->reserve(binding.struct_().element_size());
+        for (const auto& element_binding : binding.struct_().element()) {
+          elements->push_back(
+              TFF_TRY(FromHandlesAndBinding(element_binding, handles)));
+        }
+        return ExecutorValue(std::move(elements));
+      }
+      default: {
+        return absl::UnimplementedError(absl::StrCat(
+            "Unsupported output binding kind: ", binding.binding_case()));
+      }
+    }
+  }
+
+ private:
+  std::variant<TensorHandle, std::shared_ptr<std::vector<ExecutorValue>>,
+               std::shared_ptr<EagerFunction>>
+      value_;
+
+  static absl::Status BindKindMismatch(
+      const absl::string_view value_kind,
+      const federated_language::TensorFlow::Binding& binding) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Attempted to bind ", value_kind,
+                     " value to argument of kind ", binding.Utf8DebugString()));
+  }
+};
+
+// A TensorFlow computation registered with an eager context.
+class EagerFunction {
+ public:
+  static absl::StatusOr<std::shared_ptr<EagerFunction>> Create(
+      const federated_language::TensorFlow& comp_pb, EagerContext context) {
+    EagerComputation computation =
+        TFF_TRY(EagerComputation::FromProto(comp_pb));
+    TFF_TRY(computation.RegisterFunctions(context.get()));
+    std::optional<federated_language::TensorFlow::Binding> parameter;
+    if (comp_pb.has_parameter()) {
+      parameter = comp_pb.parameter();
+    }
+    return std::shared_ptr<EagerFunction>(new EagerFunction(
+        std::move(context), std::move(computation), std::move(parameter),
+        comp_pb.result()));
+  }
+
+  // Unregisters the function from the context, so that the functions of
+  // uncached computations, and of computations that lost a race to be cached,
+  // do not accumulate in it.
+  ~EagerFunction() {
+    absl::Status status = computation_.RemoveFunctions(context_.get());
+    if (!status.ok()) {
+      LOG(WARNING) << "Failed to remove a TensorFlow computation from the "
+                   << "eager context: " << status;
+    }
+  }
+
+  absl::StatusOr<ExecutorValue> Call(
+      const std::optional<ExecutorValue>& arg) const {
+    std::vector<TFE_TensorHandle*> arg_handles;
+    if (parameter_.has_value()) {
+      if (!arg.has_value()) {
+        return absl::InvalidArgumentError(
+            "Argument must be provided to TensorFlow computation which "
+            "accepts a parameter.");
+      }
+      TFF_TRY(arg->Bind(*parameter_, arg_handles));
+    } else if (arg.has_value()) {
+      return absl::InvalidArgumentError(
+          "Argument provided to TensorFlow computation which does not accept "
+          "a parameter.");
+    }
+    std::vector<TensorHandle> results;
+    // Functions without outputs cannot be executed; their result is only a
+    // structure.
+    if (num_results_ > 0) {
+      std::vector<TFE_TensorHandle*> result_handles =
+          TFF_TRY(computation_.CallRegistered(context_.get(), arg_handles));
+      results.reserve(result_handles.size());
+      for (TFE_TensorHandle* result_handle : result_handles) {
+        results.push_back(OwnHandle(result_handle, context_));
+      }
+    }
+    absl::Span<TensorHandle> remaining(results);
+    return ExecutorValue::FromHandlesAndBinding(result_, remaining);
+  }
+
+ private:
+  EagerFunction(
+      EagerContext context, EagerComputation computation,
+      std::optional<federated_language::TensorFlow::Binding> parameter,
+      federated_language::TensorFlow::Binding result)
+      : context_(std::move(context)),
+        computation_(std::move(computation)),
+        parameter_(std::move(parameter)),
+        result_(std::move(result)),
+        num_results_(NumTensorsInBinding(result_)) {}
+
+  // Kept alive until the function is removed from it.
+  const EagerContext context_;
+  // Only calls const-safe methods after construction.
+  mutable EagerComputation computation_;
+  const std::optional<federated_language::TensorFlow::Binding> parameter_;
+  const federated_language::TensorFlow::Binding result_;
+  const int32_t num_results_;
+};
+
+// Dropping the last reference to a pending value cancels its computation.
+using ValueFuture = CancellableFuture<absl::StatusOr<ExecutorValue>>;
+
+class EagerTensorFlowExecutor : public ExecutorBase<ValueFuture> {
+ public:
+  EagerTensorFlowExecutor(int32_t max_concurrent_computation_calls,
+                          TFE_Context* context)
+      : context_(context == nullptr
+                     ? EagerContext(NewContext(), TFE_DeleteContext)
+                     : EagerContext(context, [](TFE_Context*) {})),
+        thread_pool_(
+            // Use a threadpool with CPU * 4 or the user specified
+            // maximum.
+            ((max_concurrent_computation_calls > 0)
+                 ? max_concurrent_computation_calls
+                 : std::thread::hardware_concurrency() * 4),
+            ExecutorName()) {}
+
+  ~EagerTensorFlowExecutor() override {
+    // Cancel pending values while the thread pool computing them is alive.
+    ClearTracked();
+  }
+
+ private:
+  static TFE_Context* NewContext() {
+    TFStatusPtr status(TF_NewStatus(), TF_DeleteStatus);
+    std::unique_ptr<TFE_ContextOptions, decltype(&TFE_DeleteContextOptions)>
+        options(TFE_NewContextOptions(), TFE_DeleteContextOptions);
+    TFE_Context* context = TFE_NewContext(options.get(), status.get());
+    CHECK_EQ(TF_GetCode(status.get()), TF_OK) << TF_Message(status.get());
+    return context;
+  }
+
+  // Deleted with the last value or function created in it, if owned.
+  const EagerContext context_;
+  absl::Mutex functions_mutex_;
+  // Functions already registered with `context_`, by `cache_key`.
+  absl::flat_hash_map<uint64_t, std::shared_ptr<EagerFunction>> functions_
+      ABSL_GUARDED_BY(functions_mutex_);
+  ThreadPool thread_pool_;
+
+  absl::StatusOr<ExecutorValue> CreateValueAny(v0::Value&& value_pb) {
+    switch (value_pb.value_case()) {
+      case v0::Value::kArray:
+        return CreateValueArray(std::move(value_pb));
+      case v0::Value::kComputation:
+        return CreateValueComputation(value_pb.computation());
+      case v0::Value::kStruct: {
+        auto elements = std::make_shared<std::vector<ExecutorValue>>();
+        elements->reserve(value_pb.struct_().element_size());
+        for (v0::Value::Struct::Element& element_pb :
+             *value_pb.mutable_struct_()->mutable_element()) {
+          elements->push_back(
+              TFF_TRY(CreateValueAny(std::move(*element_pb.mutable_value()))));
+        }
+        return ExecutorValue(std::move(elements));
+      }
+      case v0::Value::kSequence:
+        return absl::UnimplementedError(
+            "EagerTensorFlowExecutor does not support sequence values.");
+      default:
+        return absl::UnimplementedError(
+            absl::StrCat("Unknown value proto type ", value_pb.value_case()));
+    }
+  }
+
+  absl::StatusOr<ExecutorValue> CreateValueArray(v0::Value&& value_pb) {
+    tensorflow::Tensor tensor =
+        TFF_TRY(DeserializeTensorValue(std::move(value_pb)));
+    return ExecutorValue(TFF_TRY(HandleFromTensor(tensor, context_)));
+  }
+
+  absl::StatusOr<ExecutorValue> CreateValueComputation(
+      const federated_language::Computation& comp_pb) {
+    switch (comp_pb.computation_case()) {
+      case federated_language::Computation::kTensorflow: {
+        if (!comp_pb.tensorflow().has_cache_key() ||
+            comp_pb.tensorflow().cache_key().id() == 0) {
+          LOG_FIRST_N(WARNING, 10)
+              << "Skipped caching computation, no cache_key:\n"
+              << comp_pb.type().Utf8DebugString();
+          return ExecutorValue(
+              TFF_TRY(EagerFunction::Create(comp_pb.tensorflow(), context_)));
+        }
+        const uint64_t function_id = comp_pb.tensorflow().cache_key().id();
+        {
+          absl::MutexLock lock(&functions_mutex_);
+          auto it = functions_.find(function_id);
+          if (it != functions_.end()) {
+            return ExecutorValue(it->second);
+          }
+        }
+        // If another thread beat us to creating the function, ours is thrown
+        // away, which removes it from the context.
+        std::shared_ptr<EagerFunction> function =
+            TFF_TRY(EagerFunction::Create(comp_pb.tensorflow(), context_));
+        absl::MutexLock lock(&functions_mutex_);
+        return ExecutorValue(
+            functions_.try_emplace(function_id, std::move(function))
+                .first->second);
+      }
+      case federated_language::Computation::kLiteral: {
+        const tensorflow::Tensor tensor =
+            TFF_TRY(TensorFromArray(comp_pb.literal().value()));
+        return ExecutorValue(TFF_TRY(HandleFromTensor(tensor, context_)));
+      }
+      default:
+        return absl::InvalidArgumentError(absl::StrCat(
+            "`EagerTensorFlowExecutor::CreateValueComputation` can only "
+            "create values for TensorFlow computations and literals. Found "
+            "computation of type ",
+            comp_pb.computation_case()));
+    }
+  }
+
+  // NOTE: `value` reference must be valid until `tasks.WaitAll` is called.
+  absl::Status MaterializeValue(const ExecutorValue& value, v0::Value* value_pb,
+                                ParallelTasks& tasks) {
+    switch (value.type()) {
+      case ExecutorValue::ValueType::TENSOR: {
+        return tasks.add_task([&value, value_pb]() {
+          const tensorflow::Tensor tensor =
+              TFF_TRY(TensorFromHandle(value.handle()));
+          *value_pb->mutable_array() = TFF_TRY(ArrayFromTensor(tensor));
+          return absl::OkStatus();
+        });
+      }
+      case ExecutorValue::ValueType::STRUCT: {
+        v0::Value::Struct* struct_pb = value_pb->mutable_struct_();
+        for (const ExecutorValue& element : value.elements()) {
+          // NOTE: field names are never returned.
+          TFF_TRY(MaterializeValue(
+              element, struct_pb->add_element()->mutable_value(), tasks));
+        }
+        return absl::OkStatus();
+      }
+      case ExecutorValue::ValueType::COMPUTATION: {
+        return absl::InvalidArgumentError(
+            "Cannot materialize uncalled computations");
+      }
+    }
+  }
+
+ protected:
+  absl::string_view ExecutorName() final {
+    static constexpr absl::string_view kExecutorName =
+        "EagerTensorFlowExecutor";
+    return kExecutorName;
+  }
+
+  absl::StatusOr<ValueFuture> CreateExecutorValue(
+      const v0::Value& value_pb) final {
+    return ThreadRunCancellable(
+        [value_pb, this](const CancellationToken&) mutable
+            -> absl::StatusOr<ExecutorValue> {
+          return CreateValueAny(std::move(value_pb));
+        },
+        &thread_pool_);
+  }
+
+  absl::StatusOr<ValueFuture> CreateCall(
+      ValueFuture function, std::optional<ValueFuture> argument) final {
+    return ThreadRunCancellable(
+        [function = std::move(function), argument = std::move(argument)](
+            const CancellationToken&) -> absl::StatusOr<ExecutorValue> {
+          ExecutorValue fn = TFF_TRY(Wait(function));
+          std::optional<ExecutorValue> arg = std::nullopt;
+          if (argument.has_value()) {
+            arg = TFF_TRY(Wait(argument.value()));
+          }
+          if (fn.type() != ExecutorValue::ValueType::COMPUTATION) {
+            return absl::InvalidArgumentError(absl::StrCat(
+                "Expected `function` argument to "
+                "`EagerTensorFlowExecutor::CreateCall` to be a computation, "
+                "but found type ",
+                fn.type()));
+          }
+          return fn.function()->Call(arg);
+        },
+        &thread_pool_);
+  }
+
+  absl::StatusOr<ValueFuture> CreateStruct(
+      std::vector<ValueFuture> elements) final {
+    return Map(
+        std::move(elements),
+        [](std::vector<ExecutorValue>&& elements)
+            -> absl::StatusOr<ExecutorValue> {
+          return ExecutorValue(std::make_shared<std::vector<ExecutorValue>>(
+              std::move(elements)));
+        },
+        &thread_pool_);
+  }
+
+  absl::StatusOr<ValueFuture> CreateSelection(ValueFuture value,
+                                              const uint32_t index) final {
+    return Map(
+        std::vector<ValueFuture>({value}),
+        [index](std::vector<ExecutorValue>&& values)
+            -> absl::StatusOr<ExecutorValue> {
+          ExecutorValue& value = values[0];
+          if (value.type() != ExecutorValue::ValueType::STRUCT) {
+            return absl::InvalidArgumentError(
+                "Cannot create selection on non-struct value.");
+          }
+          if (value.elements().size() <= index) {
+            return absl::InvalidArgumentError(
+                absl::StrCat("Attempted to access index ", index, " of a ",
+                             value.elements().size(), "-length struct."));
+          }
+          return ExecutorValue(value.elements()[index]);
+        },
+        &thread_pool_);
+  }
+
+  absl::Status Materialize(ValueFuture value_fut, v0::Value* value_pb) final {
+    ExecutorValue value = TFF_TRY(Wait(std::move(value_fut)));
+    ParallelTasks tasks(&thread_pool_);
+    TFF_TRY(MaterializeValue(value, value_pb, tasks));
+    TFF_TRY(tasks.WaitAll());
+    return absl::OkStatus();
+  }
+};
+
+}  // namespace
+
+std::shared_ptr<Executor> CreateEagerTensorFlowExecutor(
+    int32_t max_concurrent_computation_calls, TFE_Context* context) {
+  return std::make_shared<EagerTensorFlowExecutor>(
+      max_concurrent_computation_calls, context);
+}
+
+}  // namespace tensorflow_federated
@@ -0,0 +1,49 @@
+/* Copyright 2026, The TensorFlow Federated Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+     http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License
+==============================================================================*/
+
+#ifndef THIRD_PARTY_TENSORFLOW_FEDERATED_CC_CORE_IMPL_EXECUTORS_EAGER_TENSORFLOW_EXECUTOR_H_
+#define THIRD_PARTY_TENSORFLOW_FEDERATED_CC_CORE_IMPL_EXECUTORS_EAGER_TENSORFLOW_EXECUTOR_H_
+
+#include <cstdint>
+#include <memory>
+
+#include "tensorflow/c/eager/c_api.h"
+#include "tensorflow_federated/cc/core/impl/executors/executor.h"
+
+namespace tensorflow_federated {
+
+// Returns an executor that resolves TensorFlow computations and structures of
+// tensors like `CreateTensorFlowExecutor`, but runs each computation as a
+// function in a TensorFlow eager context instead of in graph sessions.
+//
+// Each computation is converted to a `FunctionDef` and registered with the
+// context once, when its value is created. Tensors are held as
+// `TFE_TensorHandle`s, so results of one call are passed to the next without
+// copies.
+//
+// Sequences and intrinsics are not supported, and values are not charged to a
+// `MemoryBudget`, so TFF workers do not offer this executor.
+//
+// If `context` is null, the executor creates its own context, which is deleted
+// once the executor and every tensor and function created in it are gone.
+// Otherwise `context` must outlive the executor and any work still running on
+// its values, and the library functions of its computations remain in it.
+std::shared_ptr<Executor> CreateEagerTensorFlowExecutor(
+    int32_t max_concurrent_computation_calls = -1,
+    TFE_Context* context = nullptr);
+
+}  // namespace tensorflow_federated
+
+#endif  // THIRD_PARTY_TENSORFLOW_FEDERATED_CC_CORE_IMPL_EXECUTORS_EAGER_TENSORFLOW_EXECUTOR_H_
@@ -0,0 +1,143 @@
+/* Copyright 2026, The TensorFlow Federated Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+     http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License
+==============================================================================*/
+
+// Side-by-side benchmarks of the session based `TensorFlowExecutor` and the
+// `EagerTensorFlowExecutor` calling one cached computation.
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "absl/log/check.h"
+#include "absl/status/status.h"
+#include "tensorflow/cc/framework/scope.h"
+#include "tensorflow/cc/ops/array_ops.h"
+#include "tensorflow/cc/ops/math_ops.h"
+#include "tensorflow/core/framework/graph.pb.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/framework/types.pb.h"
+#include "federated_language/proto/computation.pb.h"
+#include "tensorflow_federated/cc/core/impl/executors/eager_tensorflow_executor.h"
+#include "tensorflow_federated/cc/core/impl/executors/executor.h"
+#include "tensorflow_federated/cc/core/impl/executors/tensorflow_executor.h"
+#include "tensorflow_federated/cc/core/impl/executors/tensorflow_test_utils.h"
+#include "tensorflow_federated/proto/v0/executor.pb.h"
+
+namespace tensorflow_federated {
+namespace {
+
+using ::tensorflow_federated::testing::TensorV;
+
+enum ExecutorKind {
+  kSession = 0,
+  kEager = 1,
+};
+
+std::shared_ptr<Executor> CreateExecutor(ExecutorKind kind) {
+  switch (kind) {
+    case kSession:
+      return CreateTensorFlowExecutor();
+    case kEager:
+      return CreateEagerTensorFlowExecutor();
+  }
+}
+
+// A cached computation multiplying a square float matrix by itself.
+v0::Value MatMulComputationV() {
+  tensorflow::Scope root = tensorflow::Scope::NewRootScope();
+  tensorflow::ops::Placeholder x(root, tensorflow::DT_FLOAT);
+  tensorflow::ops::MatMul out(root, x, x);
+  tensorflow::GraphDef graphdef_pb;
+  absl::Status status = root.ToGraphDef(&graphdef_pb);
+  CHECK(status.ok()) << status;
+  v0::Value value_pb;
+  federated_language::TensorFlow* tensorflow_pb =
+      value_pb.mutable_computation()->mutable_tensorflow();
+  tensorflow_pb->mutable_graph_def()->PackFrom(graphdef_pb);
+  tensorflow_pb->mutable_parameter()->mutable_tensor()->set_tensor_name(
+      x.node()->name());
+  tensorflow_pb->mutable_result()->mutable_tensor()->set_tensor_name(
+      out.node()->name());
+  tensorflow_pb->mutable_cache_key()->set_id(1);
+  return value_pb;
+}
+
+// A matrix equal to its own square, so chained calls stay finite.
+v0::Value IdempotentMatrixV(int64_t size) {
+  tensorflow::Tensor matrix(tensorflow::DT_FLOAT,
+                            tensorflow::TensorShape({size, size}));
+  matrix.flat<float>().setConstant(1.0f / size);
+  return TensorV(matrix);
+}
+
+// Runs 256 concurrent calls per iteration. Arguments are the executor kind and
+// the matrix size.
+void BM_ConcurrentCalls(benchmark::State& state) {
+  constexpr int32_t kNumCalls = 256;
+  std::shared_ptr<Executor> executor =
+      CreateExecutor(static_cast<ExecutorKind>(state.range(0)));
+  OwnedValueId fn = executor->CreateValue(MatMulComputationV()).value();
+  OwnedValueId arg =
+      executor->CreateValue(IdempotentMatrixV(state.range(1))).value();
+  for (auto s : state) {
+    std::vector<OwnedValueId> results;
+    results.reserve(kNumCalls);
+    for (int32_t i = 0; i < kNumCalls; ++i) {
+      results.push_back(executor->CreateCall(fn, arg).value());
+    }
+    for (const OwnedValueId& result : results) {
+      CHECK(executor->Materialize(result).ok());
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kNumCalls);
+}
+
+BENCHMARK(BM_ConcurrentCalls)
+    ->ArgsProduct({{kSession, kEager}, {16, 256}})
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+// Runs 32 calls per iteration, each taking the result of the previous one, and
+// materializes only the last. Arguments are the executor kind and the matrix
+// size.
+void BM_ChainedCalls(benchmark::State& state) {
+  constexpr int32_t kNumCalls = 32;
+  std::shared_ptr<Executor> executor =
+      CreateExecutor(static_cast<ExecutorKind>(state.range(0)));
+  OwnedValueId fn = executor->CreateValue(MatMulComputationV()).value();
+  OwnedValueId arg =
+      executor->CreateValue(IdempotentMatrixV(state.range(1))).value();
+  for (auto s : state) {
+    OwnedValueId result = executor->CreateCall(fn, arg).value();
+    for (int32_t i = 1; i < kNumCalls; ++i) {
+      result = executor->CreateCall(fn, result).value();
+    }
+    CHECK(executor->Materialize(result).ok());
+  }
+  state.SetItemsProcessed(state.iterations() * kNumCalls);
+}
+
+BENCHMARK(BM_ChainedCalls)
+    ->ArgsProduct({{kSession, kEager}, {16, 256}})
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace
+}  // namespace tensorflow_federated
+
+// Run the benchmark
+BENCHMARK_MAIN();
@@ -15,4 +15,125 @@ limitations under the License
 
 #include "tensorflow_federated/cc/core/impl/executors/executor.h"
 
-namespace tensorflow_federated {}  // namespace tensorflow_federated
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "absl/functional/function_ref.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/types/span.h"
+#include "tensorflow_federated/cc/core/impl/executors/cardinalities.h"
+#include "tensorflow_federated/cc/core/impl/executors/status_macros.h"
+#include "tensorflow_federated/proto/v0/executor.pb.h"
+
+namespace tensorflow_federated {
+
+absl::Status ConsumeSequenceInChunks(
+    v0::Value value_pb, int32_t chunk_size,
+    absl::FunctionRef<absl::Status(v0::Value::Sequence)> consume) {
+  if (chunk_size <= 0) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Chunk size must be positive, found ", chunk_size));
+  }
+  if (!value_pb.has_sequence()) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "Cannot materialize a non-sequence value in chunks, found value of "
+        "kind ",
+        value_pb.value_case()));
+  }
+  auto* elements = value_pb.mutable_sequence()->mutable_element();
+  for (int start = 0; start < elements->size(); start += chunk_size) {
+    v0::Value::Sequence chunk_pb;
+    const int end = std::min(start + chunk_size, elements->size());
+    chunk_pb.mutable_element()->Reserve(end - start);
+    for (int i = start; i < end; ++i) {
+      *chunk_pb.add_element() = std::move(*elements->Mutable(i));
+    }
+    TFF_TRY(consume(std::move(chunk_pb)));
+  }
+  return absl::OkStatus();
+}
+
+absl::Status ConsumeClients(
+    v0::Value value_pb, absl::Span<const int32_t> client_indices,
+    absl::FunctionRef<absl::Status(int32_t, v0::Value)> consume) {
+  if (!value_pb.has_federated() ||
+      value_pb.federated().type().placement().value().uri() != kClientsUri) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "Cannot materialize a value which is not placed at clients one client "
+        "at a time, found value of kind ",
+        value_pb.value_case()));
+  }
+  auto* values = value_pb.mutable_federated()->mutable_value();
+  const bool all_equal = value_pb.federated().type().all_equal();
+  if (client_indices.empty()) {
+    for (int32_t i = 0; i < values->size(); ++i) {
+      TFF_TRY(consume(i, std::move(*values->Mutable(i))));
+    }
+    return absl::OkStatus();
+  }
+  for (int32_t index : client_indices) {
+    if (index < 0 || (!all_equal && index >= values->size())) {
+      return absl::InvalidArgumentError(absl::StrCat(
+          "Client index ", index, " is out of range for a value of ",
+          values->size(), " clients"));
+    }
+    TFF_TRY(consume(index, all_equal ? values->Get(0) : values->Get(index)));
+  }
+  return absl::OkStatus();
+}
+
+absl::StatusOr<std::vector<OwnedValueId>> Executor::CreateCallBatch(
+    const absl::Span<const CallArgs> calls) {
+  std::vector<OwnedValueId> results;
+  results.reserve(calls.size());
+  for (const CallArgs& call : calls) {
+    results.push_back(TFF_TRY(CreateCall(call.function, call.argument)));
+  }
+  return results;
+}
+
+absl::StatusOr<std::vector<OwnedValueId>> Executor::CreateStructBatch(
+    const absl::Span<const std::vector<ValueId>> structs) {
+  std::vector<OwnedValueId> results;
+  results.reserve(structs.size());
+  for (const std::vector<ValueId>& members : structs) {
+    results.push_back(TFF_TRY(CreateStruct(members)));
+  }
+  return results;
+}
+
+absl::StatusOr<std::vector<OwnedValueId>> Executor::CreateSelectionBatch(
+    const absl::Span<const SelectionArgs> selections) {
+  std::vector<OwnedValueId> results;
+  results.reserve(selections.size());
+  for (const SelectionArgs& selection : selections) {
+    results.push_back(
+        TFF_TRY(CreateSelection(selection.source, selection.index)));
+  }
+  return results;
+}
+
+absl::Status Executor::MaterializeSequenceChunks(
+    const ValueId value, int32_t chunk_size,
+    absl::FunctionRef<absl::Status(v0::Value::Sequence)> consume) {
+  return ConsumeSequenceInChunks(TFF_TRY(Materialize(value)), chunk_size,
+                                 consume);
+}
+
+absl::Status Executor::MaterializeClients(
+    const ValueId value, absl::Span<const int32_t> client_indices,
+    absl::FunctionRef<absl::Status(int32_t, v0::Value)> consume) {
+  return ConsumeClients(TFF_TRY(Materialize(value)), client_indices, consume);
+}
+
+absl::StatusOr<OwnedValueId> Executor::CreateClientsSubset(
+    const ValueId value, absl::Span<const int32_t> client_indices) {
+  return absl::UnimplementedError(
+      "This executor does not support restricting clients-placed values.");
+}
+
+}  // namespace tensorflow_federated
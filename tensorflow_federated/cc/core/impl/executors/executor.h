@@ -16,6 +16,7 @@ limitations under the License
 #ifndef THIRD_PARTY_TENSORFLOW_FEDERATED_CC_CORE_IMPL_EXECUTORS_EXECUTOR_H_
 #define THIRD_PARTY_TENSORFLOW_FEDERATED_CC_CORE_IMPL_EXECUTORS_EXECUTOR_H_
 
+#include <chrono>  // NOLINT
 #include <cstdint>
 #include <limits>
 #include <memory>
@@ -25,20 +26,21 @@ limitations under the License
 #include <utility>
 #include <vector>
 
-#include "absl/base/thread_annotations.h"
-#include "absl/container/flat_hash_map.h"
+#include "absl/functional/function_ref.h"
 #include "absl/log/check.h"
 #include "absl/log/log.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
-#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
 #include "absl/types/span.h"
 #include "absl/utility/utility.h"
 #include "federated_language/proto/computation.pb.h"
 #include "tensorflow/tsl/profiler/lib/traceme.h"
+#include "tensorflow_federated/cc/core/impl/executors/executor_metrics.h"
 #include "tensorflow_federated/cc/core/impl/executors/status_macros.h"
+#include "tensorflow_federated/cc/core/impl/executors/value_table.h"
 #include "tensorflow_federated/proto/v0/executor.pb.h"
 
 namespace tensorflow_federated {
@@ -47,6 +49,32 @@ class OwnedValueId;
 
 using ValueId = uint64_t;
 
+// The arguments of one call in `Executor::CreateCallBatch`.
+struct CallArgs {
+  ValueId function;
+  std::optional<ValueId> argument;
+};
+
+// The arguments of one selection in `Executor::CreateSelectionBatch`.
+struct SelectionArgs {
+  ValueId source;
+  uint32_t index;
+};
+
+// Passes the elements of the materialized sequence `value_pb` to `consume` in
+// order, in chunks of at most `chunk_size` elements.
+absl::Status ConsumeSequenceInChunks(
+    v0::Value value_pb, int32_t chunk_size,
+    absl::FunctionRef<absl::Status(v0::Value::Sequence)> consume);
+
+// Passes the values of the materialized clients-placed `value_pb` to `consume`
+// with their client indices, in the order of `client_indices`, or of all the
+// clients if `client_indices` is empty. The single value of an all-equal
+// `value_pb` is passed for every requested index.
+absl::Status ConsumeClients(
+    v0::Value value_pb, absl::Span<const int32_t> client_indices,
+    absl::FunctionRef<absl::Status(int32_t, v0::Value)> consume);
+
 // A dynamically-dispatched executor interface.
 //
 // This interface allows users to execute TensorFlow Federated computations.
@@ -145,6 +173,23 @@ class Executor {
   virtual absl::StatusOr<OwnedValueId> CreateSelection(
       const ValueId source, const uint32_t index) = 0;
 
+  // Batched forms of `CreateCall`, `CreateStruct` and `CreateSelection`.
+  //
+  // Each returns one value per element of its input, in order, equivalent to
+  // calling the unbatched method on every element. If any element fails, the
+  // first error is returned and all values created by the batch are disposed.
+  //
+  // These are intended for fanning out the same operation over many values
+  // (e.g. one per client), letting implementations amortize per-call overhead
+  // such as value lookups and locking. The default implementations simply
+  // loop over the unbatched methods.
+  virtual absl::StatusOr<std::vector<OwnedValueId>> CreateCallBatch(
+      const absl::Span<const CallArgs> calls);
+  virtual absl::StatusOr<std::vector<OwnedValueId>> CreateStructBatch(
+      const absl::Span<const std::vector<ValueId>> structs);
+  virtual absl::StatusOr<std::vector<OwnedValueId>> CreateSelectionBatch(
+      const absl::Span<const SelectionArgs> selections);
+
   // Materialize the value as a concrete structure.
   //
   // This method is blocking: it may synchronously wait for the result of
@@ -159,6 +204,54 @@ class Executor {
     return value_pb;
   }
 
+  // Materialize a sequence value incrementally, passing its elements to
+  // `consume` in order, in chunks of at most `chunk_size` elements.
+  //
+  // Implementations which can stream sequences hand over each chunk as soon as
+  // it is converted, so that peak memory is bounded by the chunk size rather
+  // than by the size of the sequence. The default implementation materializes
+  // the whole value and then splits it. Returns the first error returned by
+  // `consume`, after which no further chunks are passed.
+  virtual absl::Status MaterializeSequenceChunks(
+      const ValueId value, int32_t chunk_size,
+      absl::FunctionRef<absl::Status(v0::Value::Sequence)> consume);
+
+  // Materialize a clients-placed value one client at a time, passing each
+  // client's index and value to `consume`.
+  //
+  // Only the clients in `client_indices` are materialized, or all of them if
+  // it is empty, so that a driver can pull the results of a sampled subset of
+  // the clients. Implementations which can materialize clients independently
+  // hand over each client as soon as it is available, in no particular order,
+  // so that downstream processing need not wait for the slowest client. Calls
+  // to `consume` are never concurrent. The default implementation
+  // materializes the whole value and then passes the clients in order.
+  // Returns the first error returned by `consume`, after which no further
+  // clients are passed.
+  virtual absl::Status MaterializeClients(
+      const ValueId value, absl::Span<const int32_t> client_indices,
+      absl::FunctionRef<absl::Status(int32_t, v0::Value)> consume);
+
+  // Restrict a clients-placed value to the clients at `client_indices`, in
+  // that order, e.g. the clients sampled for a round.
+  //
+  // Computations over the resulting value only run for those clients, so
+  // restricting the inputs of a round means the other clients are never
+  // computed. Clients-placed values combined with it, e.g. by
+  // `federated_zip_at_clients`, must be restricted to the same clients, unless
+  // they hold the same value for every client (e.g. the result of
+  // `federated_broadcast`). `MaterializeClients` indexes its clients by their
+  // position in `client_indices`. The default implementation returns
+  // `Unimplemented`.
+  //
+  // Executors which spread their clients over several children (e.g. the
+  // composing executor) can only keep the order of `client_indices` if the
+  // indices of each child's clients come after those of the previous
+  // children, and return `InvalidArgument` otherwise. Callers which need to
+  // work with any executor should pass the indices in ascending order.
+  virtual absl::StatusOr<OwnedValueId> CreateClientsSubset(
+      const ValueId value, absl::Span<const int32_t> client_indices);
+
   // Dispose of a value, releasing any associated resources.
   //
   // Users of this class should not typically access this function directly.
@@ -216,6 +309,34 @@ class OwnedValueId {
   static constexpr ValueId INVALID_ID = std::numeric_limits<ValueId>::max();
 };
 
+// A scoped timer for one call of an `ExecutorBase` method; see
+// `ExecutorBase::Trace`.
+class ExecutorMethodTrace {
+ public:
+  explicit ExecutorMethodTrace(ExecutorMethodMetrics* metrics)
+      : metrics_(metrics), start_(std::chrono::steady_clock::now()) {
+    if (VLOG_IS_ON(1) || tsl::profiler::TraceMe::Active()) {
+      absl::string_view path = metrics_->path();
+      VLOG(1) << path;
+      // Safe to pass in a view here: `TraceMe` internally copies to an owned
+      // `std::string`.
+      trace_me_.emplace(path);
+    }
+  }
+  ExecutorMethodTrace(const ExecutorMethodTrace&) = delete;
+  ExecutorMethodTrace& operator=(const ExecutorMethodTrace&) = delete;
+  ~ExecutorMethodTrace() {
+    metrics_->Record(
+        absl::FromChrono(std::chrono::steady_clock::now() - start_));
+  }
+
+ private:
+  ExecutorMethodMetrics* const metrics_;
+  // A monotonic clock, which is also cheaper to read than `absl::Now`.
+  const std::chrono::steady_clock::time_point start_;
+  std::optional<tsl::profiler::TraceMe> trace_me_;
+};
+
 // A base class to allow for easy implementation of `Executor`.
 // `Executor` implementations should typically inherit from
 // `ExecutorBase<executor-specific-value-implementation>`.
@@ -238,54 +359,55 @@ class ExecutorBase : public Executor,
                 "ExecutorBase<std::shared_ptr<MyExecutorValue>>`");
 
  private:
-  absl::Mutex mutex_;
-  ValueId next_value_id_ ABSL_GUARDED_BY(mutex_) = 0;
-  absl::flat_hash_map<ValueId, ExecutorValue> tracked_values_
-      ABSL_GUARDED_BY(mutex_);
+  // Sharded so that concurrent calls on different values rarely contend.
+  ShardedValueTable<ValueId, ExecutorValue> tracked_values_;
 
   // Tracks the provided value and returns the ID which refers to it.
   absl::StatusOr<OwnedValueId> TrackValue(ExecutorValue value) {
-    absl::WriterMutexLock lock(&mutex_);
-    ValueId id = next_value_id_++;
-    tracked_values_.emplace(id, std::move(value));
+    ValueId id = tracked_values_.Insert(std::move(value));
     return absl::StatusOr<OwnedValueId>(absl::in_place_t(), shared_from_this(),
                                         id);
   }
 
+  // Tracks the provided values and returns the IDs which refer to them, in
+  // order.
+  std::vector<OwnedValueId> TrackValues(std::vector<ExecutorValue> values) {
+    const size_t num_values = values.size();
+    ValueId first_id = tracked_values_.InsertBatch(std::move(values));
+    std::weak_ptr<Executor> self = shared_from_this();
+    std::vector<OwnedValueId> ids;
+    ids.reserve(num_values);
+    for (size_t i = 0; i < num_values; ++i) {
+      ids.emplace_back(self, first_id + i);
+    }
+    return ids;
+  }
+
   // Returns a copy of the value previously stored with `TrackValue`.
   absl::StatusOr<ExecutorValue> GetTracked(ValueId value_id) {
-    absl::ReaderMutexLock lock(&mutex_);
-    auto value_iter = tracked_values_.find(value_id);
-    if (value_iter == tracked_values_.end()) {
+    std::optional<ExecutorValue> value = tracked_values_.Get(value_id);
+    if (!value.has_value()) {
       return absl::NotFoundError(
           absl::StrCat(ExecutorName(), " value not found: ", value_id));
     }
-    return value_iter->second;
+    return *std::move(value);
   }
 
  protected:
-  // Logs the current method and records its trace to the TensorFlow profiler.
-  std::optional<tsl::profiler::TraceMe> Trace(const char* method_name) {
-    bool enabled = VLOG_IS_ON(1) || tsl::profiler::TraceMe::Active();
-    if (!enabled) {
-      return std::nullopt;
-    }
-    std::string path = absl::StrCat(ExecutorName(), "::", method_name);
-    absl::string_view path_view(path);
-    VLOG(1) << path_view;
-    // Safe to pass in a view here: `TraceMe` internally copies to an owned
-    // `std::string`.
-    return std::make_optional<tsl::profiler::TraceMe>(path_view);
+  // Records the latency of the current method into its
+  // `ExecutorMethodMetrics` until the returned object is destroyed. When
+  // enabled, also logs the method and records its trace to the TensorFlow
+  // profiler.
+  ExecutorMethodTrace Trace(const char* method_name) {
+    return ExecutorMethodTrace(
+        GetExecutorMethodMetrics(ExecutorName(), method_name));
   }
 
   // Clears all currently tracked values from the executor.
   // This method is intended to be used by child class destructors to ensure
   // that the `ExecutorValue` references held by `tracked_values_` have been
   // destroyed.
-  void ClearTracked() {
-    absl::WriterMutexLock lock(&mutex_);
-    tracked_values_.clear();
-  }
+  void ClearTracked() { tracked_values_.Clear(); }
 
   // Returns the string name of the current executor.
   virtual absl::string_view ExecutorName() = 0;
@@ -299,6 +421,65 @@ class ExecutorBase : public Executor,
       ExecutorValue value, const uint32_t index) = 0;
   virtual absl::Status Materialize(ExecutorValue value,
                                    v0::Value* value_pb) = 0;
+  // Executors which can stream sequences should override this. The default
+  // implementation materializes the whole value.
+  virtual absl::Status MaterializeSequenceChunks(
+      ExecutorValue value, int32_t chunk_size,
+      absl::FunctionRef<absl::Status(v0::Value::Sequence)> consume) {
+    v0::Value value_pb;
+    TFF_TRY(Materialize(std::move(value), &value_pb));
+    return ConsumeSequenceInChunks(std::move(value_pb), chunk_size, consume);
+  }
+  // Batched forms of `CreateCall`, `CreateStruct` and `CreateSelection`,
+  // called by the public `*Batch` methods with the batch's values already
+  // looked up. Executors which can dispatch a whole batch at once should
+  // override these. The default implementations loop over the unbatched
+  // methods.
+  virtual absl::StatusOr<std::vector<ExecutorValue>> CreateCallBatch(
+      std::vector<std::pair<ExecutorValue, std::optional<ExecutorValue>>>
+          calls) {
+    std::vector<ExecutorValue> results;
+    results.reserve(calls.size());
+    for (auto& [function, argument] : calls) {
+      results.push_back(
+          TFF_TRY(CreateCall(std::move(function), std::move(argument))));
+    }
+    return results;
+  }
+  virtual absl::StatusOr<std::vector<ExecutorValue>> CreateStructBatch(
+      std::vector<std::vector<ExecutorValue>> structs) {
+    std::vector<ExecutorValue> results;
+    results.reserve(structs.size());
+    for (std::vector<ExecutorValue>& members : structs) {
+      results.push_back(TFF_TRY(CreateStruct(std::move(members))));
+    }
+    return results;
+  }
+  virtual absl::StatusOr<std::vector<ExecutorValue>> CreateSelectionBatch(
+      std::vector<std::pair<ExecutorValue, uint32_t>> selections) {
+    std::vector<ExecutorValue> results;
+    results.reserve(selections.size());
+    for (auto& [source, index] : selections) {
+      results.push_back(TFF_TRY(CreateSelection(std::move(source), index)));
+    }
+    return results;
+  }
+  // Executors which can materialize clients independently should override
+  // this. The default implementation materializes the whole value.
+  virtual absl::Status MaterializeClients(
+      ExecutorValue value, absl::Span<const int32_t> client_indices,
+      absl::FunctionRef<absl::Status(int32_t, v0::Value)> consume) {
+    v0::Value value_pb;
+    TFF_TRY(Materialize(std::move(value), &value_pb));
+    return ConsumeClients(std::move(value_pb), client_indices, consume);
+  }
+  // Executors which hold clients-placed values should override this.
+  virtual absl::StatusOr<ExecutorValue> CreateClientsSubset(
+      ExecutorValue value, absl::Span<const int32_t> client_indices) {
+    return absl::UnimplementedError(
+        absl::StrCat(ExecutorName(),
+                     " does not support restricting clients-placed values."));
+  }
   ~ExecutorBase() override {}
 
  public:
@@ -337,20 +518,92 @@ class ExecutorBase : public Executor,
         TFF_TRY(CreateSelection(TFF_TRY(GetTracked(source)), index)));
   }
 
+  absl::StatusOr<std::vector<OwnedValueId>> CreateCallBatch(
+      const absl::Span<const CallArgs> calls) final {
+    auto trace = Trace("CreateCallBatch");
+    std::vector<std::pair<ExecutorValue, std::optional<ExecutorValue>>>
+        call_values;
+    call_values.reserve(calls.size());
+    // Fan-outs typically call one function on many arguments, so reuse the
+    // previous lookup when the function repeats.
+    std::optional<ValueId> function_id;
+    std::optional<ExecutorValue> function_val;
+    for (const CallArgs& call : calls) {
+      if (function_id != call.function) {
+        function_val = TFF_TRY(GetTracked(call.function));
+        function_id = call.function;
+      }
+      std::optional<ExecutorValue> argument_val;
+      if (call.argument.has_value()) {
+        argument_val = TFF_TRY(GetTracked(call.argument.value()));
+      }
+      call_values.emplace_back(*function_val, std::move(argument_val));
+    }
+    return TrackValues(TFF_TRY(CreateCallBatch(std::move(call_values))));
+  }
+
+  absl::StatusOr<std::vector<OwnedValueId>> CreateStructBatch(
+      const absl::Span<const std::vector<ValueId>> structs) final {
+    auto trace = Trace("CreateStructBatch");
+    std::vector<std::vector<ExecutorValue>> struct_values;
+    struct_values.reserve(structs.size());
+    for (const std::vector<ValueId>& members : structs) {
+      std::vector<ExecutorValue>& member_values = struct_values.emplace_back();
+      member_values.reserve(members.size());
+      for (const ValueId member_id : members) {
+        member_values.emplace_back(TFF_TRY(GetTracked(member_id)));
+      }
+    }
+    return TrackValues(TFF_TRY(CreateStructBatch(std::move(struct_values))));
+  }
+
+  absl::StatusOr<std::vector<OwnedValueId>> CreateSelectionBatch(
+      const absl::Span<const SelectionArgs> selections) final {
+    auto trace = Trace("CreateSelectionBatch");
+    std::vector<std::pair<ExecutorValue, uint32_t>> selection_values;
+    selection_values.reserve(selections.size());
+    for (const SelectionArgs& selection : selections) {
+      selection_values.emplace_back(TFF_TRY(GetTracked(selection.source)),
+                                    selection.index);
+    }
+    return TrackValues(
+        TFF_TRY(CreateSelectionBatch(std::move(selection_values))));
+  }
+
   absl::Status Materialize(const ValueId value_id, v0::Value* value_pb) final {
     auto trace = Trace("Materialize");
     return Materialize(TFF_TRY(GetTracked(value_id)), value_pb);
   }
 
+  absl::Status MaterializeSequenceChunks(
+      const ValueId value_id, int32_t chunk_size,
+      absl::FunctionRef<absl::Status(v0::Value::Sequence)> consume) final {
+    auto trace = Trace("MaterializeSequenceChunks");
+    return MaterializeSequenceChunks(TFF_TRY(GetTracked(value_id)), chunk_size,
+                                     consume);
+  }
+
+  absl::Status MaterializeClients(
+      const ValueId value_id, absl::Span<const int32_t> client_indices,
+      absl::FunctionRef<absl::Status(int32_t, v0::Value)> consume) final {
+    auto trace = Trace("MaterializeClients");
+    return MaterializeClients(TFF_TRY(GetTracked(value_id)), client_indices,
+                              consume);
+  }
+
+  absl::StatusOr<OwnedValueId> CreateClientsSubset(
+      const ValueId value_id, absl::Span<const int32_t> client_indices) final {
+    auto trace = Trace("CreateClientsSubset");
+    return TrackValue(TFF_TRY(
+        CreateClientsSubset(TFF_TRY(GetTracked(value_id)), client_indices)));
+  }
+
   absl::Status Dispose(const ValueId value) final {
     auto trace = Trace("Dispose");
-    absl::WriterMutexLock lock(&mutex_);
-    auto value_iter = tracked_values_.find(value);
-    if (value_iter == tracked_values_.end()) {
+    if (!tracked_values_.Erase(value)) {
       return absl::NotFoundError(absl::StrCat(
           ExecutorName(), " value not found: ", value, ", cannot dispose."));
     }
-    tracked_values_.erase(value_iter);
     return absl::OkStatus();
   }
 };
@@ -0,0 +1,121 @@
+/* Copyright 2026, The TensorFlow Federated Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+     http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License
+==============================================================================*/
+
+// Microbenchmarks of the value bookkeeping shared by all `ExecutorBase`
+// executors, run concurrently from many threads against one executor.
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "tensorflow_federated/cc/core/impl/executors/executor.h"
+#include "tensorflow_federated/proto/v0/executor.pb.h"
+
+namespace tensorflow_federated {
+namespace {
+
+// An executor whose values are the protos they were created from, so that the
+// benchmarks measure `ExecutorBase` rather than any real computation.
+class PassthroughExecutor
+    : public ExecutorBase<std::shared_ptr<const v0::Value>> {
+ public:
+  ~PassthroughExecutor() override { ClearTracked(); }
+
+ protected:
+  using ValuePtr = std::shared_ptr<const v0::Value>;
+
+  absl::string_view ExecutorName() final { return "PassthroughExecutor"; }
+
+  absl::StatusOr<ValuePtr> CreateExecutorValue(
+      const v0::Value& value_pb) final {
+    return std::make_shared<const v0::Value>(value_pb);
+  }
+
+  absl::StatusOr<ValuePtr> CreateCall(ValuePtr function,
+                                      std::optional<ValuePtr> argument) final {
+    return argument.has_value() ? *argument : function;
+  }
+
+  absl::StatusOr<ValuePtr> CreateStruct(std::vector<ValuePtr> members) final {
+    return members.empty() ? std::make_shared<const v0::Value>() : members[0];
+  }
+
+  absl::StatusOr<ValuePtr> CreateSelection(ValuePtr value,
+                                           const uint32_t index) final {
+    return value;
+  }
+
+  absl::Status Materialize(ValuePtr value, v0::Value* value_pb) final {
+    *value_pb = *value;
+    return absl::OkStatus();
+  }
+};
+
+std::shared_ptr<Executor> SharedExecutor() {
+  static auto* executor =
+      new std::shared_ptr<Executor>(std::make_shared<PassthroughExecutor>());
+  return *executor;
+}
+
+// Creates a value and disposes of it by dropping its `OwnedValueId`.
+void BM_CreateValueDispose(benchmark::State& state) {
+  std::shared_ptr<Executor> executor = SharedExecutor();
+  v0::Value value_pb;
+  for (auto s : state) {
+    benchmark::DoNotOptimize(executor->CreateValue(value_pb));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_CreateValueDispose)->ThreadRange(1, 32)->UseRealTime();
+
+// Builds a struct from, and a call on, a pool of live values, the pattern of
+// an executor stack assembling call arguments.
+void BM_CreateStructCallDispose(benchmark::State& state) {
+  constexpr int32_t kNumLiveValues = 64;
+  std::shared_ptr<Executor> executor = SharedExecutor();
+  std::vector<OwnedValueId> live_values;
+  std::vector<ValueId> live_ids;
+  for (int32_t i = 0; i < kNumLiveValues; ++i) {
+    live_values.push_back(executor->CreateValue(v0::Value()).value());
+    live_ids.push_back(live_values.back().ref());
+  }
+  int32_t i = 0;
+  for (auto s : state) {
+    OwnedValueId arg =
+        executor
+            ->CreateStruct({live_ids[i % kNumLiveValues],
+                            live_ids[(i + 1) % kNumLiveValues]})
+            .value();
+    benchmark::DoNotOptimize(
+        executor->CreateCall(live_ids[(i + 2) % kNumLiveValues], arg.ref()));
+    ++i;
+  }
+  state.SetItemsProcessed(state.iterations() * 2);
+}
+
+BENCHMARK(BM_CreateStructCallDispose)->ThreadRange(1, 32)->UseRealTime();
+
+}  // namespace
+}  // namespace tensorflow_federated
+
+// Run the benchmark
+BENCHMARK_MAIN();
@@ -26,6 +26,8 @@ limitations under the License
 #include <limits>
 #include <memory>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "absl/log/log.h"
 #include "absl/status/status.h"
@@ -43,14 +45,18 @@ limitations under the License
 #include "pybind11_abseil/absl_casters.h"
 #include "pybind11_abseil/status_casters.h"
 #include "pybind11_protobuf/native_proto_caster.h"
+#include "tensorflow_federated/cc/core/impl/base/thread_pool_stats.h"
 #include "tensorflow_federated/cc/core/impl/executors/cardinalities.h"
 #include "tensorflow_federated/cc/core/impl/executors/composing_executor.h"
 #include "tensorflow_federated/cc/core/impl/executors/executor.h"
+#include "tensorflow_federated/cc/core/impl/executors/executor_metrics.h"
 #include "tensorflow_federated/cc/core/impl/executors/federating_executor.h"
+#include "tensorflow_federated/cc/core/impl/executors/memory_budget.h"
 #include "tensorflow_federated/cc/core/impl/executors/reference_resolving_executor.h"
 #include "tensorflow_federated/cc/core/impl/executors/remote_executor.h"
 #include "tensorflow_federated/cc/core/impl/executors/sequence_executor.h"
 #include "tensorflow_federated/cc/core/impl/executors/streaming_remote_executor.h"
+#include "tensorflow_federated/cc/core/impl/executors/threading.h"
 #include "tensorflow_federated/proto/v0/executor.pb.h"
 
 namespace tensorflow_federated {
@@ -114,6 +120,15 @@ PYBIND11_MODULE(executor_bindings, m) {
            // Allow `argument` to be `None`.
            py::arg("argument").none(true), py::return_value_policy::move,
            py::call_guard<py::gil_scoped_release>())
+      .def(
+          "create_clients_subset",
+          [](Executor& e, const ValueId& value_id,
+             const std::vector<int32_t>& client_indices) {
+            return e.CreateClientsSubset(value_id, client_indices);
+          },
+          py::arg("value_id"), py::arg("client_indices"),
+          py::return_value_policy::move,
+          py::call_guard<py::gil_scoped_release>())
       .def(
           "materialize",
           [](Executor& e,
@@ -126,7 +141,70 @@ PYBIND11_MODULE(executor_bindings, m) {
             }
             return value_pb;
           },
-          py::call_guard<py::gil_scoped_release>());
+          py::call_guard<py::gil_scoped_release>())
+      .def(
+          "materialize_sequence_chunks",
+          [](Executor& e, const ValueId& value_id, int32_t chunk_size,
+             const py::function& consume) -> absl::Status {
+            return e.MaterializeSequenceChunks(
+                value_id, chunk_size,
+                [&consume](v0::Value::Sequence chunk_pb) -> absl::Status {
+                  py::gil_scoped_acquire acquire;
+                  try {
+                    consume(std::move(chunk_pb));
+                  } catch (py::error_already_set& error) {
+                    return absl::InternalError(absl::StrCat(
+                        "Failed to consume a sequence chunk: ", error.what()));
+                  }
+                  return absl::OkStatus();
+                });
+          },
+          py::arg("value_id"), py::arg("chunk_size"), py::arg("consume"),
+          py::call_guard<py::gil_scoped_release>(),
+          "Materializes a sequence value in chunks of at most `chunk_size` "
+          "elements, passing each `Value.Sequence` to `consume` as soon as it "
+          "is available.")
+      .def(
+          "materialize_clients",
+          [](Executor& e, const ValueId& value_id,
+             const std::vector<int32_t>& client_indices,
+             const py::function& consume) -> absl::Status {
+            return e.MaterializeClients(
+                value_id, client_indices,
+                [&consume](int32_t index, v0::Value client_pb) -> absl::Status {
+                  py::gil_scoped_acquire acquire;
+                  try {
+                    consume(index, std::move(client_pb));
+                  } catch (py::error_already_set& error) {
+                    return absl::InternalError(absl::StrCat(
+                        "Failed to consume the value of client ", index, ": ",
+                        error.what()));
+                  }
+                  return absl::OkStatus();
+                });
+          },
+          py::arg("value_id"), py::arg("client_indices"), py::arg("consume"),
+          py::call_guard<py::gil_scoped_release>(),
+          "Materializes the clients at `client_indices` (or every client, if "
+          "empty) of a clients-placed value, passing each client's index and "
+          "`Value` to `consume` as soon as it is available.");
+
+  // Memory accounting shared by executors.
+  py::class_<MemoryBudget, std::shared_ptr<MemoryBudget>>(m, "MemoryBudget")
+      .def(py::init([](int64_t high_water_mark_bytes) {
+             return MemoryBudget::Create(high_water_mark_bytes);
+           }),
+           py::arg("high_water_mark_bytes") = -1,
+           "Creates a budget that delays new work while at least "
+           "`high_water_mark_bytes` are held. Non-positive values only track "
+           "usage.")
+      .def_property_readonly("high_water_mark_bytes",
+                             &MemoryBudget::high_water_mark_bytes)
+      .def_property_readonly("used_bytes", &MemoryBudget::used_bytes)
+      .def_property_readonly("peak_bytes", &MemoryBudget::peak_bytes)
+      .def_property_readonly("delayed_calls", &MemoryBudget::delayed_calls)
+      .def_property_readonly("timed_out_calls",
+                             &MemoryBudget::timed_out_calls);
 
   // Executor construction methods.
   m.def("create_reference_resolving_executor",
@@ -134,11 +212,15 @@ PYBIND11_MODULE(executor_bindings, m) {
         "Creates a ReferenceResolvingExecutor", py::arg("inner_executor"));
   m.def("create_federating_executor", &CreateFederatingExecutor,
         py::arg("inner_server_executor"), py::arg("inner_client_executor"),
-        py::arg("cardinalities"), "Creates a FederatingExecutor.");
+        py::arg("cardinalities"),
+        py::arg("memory_budget").none(true) = nullptr,
+        py::arg("aggregate_partitions") = 1, "Creates a FederatingExecutor.");
   m.def("create_composing_child", &ComposingChild::Make, py::arg("executor"),
         py::arg("cardinalities"), "Creates a ComposingExecutor.");
   m.def("create_composing_executor", &CreateComposingExecutor,
-        py::arg("server"), py::arg("children"), "Creates a ComposingExecutor.");
+        py::arg("server"), py::arg("children"),
+        py::arg("memory_budget").none(true) = nullptr,
+        "Creates a ComposingExecutor.");
   m.def("create_remote_executor",
         py::overload_cast<std::shared_ptr<grpc::ChannelInterface>,
                           const CardinalityMap&>(&CreateRemoteExecutor),
@@ -153,6 +235,72 @@ PYBIND11_MODULE(executor_bindings, m) {
   m.def("create_sequence_executor", &CreateSequenceExecutor,
         py::arg("target_executor"), "Creates a SequenceExecutor.");
 
+  // Threading configuration.
+  m.def("set_default_thread_pool_size", &SetDefaultThreadPoolSize,
+        py::arg("num_threads"),
+        "Sets the number of threads kept by the process-wide default pool.");
+  m.def("get_default_thread_pool_size", &GetDefaultThreadPoolSize,
+        "Returns the number of threads kept by the process-wide default "
+        "pool.");
+
+  // Thread pool telemetry.
+  py::class_<HistogramSnapshot>(m, "HistogramSnapshot")
+      .def_readonly("bucket_limits", &HistogramSnapshot::bucket_limits)
+      .def_readonly("bucket_counts", &HistogramSnapshot::bucket_counts)
+      .def_readonly("count", &HistogramSnapshot::count)
+      .def_readonly("sum", &HistogramSnapshot::sum);
+  py::class_<ThreadPoolStatsSnapshot>(m, "ThreadPoolStats")
+      .def_readonly("name", &ThreadPoolStatsSnapshot::name)
+      .def_readonly("num_threads", &ThreadPoolStatsSnapshot::num_threads)
+      .def_readonly("scheduled_tasks",
+                    &ThreadPoolStatsSnapshot::scheduled_tasks)
+      .def_readonly("started_tasks", &ThreadPoolStatsSnapshot::started_tasks)
+      .def_readonly("completed_tasks",
+                    &ThreadPoolStatsSnapshot::completed_tasks)
+      .def_readonly("rejected_tasks", &ThreadPoolStatsSnapshot::rejected_tasks)
+      .def_readonly("queue_depth", &ThreadPoolStatsSnapshot::queue_depth)
+      .def_readonly("max_queue_depth",
+                    &ThreadPoolStatsSnapshot::max_queue_depth)
+      .def_readonly("active_workers", &ThreadPoolStatsSnapshot::active_workers)
+      .def_readonly("max_active_workers",
+                    &ThreadPoolStatsSnapshot::max_active_workers)
+      .def_readonly("queue_depth_histogram",
+                    &ThreadPoolStatsSnapshot::queue_depth_histogram)
+      .def_readonly("queue_time_us", &ThreadPoolStatsSnapshot::queue_time_us)
+      .def_readonly("run_time_us", &ThreadPoolStatsSnapshot::run_time_us)
+      .def("__repr__", [](const ThreadPoolStatsSnapshot& self) {
+        return absl::StrCat("<ThreadPoolStats ", self.name, ": threads=",
+                            self.num_threads, " queued=", self.queue_depth,
+                            " active=", self.active_workers, " completed=",
+                            self.completed_tasks, " rejected=",
+                            self.rejected_tasks, ">");
+      });
+  m.def("get_thread_pool_stats", &GetAllThreadPoolStats,
+        "Returns the telemetry of every thread pool name, sorted by name.");
+  m.def("reset_thread_pool_stats", &ResetAllThreadPoolStats,
+        "Resets the counters and histograms of every thread pool.");
+  m.def("set_thread_pool_stats_enabled", &SetThreadPoolStatsEnabled,
+        "Enables or disables recording of tasks by every thread pool. "
+        "Disabled by default; thread counts are always reported.");
+
+  // Executor method metrics.
+  py::class_<ExecutorMethodMetricsSnapshot>(m, "ExecutorMethodMetrics")
+      .def_readonly("executor_name",
+                    &ExecutorMethodMetricsSnapshot::executor_name)
+      .def_readonly("method_name", &ExecutorMethodMetricsSnapshot::method_name)
+      .def_readonly("calls", &ExecutorMethodMetricsSnapshot::calls)
+      .def_readonly("latency_us", &ExecutorMethodMetricsSnapshot::latency_us)
+      .def("__repr__", [](const ExecutorMethodMetricsSnapshot& self) {
+        return absl::StrCat("<ExecutorMethodMetrics ", self.executor_name,
+                            "::", self.method_name, ": calls=", self.calls,
+                            " total_us=", self.latency_us.sum, ">");
+      });
+  m.def("get_executor_method_metrics", &GetAllExecutorMethodMetrics,
+        "Returns the call counts and latencies of every executor method, "
+        "sorted by executor and method name.");
+  m.def("reset_executor_method_metrics", &ResetAllExecutorMethodMetrics,
+        "Resets the call counts and latencies of every executor method.");
+
   py::class_<grpc::ChannelInterface, std::shared_ptr<grpc::ChannelInterface>>(
       m, "GRPCChannelInterface");
 
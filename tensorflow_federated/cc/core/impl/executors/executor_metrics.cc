@@ -0,0 +1,134 @@
+/* Copyright 2026, The TensorFlow Federated Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+     http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License
+==============================================================================*/
+
+#include "tensorflow_federated/cc/core/impl/executors/executor_metrics.h"
+
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+#include "tensorflow_federated/cc/core/impl/base/thread_pool_stats.h"
+
+namespace tensorflow_federated {
+
+namespace {
+
+class ExecutorMethodMetricsRegistry {
+ public:
+  static ExecutorMethodMetricsRegistry& Get() {
+    // Intentionally leaked so that executors destroyed during static
+    // destruction can still report into their metrics.
+    static ExecutorMethodMetricsRegistry* registry =
+        new ExecutorMethodMetricsRegistry();
+    return *registry;
+  }
+
+  ExecutorMethodMetrics* GetOrCreate(absl::string_view executor_name,
+                                     absl::string_view method_name) {
+    absl::MutexLock lock(&mutex_);
+    std::unique_ptr<ExecutorMethodMetrics>& metrics =
+        metrics_[{std::string(executor_name), std::string(method_name)}];
+    if (metrics == nullptr) {
+      metrics =
+          std::make_unique<ExecutorMethodMetrics>(executor_name, method_name);
+    }
+    return metrics.get();
+  }
+
+  std::vector<ExecutorMethodMetricsSnapshot> SnapshotAll() {
+    absl::MutexLock lock(&mutex_);
+    std::vector<ExecutorMethodMetricsSnapshot> snapshots;
+    snapshots.reserve(metrics_.size());
+    for (const auto& [name, metrics] : metrics_) {
+      snapshots.push_back(metrics->Snapshot());
+    }
+    return snapshots;
+  }
+
+  void ResetAll() {
+    absl::MutexLock lock(&mutex_);
+    for (const auto& [name, metrics] : metrics_) {
+      metrics->Reset();
+    }
+  }
+
+ private:
+  absl::Mutex mutex_;
+  // Ordered so that snapshots are sorted by name.
+  std::map<std::pair<std::string, std::string>,
+           std::unique_ptr<ExecutorMethodMetrics>>
+      metrics_ ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace
+
+ExecutorMethodMetrics::ExecutorMethodMetrics(absl::string_view executor_name,
+                                             absl::string_view method_name)
+    : executor_name_(executor_name),
+      method_name_(method_name),
+      path_(absl::StrCat(executor_name, "::", method_name)) {}
+
+void ExecutorMethodMetrics::Record(absl::Duration latency) {
+  latency_us_.Record(absl::ToInt64Microseconds(latency));
+}
+
+ExecutorMethodMetricsSnapshot ExecutorMethodMetrics::Snapshot() const {
+  ExecutorMethodMetricsSnapshot snapshot;
+  snapshot.executor_name = executor_name_;
+  snapshot.method_name = method_name_;
+  snapshot.latency_us = latency_us_.Snapshot();
+  snapshot.calls = snapshot.latency_us.count;
+  return snapshot;
+}
+
+void ExecutorMethodMetrics::Reset() { latency_us_.Reset(); }
+
+ExecutorMethodMetrics* GetExecutorMethodMetrics(absl::string_view executor_name,
+                                                absl::string_view method_name) {
+  // Executor and method names are almost always string literals, so their
+  // addresses identify them. The names are still compared on a hit in case a
+  // caller reuses a buffer for a different name. The cached metrics are
+  // owned by the registry, so the cache is freed with its thread.
+  thread_local absl::flat_hash_map<std::pair<const char*, const char*>,
+                                   ExecutorMethodMetrics*>
+      cache;
+  auto [iter, inserted] =
+      cache.try_emplace({executor_name.data(), method_name.data()}, nullptr);
+  ExecutorMethodMetrics*& metrics = iter->second;
+  if (inserted || metrics->executor_name() != executor_name ||
+      metrics->method_name() != method_name) {
+    metrics = ExecutorMethodMetricsRegistry::Get().GetOrCreate(executor_name,
+                                                               method_name);
+  }
+  return metrics;
+}
+
+std::vector<ExecutorMethodMetricsSnapshot> GetAllExecutorMethodMetrics() {
+  return ExecutorMethodMetricsRegistry::Get().SnapshotAll();
+}
+
+void ResetAllExecutorMethodMetrics() {
+  ExecutorMethodMetricsRegistry::Get().ResetAll();
+}
+
+}  // namespace tensorflow_federated
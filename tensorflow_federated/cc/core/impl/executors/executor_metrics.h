@@ -0,0 +1,87 @@
+/* Copyright 2026, The TensorFlow Federated Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+     http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License
+==============================================================================*/
+
+#ifndef THIRD_PARTY_TENSORFLOW_FEDERATED_CC_CORE_IMPL_EXECUTORS_EXECUTOR_METRICS_H_
+#define THIRD_PARTY_TENSORFLOW_FEDERATED_CC_CORE_IMPL_EXECUTORS_EXECUTOR_METRICS_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "absl/strings/string_view.h"
+#include "absl/time/time.h"
+#include "tensorflow_federated/cc/core/impl/base/thread_pool_stats.h"
+
+namespace tensorflow_federated {
+
+// A point-in-time copy of an `ExecutorMethodMetrics`.
+struct ExecutorMethodMetricsSnapshot {
+  std::string executor_name;
+  std::string method_name;
+  // Number of completed calls.
+  int64_t calls = 0;
+  // Microseconds each call took.
+  HistogramSnapshot latency_us;
+};
+
+// Call counts and latencies of one method of one kind of executor (e.g.
+// `TensorFlowExecutor::CreateCall`), aggregated over all executor instances
+// reporting that name.
+//
+// Instances are interned by `GetExecutorMethodMetrics` and never destroyed, so
+// callers may hold on to the returned pointer. Recording is lock-free.
+class ExecutorMethodMetrics {
+ public:
+  ExecutorMethodMetrics(absl::string_view executor_name,
+                        absl::string_view method_name);
+
+  ExecutorMethodMetrics(const ExecutorMethodMetrics&) = delete;
+  ExecutorMethodMetrics& operator=(const ExecutorMethodMetrics&) = delete;
+
+  const std::string& executor_name() const { return executor_name_; }
+  const std::string& method_name() const { return method_name_; }
+  // "<executor_name>::<method_name>", e.g. for use as a trace name.
+  const std::string& path() const { return path_; }
+
+  void Record(absl::Duration latency);
+  ExecutorMethodMetricsSnapshot Snapshot() const;
+  void Reset();
+
+ private:
+  const std::string executor_name_;
+  const std::string method_name_;
+  const std::string path_;
+  Histogram latency_us_{/*base=*/4};
+};
+
+// Returns the process-wide metrics for `method_name` of executors named
+// `executor_name`, creating them if needed.
+//
+// Repeated lookups of the same names from the same thread are served from a
+// thread-local cache without locking, so this is cheap enough to call on every
+// executor method invocation.
+ExecutorMethodMetrics* GetExecutorMethodMetrics(absl::string_view executor_name,
+                                                absl::string_view method_name);
+
+// Returns snapshots of the metrics of every executor method called so far,
+// sorted by executor name and then method name.
+std::vector<ExecutorMethodMetricsSnapshot> GetAllExecutorMethodMetrics();
+
+// Resets the metrics of every executor method called so far.
+void ResetAllExecutorMethodMetrics();
+
+}  // namespace tensorflow_federated
+
+#endif  // THIRD_PARTY_TENSORFLOW_FEDERATED_CC_CORE_IMPL_EXECUTORS_EXECUTOR_METRICS_H_
@@ -0,0 +1,90 @@
+/* Copyright 2026, The TensorFlow Federated Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+     http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License
+==============================================================================*/
+
+#include "tensorflow_federated/cc/core/impl/executors/executor_metrics.h"
+
+#include <string>
+#include <vector>
+
+#include "googlemock/include/gmock/gmock.h"
+#include "googletest/include/gtest/gtest.h"
+#include "absl/time/time.h"
+
+namespace tensorflow_federated {
+
+namespace {
+
+TEST(ExecutorMetricsTest, InternsMetricsByName) {
+  ExecutorMethodMetrics* metrics =
+      GetExecutorMethodMetrics("InternExecutor", "CreateValue");
+  EXPECT_EQ(metrics->path(), "InternExecutor::CreateValue");
+  EXPECT_EQ(GetExecutorMethodMetrics("InternExecutor", "CreateValue"),
+            metrics);
+  // Equal names held in different buffers resolve to the same metrics.
+  std::string executor_name = "InternExecutor";
+  std::string method_name = "CreateValue";
+  EXPECT_EQ(GetExecutorMethodMetrics(executor_name, method_name), metrics);
+  EXPECT_NE(GetExecutorMethodMetrics("InternExecutor", "Materialize"),
+            metrics);
+}
+
+TEST(ExecutorMetricsTest, ReusedNameBufferIsNotConfused) {
+  std::string name = "FirstExecutor";
+  ExecutorMethodMetrics* first = GetExecutorMethodMetrics(name, "Dispose");
+  name = "OtherExecutor";
+  ExecutorMethodMetrics* other = GetExecutorMethodMetrics(name, "Dispose");
+  EXPECT_NE(first, other);
+  EXPECT_EQ(other->executor_name(), "OtherExecutor");
+}
+
+TEST(ExecutorMetricsTest, RecordsCallsAndLatency) {
+  ExecutorMethodMetrics* metrics =
+      GetExecutorMethodMetrics("RecordExecutor", "CreateCall");
+  metrics->Record(absl::Microseconds(3));
+  metrics->Record(absl::Milliseconds(2));
+  ExecutorMethodMetricsSnapshot snapshot = metrics->Snapshot();
+  EXPECT_EQ(snapshot.executor_name, "RecordExecutor");
+  EXPECT_EQ(snapshot.method_name, "CreateCall");
+  EXPECT_EQ(snapshot.calls, 2);
+  EXPECT_EQ(snapshot.latency_us.sum, 2003);
+}
+
+TEST(ExecutorMetricsTest, SnapshotAllIsSortedAndResettable) {
+  GetExecutorMethodMetrics("SortExecutorB", "CreateValue")
+      ->Record(absl::Microseconds(1));
+  GetExecutorMethodMetrics("SortExecutorA", "Materialize")
+      ->Record(absl::Microseconds(1));
+  GetExecutorMethodMetrics("SortExecutorA", "CreateValue")
+      ->Record(absl::Microseconds(1));
+  std::vector<std::string> paths;
+  for (const ExecutorMethodMetricsSnapshot& snapshot :
+       GetAllExecutorMethodMetrics()) {
+    if (snapshot.executor_name.rfind("SortExecutor", 0) == 0) {
+      paths.push_back(snapshot.executor_name + "::" + snapshot.method_name);
+    }
+  }
+  EXPECT_THAT(paths, ::testing::ElementsAre("SortExecutorA::CreateValue",
+                                            "SortExecutorA::Materialize",
+                                            "SortExecutorB::CreateValue"));
+  ResetAllExecutorMethodMetrics();
+  for (const ExecutorMethodMetricsSnapshot& snapshot :
+       GetAllExecutorMethodMetrics()) {
+    EXPECT_EQ(snapshot.calls, 0);
+  }
+}
+
+}  // namespace
+
+}  // namespace tensorflow_federated
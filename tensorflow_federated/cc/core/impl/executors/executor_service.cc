@@ -15,6 +15,7 @@ limitations under the License
 
 #include "tensorflow_federated/cc/core/impl/executors/executor_service.h"
 
+#include <cstdint>
 #include <memory>
 #include <optional>
 #include <string>
@@ -336,6 +337,41 @@ grpc::Status ExecutorService::Compute(grpc::ServerContext* context,
   return HandleNotOK(status, request->executor());
 }
 
+grpc::Status ExecutorService::ComputeClients(
+    grpc::ServerContext* context, const v0::ComputeClientsRequest* request,
+    grpc::ServerWriter<v0::ComputeClientsResponse>* writer) {
+  return ComputeClients(
+      context, request,
+      static_cast<grpc::ServerWriterInterface<v0::ComputeClientsResponse>*>(
+          writer));
+}
+
+grpc::Status ExecutorService::ComputeClients(
+    grpc::ServerContext* context, const v0::ComputeClientsRequest* request,
+    grpc::ServerWriterInterface<v0::ComputeClientsResponse>* writer) {
+  std::shared_ptr<Executor> executor;
+  TFF_TRYLOG_GRPC(
+      RequireExecutor("ComputeClients", request->executor(), executor));
+  ValueId requested_value;
+  TFF_TRYLOG_GRPC(RemoteValueToId(request->value_ref(), requested_value));
+  absl::Status status = executor->MaterializeClients(
+      requested_value, request->client_index(),
+      [writer](int32_t index, v0::Value client_pb) -> absl::Status {
+        v0::ComputeClientsResponse response;
+        response.set_client_index(index);
+        *response.mutable_value() = std::move(client_pb);
+        if (!writer->Write(response)) {
+          return absl::CancelledError(
+              "The stream of computed clients was closed by the caller.");
+        }
+        return absl::OkStatus();
+      });
+  if (status.ok()) {
+    return absl_to_grpc(status);
+  }
+  return HandleNotOK(status, request->executor());
+}
+
 grpc::Status ExecutorService::Dispose(grpc::ServerContext* context,
                                       const v0::DisposeRequest* request,
                                       v0::DisposeResponse* response) {
@@ -53,9 +53,10 @@ using ExecutorFactory = std::function<absl::StatusOr<std::shared_ptr<Executor>>(
 // immediately; this depends crucially on implementations of
 // `tensorflow_federated::Executor` respecting the same performance contract.
 //
-// `Compute` is the single method below which can block at the application
-// layer. It serves as a signal from the client that values need to be
-// materialized on the other side of the gRPC channel.
+// `Compute` and its streaming counterpart `ComputeClients` are the only methods
+// below which can block at the application layer. They serve as a signal from
+// the client that values need to be materialized on the other side of the gRPC
+// channel.
 //
 // Finally, `Dispose` serves as an explicit resource-management request;
 // `Dispose` tells the service that it can free any resources
@@ -108,6 +109,15 @@ class ExecutorService : public v0::ExecutorGroup::Service {
                        const v0::ComputeRequest* request,
                        v0::ComputeResponse* response) override;
 
+  // Materialize the requested clients of a clients-placed value on the client,
+  // writing each to `writer` as soon as it is available. Blocking.
+  grpc::Status ComputeClients(
+      grpc::ServerContext* context, const v0::ComputeClientsRequest* request,
+      grpc::ServerWriter<v0::ComputeClientsResponse>* writer) override;
+  grpc::Status ComputeClients(
+      grpc::ServerContext* context, const v0::ComputeClientsRequest* request,
+      grpc::ServerWriterInterface<v0::ComputeClientsResponse>* writer);
+
   // Free the resources associated to the embedded values specified.
   grpc::Status Dispose(grpc::ServerContext* context,
                        const v0::DisposeRequest* request,
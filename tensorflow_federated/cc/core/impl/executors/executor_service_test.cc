@@ -312,6 +312,47 @@ TEST_F(ExecutorServiceTest, ComputeFailedPreconditionDestroysExecutor) {
                            "No executor found for ID"));
 }
 
+// Records the responses written by `ExecutorService::ComputeClients`.
+class FakeComputeClientsWriter
+    : public grpc::ServerWriterInterface<v0::ComputeClientsResponse> {
+ public:
+  using grpc::ServerWriterInterface<v0::ComputeClientsResponse>::Write;
+  void SendInitialMetadata() override {}
+  bool Write(const v0::ComputeClientsResponse& response,
+             grpc::WriteOptions options) override {
+    responses.push_back(response);
+    return true;
+  }
+
+  std::vector<v0::ComputeClientsResponse> responses;
+};
+
+TEST_F(ExecutorServiceTest, ComputeClientsWritesRequestedClients) {
+  v0::ComputeClientsRequest request_pb;
+  *request_pb.mutable_executor() = executor_pb_;
+  request_pb.mutable_value_ref()->set_id("0");
+  request_pb.add_client_index(2);
+  request_pb.add_client_index(0);
+  grpc::ServerContext server_context;
+  FakeComputeClientsWriter writer;
+
+  v0::Value clients_pb = testing::ClientsV(
+      {testing::TensorV(1.0f), testing::TensorV(2.0f), testing::TensorV(3.0f)});
+  EXPECT_CALL(*executor_ptr_, Materialize(0, ::testing::_))
+      .WillOnce(::testing::DoAll(::testing::SetArgPointee<1>(clients_pb),
+                                 ::testing::Return(absl::OkStatus())));
+
+  TFF_ASSERT_OK(grpc_to_absl(
+      executor_service_.ComputeClients(&server_context, &request_pb, &writer)));
+  ASSERT_EQ(writer.responses.size(), 2);
+  EXPECT_EQ(writer.responses[0].client_index(), 2);
+  EXPECT_THAT(writer.responses[0].value(),
+              testing::EqualsProto(testing::TensorV(3.0f)));
+  EXPECT_EQ(writer.responses[1].client_index(), 0);
+  EXPECT_THAT(writer.responses[1].value(),
+              testing::EqualsProto(testing::TensorV(1.0f)));
+}
+
 TEST_F(ExecutorServiceTest, GetExecutorReturnsCardinalitySpecificIds) {
   grpc::ServerContext context;
 
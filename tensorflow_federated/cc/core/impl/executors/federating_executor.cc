@@ -15,9 +15,11 @@ limitations under the License
 
 #include "tensorflow_federated/cc/core/impl/executors/federating_executor.h"
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
 #include <memory>
+#include <numeric>
 #include <optional>
 #include <utility>
 #include <variant>
@@ -27,6 +29,7 @@ limitations under the License
 #include "absl/base/thread_annotations.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
+#include "absl/functional/function_ref.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
@@ -39,6 +42,7 @@ limitations under the License
 #include "tensorflow_federated/cc/core/impl/executors/cardinalities.h"
 #include "tensorflow_federated/cc/core/impl/executors/executor.h"
 #include "tensorflow_federated/cc/core/impl/executors/federated_intrinsics.h"
+#include "tensorflow_federated/cc/core/impl/executors/memory_budget.h"
 #include "tensorflow_federated/cc/core/impl/executors/status_macros.h"
 #include "tensorflow_federated/cc/core/impl/executors/threading.h"
 #include "tensorflow_federated/cc/core/impl/executors/value_validation.h"
@@ -62,15 +66,25 @@ inline std::shared_ptr<OwnedValueId> ShareValueId(OwnedValueId&& id) {
 // (3) both.
 class UnplacedInner {
  public:
-  explicit UnplacedInner(std::shared_ptr<v0::Value> proto)
-      : proto_(std::move(proto)) {}
-  explicit UnplacedInner(v0::Value proto)
-      : proto_(std::make_shared<v0::Value>(std::move(proto))) {}
+  // The bytes of the proto representation, once it exists, are charged to
+  // `memory_budget` for the lifetime of this value.
+  UnplacedInner(std::shared_ptr<v0::Value> proto,
+                std::shared_ptr<MemoryBudget> memory_budget)
+      : memory_budget_(std::move(memory_budget)),
+        proto_charge_(memory_budget_->Charge(proto->ByteSizeLong())),
+        proto_(std::move(proto)) {}
+  UnplacedInner(v0::Value proto, std::shared_ptr<MemoryBudget> memory_budget)
+      : UnplacedInner(std::make_shared<v0::Value>(std::move(proto)),
+                      std::move(memory_budget)) {}
 
-  explicit UnplacedInner(std::shared_ptr<OwnedValueId> embedded)
-      : embedded_(std::move(embedded)) {}
-  explicit UnplacedInner(OwnedValueId embedded)
-      : embedded_(std::make_shared<OwnedValueId>(std::move(embedded))) {}
+  UnplacedInner(std::shared_ptr<OwnedValueId> embedded,
+                std::shared_ptr<MemoryBudget> memory_budget)
+      : memory_budget_(std::move(memory_budget)),
+        embedded_(std::move(embedded)) {}
+  UnplacedInner(OwnedValueId embedded,
+                std::shared_ptr<MemoryBudget> memory_budget)
+      : memory_budget_(std::move(memory_budget)),
+        embedded_(std::make_shared<OwnedValueId>(std::move(embedded))) {}
 
   // NOTE: all constructors must set `proto` or optionally `embedded` value.
   // Internals assume that proto value is set.
@@ -103,6 +117,8 @@ class UnplacedInner {
       auto proto_or_status =
           server.Materialize(embedded_.value().value()->ref());
       if (proto_or_status.ok()) {
+        proto_charge_ =
+            memory_budget_->Charge(proto_or_status.value().ByteSizeLong());
         proto_ =
             std::make_shared<v0::Value>(std::move(proto_or_status.value()));
       } else {
@@ -159,7 +175,9 @@ class UnplacedInner {
     }
   }
 
+  const std::shared_ptr<MemoryBudget> memory_budget_;
   absl::Mutex mutex_;
+  std::shared_ptr<const MemoryCharge> proto_charge_ ABSL_GUARDED_BY(mutex_);
   std::optional<absl::StatusOr<std::shared_ptr<v0::Value>>> proto_
       ABSL_GUARDED_BY(mutex_);
   std::optional<absl::StatusOr<std::shared_ptr<OwnedValueId>>> embedded_
@@ -181,6 +199,15 @@ inline Clients NewClients(uint32_t num_clients) {
   return v;
 }
 
+// Wraps each of `ids` for sharing as the per-client values of a `Clients`.
+inline Clients ShareClientValueIds(std::vector<OwnedValueId>&& ids) {
+  Clients clients = NewClients(ids.size());
+  for (OwnedValueId& id : ids) {
+    clients->emplace_back(ShareValueId(std::move(id)));
+  }
+  return clients;
+}
+
 inline Structure NewStructure() {
   return std::make_shared<std::vector<ExecutorValue>>();
 }
@@ -204,6 +231,18 @@ class ExecutorValue {
   inline static ExecutorValue CreateClientsPlaced(Clients client_values) {
     return ExecutorValue(std::move(client_values), ValueType::CLIENTS);
   }
+  // A clients-placed value which holds the same value for every client, e.g.
+  // the result of `federated_broadcast`. `client_values` must not be empty,
+  // and all of its elements must be the same value. Such a value can be zipped
+  // with a value of fewer clients, e.g. one restricted by
+  // `CreateClientsSubset`.
+  inline static ExecutorValue CreateClientsPlacedAllEqual(
+      Clients client_values) {
+    ExecutorValue value(std::move(client_values), ValueType::CLIENTS);
+    value.clients_all_equal_ = true;
+    return value;
+  }
+  inline bool clients_all_equal() const { return clients_all_equal_; }
   // Convenience constructor from an un-shared_ptr vector.
   inline static ExecutorValue CreateClientsPlaced(
       std::vector<std::shared_ptr<OwnedValueId>>&& client_values) {
@@ -246,6 +285,7 @@ class ExecutorValue {
   ExecutorValue() = delete;
   ValueVariant value_;
   ValueType type_;
+  bool clients_all_equal_ = false;
 };
 
 absl::Status CheckLenForUseAsArgument(const ExecutorValue& value,
@@ -265,10 +305,14 @@ class FederatingExecutor : public ExecutorBase<ExecutorValue> {
  public:
   explicit FederatingExecutor(std::shared_ptr<Executor> server_child,
                               std::shared_ptr<Executor> client_child,
-                              uint32_t num_clients)
+                              uint32_t num_clients,
+                              std::shared_ptr<MemoryBudget> memory_budget,
+                              int32_t aggregate_partitions)
       : server_child_(server_child),
         client_child_(client_child),
-        num_clients_(num_clients) {}
+        num_clients_(num_clients),
+        memory_budget_(std::move(memory_budget)),
+        aggregate_partitions_(aggregate_partitions) {}
   ~FederatingExecutor() override {
     // We must make sure to delete all of our OwnedValueIds, releasing them from
     // the child executor as well, before deleting the child executor.
@@ -279,6 +323,10 @@ class FederatingExecutor : public ExecutorBase<ExecutorValue> {
   std::shared_ptr<Executor> server_child_;
   std::shared_ptr<Executor> client_child_;
   uint32_t num_clients_;
+  // Charged with the unplaced value protos held by this executor.
+  std::shared_ptr<MemoryBudget> memory_budget_;
+  // Number of independent `accumulate` chains of a `federated_aggregate`.
+  const int32_t aggregate_partitions_;
 
   absl::string_view ExecutorName() final {
     static constexpr absl::string_view kExecutorName = "FederatingExecutor";
@@ -291,9 +339,12 @@ class FederatingExecutor : public ExecutorBase<ExecutorValue> {
     // `num_clients_` non-all-equal references to the same value. This
     // prevents optimization of the uncommon "materialize a broadcasted
     // value" case, but allows for simpler handling of values throughout.
-    return ExecutorValue::CreateClientsPlaced(
-        std::make_shared<std::vector<std::shared_ptr<OwnedValueId>>>(
-            num_clients_, value));
+    auto clients = std::make_shared<std::vector<std::shared_ptr<OwnedValueId>>>(
+        num_clients_, value);
+    if (clients->empty()) {
+      return ExecutorValue::CreateClientsPlaced(std::move(clients));
+    }
+    return ExecutorValue::CreateClientsPlacedAllEqual(std::move(clients));
   }
 
   Clients NewClients() {
@@ -324,6 +375,18 @@ class FederatingExecutor : public ExecutorBase<ExecutorValue> {
   bool is_server_child(Executor* child) const {
     return child == server_child_.get();
   }
+  // Returns `server_val`, a value of the server child, as a value of the
+  // client child. When both children are the same executor the value id is
+  // shared; otherwise the value is copied through a proto.
+  absl::StatusOr<std::shared_ptr<OwnedValueId>> ServerValueToClients(
+      std::shared_ptr<OwnedValueId> server_val) {
+    if (is_server_child(client_child_.get())) {
+      return server_val;
+    }
+    v0::Value value_pb;
+    TFF_TRY(server_child_->Materialize(server_val->ref(), &value_pb));
+    return ShareValueId(TFF_TRY(client_child_->CreateValue(value_pb)));
+  }
   absl::StatusOr<std::shared_ptr<OwnedValueId>> Embed(
       const ExecutorValue& value, std::shared_ptr<Executor> child) {
     switch (value.type()) {
@@ -398,13 +461,16 @@ class FederatingExecutor : public ExecutorBase<ExecutorValue> {
         ABSL_FALLTHROUGH_INTENDED;
       default: {
         return ExecutorValue::CreateUnplaced(
-            std::make_shared<UnplacedInner>(value_pb));
+            std::make_shared<UnplacedInner>(value_pb, memory_budget_));
       }
     }
   }
 
   absl::StatusOr<ExecutorValue> CreateCall(
       ExecutorValue function, std::optional<ExecutorValue> argument) final {
+    // Blocks the caller while over the high-water mark; see
+    // `CreateFederatingExecutor`.
+    memory_budget_->WaitForCapacity();
     switch (function.type()) {
       case ExecutorValue::ValueType::CLIENTS:
       case ExecutorValue::ValueType::SERVER: {
@@ -423,7 +489,8 @@ class FederatingExecutor : public ExecutorBase<ExecutorValue> {
           arg_id = arg_owner.value()->ref();
         }
         return ExecutorValue::CreateUnplaced(std::make_shared<UnplacedInner>(
-            ShareValueId(TFF_TRY(server_child_->CreateCall(fn_id, arg_id)))));
+            ShareValueId(TFF_TRY(server_child_->CreateCall(fn_id, arg_id))),
+            memory_budget_));
       }
       case ExecutorValue::ValueType::INTRINSIC: {
         if (!argument.has_value()) {
@@ -466,27 +533,51 @@ class FederatingExecutor : public ExecutorBase<ExecutorValue> {
   }
 
   // Embeds `arg` containing structures of client-placed values into the
-  // `child_` executor. The resulting structure on `child_` will contain all
-  // values for the client corresponding to `client_index`.
-  absl::StatusOr<std::shared_ptr<OwnedValueId>> ZipStructIntoClient(
-      const ExecutorValue& arg, uint32_t client_index) {
+  // `client_child_` executor. The result holds, for each client, a structure on
+  // `client_child_` containing all values for that client. Each level of
+  // nesting is created with a single `CreateStructBatch` over all clients.
+  absl::StatusOr<ExecutorValue> ZipStructIntoClients(const ExecutorValue& arg) {
     switch (arg.type()) {
       case ExecutorValue::ValueType::CLIENTS: {
-        return (*arg.clients())[client_index];
+        return arg;
       }
       case ExecutorValue::ValueType::STRUCTURE: {
-        std::vector<std::shared_ptr<OwnedValueId>> owned_element_ids;
-        owned_element_ids.reserve(arg.structure()->size());
+        std::vector<ExecutorValue> zipped_elements;
+        zipped_elements.reserve(arg.structure()->size());
         for (const auto& element : *arg.structure()) {
-          owned_element_ids.push_back(
-              TFF_TRY(ZipStructIntoClient(element, client_index)));
+          zipped_elements.push_back(TFF_TRY(ZipStructIntoClients(element)));
         }
-        std::vector<ValueId> element_ids;
-        element_ids.reserve(arg.structure()->size());
-        for (const auto& owned_id : owned_element_ids) {
-          element_ids.push_back(owned_id->ref());
+        // Values restricted by `CreateClientsSubset` hold fewer clients, and
+        // can only be zipped with values restricted to the same clients, or
+        // with all-equal values (e.g. a broadcast), whose value is zipped with
+        // each of the restricted clients.
+        size_t num_clients = num_clients_;
+        for (const ExecutorValue& element : zipped_elements) {
+          if (!element.clients_all_equal()) {
+            num_clients = element.clients()->size();
+            break;
+          }
+        }
+        for (const ExecutorValue& element : zipped_elements) {
+          const size_t element_clients = element.clients()->size();
+          if (element_clients != num_clients && !element.clients_all_equal()) {
+            return absl::InvalidArgumentError(absl::StrCat(
+                "Cannot `", kFederatedZipAtClientsUri, "` values of ",
+                num_clients, " and ", element_clients, " clients"));
+          }
+        }
+        std::vector<std::vector<ValueId>> element_ids_per_client(num_clients);
+        for (size_t i = 0; i < num_clients; i++) {
+          element_ids_per_client[i].reserve(zipped_elements.size());
+          for (const ExecutorValue& element : zipped_elements) {
+            const Clients& clients = element.clients();
+            const auto& client =
+                element.clients_all_equal() ? clients->front() : clients->at(i);
+            element_ids_per_client[i].push_back(client->ref());
+          }
         }
-        return ShareValueId(TFF_TRY(client_child_->CreateStruct(element_ids)));
+        return ExecutorValue::CreateClientsPlaced(ShareClientValueIds(
+            TFF_TRY(client_child_->CreateStructBatch(element_ids_per_client))));
       }
       default: {
         return absl::InvalidArgumentError(absl::StrCat(
@@ -513,12 +604,10 @@ class FederatingExecutor : public ExecutorBase<ExecutorValue> {
       }
       case FederatedIntrinsic::EVAL_AT_CLIENTS: {
         auto embedded = TFF_TRY(Embed(arg, client_child_));
-        Clients client_values = NewClients();
-        for (int i = 0; i < num_clients_; i++) {
-          client_values->emplace_back(ShareValueId(TFF_TRY(
-              client_child_->CreateCall(embedded->ref(), std::nullopt))));
-        }
-        return ExecutorValue::CreateClientsPlaced(std::move(client_values));
+        std::vector<CallArgs> calls(num_clients_,
+                                    CallArgs{embedded->ref(), std::nullopt});
+        return ExecutorValue::CreateClientsPlaced(ShareClientValueIds(
+            TFF_TRY(client_child_->CreateCallBatch(calls))));
       }
       case FederatedIntrinsic::AGGREGATE: {
         auto traceme = Trace("CallFederatedAggregate");
@@ -537,27 +626,77 @@ class FederatingExecutor : public ExecutorBase<ExecutorValue> {
           return absl::InvalidArgumentError(
               "Failed to get accumulate function.");
         }
-        // `merge` is unused (argument four).
         const auto& report = arg.structure()->at(4);
         auto report_child_id = TFF_TRY(Embed(report, server_child_));
         TFF_TRY(value.CheckArgumentType(ExecutorValue::ValueType::CLIENTS,
                                         "`federated_aggregate`'s `value`"));
-        std::optional<OwnedValueId> current_owner = std::nullopt;
+        const std::vector<std::shared_ptr<OwnedValueId>>& client_vals =
+            *value.clients();
+        const size_t num_partitions = std::clamp<size_t>(
+            aggregate_partitions_, 1, std::max<size_t>(client_vals.size(), 1));
         auto zero_val_id_owner = TFF_TRY(client_child_->CreateValue(zero_val));
-        ValueId current = zero_val_id_owner.ref();
         auto accumulate_child_id = TFF_TRY(
             client_child_->CreateValue(*(accumulate_val_or.value()->get())));
-        for (const auto& client_val_id : *value.clients()) {
-          auto acc_arg = TFF_TRY(
-              client_child_->CreateStruct({current, client_val_id->ref()}));
-          current_owner =
-              TFF_TRY(client_child_->CreateCall(accumulate_child_id, acc_arg));
-          current = current_owner.value().ref();
+        // Each contiguous partition of the clients is folded into its own
+        // chain of `accumulate` calls starting from `zero`, so that the
+        // partitions run in parallel in the child.
+        std::vector<OwnedValueId> partial_owners;
+        std::vector<ValueId> partials;
+        partials.reserve(num_partitions);
+        for (size_t p = 0; p < num_partitions; ++p) {
+          std::optional<OwnedValueId> current_owner = std::nullopt;
+          ValueId current = zero_val_id_owner.ref();
+          const size_t end = (p + 1) * client_vals.size() / num_partitions;
+          for (size_t i = p * client_vals.size() / num_partitions; i < end;
+               ++i) {
+            auto acc_arg = TFF_TRY(client_child_->CreateStruct(
+                {current, client_vals[i]->ref()}));
+            current_owner = TFF_TRY(
+                client_child_->CreateCall(accumulate_child_id, acc_arg));
+            current = current_owner.value().ref();
+          }
+          partials.push_back(current);
+          if (current_owner.has_value()) {
+            partial_owners.push_back(std::move(current_owner).value());
+          }
+        }
+        // The partial results are combined with `merge` in a balanced tree.
+        // Only adjacent results are merged, which keeps the clients' order.
+        if (partials.size() > 1) {
+          const auto& merge = arg.structure()->at(3);
+          auto merge_val_or = merge.unplaced()->GetProto();
+          if (!merge_val_or.has_value()) {
+            return absl::InvalidArgumentError("Failed to get merge function.");
+          }
+          auto merge_child_id = TFF_TRY(
+              client_child_->CreateValue(*(merge_val_or.value()->get())));
+          while (partials.size() > 1) {
+            std::vector<ValueId> merged;
+            merged.reserve((partials.size() + 1) / 2);
+            for (size_t i = 0; i + 1 < partials.size(); i += 2) {
+              auto merge_arg = TFF_TRY(
+                  client_child_->CreateStruct({partials[i], partials[i + 1]}));
+              auto merged_owner =
+                  TFF_TRY(client_child_->CreateCall(merge_child_id, merge_arg));
+              merged.push_back(merged_owner.ref());
+              partial_owners.push_back(std::move(merged_owner));
+            }
+            if (partials.size() % 2 == 1) {
+              merged.push_back(partials.back());
+            }
+            partials = std::move(merged);
+          }
+        }
+        // The aggregate is copied to the server child through a proto, unless
+        // both children are the same executor.
+        std::optional<OwnedValueId> server_res_owner = std::nullopt;
+        ValueId res = partials.front();
+        if (!is_server_child(client_child_.get())) {
+          v0::Value result_val;
+          TFF_TRY(client_child_->Materialize(res, &result_val));
+          server_res_owner = TFF_TRY(server_child_->CreateValue(result_val));
+          res = server_res_owner.value().ref();
         }
-        v0::Value result_val;
-        TFF_TRY(client_child_->Materialize(current, &result_val));
-
-        auto res = TFF_TRY(server_child_->CreateValue(result_val));
         auto result =
             TFF_TRY(server_child_->CreateCall(report_child_id->ref(), res));
         return ExecutorValue::CreateServerPlaced(
@@ -567,10 +706,8 @@ class FederatingExecutor : public ExecutorBase<ExecutorValue> {
         auto traceme = Trace("CallFederatedBroadcast");
         TFF_TRY(arg.CheckArgumentType(ExecutorValue::ValueType::SERVER,
                                       "`federated_broadcast`"));
-        v0::Value server_val;
-        TFF_TRY(server_child_->Materialize(arg.server()->ref(), &server_val));
         return ClientsAllEqualValue(
-            ShareValueId(TFF_TRY(client_child_->CreateValue(server_val))));
+            TFF_TRY(ServerValueToClients(arg.server())));
       }
       case FederatedIntrinsic::MAP: {
         auto traceme = Trace("CallFederatedMap");
@@ -593,14 +730,13 @@ class FederatingExecutor : public ExecutorBase<ExecutorValue> {
           }
           auto child_fn = TFF_TRY(
               client_child_->CreateValue(*(child_fn_val.value()->get())));
-          Clients results = NewClients();
-          for (int i = 0; i < num_clients_; i++) {
-            auto client_arg = data.clients()->at(i)->ref();
-            auto result =
-                TFF_TRY(client_child_->CreateCall(child_fn, client_arg));
-            results->emplace_back(ShareValueId(std::move(result)));
+          std::vector<CallArgs> calls;
+          calls.reserve(data.clients()->size());
+          for (const std::shared_ptr<OwnedValueId>& client : *data.clients()) {
+            calls.push_back({child_fn.ref(), client->ref()});
           }
-          return ExecutorValue::CreateClientsPlaced(std::move(results));
+          return ExecutorValue::CreateClientsPlaced(ShareClientValueIds(
+              TFF_TRY(client_child_->CreateCallBatch(calls))));
         } else if (data.type() == ExecutorValue::ValueType::SERVER) {
           auto child_fn = TFF_TRY(Embed(fn, server_child_));
           auto res = TFF_TRY(
@@ -636,11 +772,7 @@ class FederatingExecutor : public ExecutorBase<ExecutorValue> {
       }
       case FederatedIntrinsic::ZIP_AT_CLIENTS: {
         auto traceme = Trace("CallIntrinsicZipClients");
-        Clients results = NewClients();
-        for (uint32_t i = 0; i < num_clients_; i++) {
-          results->push_back(TFF_TRY(ZipStructIntoClient(arg, i)));
-        }
-        return ExecutorValue::CreateClientsPlaced(std::move(results));
+        return ZipStructIntoClients(arg);
       }
       case FederatedIntrinsic::ZIP_AT_SERVER: {
         auto traceme = Trace("CallIntrinsicZipServer");
@@ -664,83 +796,117 @@ class FederatingExecutor : public ExecutorBase<ExecutorValue> {
       const Clients& keys_child_ids, ValueId server_val_child_id,
       ValueId select_fn_child_id) {
     KeyData keys = TFF_TRY(MaterializeKeys(keys_child_ids));
-    absl::flat_hash_map<int32_t, OwnedValueId> slice_for_key;
-    slice_for_key.reserve(keys.all.size());
-    for (int32_t key : keys.all) {
-      slice_for_key.insert(
-          {key, TFF_TRY(SelectSliceForKey(key, server_val_child_id,
-                                          select_fn_child_id))});
+    // The slice of each unique key is selected once, by a single batch of
+    // calls, and shared by every client requesting the key.
+    std::vector<int32_t> unique_keys(keys.all.begin(), keys.all.end());
+    std::vector<OwnedValueId> key_ids;
+    key_ids.reserve(unique_keys.size());
+    std::vector<std::vector<ValueId>> select_args;
+    select_args.reserve(unique_keys.size());
+    for (int32_t key : unique_keys) {
+      key_ids.push_back(TFF_TRY(server_child_->CreateValue(KeyValue(key))));
+      select_args.push_back({server_val_child_id, key_ids.back().ref()});
+    }
+    std::vector<OwnedValueId> select_arg_ids =
+        TFF_TRY(server_child_->CreateStructBatch(select_args));
+    std::vector<CallArgs> select_calls;
+    select_calls.reserve(select_arg_ids.size());
+    for (const OwnedValueId& select_arg_id : select_arg_ids) {
+      select_calls.push_back({select_fn_child_id, select_arg_id.ref()});
+    }
+    std::vector<OwnedValueId> slices =
+        TFF_TRY(server_child_->CreateCallBatch(select_calls));
+    absl::flat_hash_map<int32_t, ValueId> slice_for_key;
+    slice_for_key.reserve(unique_keys.size());
+    for (size_t i = 0; i < unique_keys.size(); ++i) {
+      slice_for_key.insert({unique_keys[i], slices[i].ref()});
     }
     v0::Value args_into_sequence_pb;
     args_into_sequence_pb.mutable_computation()->mutable_intrinsic()->set_uri(
         "args_into_sequence");
     OwnedValueId args_into_sequence_id =
         TFF_TRY(server_child_->CreateValue(args_into_sequence_pb));
-    Clients client_datasets = NewClients();
-    for (const auto& keys_for_client : keys.for_clients) {
-      std::vector<ValueId> slice_ids_for_client;
+    // The sequences of all clients are built by one batch of calls in the
+    // server child.
+    std::vector<std::vector<ValueId>> slice_ids_per_client;
+    slice_ids_per_client.reserve(keys.for_clients.size());
+    for (const std::vector<int32_t>& keys_for_client : keys.for_clients) {
+      std::vector<ValueId>& slice_ids_for_client =
+          slice_ids_per_client.emplace_back();
       slice_ids_for_client.reserve(keys_for_client.size());
       for (int32_t key : keys_for_client) {
-        slice_ids_for_client.push_back(slice_for_key.at(key).ref());
+        slice_ids_for_client.push_back(slice_for_key.at(key));
       }
-      OwnedValueId slices =
-          TFF_TRY(server_child_->CreateStruct(slice_ids_for_client));
-      OwnedValueId dataset =
-          TFF_TRY(server_child_->CreateCall(args_into_sequence_id, slices));
-      v0::Value dataset_pb;
-      TFF_TRY(server_child_->Materialize(dataset.ref(), &dataset_pb));
-      client_datasets->push_back(
-          ShareValueId(TFF_TRY(client_child_->CreateValue(dataset_pb))));
     }
+    std::vector<OwnedValueId> slices_per_client =
+        TFF_TRY(server_child_->CreateStructBatch(slice_ids_per_client));
+    std::vector<CallArgs> dataset_calls;
+    dataset_calls.reserve(slices_per_client.size());
+    for (const OwnedValueId& slices_for_client : slices_per_client) {
+      dataset_calls.push_back(
+          {args_into_sequence_id.ref(), slices_for_client.ref()});
+    }
+    std::vector<OwnedValueId> datasets =
+        TFF_TRY(server_child_->CreateCallBatch(dataset_calls));
+    Clients client_datasets =
+        std::make_shared<std::vector<std::shared_ptr<OwnedValueId>>>(
+            datasets.size());
+    TFF_TRY(ParallelFor(datasets.size(), [&](size_t i) -> absl::Status {
+      (*client_datasets)[i] =
+          TFF_TRY(ServerValueToClients(ShareValueId(std::move(datasets[i]))));
+      return absl::OkStatus();
+    }));
     return ExecutorValue::CreateClientsPlaced(std::move(client_datasets));
   }
 
   absl::StatusOr<KeyData> MaterializeKeys(const Clients& keys_child_ids) {
     KeyData keys;
-    keys.for_clients.reserve(keys_child_ids->size());
-    for (const auto& keys_child_id : *keys_child_ids) {
-      // TODO: b/209504748 - Make federating_executor value a future so that
-      // these materialize calls don't block.
-      v0::Value keys_for_client_pb =
-          TFF_TRY(client_child_->Materialize(keys_child_id->ref()));
-      federated_language::Array array_pb = keys_for_client_pb.array();
-      if (array_pb.dtype() != federated_language::DataType::DT_INT32) {
-        return absl::InvalidArgumentError(
-            absl::StrCat("Expected int32_t key, found key of tensor dtype ",
-                         array_pb.dtype()));
-      }
-      if (array_pb.shape().dim().size() != 1) {
-        return absl::InvalidArgumentError(absl::StrCat(
-            "Expected key tensor to be rank one, but found tensor of rank ",
-            array_pb.shape().dim().size()));
-      }
-      int64_t num_keys = array_pb.shape().dim()[0];
-      std::vector<int32_t> keys_for_client;
-      keys_for_client.reserve(num_keys);
-      auto keys_for_client_eigen = array_pb.int32_list().value();
-      for (int64_t i = 0; i < num_keys; i++) {
-        int32_t key = keys_for_client_eigen[i];
-        keys_for_client.push_back(key);
-        keys.all.insert(key);
-      }
-      keys.for_clients.push_back(std::move(keys_for_client));
+    keys.for_clients.resize(keys_child_ids->size());
+    // The keys of the clients are materialized and checked in parallel.
+    TFF_TRY(ParallelFor(keys_child_ids->size(), [&](size_t i) {
+      return MaterializeKeysForClient(keys_child_ids->at(i)->ref(),
+                                      &keys.for_clients[i]);
+    }));
+    for (const std::vector<int32_t>& keys_for_client : keys.for_clients) {
+      keys.all.insert(keys_for_client.begin(), keys_for_client.end());
     }
     return keys;
   }
 
-  absl::StatusOr<OwnedValueId> SelectSliceForKey(int32_t key,
-                                                 ValueId server_val_child_id,
-                                                 ValueId select_fn_child_id) {
+  absl::Status MaterializeKeysForClient(ValueId keys_child_id,
+                                        std::vector<int32_t>* keys_for_client) {
+    v0::Value keys_for_client_pb =
+        TFF_TRY(client_child_->Materialize(keys_child_id));
+    const federated_language::Array& array_pb = keys_for_client_pb.array();
+    if (array_pb.dtype() != federated_language::DataType::DT_INT32) {
+      return absl::InvalidArgumentError(
+          absl::StrCat("Expected int32_t key, found key of tensor dtype ",
+                       array_pb.dtype()));
+    }
+    if (array_pb.shape().dim().size() != 1) {
+      return absl::InvalidArgumentError(absl::StrCat(
+          "Expected key tensor to be rank one, but found tensor of rank ",
+          array_pb.shape().dim().size()));
+    }
+    const int64_t num_keys = array_pb.shape().dim()[0];
+    const auto& keys_pb = array_pb.int32_list().value();
+    if (keys_pb.size() != num_keys) {
+      return absl::InvalidArgumentError(absl::StrCat(
+          "Expected key tensor of shape [", num_keys, "] to hold ", num_keys,
+          " keys, but found ", keys_pb.size()));
+    }
+    keys_for_client->assign(keys_pb.begin(), keys_pb.end());
+    return absl::OkStatus();
+  }
+
+  static v0::Value KeyValue(int32_t key) {
     federated_language::Array array_pb;
     array_pb.set_dtype(federated_language::DataType::DT_INT32);
     array_pb.mutable_shape();
     array_pb.mutable_int32_list()->add_value(key);
     v0::Value key_pb;
     *key_pb.mutable_array() = array_pb;
-    OwnedValueId key_id = TFF_TRY(server_child_->CreateValue(key_pb));
-    OwnedValueId arg_id =
-        TFF_TRY(server_child_->CreateStruct({server_val_child_id, key_id}));
-    return TFF_TRY(server_child_->CreateCall(select_fn_child_id, arg_id));
+    return key_pb;
   }
 
   absl::StatusOr<ExecutorValue> CreateStruct(
@@ -758,9 +924,10 @@ class FederatingExecutor : public ExecutorBase<ExecutorValue> {
       }
       case ExecutorValue::ValueType::UNPLACED: {
         auto id = TFF_TRY(value.unplaced()->Embedded(*server_child_));
-        return ExecutorValue::CreateUnplaced(
-            std::make_shared<UnplacedInner>(ShareValueId(
-                TFF_TRY(server_child_->CreateSelection(id->ref(), index)))));
+        return ExecutorValue::CreateUnplaced(std::make_shared<UnplacedInner>(
+            ShareValueId(
+                TFF_TRY(server_child_->CreateSelection(id->ref(), index))),
+            memory_budget_));
       }
       case ExecutorValue::ValueType::INTRINSIC: {
         return absl::InvalidArgumentError("Cannot select from intrinsic");
@@ -842,9 +1009,102 @@ class FederatingExecutor : public ExecutorBase<ExecutorValue> {
   absl::Status Materialize(ExecutorValue value, v0::Value* value_pb) override {
     ParallelTasks tasks;
     TFF_TRY(CreateMaterializeTasks(value, value_pb, tasks));
-    TFF_TRY(tasks.WaitAll());
+    // Once one client fails the result is an error, so skip the remaining
+    // per-client materializations.
+    TFF_TRY(tasks.WaitAllFailFast());
     return absl::OkStatus();
   }
+
+  absl::Status MaterializeSequenceChunks(
+      ExecutorValue value, int32_t chunk_size,
+      absl::FunctionRef<absl::Status(v0::Value::Sequence)> consume) override {
+    switch (value.type()) {
+      case ExecutorValue::ValueType::UNPLACED: {
+        // A sequence that was never embedded is split from its proto. Once
+        // embedded, it is streamed from the server child.
+        std::optional<absl::StatusOr<std::shared_ptr<v0::Value>>> proto =
+            value.unplaced()->GetProto();
+        if (proto.has_value()) {
+          std::shared_ptr<v0::Value> value_pb = TFF_TRY(std::move(*proto));
+          return ConsumeSequenceInChunks(*value_pb, chunk_size, consume);
+        }
+        std::shared_ptr<OwnedValueId> embedded =
+            TFF_TRY(value.unplaced()->Embedded(*server_child_));
+        return server_child_->MaterializeSequenceChunks(embedded->ref(),
+                                                        chunk_size, consume);
+      }
+      case ExecutorValue::ValueType::SERVER: {
+        return server_child_->MaterializeSequenceChunks(
+            value.server()->ref(), chunk_size, consume);
+      }
+      default: {
+        return absl::InvalidArgumentError(absl::StrCat(
+            "`MaterializeSequenceChunks` expected an unplaced or server-placed "
+            "sequence, found a value of type ",
+            value.type()));
+      }
+    }
+  }
+
+  absl::StatusOr<ExecutorValue> CreateClientsSubset(
+      ExecutorValue value, absl::Span<const int32_t> client_indices) override {
+    TFF_TRY(value.CheckArgumentType(ExecutorValue::ValueType::CLIENTS,
+                                    "`CreateClientsSubset`"));
+    const Clients& clients = value.clients();
+    Clients subset = ::tensorflow_federated::NewClients(client_indices.size());
+    for (int32_t index : client_indices) {
+      if (index < 0 || static_cast<size_t>(index) >= clients->size()) {
+        return absl::InvalidArgumentError(absl::StrCat(
+            "Client index ", index, " is out of range for a value of ",
+            clients->size(), " clients"));
+      }
+      // The subset shares the clients' values in the child, so restricting a
+      // value creates nothing there.
+      subset->push_back(clients->at(index));
+    }
+    if (value.clients_all_equal() && !subset->empty()) {
+      return ExecutorValue::CreateClientsPlacedAllEqual(std::move(subset));
+    }
+    return ExecutorValue::CreateClientsPlaced(std::move(subset));
+  }
+
+  absl::Status MaterializeClients(
+      ExecutorValue value, absl::Span<const int32_t> client_indices,
+      absl::FunctionRef<absl::Status(int32_t, v0::Value)> consume) override {
+    TFF_TRY(value.CheckArgumentType(ExecutorValue::ValueType::CLIENTS,
+                                    "`MaterializeClients`"));
+    const Clients& clients = value.clients();
+    std::vector<int32_t> all_indices;
+    if (client_indices.empty()) {
+      all_indices.resize(clients->size());
+      std::iota(all_indices.begin(), all_indices.end(), 0);
+      client_indices = all_indices;
+    }
+    for (int32_t index : client_indices) {
+      if (index < 0 || static_cast<size_t>(index) >= clients->size()) {
+        return absl::InvalidArgumentError(absl::StrCat(
+            "Client index ", index, " is out of range for a value of ",
+            clients->size(), " clients"));
+      }
+    }
+    // The clients are materialized in parallel, and each is handed to
+    // `consume` as soon as it is available. Once `consume` fails, clients
+    // which are already being materialized are dropped.
+    absl::Mutex consume_mutex;
+    bool consume_failed = false;  // Guarded by `consume_mutex`.
+    return ParallelFor(client_indices.size(), [&](size_t i) -> absl::Status {
+      const int32_t index = client_indices[i];
+      v0::Value client_pb =
+          TFF_TRY(client_child_->Materialize(clients->at(index)->ref()));
+      absl::MutexLock lock(&consume_mutex);
+      if (consume_failed) {
+        return absl::OkStatus();
+      }
+      absl::Status status = consume(index, std::move(client_pb));
+      consume_failed = !status.ok();
+      return status;
+    });
+  }
 };
 
 }  // namespace
@@ -852,10 +1112,21 @@ class FederatingExecutor : public ExecutorBase<ExecutorValue> {
 absl::StatusOr<std::shared_ptr<Executor>> CreateFederatingExecutor(
     std::shared_ptr<Executor> server_child,
     std::shared_ptr<Executor> client_child,
-    const CardinalityMap& cardinalities) {
+    const CardinalityMap& cardinalities,
+    std::shared_ptr<MemoryBudget> memory_budget,
+    int32_t aggregate_partitions) {
   int num_clients = TFF_TRY(NumClientsFromCardinalities(cardinalities));
+  if (memory_budget == nullptr) {
+    memory_budget = MemoryBudget::Create();
+  }
+  if (aggregate_partitions <= 0) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("`aggregate_partitions` must be positive, got ",
+                     aggregate_partitions));
+  }
   return std::make_shared<FederatingExecutor>(
-      std::move(server_child), std::move(client_child), num_clients);
+      std::move(server_child), std::move(client_child), num_clients,
+      std::move(memory_budget), aggregate_partitions);
 }
 
 }  // namespace tensorflow_federated
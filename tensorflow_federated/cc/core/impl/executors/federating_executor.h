@@ -16,19 +16,42 @@ limitations under the License
 #ifndef THIRD_PARTY_TENSORFLOW_FEDERATED_CC_CORE_IMPL_EXECUTORS_FEDERATING_EXECUTOR_H_
 #define THIRD_PARTY_TENSORFLOW_FEDERATED_CC_CORE_IMPL_EXECUTORS_FEDERATING_EXECUTOR_H_
 
+#include <cstdint>
 #include <memory>
 
 #include "absl/status/statusor.h"
 #include "tensorflow_federated/cc/core/impl/executors/cardinalities.h"
 #include "tensorflow_federated/cc/core/impl/executors/executor.h"
+#include "tensorflow_federated/cc/core/impl/executors/memory_budget.h"
 
 namespace tensorflow_federated {
 
 // Returns an executor that can resolve federated values and intrinsics.
+//
+// The unplaced value protos held by the executor are charged to
+// `memory_budget`, and calls are delayed while it is over its high-water mark.
+// If not provided, the executor accounts its memory in a budget without a
+// high-water mark.
+//
+// Because this executor creates its values synchronously, the delay happens on
+// the calling thread: while `memory_budget` is over its high-water mark,
+// `CreateCall` blocks for up to the budget's `max_delay` before proceeding.
+// Callers must not depend on that thread to release the budget's memory; the
+// children's work, which releases it, runs on their own threads.
+//
+// `federated_aggregate` folds the clients into `aggregate_partitions`
+// independent chains of `accumulate` calls, whose results are combined with
+// `merge` in a balanced tree, so that an aggregate over N clients has a
+// critical path of about N / `aggregate_partitions` + log2(
+// `aggregate_partitions`) calls. The default, a single partition, folds the
+// clients in one chain and never calls `merge`; returns InvalidArgument if
+// `aggregate_partitions` is not positive.
 absl::StatusOr<std::shared_ptr<Executor>> CreateFederatingExecutor(
     std::shared_ptr<Executor> server_child,
     std::shared_ptr<Executor> client_child,
-    const CardinalityMap& cardinalities);
+    const CardinalityMap& cardinalities,
+    std::shared_ptr<MemoryBudget> memory_budget = nullptr,
+    int32_t aggregate_partitions = 1);
 
 }  // namespace tensorflow_federated
 
@@ -23,16 +23,20 @@ limitations under the License
 
 #include "googlemock/include/gmock/gmock.h"
 #include "googletest/include/gtest/gtest.h"
+#include "absl/container/flat_hash_map.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/time/time.h"
 #include "absl/types/span.h"
 #include "tensorflow_federated/cc/core/impl/executors/array_shape_test_utils.h"
 #include "tensorflow_federated/cc/core/impl/executors/array_test_utils.h"
 #include "tensorflow_federated/cc/core/impl/executors/executor.h"
 #include "tensorflow_federated/cc/core/impl/executors/executor_test_base.h"
+#include "tensorflow_federated/cc/core/impl/executors/memory_budget.h"
 #include "tensorflow_federated/cc/core/impl/executors/mock_executor.h"
 #include "tensorflow_federated/cc/core/impl/executors/status_macros.h"
 #include "tensorflow_federated/cc/core/impl/executors/value_test_utils.h"
+#include "tensorflow_federated/cc/testing/protobuf_matchers.h"
 #include "tensorflow_federated/cc/testing/status_matchers.h"
 #include "tensorflow_federated/proto/v0/executor.pb.h"
 
@@ -59,6 +63,7 @@ using ::tensorflow_federated::testing::intrinsic::FederatedValueAtServerV;
 using ::tensorflow_federated::testing::intrinsic::FederatedZipAtClientsV;
 using ::tensorflow_federated::testing::intrinsic::FederatedZipAtServerV;
 using ::testing::Cardinality;
+using ::testing::ElementsAre;
 using ::testing::HasSubstr;
 
 const uint16_t NUM_CLIENTS = 10;
@@ -151,6 +156,83 @@ class FederatingExecutorTest : public ExecutorTestBase {
     OwnedValueId id = TFF_TRY(test_executor_->CreateValue(value));
     return IdPair{std::move(id), child_id};
   }
+
+  // A `federated_aggregate` of the clients' values `0, ..., NUM_CLIENTS - 1`,
+  // and the child values its operands are expected to be embedded as.
+  struct FederatedAggregateCall {
+    OwnedValueId intrinsic_id;
+    OwnedValueId arg_id;
+    std::vector<ValueId> client_child_ids;
+    ValueId zero_child_id;
+    ValueId accumulate_child_id;
+    // Only embedded in the client child when the clients are partitioned.
+    std::optional<ValueId> merge_child_id;
+    ValueId report_child_id;
+  };
+
+  absl::StatusOr<v0::Value> StringValue(const char* value) {
+    federated_language::Array array_pb = TFF_TRY(
+        testing::CreateArray(federated_language::DataType::DT_STRING,
+                             testing::CreateArrayShape({}), {value}));
+    v0::Value value_pb;
+    value_pb.mutable_array()->Swap(&array_pb);
+    return value_pb;
+  }
+
+  absl::StatusOr<FederatedAggregateCall> CreateFederatedAggregateCall(
+      bool expect_merge_in_client_child) {
+    std::vector<v0::Value> client_vals;
+    std::vector<ValueId> client_child_ids;
+    for (int i = 0; i < NUM_CLIENTS; i++) {
+      federated_language::Array array_pb = TFF_TRY(
+          testing::CreateArray(federated_language::DataType::DT_INT32,
+                               testing::CreateArrayShape({}), {i}));
+      v0::Value value_pb;
+      value_pb.mutable_array()->Swap(&array_pb);
+      client_vals.emplace_back(value_pb);
+      client_child_ids.emplace_back(ExpectCreateInClientChild(value_pb));
+    }
+    v0::Value zero_pb = TFF_TRY(StringValue("zero"));
+    v0::Value accumulate_pb = TFF_TRY(StringValue("accumulate"));
+    v0::Value merge_pb = TFF_TRY(StringValue("merge"));
+    v0::Value report_pb = TFF_TRY(StringValue("report"));
+    ValueId zero_child_id = ExpectCreateInClientChild(zero_pb);
+    ValueId accumulate_child_id = ExpectCreateInClientChild(accumulate_pb);
+    std::optional<ValueId> merge_child_id;
+    if (expect_merge_in_client_child) {
+      merge_child_id = ExpectCreateInClientChild(merge_pb);
+    }
+    ValueId report_child_id = ExpectCreateInServerChild(report_pb);
+    OwnedValueId arg_id = TFF_TRY(test_executor_->CreateValue(StructV(
+        {ClientsV(client_vals), zero_pb, accumulate_pb, merge_pb, report_pb})));
+    OwnedValueId intrinsic_id =
+        TFF_TRY(test_executor_->CreateValue(FederatedAggregateV()));
+    return FederatedAggregateCall{std::move(intrinsic_id),
+                                  std::move(arg_id),
+                                  std::move(client_child_ids),
+                                  zero_child_id,
+                                  accumulate_child_id,
+                                  merge_child_id,
+                                  report_child_id};
+  }
+
+  // Expects the clients' aggregate, `aggregate_child_id`, to be moved to the
+  // server and reported, and checks the result of `call`.
+  void CheckFederatedAggregateReports(const FederatedAggregateCall& call,
+                                      ValueId aggregate_child_id) {
+    TFF_ASSERT_OK_AND_ASSIGN(v0::Value aggregate_pb,
+                             StringValue("result_value"));
+    ExpectMaterializeInClientChild(aggregate_child_id, aggregate_pb);
+    ValueId result_in_server_id = ExpectCreateInServerChild(aggregate_pb);
+    ValueId result_child_id = ExpectCreateCallInServerChild(
+        call.report_child_id, result_in_server_id);
+    TFF_ASSERT_OK_AND_ASSIGN(
+        auto result_id, test_executor_->CreateCall(call.intrinsic_id,
+                                                   call.arg_id));
+    TFF_ASSERT_OK_AND_ASSIGN(v0::Value result_pb, StringValue("result"));
+    ExpectMaterializeInServerChild(result_child_id, result_pb);
+    ExpectMaterialize(result_id, ServerV(result_pb));
+  }
 };
 
 TEST_F(FederatingExecutorTest, ConstructsExecutorWithEmptyCardinalities) {
@@ -233,6 +315,110 @@ TEST_F(FederatingExecutorTest, CreateMaterializeAtClients) {
   ExpectCreateMaterialize(ClientsV(values));
 }
 
+TEST_F(FederatingExecutorTest, MaterializeClientsSubset) {
+  std::vector<v0::Value> values;
+  std::vector<ValueId> child_ids;
+  for (int i = 0; i < NUM_CLIENTS; i++) {
+    federated_language::Array array_pb = TFF_ASSERT_OK(
+        testing::CreateArray(federated_language::DataType::DT_INT32,
+                             testing::CreateArrayShape({}), {i}));
+    v0::Value value_pb;
+    value_pb.mutable_array()->Swap(&array_pb);
+    values.emplace_back(value_pb);
+    child_ids.push_back(ExpectCreateInClientChild(value_pb));
+  }
+  TFF_ASSERT_OK_AND_ASSIGN(auto id,
+                           test_executor_->CreateValue(ClientsV(values)));
+  // Only the sampled clients are materialized.
+  const std::vector<int32_t> sampled = {1, 4, 7};
+  for (int32_t index : sampled) {
+    ExpectMaterializeInClientChild(child_ids[index], values[index]);
+  }
+  absl::flat_hash_map<int32_t, v0::Value> materialized;
+  TFF_ASSERT_OK(test_executor_->MaterializeClients(
+      id, sampled, [&](int32_t index, v0::Value value_pb) {
+        materialized.insert({index, std::move(value_pb)});
+        return absl::OkStatus();
+      }));
+  ASSERT_EQ(materialized.size(), sampled.size());
+  for (int32_t index : sampled) {
+    EXPECT_THAT(materialized[index], testing::EqualsProto(values[index]));
+  }
+}
+
+TEST_F(FederatingExecutorTest, MaterializeClientsStopsAfterConsumeFails) {
+  std::vector<ValueId> child_ids;
+  std::vector<v0::Value> values;
+  for (int i = 0; i < NUM_CLIENTS; i++) {
+    federated_language::Array array_pb = TFF_ASSERT_OK(
+        testing::CreateArray(federated_language::DataType::DT_INT32,
+                             testing::CreateArrayShape({}), {i}));
+    v0::Value value_pb;
+    value_pb.mutable_array()->Swap(&array_pb);
+    values.emplace_back(value_pb);
+    child_ids.push_back(ExpectCreateInClientChild(value_pb));
+  }
+  TFF_ASSERT_OK_AND_ASSIGN(auto id,
+                           test_executor_->CreateValue(ClientsV(values)));
+  // Clients may already be materializing when `consume` fails.
+  for (int i = 0; i < NUM_CLIENTS; i++) {
+    ExpectMaterializeInClientChild(child_ids[i], values[i],
+                                   ::testing::AtMost(1));
+  }
+  int num_consumed = 0;
+  EXPECT_THAT(test_executor_->MaterializeClients(
+                  id, {},
+                  [&](int32_t, v0::Value) {
+                    num_consumed++;
+                    return absl::InternalError("consume failed");
+                  }),
+              StatusIs(StatusCode::kInternal, HasSubstr("consume failed")));
+  EXPECT_EQ(num_consumed, 1);
+}
+
+TEST_F(FederatingExecutorTest, MaterializeClientsFailsOnServerValue) {
+  federated_language::Array array_pb =
+      TFF_ASSERT_OK(testing::CreateArray(federated_language::DataType::DT_INT32,
+                                         testing::CreateArrayShape({}), {1}));
+  v0::Value value_pb;
+  value_pb.mutable_array()->Swap(&array_pb);
+  ExpectCreateInServerChild(value_pb);
+  TFF_ASSERT_OK_AND_ASSIGN(auto id,
+                           test_executor_->CreateValue(ServerV(value_pb)));
+  EXPECT_THAT(test_executor_->MaterializeClients(
+                  id, {}, [](int32_t, v0::Value) { return absl::OkStatus(); }),
+              StatusIs(StatusCode::kInvalidArgument));
+}
+
+TEST_F(FederatingExecutorTest, MaterializeSequenceChunksAtServer) {
+  v0::Value sequence_pb = SequenceV(0, 5, 1);
+  ExpectCreateMaterializeInServerChild(sequence_pb);
+  TFF_ASSERT_OK_AND_ASSIGN(auto id,
+                           test_executor_->CreateValue(ServerV(sequence_pb)));
+  std::vector<int> chunk_sizes;
+  TFF_ASSERT_OK(test_executor_->MaterializeSequenceChunks(
+      id, 2, [&chunk_sizes](v0::Value::Sequence chunk_pb) {
+        chunk_sizes.push_back(chunk_pb.element_size());
+        return absl::OkStatus();
+      }));
+  EXPECT_THAT(chunk_sizes, ElementsAre(2, 2, 1));
+}
+
+TEST_F(FederatingExecutorTest, MaterializeSequenceChunksFailsOnClientsValue) {
+  std::vector<v0::Value> values;
+  for (int i = 0; i < NUM_CLIENTS; i++) {
+    v0::Value sequence_pb = SequenceV(0, i + 1, 1);
+    values.emplace_back(sequence_pb);
+    ExpectCreateInClientChild(sequence_pb);
+  }
+  TFF_ASSERT_OK_AND_ASSIGN(auto id,
+                           test_executor_->CreateValue(ClientsV(values)));
+  EXPECT_THAT(test_executor_->MaterializeSequenceChunks(
+                  id, 2,
+                  [](v0::Value::Sequence) { return absl::OkStatus(); }),
+              StatusIs(StatusCode::kInvalidArgument));
+}
+
 TEST_F(FederatingExecutorTest, CreateValueFailsWrongNumberClients) {
   EXPECT_THAT(test_executor_->CreateValue(ClientsV({})),
               StatusIs(StatusCode::kInvalidArgument));
@@ -363,6 +549,45 @@ TEST_F(FederatingExecutorTest, CreateSelectionFromEmbeddedValue) {
   ExpectMaterialize(id, value2_pb);
 }
 
+TEST_F(FederatingExecutorTest, ChargesUnplacedValuesToMemoryBudget) {
+  std::shared_ptr<MemoryBudget> memory_budget = MemoryBudget::Create();
+  TFF_ASSERT_OK_AND_ASSIGN(
+      test_executor_, tensorflow_federated::CreateFederatingExecutor(
+                          mock_server_executor_, mock_client_executor_,
+                          {{"clients", NUM_CLIENTS}}, memory_budget));
+  federated_language::Array array_pb = TFF_ASSERT_OK(
+      testing::CreateArray(federated_language::DataType::DT_INT32,
+                           testing::CreateArrayShape({3}), {1, 2, 3}));
+  v0::Value value_pb;
+  value_pb.mutable_array()->Swap(&array_pb);
+  {
+    TFF_ASSERT_OK_AND_ASSIGN(auto id, test_executor_->CreateValue(value_pb));
+    EXPECT_EQ(memory_budget->used_bytes(), value_pb.ByteSizeLong());
+  }
+  EXPECT_EQ(memory_budget->used_bytes(), 0);
+  EXPECT_EQ(memory_budget->peak_bytes(), value_pb.ByteSizeLong());
+}
+
+TEST_F(FederatingExecutorTest, CreateCallWaitsForMemoryBudget) {
+  std::shared_ptr<MemoryBudget> memory_budget =
+      MemoryBudget::Create(/*high_water_mark_bytes=*/1, absl::Milliseconds(1));
+  TFF_ASSERT_OK_AND_ASSIGN(
+      test_executor_, tensorflow_federated::CreateFederatingExecutor(
+                          mock_server_executor_, mock_client_executor_,
+                          {{"clients", NUM_CLIENTS}}, memory_budget));
+  federated_language::Array array_pb =
+      TFF_ASSERT_OK(testing::CreateArray(federated_language::DataType::DT_INT32,
+                                         testing::CreateArrayShape({}), {1}));
+  v0::Value value_pb;
+  value_pb.mutable_array()->Swap(&array_pb);
+  TFF_ASSERT_OK_AND_ASSIGN(auto s,
+                           test_executor_->CreateValue(StructV({value_pb})));
+  EXPECT_THAT(test_executor_->CreateCall(s, std::nullopt),
+              StatusIs(StatusCode::kInvalidArgument));
+  EXPECT_EQ(memory_budget->delayed_calls(), 1);
+  EXPECT_EQ(memory_budget->timed_out_calls(), 1);
+}
+
 TEST_F(FederatingExecutorTest, CreateSelectionFromFederatedValueFails) {
   federated_language::Array array_pb =
       TFF_ASSERT_OK(testing::CreateArray(federated_language::DataType::DT_INT32,
@@ -500,74 +725,53 @@ TEST_F(FederatingExecutorTest, CreateCallStructFails) {
 }
 
 TEST_F(FederatingExecutorTest, CreateCallFederatedAggregate) {
-  std::vector<v0::Value> client_vals;
-  std::vector<ValueId> client_vals_child_ids;
-  for (int i = 0; i < NUM_CLIENTS; i++) {
-    federated_language::Array array_pb = TFF_ASSERT_OK(
-        testing::CreateArray(federated_language::DataType::DT_INT32,
-                             testing::CreateArrayShape({}), {i}));
-    v0::Value value_pb;
-    value_pb.mutable_array()->Swap(&array_pb);
-    client_vals.emplace_back(value_pb);
-    client_vals_child_ids.emplace_back(ExpectCreateInClientChild(value_pb));
-  }
-  v0::Value value = ClientsV(client_vals);
-  federated_language::Array array_zero_pb = TFF_ASSERT_OK(
-      testing::CreateArray(federated_language::DataType::DT_STRING,
-                           testing::CreateArrayShape({}), {"zero"}));
-  v0::Value value_zero_pb;
-  value_zero_pb.mutable_array()->Swap(&array_zero_pb);
-  ValueId zero_child_id = ExpectCreateInClientChild(value_zero_pb);
-  federated_language::Array array_accumulate_pb = TFF_ASSERT_OK(
-      testing::CreateArray(federated_language::DataType::DT_STRING,
-                           testing::CreateArrayShape({}), {"accumulate"}));
-  v0::Value value_accumulate_pb;
-  value_accumulate_pb.mutable_array()->Swap(&array_accumulate_pb);
-  ValueId accumulate_child_id = ExpectCreateInClientChild(value_accumulate_pb);
-  federated_language::Array array_merge_pb = TFF_ASSERT_OK(
-      testing::CreateArray(federated_language::DataType::DT_STRING,
-                           testing::CreateArrayShape({}), {"merge"}));
-  v0::Value value_merge_pb;
-  value_merge_pb.mutable_array()->Swap(&array_merge_pb);
-  federated_language::Array array_report_pb = TFF_ASSERT_OK(
-      testing::CreateArray(federated_language::DataType::DT_STRING,
-                           testing::CreateArrayShape({}), {"report"}));
-  v0::Value value_report_pb;
-  value_report_pb.mutable_array()->Swap(&array_report_pb);
-  ValueId report_child_id = ExpectCreateInServerChild(value_report_pb);
-  v0::Value arg = StructV({value, value_zero_pb, value_accumulate_pb,
-                           value_merge_pb, value_report_pb});
-  TFF_ASSERT_OK_AND_ASSIGN(auto arg_id, test_executor_->CreateValue(arg));
-  TFF_ASSERT_OK_AND_ASSIGN(auto intrinsic_id,
-                           test_executor_->CreateValue(FederatedAggregateV()));
-  ValueId current_child_id = zero_child_id;
-  for (auto client_val_child_id : client_vals_child_ids) {
+  TFF_ASSERT_OK_AND_ASSIGN(
+      FederatedAggregateCall call,
+      CreateFederatedAggregateCall(/*expect_merge_in_client_child=*/false));
+  ValueId current_child_id = call.zero_child_id;
+  for (auto client_val_child_id : call.client_child_ids) {
     ValueId call_arg_child_id = ExpectCreateStructInClientChild(
         {current_child_id, client_val_child_id});
-    current_child_id =
-        ExpectCreateCallInClientChild(accumulate_child_id, call_arg_child_id);
+    current_child_id = ExpectCreateCallInClientChild(call.accumulate_child_id,
+                                                     call_arg_child_id);
   }
-  federated_language::Array array_client_child_result_pb = TFF_ASSERT_OK(
-      testing::CreateArray(federated_language::DataType::DT_STRING,
-                           testing::CreateArrayShape({}), {"result_value"}));
-  v0::Value value_client_child_result_pb;
-  value_client_child_result_pb.mutable_array()->Swap(
-      &array_client_child_result_pb);
-  ExpectMaterializeInClientChild(current_child_id,
-                                 value_client_child_result_pb);
-  ValueId result_in_server_id =
-      ExpectCreateInServerChild(value_client_child_result_pb);
-  ValueId result_child_id =
-      ExpectCreateCallInServerChild(report_child_id, result_in_server_id);
-  TFF_ASSERT_OK_AND_ASSIGN(auto result_id,
-                           test_executor_->CreateCall(intrinsic_id, arg_id));
-  federated_language::Array array_child_result_pb = TFF_ASSERT_OK(
-      testing::CreateArray(federated_language::DataType::DT_STRING,
-                           testing::CreateArrayShape({}), {"result"}));
-  v0::Value value_child_result_pb;
-  value_child_result_pb.mutable_array()->Swap(&array_child_result_pb);
-  ExpectMaterializeInServerChild(result_child_id, value_child_result_pb);
-  ExpectMaterialize(result_id, ServerV(value_child_result_pb));
+  CheckFederatedAggregateReports(call, current_child_id);
+}
+
+TEST_F(FederatingExecutorTest, CreateCallFederatedAggregateInPartitions) {
+  TFF_ASSERT_OK_AND_ASSIGN(
+      test_executor_,
+      tensorflow_federated::CreateFederatingExecutor(
+          mock_server_executor_, mock_client_executor_,
+          {{"clients", NUM_CLIENTS}}, /*memory_budget=*/nullptr,
+          /*aggregate_partitions=*/3));
+  TFF_ASSERT_OK_AND_ASSIGN(
+      FederatedAggregateCall call,
+      CreateFederatedAggregateCall(/*expect_merge_in_client_child=*/true));
+  // The ten clients are accumulated in the partitions [0, 3), [3, 6) and
+  // [6, 10).
+  const std::vector<int> partition_bounds = {0, 3, 6, 10};
+  std::vector<ValueId> partial_child_ids;
+  for (int p = 0; p < 3; p++) {
+    ValueId current_child_id = call.zero_child_id;
+    for (int i = partition_bounds[p]; i < partition_bounds[p + 1]; i++) {
+      ValueId call_arg_child_id = ExpectCreateStructInClientChild(
+          {current_child_id, call.client_child_ids[i]});
+      current_child_id = ExpectCreateCallInClientChild(
+          call.accumulate_child_id, call_arg_child_id);
+    }
+    partial_child_ids.push_back(current_child_id);
+  }
+  // The first two partial results are merged, then merged with the third.
+  ValueId merge_arg_child_id = ExpectCreateStructInClientChild(
+      {partial_child_ids[0], partial_child_ids[1]});
+  ValueId merged_child_id = ExpectCreateCallInClientChild(
+      *call.merge_child_id, merge_arg_child_id);
+  merge_arg_child_id =
+      ExpectCreateStructInClientChild({merged_child_id, partial_child_ids[2]});
+  merged_child_id = ExpectCreateCallInClientChild(*call.merge_child_id,
+                                                  merge_arg_child_id);
+  CheckFederatedAggregateReports(call, merged_child_id);
 }
 
 TEST_F(FederatingExecutorTest, CreateCallFederatedBroadcast) {
@@ -595,6 +799,29 @@ TEST_F(FederatingExecutorTest, CreateCallFederatedBroadcast) {
                     ClientsV(std::vector<v0::Value>(NUM_CLIENTS, value2_pb)));
 }
 
+TEST_F(FederatingExecutorTest, CreateCallFederatedBroadcastSharesColocatedId) {
+  TFF_ASSERT_OK_AND_ASSIGN(
+      test_executor_, tensorflow_federated::CreateFederatingExecutor(
+                          mock_server_executor_, mock_server_executor_,
+                          {{"clients", NUM_CLIENTS}}));
+  federated_language::Array array_pb =
+      TFF_ASSERT_OK(testing::CreateArray(federated_language::DataType::DT_INT32,
+                                         testing::CreateArrayShape({}), {1}));
+  v0::Value value_pb;
+  value_pb.mutable_array()->Swap(&array_pb);
+  // The broadcast value is neither materialized nor created again.
+  ValueId tensor_id = ExpectCreateInServerChild(value_pb);
+  TFF_ASSERT_OK_AND_ASSIGN(auto server_id,
+                           test_executor_->CreateValue(ServerV(value_pb)));
+  TFF_ASSERT_OK_AND_ASSIGN(auto broadcast_id,
+                           test_executor_->CreateValue(FederatedBroadcastV()));
+  TFF_ASSERT_OK_AND_ASSIGN(auto clients_id,
+                           test_executor_->CreateCall(broadcast_id, server_id));
+  ExpectMaterializeInServerChild(tensor_id, value_pb, ONCE_PER_CLIENT);
+  ExpectMaterialize(clients_id,
+                    ClientsV(std::vector<v0::Value>(NUM_CLIENTS, value_pb)));
+}
+
 TEST_F(FederatingExecutorTest, CreateCallFederatedMapAtClients) {
   std::vector<v0::Value> client_vals;
   std::vector<ValueId> client_vals_child_ids;
@@ -632,6 +859,111 @@ TEST_F(FederatingExecutorTest, CreateCallFederatedMapAtClients) {
   ExpectMaterialize(result_id, value);
 }
 
+TEST_F(FederatingExecutorTest, CreateCallFederatedMapAtClientsSubset) {
+  std::vector<v0::Value> client_vals;
+  std::vector<ValueId> client_vals_child_ids;
+  for (int i = 0; i < NUM_CLIENTS; i++) {
+    federated_language::Array array_pb = TFF_ASSERT_OK(
+        testing::CreateArray(federated_language::DataType::DT_INT32,
+                             testing::CreateArrayShape({}), {i}));
+    v0::Value value_pb;
+    value_pb.mutable_array()->Swap(&array_pb);
+    client_vals.emplace_back(value_pb);
+    client_vals_child_ids.emplace_back(ExpectCreateInClientChild(value_pb));
+  }
+  TFF_ASSERT_OK_AND_ASSIGN(auto input_id,
+                           test_executor_->CreateValue(ClientsV(client_vals)));
+  // Only the sampled clients are mapped over, in the order they were
+  // requested, which need not be ascending.
+  const std::vector<int32_t> sampled = {7, 2};
+  TFF_ASSERT_OK_AND_ASSIGN(
+      auto subset_id, test_executor_->CreateClientsSubset(input_id, sampled));
+  federated_language::Array array_fn_pb = TFF_ASSERT_OK(
+      testing::CreateArray(federated_language::DataType::DT_STRING,
+                           testing::CreateArrayShape({}), {"fn"}));
+  v0::Value value_fn_pb;
+  value_fn_pb.mutable_array()->Swap(&array_fn_pb);
+  auto fn_id = ExpectCreateInClientChild(value_fn_pb);
+  std::vector<v0::Value> sampled_vals;
+  for (int32_t index : sampled) {
+    ValueId result_child_id =
+        ExpectCreateCallInClientChild(fn_id, client_vals_child_ids[index]);
+    ExpectMaterializeInClientChild(result_child_id, client_vals[index]);
+    sampled_vals.push_back(client_vals[index]);
+  }
+  TFF_ASSERT_OK_AND_ASSIGN(auto map_id,
+                           test_executor_->CreateValue(FederatedMapV()));
+  TFF_ASSERT_OK_AND_ASSIGN(auto fn_at_fed_exec_id,
+                           test_executor_->CreateValue(value_fn_pb));
+  TFF_ASSERT_OK_AND_ASSIGN(auto arg_id, test_executor_->CreateStruct(
+                                            {fn_at_fed_exec_id, subset_id}));
+  TFF_ASSERT_OK_AND_ASSIGN(auto result_id,
+                           test_executor_->CreateCall(map_id, arg_id));
+  ExpectMaterialize(result_id, ClientsV(sampled_vals));
+}
+
+TEST_F(FederatingExecutorTest, CreateCallFederatedZipAtClientsSubsetAllEqual) {
+  std::vector<v0::Value> client_vals;
+  std::vector<ValueId> client_vals_child_ids;
+  for (int i = 0; i < NUM_CLIENTS; i++) {
+    federated_language::Array array_pb = TFF_ASSERT_OK(
+        testing::CreateArray(federated_language::DataType::DT_INT32,
+                             testing::CreateArrayShape({}), {i}));
+    v0::Value value_pb;
+    value_pb.mutable_array()->Swap(&array_pb);
+    client_vals.emplace_back(value_pb);
+    client_vals_child_ids.emplace_back(ExpectCreateInClientChild(value_pb));
+  }
+  TFF_ASSERT_OK_AND_ASSIGN(auto input_id,
+                           test_executor_->CreateValue(ClientsV(client_vals)));
+  const std::vector<int32_t> sampled = {7, 2};
+  TFF_ASSERT_OK_AND_ASSIGN(
+      auto subset_id, test_executor_->CreateClientsSubset(input_id, sampled));
+  // An all-equal value, like a broadcast model, holds every client but is
+  // zipped with only the sampled ones.
+  federated_language::Array model_array_pb =
+      TFF_ASSERT_OK(testing::CreateArray(federated_language::DataType::DT_INT32,
+                                         testing::CreateArrayShape({}), {100}));
+  v0::Value model_pb;
+  model_pb.mutable_array()->Swap(&model_array_pb);
+  ValueId model_child_id = ExpectCreateInClientChild(model_pb);
+  TFF_ASSERT_OK_AND_ASSIGN(
+      auto model_id, test_executor_->CreateValue(ClientsV({model_pb}, true)));
+  std::vector<v0::Value> zipped_vals;
+  for (int32_t index : sampled) {
+    ValueId struct_child_id = ExpectCreateStructInClientChild(
+        {model_child_id, client_vals_child_ids[index]});
+    v0::Value zipped = StructV({model_pb, client_vals[index]});
+    ExpectMaterializeInClientChild(struct_child_id, zipped);
+    zipped_vals.push_back(std::move(zipped));
+  }
+  TFF_ASSERT_OK_AND_ASSIGN(
+      auto zip_id, test_executor_->CreateValue(FederatedZipAtClientsV()));
+  TFF_ASSERT_OK_AND_ASSIGN(auto arg_id,
+                           test_executor_->CreateStruct({model_id, subset_id}));
+  TFF_ASSERT_OK_AND_ASSIGN(auto result_id,
+                           test_executor_->CreateCall(zip_id, arg_id));
+  ExpectMaterialize(result_id, ClientsV(zipped_vals));
+}
+
+TEST_F(FederatingExecutorTest, CreateClientsSubsetFailsOnIndexOutOfRange) {
+  std::vector<v0::Value> client_vals;
+  for (int i = 0; i < NUM_CLIENTS; i++) {
+    federated_language::Array array_pb = TFF_ASSERT_OK(
+        testing::CreateArray(federated_language::DataType::DT_INT32,
+                             testing::CreateArrayShape({}), {i}));
+    v0::Value value_pb;
+    value_pb.mutable_array()->Swap(&array_pb);
+    client_vals.emplace_back(value_pb);
+    ExpectCreateInClientChild(value_pb);
+  }
+  TFF_ASSERT_OK_AND_ASSIGN(auto input_id,
+                           test_executor_->CreateValue(ClientsV(client_vals)));
+  EXPECT_THAT(test_executor_->CreateClientsSubset(input_id, {0, NUM_CLIENTS}),
+              StatusIs(StatusCode::kInvalidArgument,
+                       HasSubstr("out of range")));
+}
+
 TEST_F(FederatingExecutorTest, CreateCallFederatedMapAllEqualAtClients) {
   std::vector<v0::Value> client_vals;
   std::vector<ValueId> client_vals_child_ids;
@@ -922,9 +1254,12 @@ TEST_F(FederatingExecutorTest, CreateCallFederatedSelectNonInt32KeysFails) {
   array_keys_pb.mutable_shape()->mutable_dim()->Add(1);
   v0::Value keys_pb;
   *keys_pb.mutable_array() = array_keys_pb;
-  // The child `keys_pb` value is only created once due to the ALL_EQUALS bit,
-  // and then is only materialized once after which the operation fails.
-  ExpectCreateMaterializeInClientChild(keys_pb, ONCE);
+  // The child `keys_pb` value is only created once due to the ALL_EQUALS bit.
+  // The keys of the clients are materialized in parallel, and the remaining
+  // ones are skipped once one of them fails.
+  ValueId keys_child_id = ExpectCreateInClientChild(keys_pb);
+  ExpectMaterializeInClientChild(keys_child_id, keys_pb,
+                                 ::testing::Between(1, NUM_CLIENTS));
   OwnedValueId keys_id =
       TFF_ASSERT_OK(test_executor_->CreateValue(ClientsV({keys_pb}, true)));
   OwnedValueId select_args_id = TFF_ASSERT_OK(test_executor_->CreateStruct(
@@ -965,9 +1300,12 @@ TEST_F(FederatingExecutorTest, CreateCallFederatedSelectNonRankOneKeysFails) {
   array_keys_pb.mutable_shape()->mutable_dim()->Add(2);
   v0::Value keys_pb;
   *keys_pb.mutable_array() = array_keys_pb;
-  // The child `keys_pb` value is only created once due to the ALL_EQUALS bit,
-  // and then is only materialized once after which the operation fails.
-  ExpectCreateMaterializeInClientChild(keys_pb, ONCE);
+  // The child `keys_pb` value is only created once due to the ALL_EQUALS bit.
+  // The keys of the clients are materialized in parallel, and the remaining
+  // ones are skipped once one of them fails.
+  ValueId keys_child_id = ExpectCreateInClientChild(keys_pb);
+  ExpectMaterializeInClientChild(keys_child_id, keys_pb,
+                                 ::testing::Between(1, NUM_CLIENTS));
   OwnedValueId keys_id =
       TFF_ASSERT_OK(test_executor_->CreateValue(ClientsV({keys_pb}, true)));
   OwnedValueId select_args_id = TFF_ASSERT_OK(test_executor_->CreateStruct(
@@ -977,6 +1315,53 @@ TEST_F(FederatingExecutorTest, CreateCallFederatedSelectNonRankOneKeysFails) {
                        HasSubstr("Expected key tensor to be rank one")));
 }
 
+TEST_F(FederatingExecutorTest, CreateCallFederatedSelectKeysOfWrongSizeFails) {
+  OwnedValueId select_id =
+      TFF_ASSERT_OK(test_executor_->CreateValue(FederatedSelectV()));
+  federated_language::Array array_fn_pb = TFF_ASSERT_OK(
+      testing::CreateArray(federated_language::DataType::DT_STRING,
+                           testing::CreateArrayShape({}), {"fn"}));
+  v0::Value value_fn_pb;
+  value_fn_pb.mutable_array()->Swap(&array_fn_pb);
+  IdPair select_fn = TFF_ASSERT_OK(CreatePassthroughValue(value_fn_pb));
+  federated_language::Array array_max_key_pb = TFF_ASSERT_OK(
+      testing::CreateArray(federated_language::DataType::DT_STRING,
+                           testing::CreateArrayShape({}), {"max_key"}));
+  v0::Value value_max_key_pb;
+  value_max_key_pb.mutable_array()->Swap(&array_max_key_pb);
+  OwnedValueId max_key =
+      TFF_ASSERT_OK(test_executor_->CreateValue(value_max_key_pb));
+  federated_language::Array array_pb =
+      TFF_ASSERT_OK(testing::CreateArray(federated_language::DataType::DT_INT32,
+                                         testing::CreateArrayShape({}), {1}));
+  v0::Value value_pb;
+  value_pb.mutable_array()->Swap(&array_pb);
+  ExpectCreateInServerChild(value_pb);
+  OwnedValueId server_value_id =
+      TFF_ASSERT_OK(test_executor_->CreateValue(ServerV(value_pb)));
+
+  federated_language::Array array_keys_pb;
+  array_keys_pb.set_dtype(federated_language::DataType::DT_INT32);
+  array_keys_pb.mutable_shape()->mutable_dim()->Add(3);
+  array_keys_pb.mutable_int32_list()->add_value(1);
+  array_keys_pb.mutable_int32_list()->add_value(2);
+  v0::Value keys_pb;
+  *keys_pb.mutable_array() = array_keys_pb;
+  // The child `keys_pb` value is only created once due to the ALL_EQUALS bit.
+  // The keys of the clients are materialized in parallel, and the remaining
+  // ones are skipped once one of them fails.
+  ValueId keys_child_id = ExpectCreateInClientChild(keys_pb);
+  ExpectMaterializeInClientChild(keys_child_id, keys_pb,
+                                 ::testing::Between(1, NUM_CLIENTS));
+  OwnedValueId keys_id =
+      TFF_ASSERT_OK(test_executor_->CreateValue(ClientsV({keys_pb}, true)));
+  OwnedValueId select_args_id = TFF_ASSERT_OK(test_executor_->CreateStruct(
+      {keys_id, max_key, server_value_id, select_fn.id}));
+  ASSERT_THAT(test_executor_->CreateCall(select_id, select_args_id),
+              StatusIs(StatusCode::kInvalidArgument,
+                       HasSubstr("to hold 3 keys, but found 2")));
+}
+
 TEST_F(FederatingExecutorTest, CreateCallFederatedValueAtClients) {
   federated_language::Array array_pb =
       TFF_ASSERT_OK(testing::CreateArray(federated_language::DataType::DT_INT32,
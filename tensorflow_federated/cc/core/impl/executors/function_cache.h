@@ -0,0 +1,362 @@
+/* Copyright 2026, The TensorFlow Federated Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+     http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License
+==============================================================================*/
+
+#ifndef THIRD_PARTY_TENSORFLOW_FEDERATED_CC_CORE_IMPL_EXECUTORS_FUNCTION_CACHE_H_
+#define THIRD_PARTY_TENSORFLOW_FEDERATED_CC_CORE_IMPL_EXECUTORS_FUNCTION_CACHE_H_
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/base/optimization.h"
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/container/node_hash_map.h"
+#include "absl/log/log.h"
+#include "absl/synchronization/mutex.h"
+
+namespace tensorflow_federated {
+
+// A counter incremented by many threads, e.g. on every cache lookup.
+//
+// Each thread increments its own cache line, so concurrent increments do not
+// contend. Reads sum the per-thread shards.
+class FunctionCacheCounter {
+ public:
+  void Increment() {
+    shards_[ThisThreadShard()].value.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  int64_t load() const {
+    int64_t sum = 0;
+    for (const Shard& shard : shards_) {
+      sum += shard.value.load(std::memory_order_relaxed);
+    }
+    return sum;
+  }
+
+ private:
+  static constexpr size_t kNumShards = 16;
+
+  struct ABSL_CACHELINE_ALIGNED Shard {
+    std::atomic<int64_t> value{0};
+  };
+
+  static size_t ThisThreadShard() {
+    static std::atomic<size_t> next_shard{0};
+    thread_local const size_t shard =
+        next_shard.fetch_add(1, std::memory_order_relaxed) % kNumShards;
+    return shard;
+  }
+
+  std::array<Shard, kNumShards> shards_;
+};
+
+// Counters of a `FunctionCache`. May be shared with the cache's owner (see
+// `FunctionCacheOptions::stats`) to observe the cache.
+struct FunctionCacheStats {
+  FunctionCacheCounter hits;
+  FunctionCacheCounter misses;
+  std::atomic<int64_t> evictions{0};
+  // Gauges, updated whenever a function is inserted. `bytes` and `sessions`
+  // include evicted functions that are still in use.
+  std::atomic<int64_t> entries{0};
+  std::atomic<int64_t> bytes{0};
+  std::atomic<int64_t> sessions{0};
+};
+
+// Keys of the functions that a `FunctionCache` never evicts. May be shared with
+// the cache's owner (see `FunctionCacheOptions::pins`) to pin functions while
+// the cache is in use.
+class FunctionCachePins {
+ public:
+  FunctionCachePins() = default;
+  explicit FunctionCachePins(absl::flat_hash_set<uint64_t> keys)
+      : keys_(std::move(keys)) {}
+
+  FunctionCachePins(const FunctionCachePins&) = delete;
+  FunctionCachePins& operator=(const FunctionCachePins&) = delete;
+
+  // Excludes the function under `key` from eviction, including functions
+  // inserted under `key` in the future.
+  void Pin(uint64_t key) {
+    absl::MutexLock lock(&mutex_);
+    keys_.insert(key);
+  }
+
+  // Makes the function under `key` evictable again.
+  void Unpin(uint64_t key) {
+    absl::MutexLock lock(&mutex_);
+    keys_.erase(key);
+  }
+
+  bool IsPinned(uint64_t key) const {
+    absl::MutexLock lock(&mutex_);
+    return keys_.contains(key);
+  }
+
+ private:
+  mutable absl::Mutex mutex_;
+  absl::flat_hash_set<uint64_t> keys_ ABSL_GUARDED_BY(mutex_);
+};
+
+struct FunctionCacheOptions {
+  // Once the cached functions hold more than this many bytes, least recently
+  // used functions are evicted. Non-positive values disable the limit.
+  int64_t max_bytes = -1;
+  // Once the cached functions hold more than this many sessions, least
+  // recently used functions are evicted. Non-positive values disable the
+  // limit.
+  int64_t max_sessions = -1;
+  // Keys of functions that are never evicted. Added to `pins`.
+  absl::flat_hash_set<uint64_t> pinned_keys;
+  // Pins functions while the cache is in use if set, e.g. by the owner of an
+  // executor holding the cache.
+  std::shared_ptr<FunctionCachePins> pins;
+  // Receives the cache's counters if set.
+  std::shared_ptr<FunctionCacheStats> stats;
+};
+
+// The resources held by a cached function.
+struct FunctionCacheCost {
+  int64_t bytes = 0;
+  int64_t sessions = 0;
+};
+
+// A cache of functions (e.g. TensorFlow computations) by key, bounded by the
+// bytes and sessions the functions hold.
+//
+// When an insertion takes the cache over its limits, the least recently used
+// functions that are not pinned are evicted until it is within them again.
+// The newly inserted function is never evicted by its own insertion.
+//
+// Functions may acquire resources (e.g. sessions) after they were inserted, so
+// every insertion re-evaluates the costs of all functions. Insertions follow a
+// miss, which builds a new function, so this is cheap by comparison. Lookups
+// never evaluate costs: they only take a reader lock, count the hit on a
+// per-thread counter, and record recency with a plain store.
+//
+// Functions are held by `shared_ptr`, so eviction only drops the cache's
+// reference: functions that are still in use remain valid. Until their last
+// reference is gone, they still count towards the limits, and looking up or
+// inserting their key returns them rather than a duplicate.
+template <typename Function>
+class FunctionCache {
+ public:
+  using CostFn = std::function<FunctionCacheCost(const Function&)>;
+
+  FunctionCache(FunctionCacheOptions options, CostFn cost_fn)
+      : max_bytes_(options.max_bytes),
+        max_sessions_(options.max_sessions),
+        pins_(options.pins != nullptr ? std::move(options.pins)
+                                      : std::make_shared<FunctionCachePins>()),
+        stats_(options.stats != nullptr
+                   ? std::move(options.stats)
+                   : std::make_shared<FunctionCacheStats>()),
+        cost_fn_(std::move(cost_fn)) {
+    for (uint64_t key : options.pinned_keys) {
+      pins_->Pin(key);
+    }
+  }
+
+  FunctionCache(const FunctionCache&) = delete;
+  FunctionCache& operator=(const FunctionCache&) = delete;
+
+  // Returns the function cached under `key`, or `nullptr` if there is none.
+  std::shared_ptr<Function> Get(uint64_t key) {
+    absl::ReaderMutexLock lock(&mutex_);
+    auto it = entries_.find(key);
+    if (ABSL_PREDICT_TRUE(it != entries_.end())) {
+      stats_->hits.Increment();
+      it->second.last_used.store(Now(), std::memory_order_relaxed);
+      return it->second.function;
+    }
+    if (auto evicted = evicted_.find(key); evicted != evicted_.end()) {
+      if (std::shared_ptr<Function> function = evicted->second.function.lock();
+          function != nullptr) {
+        stats_->hits.Increment();
+        return function;
+      }
+    }
+    stats_->misses.Increment();
+    return nullptr;
+  }
+
+  // Caches `function` under `key`, evicting other functions as needed.
+  // Returns the cached function, which is an existing one if another caller
+  // inserted `key` first, or if the function evicted from `key` is still in
+  // use.
+  std::shared_ptr<Function> Insert(uint64_t key,
+                                   std::shared_ptr<Function> function) {
+    // Declared outside the lock's scope, so that evicted functions (and any
+    // sessions they own) are destroyed after the lock is released.
+    std::vector<std::shared_ptr<Function>> evicted;
+    absl::WriterMutexLock lock(&mutex_);
+    auto [it, inserted] = entries_.try_emplace(key);
+    Entry& entry = it->second;
+    entry.last_used.store(Now(), std::memory_order_relaxed);
+    if (!inserted) {
+      return entry.function;
+    }
+    if (auto retired = evicted_.find(key); retired != evicted_.end()) {
+      // Bring the evicted function back rather than holding it twice.
+      entry.function = retired->second.function.lock();
+      evicted_.erase(retired);
+    }
+    if (entry.function == nullptr) {
+      entry.function = std::move(function);
+    }
+    RefreshCosts();
+    if (OverBudget()) {
+      evicted = Evict(key);
+    }
+    UpdateGauges();
+    return entry.function;
+  }
+
+  // See `FunctionCachePins`.
+  void Pin(uint64_t key) { pins_->Pin(key); }
+  void Unpin(uint64_t key) { pins_->Unpin(key); }
+
+  size_t size() {
+    absl::ReaderMutexLock lock(&mutex_);
+    return entries_.size();
+  }
+
+  const FunctionCacheStats& stats() const { return *stats_; }
+
+ private:
+  struct Entry {
+    std::shared_ptr<Function> function;
+    // Written by lookups under a reader lock, hence atomic.
+    std::atomic<int64_t> last_used{0};
+    // The cost last accounted for in the cache's totals.
+    FunctionCacheCost cost;
+  };
+
+  // A function evicted while still in use elsewhere.
+  struct Evicted {
+    std::weak_ptr<Function> function;
+    FunctionCacheCost cost;
+  };
+
+  static int64_t Now() {
+    return std::chrono::steady_clock::now().time_since_epoch().count();
+  }
+
+  // Re-evaluates the costs of all functions, including evicted functions
+  // which are still in use, and forgets those which no longer are.
+  void RefreshCosts() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_) {
+    total_ = {};
+    for (auto& [key, entry] : entries_) {
+      entry.cost = cost_fn_(*entry.function);
+      AddCost(entry.cost);
+    }
+    for (auto it = evicted_.begin(); it != evicted_.end();) {
+      std::shared_ptr<Function> function = it->second.function.lock();
+      if (function == nullptr) {
+        evicted_.erase(it++);
+        continue;
+      }
+      it->second.cost = cost_fn_(*function);
+      AddCost(it->second.cost);
+      ++it;
+    }
+  }
+
+  void AddCost(const FunctionCacheCost& cost)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_) {
+    total_.bytes += cost.bytes;
+    total_.sessions += cost.sessions;
+  }
+
+  // Evicts functions until the cache is within its limits, returning them.
+  std::vector<std::shared_ptr<Function>> Evict(uint64_t inserted_key)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_) {
+    std::vector<std::shared_ptr<Function>> evicted;
+    // Evictable entries, least recently used first.
+    std::vector<std::pair<int64_t, uint64_t>> candidates;
+    for (auto& [key, entry] : entries_) {
+      if (key != inserted_key && !pins_->IsPinned(key)) {
+        candidates.emplace_back(
+            entry.last_used.load(std::memory_order_relaxed), key);
+      }
+    }
+    std::sort(candidates.begin(), candidates.end());
+    for (const auto& [last_used, key] : candidates) {
+      if (!OverBudget()) {
+        break;
+      }
+      auto it = entries_.find(key);
+      const FunctionCacheCost cost = it->second.cost;
+      // Only the cache holds the function, so evicting it frees its
+      // resources. Otherwise, they stay accounted for until it is released.
+      if (it->second.function.use_count() == 1) {
+        total_.bytes -= cost.bytes;
+        total_.sessions -= cost.sessions;
+      } else {
+        evicted_[key] = Evicted{it->second.function, cost};
+      }
+      evicted.push_back(std::move(it->second.function));
+      entries_.erase(it);
+      stats_->evictions.fetch_add(1, std::memory_order_relaxed);
+      VLOG(1) << "Evicted function " << key << " holding " << cost.bytes
+              << " bytes and " << cost.sessions << " sessions.";
+    }
+    if (OverBudget()) {
+      LOG_FIRST_N(WARNING, 10)
+          << "Function cache holds " << total_.bytes << " bytes and "
+          << total_.sessions << " sessions after evicting all "
+          << "evictable functions (limits: " << max_bytes_ << " bytes, "
+          << max_sessions_ << " sessions).";
+    }
+    return evicted;
+  }
+
+  bool OverBudget() const ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_) {
+    return (max_bytes_ > 0 && total_.bytes > max_bytes_) ||
+           (max_sessions_ > 0 && total_.sessions > max_sessions_);
+  }
+
+  void UpdateGauges() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_) {
+    stats_->entries.store(entries_.size(), std::memory_order_relaxed);
+    stats_->bytes.store(total_.bytes, std::memory_order_relaxed);
+    stats_->sessions.store(total_.sessions, std::memory_order_relaxed);
+  }
+
+  const int64_t max_bytes_;
+  const int64_t max_sessions_;
+  absl::Mutex mutex_;
+  // `Entry` holds an atomic, so entries need pointer stability.
+  absl::node_hash_map<uint64_t, Entry> entries_ ABSL_GUARDED_BY(mutex_);
+  absl::flat_hash_map<uint64_t, Evicted> evicted_ ABSL_GUARDED_BY(mutex_);
+  // Sums of the costs recorded in `entries_` and `evicted_`.
+  FunctionCacheCost total_ ABSL_GUARDED_BY(mutex_);
+  const std::shared_ptr<FunctionCachePins> pins_;
+  const std::shared_ptr<FunctionCacheStats> stats_;
+  const CostFn cost_fn_;
+};
+
+}  // namespace tensorflow_federated
+
+#endif  // THIRD_PARTY_TENSORFLOW_FEDERATED_CC_CORE_IMPL_EXECUTORS_FUNCTION_CACHE_H_
@@ -0,0 +1,200 @@
+/* Copyright 2026, The TensorFlow Federated Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+     http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License
+==============================================================================*/
+
+#include "tensorflow_federated/cc/core/impl/executors/function_cache.h"
+
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+#include "googletest/include/gtest/gtest.h"
+
+namespace tensorflow_federated {
+
+namespace {
+
+struct FakeFunction {
+  int64_t bytes = 0;
+  int64_t sessions = 0;
+};
+
+FunctionCacheCost FakeCost(const FakeFunction& function) {
+  return {function.bytes, function.sessions};
+}
+
+std::shared_ptr<FakeFunction> MakeFunction(int64_t bytes,
+                                           int64_t sessions = 0) {
+  return std::make_shared<FakeFunction>(FakeFunction{bytes, sessions});
+}
+
+TEST(FunctionCacheTest, GetReturnsInsertedFunction) {
+  FunctionCache<FakeFunction> cache({}, FakeCost);
+  EXPECT_EQ(cache.Get(1), nullptr);
+  std::shared_ptr<FakeFunction> function = MakeFunction(10);
+  EXPECT_EQ(cache.Insert(1, function), function);
+  EXPECT_EQ(cache.Get(1), function);
+  EXPECT_EQ(cache.stats().hits.load(), 1);
+  EXPECT_EQ(cache.stats().misses.load(), 1);
+}
+
+TEST(FunctionCacheTest, InsertReturnsExistingFunction) {
+  FunctionCache<FakeFunction> cache({}, FakeCost);
+  std::shared_ptr<FakeFunction> first = MakeFunction(10);
+  cache.Insert(1, first);
+  EXPECT_EQ(cache.Insert(1, MakeFunction(10)), first);
+  EXPECT_EQ(cache.size(), 1);
+}
+
+TEST(FunctionCacheTest, EvictsLeastRecentlyUsedOverByteLimit) {
+  FunctionCacheOptions options;
+  options.max_bytes = 25;
+  FunctionCache<FakeFunction> cache(std::move(options), FakeCost);
+  cache.Insert(1, MakeFunction(10));
+  cache.Insert(2, MakeFunction(10));
+  // Touch 1, so that 2 is the least recently used.
+  ASSERT_NE(cache.Get(1), nullptr);
+  cache.Insert(3, MakeFunction(10));
+  EXPECT_NE(cache.Get(1), nullptr);
+  EXPECT_EQ(cache.Get(2), nullptr);
+  EXPECT_NE(cache.Get(3), nullptr);
+  EXPECT_EQ(cache.stats().evictions.load(), 1);
+  EXPECT_EQ(cache.stats().entries.load(), 2);
+  EXPECT_EQ(cache.stats().bytes.load(), 20);
+}
+
+TEST(FunctionCacheTest, EvictsOverSessionLimit) {
+  FunctionCacheOptions options;
+  options.max_sessions = 2;
+  FunctionCache<FakeFunction> cache(std::move(options), FakeCost);
+  FakeFunction* first = cache.Insert(1, MakeFunction(0)).get();
+  // Sessions created after insertion are accounted for on the next insertion.
+  first->sessions = 2;
+  ASSERT_NE(cache.Get(1), nullptr);
+  EXPECT_EQ(cache.stats().sessions.load(), 0);
+  cache.Insert(2, MakeFunction(0, 1));
+  EXPECT_EQ(cache.Get(1), nullptr);
+  EXPECT_EQ(cache.stats().sessions.load(), 1);
+}
+
+TEST(FunctionCacheTest, NeverEvictsPinnedFunctions) {
+  FunctionCacheOptions options;
+  options.max_bytes = 15;
+  options.pinned_keys = {1};
+  FunctionCache<FakeFunction> cache(std::move(options), FakeCost);
+  cache.Insert(1, MakeFunction(10));
+  cache.Pin(2);
+  cache.Insert(2, MakeFunction(10));
+  cache.Insert(3, MakeFunction(10));
+  EXPECT_NE(cache.Get(1), nullptr);
+  EXPECT_NE(cache.Get(2), nullptr);
+  EXPECT_NE(cache.Get(3), nullptr);
+  cache.Unpin(2);
+  cache.Insert(4, MakeFunction(1));
+  EXPECT_NE(cache.Get(1), nullptr);
+  EXPECT_EQ(cache.Get(2), nullptr);
+  EXPECT_EQ(cache.Get(3), nullptr);
+  EXPECT_NE(cache.Get(4), nullptr);
+}
+
+TEST(FunctionCacheTest, AppliesSharedPins) {
+  auto pins = std::make_shared<FunctionCachePins>();
+  FunctionCacheOptions options;
+  options.max_bytes = 15;
+  options.pinned_keys = {1};
+  options.pins = pins;
+  FunctionCache<FakeFunction> cache(std::move(options), FakeCost);
+  EXPECT_TRUE(pins->IsPinned(1));
+  cache.Insert(1, MakeFunction(10));
+  cache.Insert(2, MakeFunction(10));
+  pins->Unpin(1);
+  cache.Insert(3, MakeFunction(1));
+  EXPECT_EQ(cache.Get(1), nullptr);
+  EXPECT_NE(cache.Get(3), nullptr);
+}
+
+TEST(FunctionCacheTest, LookupsDoNotWeighFunctions) {
+  int cost_calls = 0;
+  FunctionCacheOptions options;
+  options.max_bytes = 100;
+  FunctionCache<FakeFunction> cache(
+      std::move(options), [&cost_calls](const FakeFunction& function) {
+        ++cost_calls;
+        return FakeCost(function);
+      });
+  for (uint64_t key = 0; key < 10; ++key) {
+    cache.Insert(key, MakeFunction(10));
+  }
+  const int insertion_cost_calls = cost_calls;
+  for (uint64_t key = 0; key < 10; ++key) {
+    ASSERT_NE(cache.Get(key), nullptr);
+  }
+  EXPECT_EQ(cost_calls, insertion_cost_calls);
+  EXPECT_EQ(cache.stats().hits.load(), 10);
+}
+
+TEST(FunctionCacheTest, EvictedFunctionsInUseRemainValid) {
+  FunctionCacheOptions options;
+  options.max_bytes = 10;
+  FunctionCache<FakeFunction> cache(std::move(options), FakeCost);
+  std::shared_ptr<FakeFunction> in_use = cache.Insert(1, MakeFunction(10));
+  cache.Insert(2, MakeFunction(10));
+  EXPECT_EQ(cache.stats().evictions.load(), 1);
+  EXPECT_EQ(cache.stats().entries.load(), 1);
+  EXPECT_EQ(in_use->bytes, 10);
+  // The evicted function still holds its resources, and is returned rather
+  // than duplicated.
+  EXPECT_EQ(cache.stats().bytes.load(), 20);
+  EXPECT_EQ(cache.Get(1), in_use);
+}
+
+TEST(FunctionCacheTest, ReinsertingEvictedFunctionInUseReturnsIt) {
+  FunctionCacheOptions options;
+  options.max_bytes = 10;
+  FunctionCache<FakeFunction> cache(std::move(options), FakeCost);
+  std::shared_ptr<FakeFunction> in_use = cache.Insert(1, MakeFunction(10));
+  cache.Insert(2, MakeFunction(10));
+  EXPECT_EQ(cache.Insert(1, MakeFunction(10)), in_use);
+  // Bringing it back evicts the other function, which is no longer in use.
+  EXPECT_EQ(cache.Get(2), nullptr);
+  EXPECT_EQ(cache.stats().bytes.load(), 10);
+}
+
+TEST(FunctionCacheTest, ReleasesEvictedFunctionsOnceUnused) {
+  FunctionCacheOptions options;
+  options.max_bytes = 10;
+  FunctionCache<FakeFunction> cache(std::move(options), FakeCost);
+  std::shared_ptr<FakeFunction> in_use = cache.Insert(1, MakeFunction(10));
+  cache.Insert(2, MakeFunction(10));
+  in_use.reset();
+  EXPECT_EQ(cache.Get(1), nullptr);
+  cache.Insert(3, MakeFunction(0));
+  EXPECT_EQ(cache.stats().bytes.load(), 10);
+  EXPECT_NE(cache.Get(2), nullptr);
+}
+
+TEST(FunctionCacheTest, ReportsIntoSharedStats) {
+  auto stats = std::make_shared<FunctionCacheStats>();
+  FunctionCacheOptions options;
+  options.stats = stats;
+  FunctionCache<FakeFunction> cache(std::move(options), FakeCost);
+  cache.Insert(1, MakeFunction(7, 1));
+  EXPECT_EQ(stats->entries.load(), 1);
+  EXPECT_EQ(stats->bytes.load(), 7);
+  EXPECT_EQ(stats->sessions.load(), 1);
+}
+
+}  // namespace
+
+}  // namespace tensorflow_federated
@@ -0,0 +1,85 @@
+/* Copyright 2026, The TensorFlow Federated Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+     http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License
+==============================================================================*/
+
+#include "tensorflow_federated/cc/core/impl/executors/memory_budget.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+#include "absl/log/log.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+
+namespace tensorflow_federated {
+
+MemoryCharge::~MemoryCharge() { budget_->Release(bytes_); }
+
+std::shared_ptr<MemoryBudget> MemoryBudget::Create(
+    int64_t high_water_mark_bytes, absl::Duration max_delay) {
+  return std::shared_ptr<MemoryBudget>(
+      new MemoryBudget(high_water_mark_bytes, max_delay));
+}
+
+std::shared_ptr<const MemoryCharge> MemoryBudget::Charge(int64_t bytes) {
+  if (bytes <= 0) {
+    return nullptr;
+  }
+  int64_t used =
+      used_bytes_.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+  int64_t peak = peak_bytes_.load(std::memory_order_relaxed);
+  while (used > peak && !peak_bytes_.compare_exchange_weak(
+                            peak, used, std::memory_order_relaxed)) {
+  }
+  // `MemoryCharge`'s constructor is private, so `make_shared` can't be used.
+  return std::shared_ptr<const MemoryCharge>(
+      new MemoryCharge(shared_from_this(), bytes));
+}
+
+bool MemoryBudget::HasCapacity() const {
+  return high_water_mark_bytes_ <= 0 ||
+         used_bytes_.load(std::memory_order_seq_cst) < high_water_mark_bytes_;
+}
+
+void MemoryBudget::WaitForCapacity() {
+  if (HasCapacity()) {
+    return;
+  }
+  delayed_calls_.fetch_add(1, std::memory_order_relaxed);
+  absl::MutexLock lock(&mutex_);
+  waiters_.fetch_add(1, std::memory_order_seq_cst);
+  bool has_capacity =
+      mutex_.AwaitWithTimeout(absl::Condition(this, &MemoryBudget::HasCapacity),
+                              max_delay_);
+  waiters_.fetch_sub(1, std::memory_order_relaxed);
+  if (!has_capacity) {
+    timed_out_calls_.fetch_add(1, std::memory_order_relaxed);
+    LOG_FIRST_N(WARNING, 10)
+        << "Proceeding after waiting " << max_delay_
+        << " for memory to be released: " << used_bytes()
+        << " bytes in use, high-water mark is " << high_water_mark_bytes_
+        << " bytes.";
+  }
+}
+
+void MemoryBudget::Release(int64_t bytes) {
+  used_bytes_.fetch_sub(bytes, std::memory_order_seq_cst);
+  if (waiters_.load(std::memory_order_seq_cst) > 0) {
+    // Waiters re-evaluate their condition when the mutex is released.
+    absl::MutexLock lock(&mutex_);
+  }
+}
+
+}  // namespace tensorflow_federated
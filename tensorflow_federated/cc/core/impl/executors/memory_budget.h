@@ -0,0 +1,129 @@
+/* Copyright 2026, The TensorFlow Federated Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+     http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License
+==============================================================================*/
+
+#ifndef THIRD_PARTY_TENSORFLOW_FEDERATED_CC_CORE_IMPL_EXECUTORS_MEMORY_BUDGET_H_
+#define THIRD_PARTY_TENSORFLOW_FEDERATED_CC_CORE_IMPL_EXECUTORS_MEMORY_BUDGET_H_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+
+namespace tensorflow_federated {
+
+class MemoryBudget;
+
+// Bytes charged against a `MemoryBudget`. The bytes are released when the
+// charge is destroyed, so a charge is usually held (behind a `shared_ptr`) by
+// the value whose memory it accounts for.
+class MemoryCharge {
+ public:
+  ~MemoryCharge();
+
+  MemoryCharge(const MemoryCharge&) = delete;
+  MemoryCharge& operator=(const MemoryCharge&) = delete;
+
+  int64_t bytes() const { return bytes_; }
+
+ private:
+  friend class MemoryBudget;
+  MemoryCharge(std::shared_ptr<MemoryBudget> budget, int64_t bytes)
+      : budget_(std::move(budget)), bytes_(bytes) {}
+
+  const std::shared_ptr<MemoryBudget> budget_;
+  const int64_t bytes_;
+};
+
+// Accounts for the bytes held by the values an executor is tracking, and
+// applies backpressure to new work once they reach a high-water mark.
+//
+// Charging never blocks: a value that already exists is always accounted for,
+// even when the budget is over its high-water mark. Instead, executors call
+// `WaitForCapacity` before starting new work (e.g. in `CreateCall`), so that
+// under memory pressure a workload runs with lower throughput rather than
+// running out of memory.
+class MemoryBudget : public std::enable_shared_from_this<MemoryBudget> {
+ public:
+  // Creates a budget that delays new work while at least
+  // `high_water_mark_bytes` are charged. Non-positive values disable the
+  // high-water mark, only tracking usage.
+  //
+  // Each call to `WaitForCapacity` waits at most `max_delay`, after which the
+  // work proceeds anyway. This guarantees progress when the memory can only
+  // be released by the delayed work itself.
+  static std::shared_ptr<MemoryBudget> Create(
+      int64_t high_water_mark_bytes = -1,
+      absl::Duration max_delay = absl::Seconds(30));
+
+  MemoryBudget(const MemoryBudget&) = delete;
+  MemoryBudget& operator=(const MemoryBudget&) = delete;
+
+  // Charges `bytes` against the budget until the returned charge is
+  // destroyed. Returns `nullptr` if `bytes` is not positive.
+  std::shared_ptr<const MemoryCharge> Charge(int64_t bytes);
+
+  // Blocks while the charged bytes are at or above the high-water mark, for at
+  // most `max_delay`. Returns immediately if no high-water mark is set.
+  //
+  // Asynchronous executors call this from the task that runs the delayed
+  // work. Executors which create values synchronously (e.g.
+  // `FederatingExecutor`) call it from `CreateCall` itself, and document that
+  // their `CreateCall` may block.
+  void WaitForCapacity();
+
+  int64_t high_water_mark_bytes() const { return high_water_mark_bytes_; }
+  // Bytes currently charged.
+  int64_t used_bytes() const {
+    return used_bytes_.load(std::memory_order_relaxed);
+  }
+  // The maximum of `used_bytes()` over the budget's lifetime.
+  int64_t peak_bytes() const {
+    return peak_bytes_.load(std::memory_order_relaxed);
+  }
+  // Number of `WaitForCapacity` calls that had to wait.
+  int64_t delayed_calls() const {
+    return delayed_calls_.load(std::memory_order_relaxed);
+  }
+  // Number of `WaitForCapacity` calls that gave up waiting after `max_delay`.
+  int64_t timed_out_calls() const {
+    return timed_out_calls_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  friend class MemoryCharge;
+  MemoryBudget(int64_t high_water_mark_bytes, absl::Duration max_delay)
+      : high_water_mark_bytes_(high_water_mark_bytes), max_delay_(max_delay) {}
+
+  bool HasCapacity() const;
+  void Release(int64_t bytes);
+
+  const int64_t high_water_mark_bytes_;
+  const absl::Duration max_delay_;
+  std::atomic<int64_t> used_bytes_{0};
+  std::atomic<int64_t> peak_bytes_{0};
+  std::atomic<int64_t> delayed_calls_{0};
+  std::atomic<int64_t> timed_out_calls_{0};
+  // Number of callers blocked in `WaitForCapacity`. Releases only take
+  // `mutex_` (to wake them up) when this is non-zero.
+  std::atomic<int32_t> waiters_{0};
+  absl::Mutex mutex_;
+};
+
+}  // namespace tensorflow_federated
+
+#endif  // THIRD_PARTY_TENSORFLOW_FEDERATED_CC_CORE_IMPL_EXECUTORS_MEMORY_BUDGET_H_
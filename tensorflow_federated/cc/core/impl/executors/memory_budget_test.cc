@@ -0,0 +1,101 @@
+/* Copyright 2026, The TensorFlow Federated Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+     http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License
+==============================================================================*/
+
+#include "tensorflow_federated/cc/core/impl/executors/memory_budget.h"
+
+#include <memory>
+#include <thread>  // NOLINT
+
+#include "googletest/include/gtest/gtest.h"
+#include "absl/synchronization/notification.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+
+namespace tensorflow_federated {
+
+namespace {
+
+TEST(MemoryBudgetTest, TracksUsedAndPeakBytes) {
+  std::shared_ptr<MemoryBudget> budget = MemoryBudget::Create();
+  std::shared_ptr<const MemoryCharge> first = budget->Charge(100);
+  {
+    std::shared_ptr<const MemoryCharge> second = budget->Charge(50);
+    EXPECT_EQ(second->bytes(), 50);
+    EXPECT_EQ(budget->used_bytes(), 150);
+  }
+  EXPECT_EQ(budget->used_bytes(), 100);
+  first = nullptr;
+  EXPECT_EQ(budget->used_bytes(), 0);
+  EXPECT_EQ(budget->peak_bytes(), 150);
+}
+
+TEST(MemoryBudgetTest, EmptyChargeIsNull) {
+  std::shared_ptr<MemoryBudget> budget = MemoryBudget::Create();
+  EXPECT_EQ(budget->Charge(0), nullptr);
+  EXPECT_EQ(budget->used_bytes(), 0);
+}
+
+TEST(MemoryBudgetTest, ChargeKeepsBudgetAlive) {
+  std::shared_ptr<const MemoryCharge> charge =
+      MemoryBudget::Create()->Charge(10);
+  // Releasing the charge after the budget's last owner is gone must be safe.
+  charge = nullptr;
+}
+
+TEST(MemoryBudgetTest, WaitForCapacityReturnsImmediatelyWithoutLimit) {
+  std::shared_ptr<MemoryBudget> budget = MemoryBudget::Create();
+  std::shared_ptr<const MemoryCharge> charge = budget->Charge(1 << 30);
+  budget->WaitForCapacity();
+  EXPECT_EQ(budget->delayed_calls(), 0);
+}
+
+TEST(MemoryBudgetTest, WaitForCapacityReturnsImmediatelyBelowLimit) {
+  std::shared_ptr<MemoryBudget> budget = MemoryBudget::Create(100);
+  std::shared_ptr<const MemoryCharge> charge = budget->Charge(99);
+  budget->WaitForCapacity();
+  EXPECT_EQ(budget->delayed_calls(), 0);
+}
+
+TEST(MemoryBudgetTest, WaitForCapacityWaitsForRelease) {
+  std::shared_ptr<MemoryBudget> budget =
+      MemoryBudget::Create(100, absl::InfiniteDuration());
+  std::shared_ptr<const MemoryCharge> charge = budget->Charge(100);
+  absl::Notification done;
+  std::thread waiter([&budget, &done]() {
+    budget->WaitForCapacity();
+    done.Notify();
+  });
+  EXPECT_FALSE(done.WaitForNotificationWithTimeout(absl::Milliseconds(50)));
+  charge = nullptr;
+  EXPECT_TRUE(done.WaitForNotificationWithTimeout(absl::Seconds(10)));
+  waiter.join();
+  EXPECT_EQ(budget->delayed_calls(), 1);
+  EXPECT_EQ(budget->timed_out_calls(), 0);
+}
+
+TEST(MemoryBudgetTest, WaitForCapacityGivesUpAfterMaxDelay) {
+  std::shared_ptr<MemoryBudget> budget =
+      MemoryBudget::Create(100, absl::Milliseconds(10));
+  std::shared_ptr<const MemoryCharge> charge = budget->Charge(200);
+  absl::Time start = absl::Now();
+  budget->WaitForCapacity();
+  EXPECT_GE(absl::Now() - start, absl::Milliseconds(10));
+  EXPECT_EQ(budget->delayed_calls(), 1);
+  EXPECT_EQ(budget->timed_out_calls(), 1);
+}
+
+}  // namespace
+
+}  // namespace tensorflow_federated
@@ -50,6 +50,10 @@ class MockExecutor : public Executor,
               (const absl::Span<const ValueId> members), (override));
   MOCK_METHOD(absl::StatusOr<OwnedValueId>, CreateSelection,
               (const ValueId source, const uint32_t index), (override));
+  MOCK_METHOD(absl::StatusOr<OwnedValueId>, CreateClientsSubset,
+              (const ValueId value,
+               absl::Span<const int32_t> client_indices),
+              (override));
   MOCK_METHOD(absl::Status, Materialize,
               (const ValueId value, v0::Value* value_pb), (override));
   MOCK_METHOD(absl::Status, Dispose, (const ValueId value), (override));
@@ -94,6 +98,13 @@ class MockExecutor : public Executor,
                            repeatedly);
   }
 
+  inline ValueId ExpectCreateClientsSubset(
+      ValueId value_id, std::vector<int32_t> client_indices) {
+    return ReturnsNewValue(EXPECT_CALL(
+        *this, CreateClientsSubset(
+                   value_id, ::testing::ElementsAreArray(client_indices))));
+  }
+
   inline void ExpectMaterialize(ValueId id, v0::Value to_return,
                                 ::testing::Cardinality repeatedly = ONCE) {
     EXPECT_CALL(*this, Materialize(id, ::testing::_))
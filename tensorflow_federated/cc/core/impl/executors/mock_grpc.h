@@ -49,6 +49,9 @@ class MockGrpcExecutorService : public v0::ExecutorGroup::Service {
   MOCK_METHOD(grpc::Status, Compute,
               (grpc::ServerContext*, const v0::ComputeRequest*,
                v0::ComputeResponse*));
+  MOCK_METHOD(grpc::Status, ComputeClients,
+              (grpc::ServerContext*, const v0::ComputeClientsRequest*,
+               grpc::ServerWriter<v0::ComputeClientsResponse>*));
   MOCK_METHOD(grpc::Status, Dispose,
               (grpc::ServerContext*, const v0::DisposeRequest*,
                v0::DisposeResponse*));
@@ -24,12 +24,14 @@ limitations under the License
 #include <variant>
 #include <vector>
 
+#include "absl/functional/function_ref.h"
 #include "absl/log/log.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_join.h"
 #include "absl/strings/string_view.h"
+#include "absl/types/span.h"
 #include "federated_language/proto/computation.pb.h"
 #include "tensorflow_federated/cc/core/impl/executors/executor.h"
 #include "tensorflow_federated/cc/core/impl/executors/status_macros.h"
@@ -228,6 +230,16 @@ class ReferenceResolvingExecutor
 
   absl::Status Materialize(std::shared_ptr<ExecutorValue> value,
                            v0::Value* value_pb) final;
+  absl::Status MaterializeSequenceChunks(
+      std::shared_ptr<ExecutorValue> value, int32_t chunk_size,
+      absl::FunctionRef<absl::Status(v0::Value::Sequence)> consume) final;
+  absl::Status MaterializeClients(
+      std::shared_ptr<ExecutorValue> value,
+      absl::Span<const int32_t> client_indices,
+      absl::FunctionRef<absl::Status(int32_t, v0::Value)> consume) final;
+  absl::StatusOr<std::shared_ptr<ExecutorValue>> CreateClientsSubset(
+      std::shared_ptr<ExecutorValue> value,
+      absl::Span<const int32_t> client_indices) final;
 
  private:
   std::shared_ptr<Executor> child_executor_;
@@ -470,6 +482,35 @@ absl::Status ReferenceResolvingExecutor::Materialize(
   return child_executor_->Materialize(child_value_id, value_pb);
 }
 
+absl::Status ReferenceResolvingExecutor::MaterializeSequenceChunks(
+    std::shared_ptr<ExecutorValue> value, int32_t chunk_size,
+    absl::FunctionRef<absl::Status(v0::Value::Sequence)> consume) {
+  std::optional<OwnedValueId> slot;
+  ValueId child_value_id = TFF_TRY(Embed(*value, &slot));
+  return child_executor_->MaterializeSequenceChunks(child_value_id, chunk_size,
+                                                    consume);
+}
+
+absl::Status ReferenceResolvingExecutor::MaterializeClients(
+    std::shared_ptr<ExecutorValue> value,
+    absl::Span<const int32_t> client_indices,
+    absl::FunctionRef<absl::Status(int32_t, v0::Value)> consume) {
+  std::optional<OwnedValueId> slot;
+  ValueId child_value_id = TFF_TRY(Embed(*value, &slot));
+  return child_executor_->MaterializeClients(child_value_id, client_indices,
+                                             consume);
+}
+
+absl::StatusOr<std::shared_ptr<ExecutorValue>>
+ReferenceResolvingExecutor::CreateClientsSubset(
+    std::shared_ptr<ExecutorValue> value,
+    absl::Span<const int32_t> client_indices) {
+  std::optional<OwnedValueId> slot;
+  ValueId child_value_id = TFF_TRY(Embed(*value, &slot));
+  return std::make_shared<ExecutorValue>(TFF_TRY(
+      child_executor_->CreateClientsSubset(child_value_id, client_indices)));
+}
+
 absl::StatusOr<ValueId> ReferenceResolvingExecutor::Embed(
     const ExecutorValue& value, std::optional<OwnedValueId>* slot) const {
   switch (value.type()) {
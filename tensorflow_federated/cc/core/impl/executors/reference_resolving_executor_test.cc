@@ -46,6 +46,7 @@ limitations under the License
 #include "tensorflow_federated/cc/core/impl/executors/array_shape_test_utils.h"
 #include "tensorflow_federated/cc/core/impl/executors/array_test_utils.h"
 #include "tensorflow_federated/cc/core/impl/executors/executor.h"
+#include "tensorflow_federated/cc/core/impl/executors/executor_metrics.h"
 #include "tensorflow_federated/cc/core/impl/executors/executor_test_base.h"
 #include "tensorflow_federated/cc/core/impl/executors/mock_executor.h"
 #include "tensorflow_federated/cc/core/impl/executors/value_test_utils.h"
@@ -63,6 +64,7 @@ using ::testing::_;
 using testing::BlockComputation;
 using testing::ComputationV;
 using testing::DataComputation;
+using ::testing::ElementsAre;
 using ::testing::ElementsAreArray;
 using ::testing::Eq;
 using testing::EqualsProto;
@@ -75,6 +77,7 @@ using testing::PlacementComputation;
 using testing::ReferenceComputation;
 using ::testing::Return;
 using testing::SelectionComputation;
+using testing::SequenceV;
 using ::testing::StrictMock;
 using testing::StructComputation;
 using testing::StructV;
@@ -123,6 +126,23 @@ TEST_F(ReferenceResolvingExecutorTest, CreateValueTensor) {
   }
 }
 
+TEST_F(ReferenceResolvingExecutorTest, CreateValueRecordsMethodMetrics) {
+  ExecutorMethodMetrics* metrics =
+      GetExecutorMethodMetrics("ReferenceResolvingExecutor", "CreateValue");
+  const int64_t calls_before = metrics->Snapshot().calls;
+  federated_language::Array array_pb =
+      TFF_ASSERT_OK(testing::CreateArray(federated_language::DataType::DT_FLOAT,
+                                         testing::CreateArrayShape({}), {1.0}));
+  v0::Value value_pb;
+  value_pb.mutable_array()->Swap(&array_pb);
+  constexpr int kNumValues = 3;
+  mock_executor_->ExpectCreateValue(value_pb, Exactly(kNumValues));
+  for (int i = 0; i < kNumValues; ++i) {
+    TFF_ASSERT_OK(test_executor_->CreateValue(value_pb));
+  }
+  EXPECT_EQ(metrics->Snapshot().calls, calls_before + kNumValues);
+}
+
 TEST_F(ReferenceResolvingExecutorTest, CreateValueSequence) {
   v0::Value sequence_val_pb;
   *sequence_val_pb.mutable_sequence() = v0::Value::Sequence();
@@ -134,6 +154,21 @@ TEST_F(ReferenceResolvingExecutorTest, CreateValueSequence) {
   }
 }
 
+TEST_F(ReferenceResolvingExecutorTest, MaterializeSequenceChunksForwards) {
+  v0::Value sequence_val_pb = SequenceV(0, 5, 1);
+  ValueId child_id = mock_executor_->ExpectCreateValue(sequence_val_pb);
+  mock_executor_->ExpectMaterialize(child_id, sequence_val_pb);
+  OwnedValueId id =
+      TFF_ASSERT_OK(test_executor_->CreateValue(sequence_val_pb));
+  std::vector<int> chunk_sizes;
+  TFF_ASSERT_OK(test_executor_->MaterializeSequenceChunks(
+      id, 2, [&chunk_sizes](v0::Value::Sequence chunk_pb) {
+        chunk_sizes.push_back(chunk_pb.element_size());
+        return absl::OkStatus();
+      }));
+  EXPECT_THAT(chunk_sizes, ElementsAre(2, 2, 1));
+}
+
 TEST_F(ReferenceResolvingExecutorTest, CreateValueFederatedTensor) {
   v0::Value federated_value_pb;
   v0::Value::Federated* federated_pb = federated_value_pb.mutable_federated();
@@ -813,6 +848,93 @@ TEST_F(ReferenceResolvingExecutorTest, CreateSelection) {
   ExpectMaterialize(create_selection_result.value(), value3_pb);
 }
 
+TEST_F(ReferenceResolvingExecutorTest, CreateCallBatch) {
+  v0::Value computation_pb;
+  computation_pb.mutable_computation()->mutable_tensorflow();
+  ValueId function_child_id = mock_executor_->ExpectCreateValue(computation_pb);
+  OwnedValueId function =
+      TFF_ASSERT_OK(test_executor_->CreateValue(computation_pb));
+  std::vector<OwnedValueId> args;
+  std::vector<ValueId> arg_child_ids;
+  for (int i = 0; i < 2; ++i) {
+    federated_language::Array array_pb = TFF_ASSERT_OK(testing::CreateArray(
+        federated_language::DataType::DT_FLOAT, testing::CreateArrayShape({}),
+        {static_cast<float>(i)}));
+    v0::Value value_pb;
+    value_pb.mutable_array()->Swap(&array_pb);
+    arg_child_ids.push_back(mock_executor_->ExpectCreateValue(value_pb));
+    args.push_back(TFF_ASSERT_OK(test_executor_->CreateValue(value_pb)));
+  }
+  std::vector<ValueId> result_child_ids;
+  for (ValueId arg_child_id : arg_child_ids) {
+    result_child_ids.push_back(mock_executor_->ExpectCreateCall(
+        function_child_id, arg_child_id));
+  }
+  std::vector<CallArgs> calls = {{function.ref(), args[0].ref()},
+                                 {function.ref(), args[1].ref()}};
+  std::vector<OwnedValueId> results =
+      TFF_ASSERT_OK(test_executor_->CreateCallBatch(calls));
+  ASSERT_EQ(results.size(), 2);
+  EXPECT_EQ(results[0].ref(), 3);
+  EXPECT_EQ(results[1].ref(), 4);
+  federated_language::Array array_pb =
+      TFF_ASSERT_OK(testing::CreateArray(federated_language::DataType::DT_FLOAT,
+                                         testing::CreateArrayShape({}), {1.0}));
+  v0::Value value_pb;
+  value_pb.mutable_array()->Swap(&array_pb);
+  mock_executor_->ExpectMaterialize(result_child_ids[1], value_pb);
+  ExpectMaterialize(results[1], value_pb);
+}
+
+TEST_F(ReferenceResolvingExecutorTest, CreateStructAndSelectionBatch) {
+  std::vector<OwnedValueId> elements;
+  std::vector<ValueId> element_child_ids;
+  for (int i = 0; i < 2; ++i) {
+    federated_language::Array array_pb = TFF_ASSERT_OK(testing::CreateArray(
+        federated_language::DataType::DT_FLOAT, testing::CreateArrayShape({}),
+        {static_cast<float>(i)}));
+    v0::Value value_pb;
+    value_pb.mutable_array()->Swap(&array_pb);
+    element_child_ids.push_back(mock_executor_->ExpectCreateValue(value_pb));
+    elements.push_back(TFF_ASSERT_OK(test_executor_->CreateValue(value_pb)));
+  }
+  // Structs and selections are lazy, so neither batch reaches the child.
+  std::vector<std::vector<ValueId>> structs = {
+      {elements[0].ref(), elements[1].ref()},
+      {elements[1].ref(), elements[0].ref()}};
+  std::vector<OwnedValueId> struct_ids =
+      TFF_ASSERT_OK(test_executor_->CreateStructBatch(structs));
+  ASSERT_EQ(struct_ids.size(), 2);
+  std::vector<SelectionArgs> selections = {{struct_ids[0].ref(), 1},
+                                           {struct_ids[1].ref(), 1}};
+  std::vector<OwnedValueId> selection_ids =
+      TFF_ASSERT_OK(test_executor_->CreateSelectionBatch(selections));
+  ASSERT_EQ(selection_ids.size(), 2);
+  federated_language::Array array_pb =
+      TFF_ASSERT_OK(testing::CreateArray(federated_language::DataType::DT_FLOAT,
+                                         testing::CreateArrayShape({}), {1.0}));
+  v0::Value value_pb;
+  value_pb.mutable_array()->Swap(&array_pb);
+  mock_executor_->ExpectMaterialize(element_child_ids[0], value_pb);
+  ExpectMaterialize(selection_ids[1], value_pb);
+}
+
+TEST_F(ReferenceResolvingExecutorTest, CreateSelectionBatchFailsInvalidIndex) {
+  federated_language::Array array_pb =
+      TFF_ASSERT_OK(testing::CreateArray(federated_language::DataType::DT_FLOAT,
+                                         testing::CreateArrayShape({}), {1.0}));
+  v0::Value value_pb;
+  value_pb.mutable_array()->Swap(&array_pb);
+  mock_executor_->ExpectCreateValue(value_pb);
+  OwnedValueId struct_id =
+      TFF_ASSERT_OK(test_executor_->CreateValue(StructV({value_pb})));
+  std::vector<SelectionArgs> selections = {{struct_id.ref(), 0},
+                                           {struct_id.ref(), 1}};
+  EXPECT_THAT(test_executor_->CreateSelectionBatch(selections),
+              StatusIs(StatusCode::kNotFound,
+                       HasSubstr("index [1] on structure with length [1]")));
+}
+
 TEST_F(ReferenceResolvingExecutorTest, CreateValueComputationSelection) {
   v0::Value selection_value_pb = ComputationV(
       SelectionComputation(StructComputation({DataComputation("test_data1"),
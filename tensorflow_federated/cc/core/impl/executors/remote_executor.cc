@@ -15,7 +15,9 @@ limitations under the License
 
 #include "tensorflow_federated/cc/core/impl/executors/remote_executor.h"
 
+#include <cstddef>
 #include <cstdint>
+#include <functional>
 #include <future>  // NOLINT
 #include <memory>
 #include <optional>
@@ -23,15 +25,18 @@ limitations under the License
 #include <vector>
 
 #include "absl/base/thread_annotations.h"
+#include "absl/functional/function_ref.h"
 #include "absl/log/log.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/string_view.h"
 #include "absl/synchronization/mutex.h"
+#include "absl/types/span.h"
 #include "include/grpcpp/grpcpp.h"
 #include "include/grpcpp/support/status.h"
 #include "federated_language/proto/computation.pb.h"
 #include "tensorflow_federated/cc/core/impl/executors/cardinalities.h"
+#include "tensorflow_federated/cc/core/impl/executors/continuation_future.h"
 #include "tensorflow_federated/cc/core/impl/executors/executor.h"
 #include "tensorflow_federated/cc/core/impl/executors/status_conversion.h"
 #include "tensorflow_federated/cc/core/impl/executors/status_macros.h"
@@ -43,8 +48,10 @@ namespace tensorflow_federated {
 
 class ExecutorValue;
 
-using ValueFuture =
-    std::shared_future<absl::StatusOr<std::shared_ptr<ExecutorValue>>>;
+// Dropping the last reference to a pending value cancels its RPC. Continuation
+// futures let calls on pending values wait for them without parking a thread.
+using ValueFuture = CancellableContinuationFuture<
+    absl::StatusOr<std::shared_ptr<ExecutorValue>>>;
 
 // A custom deleter for the `std::shared_ptr<v0::ExecutorGroup::StubInterface>`
 // which will call `DisposeExecutor` for the provided `executor_pb`, if any.
@@ -67,6 +74,7 @@ class StubDeleter {
         v0::DisposeExecutorResponse response;
         grpc::ClientContext context;
         *request.mutable_executor() = std::move(executor_pb);
+        ScopedBlockingRegion blocking;
         grpc::Status dispose_status =
             stub->DisposeExecutor(&context, request, &response);
         if (!dispose_status.ok()) {
@@ -85,6 +93,23 @@ class StubDeleter {
   std::optional<v0::ExecutorId> executor_pb_;
 };
 
+namespace {
+
+// Returns a `CancelledError` if the value being created has been disposed of.
+//
+// Called just before sending an RPC which creates a value, rather than
+// cancelling the RPC in flight: the worker may still create the value for a
+// cancelled RPC, and without its response the ref could never be disposed.
+absl::Status CheckNotCancelled(const CancellationToken& cancellation) {
+  if (cancellation.IsCancelled()) {
+    return absl::CancelledError(
+        "Value was disposed of before its RPC was sent.");
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace
+
 class RemoteExecutor : public ExecutorBase<ValueFuture> {
  public:
   RemoteExecutor(std::unique_ptr<v0::ExecutorGroup::StubInterface> stub,
@@ -112,7 +137,41 @@ class RemoteExecutor : public ExecutorBase<ValueFuture> {
 
   absl::Status Materialize(ValueFuture value, v0::Value* value_pb) final;
 
+  absl::Status MaterializeClients(
+      ValueFuture value, absl::Span<const int32_t> client_indices,
+      absl::FunctionRef<absl::Status(int32_t, v0::Value)> consume) final;
+
+  absl::StatusOr<std::vector<ValueFuture>> CreateCallBatch(
+      std::vector<std::pair<ValueFuture, std::optional<ValueFuture>>> calls)
+      final;
+
+  absl::StatusOr<std::vector<ValueFuture>> CreateStructBatch(
+      std::vector<std::vector<ValueFuture>> structs) final;
+
+  absl::StatusOr<std::vector<ValueFuture>> CreateSelectionBatch(
+      std::vector<std::pair<ValueFuture, uint32_t>> selections) final;
+
  private:
+  // An asynchronous `ExecutorGroup` method, e.g. `CreateCall`.
+  using AsyncStub = v0::ExecutorGroup::StubInterface::async_interface;
+  template <typename Request, typename Response>
+  using AsyncMethod = void (AsyncStub::*)(grpc::ClientContext*, const Request*,
+                                          Response*,
+                                          std::function<void(grpc::Status)>);
+
+  // Issues one asynchronous `method` RPC per element of a batch as soon as
+  // the inputs of that element are ready, without parking a thread on either.
+  // `prepare(i, values, request)` fills in the request of element `i` from the
+  // values of `inputs[i]`.
+  template <typename Request, typename Response>
+  std::vector<ValueFuture> DispatchBatch(
+      std::vector<std::vector<ValueFuture>> inputs,
+      std::function<void(size_t,
+                         const std::vector<std::shared_ptr<ExecutorValue>>&,
+                         Request*)>
+          prepare,
+      AsyncMethod<Request, Response> method);
+
   absl::Status EnsureInitialized();
   std::shared_ptr<v0::ExecutorGroup::StubInterface> stub_;
   CardinalityMap cardinalities_;
@@ -138,6 +197,7 @@ class ExecutorValue {
       grpc::ClientContext context;
       *request.mutable_executor() = std::move(executor_pb);
       *request.add_value_ref() = value_ref;
+      ScopedBlockingRegion blocking;
       grpc::Status dispose_status = stub->Dispose(&context, request, &response);
       if (!dispose_status.ok()) {
         LOG(ERROR) << "Error disposing of ExecutorValue [" << value_ref.id()
@@ -173,6 +233,7 @@ absl::Status RemoteExecutor::EnsureInitialized() {
   }
   v0::GetExecutorResponse response;
   grpc::ClientContext client_context;
+  ScopedBlockingRegion blocking;
   auto result = stub_->GetExecutor(&client_context, request, &response);
   if (result.ok()) {
     executor_pb_ = response.executor();
@@ -187,94 +248,112 @@ absl::Status RemoteExecutor::EnsureInitialized() {
 absl::StatusOr<ValueFuture> RemoteExecutor::CreateExecutorValue(
     const v0::Value& value_pb) {
   TFF_TRY(EnsureInitialized());
-  return ThreadRun([value_pb, this, this_keepalive = shared_from_this()]()
-                       -> absl::StatusOr<std::shared_ptr<ExecutorValue>> {
-    v0::CreateValueRequest request;
-    *request.mutable_executor() = executor_pb_;
-    *request.mutable_value() = value_pb;
-    v0::CreateValueResponse response;
-    grpc::ClientContext client_context;
-    grpc::Status status =
-        stub_->CreateValue(&client_context, request, &response);
-    TFF_TRY(grpc_to_absl(status));
-    return std::make_shared<ExecutorValue>(std::move(response.value_ref()),
-                                           executor_pb_, stub_);
-  });
+  return MapCancellable(
+      std::vector<ValueFuture>(),
+      [value_pb, this, this_keepalive = shared_from_this()](
+          const CancellationToken& cancellation,
+          std::vector<std::shared_ptr<ExecutorValue>>&&)
+          -> absl::StatusOr<std::shared_ptr<ExecutorValue>> {
+        v0::CreateValueRequest request;
+        *request.mutable_executor() = executor_pb_;
+        *request.mutable_value() = value_pb;
+        v0::CreateValueResponse response;
+        grpc::ClientContext client_context;
+        TFF_TRY(CheckNotCancelled(cancellation));
+        ScopedBlockingRegion blocking;
+        grpc::Status status =
+            stub_->CreateValue(&client_context, request, &response);
+        TFF_TRY(grpc_to_absl(status));
+        return std::make_shared<ExecutorValue>(
+            std::move(response.value_ref()), executor_pb_, stub_);
+      });
 }
 
 absl::StatusOr<ValueFuture> RemoteExecutor::CreateCall(
     ValueFuture function, std::optional<ValueFuture> argument) {
   TFF_TRY(EnsureInitialized());
-  return ThreadRun([function = std::move(function),
-                    argument = std::move(argument), executor_pb = executor_pb_,
-                    this, this_keepalive = shared_from_this()]()
-                       -> absl::StatusOr<std::shared_ptr<ExecutorValue>> {
-    v0::CreateCallRequest request;
-    v0::CreateCallResponse response;
-    grpc::ClientContext context;
-    std::shared_ptr<ExecutorValue> fn = TFF_TRY(Wait(function));
-
-    *request.mutable_executor() = executor_pb;
-    *request.mutable_function_ref() = fn->Get();
-    if (argument.has_value()) {
-      std::shared_ptr<ExecutorValue> arg_value =
-          TFF_TRY(Wait(argument.value()));
-      *request.mutable_argument_ref() = arg_value->Get();
-    }
+  std::vector<ValueFuture> futures = {std::move(function)};
+  if (argument.has_value()) {
+    futures.push_back(std::move(*argument));
+  }
+  return MapCancellable(
+      std::move(futures),
+      [executor_pb = executor_pb_, this, this_keepalive = shared_from_this()](
+          const CancellationToken& cancellation,
+          std::vector<std::shared_ptr<ExecutorValue>>&& values)
+          -> absl::StatusOr<std::shared_ptr<ExecutorValue>> {
+        // `values` holds the resolved `futures`, either `{function}` or
+        // `{function, argument}`.
+        v0::CreateCallRequest request;
+        v0::CreateCallResponse response;
+        grpc::ClientContext context;
+        *request.mutable_executor() = executor_pb;
+        *request.mutable_function_ref() = values[0]->Get();
+        if (values.size() == 2) {
+          *request.mutable_argument_ref() = values[1]->Get();
+        }
 
-    grpc::Status status = this->stub_->CreateCall(&context, request, &response);
-    TFF_TRY(grpc_to_absl(status));
-    return std::make_shared<ExecutorValue>(std::move(response.value_ref()),
-                                           executor_pb, this->stub_);
-  });
+        TFF_TRY(CheckNotCancelled(cancellation));
+        ScopedBlockingRegion blocking;
+        grpc::Status status =
+            this->stub_->CreateCall(&context, request, &response);
+        TFF_TRY(grpc_to_absl(status));
+        return std::make_shared<ExecutorValue>(std::move(response.value_ref()),
+                                               executor_pb, this->stub_);
+      });
 }
 
 absl::StatusOr<ValueFuture> RemoteExecutor::CreateStruct(
     std::vector<ValueFuture> members) {
   TFF_TRY(EnsureInitialized());
-  return ThreadRun([futures = std::move(members), this,
-                    this_keepalive = shared_from_this()]()
-                       -> absl::StatusOr<std::shared_ptr<ExecutorValue>> {
-    v0::CreateStructRequest request;
-    *request.mutable_executor() = this->executor_pb_;
-    v0::CreateStructResponse response;
-    grpc::ClientContext context;
-    std::vector<std::shared_ptr<ExecutorValue>> values =
-        TFF_TRY(WaitAll(futures));
-    federated_language::Type result_type;
-    for (const std::shared_ptr<ExecutorValue>& element : values) {
-      v0::CreateStructRequest_Element struct_elem;
-      *struct_elem.mutable_value_ref() = element->Get();
-      request.mutable_element()->Add(std::move(struct_elem));
-    }
-    grpc::Status status =
-        this->stub_->CreateStruct(&context, request, &response);
-    TFF_TRY(grpc_to_absl(status));
-    auto result = std::make_shared<ExecutorValue>(
-        std::move(response.value_ref()), this->executor_pb_, this->stub_);
-    return result;
-  });
+  return MapCancellable(
+      std::move(members),
+      [this, this_keepalive = shared_from_this()](
+          const CancellationToken& cancellation,
+          std::vector<std::shared_ptr<ExecutorValue>>&& values)
+          -> absl::StatusOr<std::shared_ptr<ExecutorValue>> {
+        v0::CreateStructRequest request;
+        *request.mutable_executor() = this->executor_pb_;
+        v0::CreateStructResponse response;
+        grpc::ClientContext context;
+        for (const std::shared_ptr<ExecutorValue>& element : values) {
+          v0::CreateStructRequest_Element struct_elem;
+          *struct_elem.mutable_value_ref() = element->Get();
+          request.mutable_element()->Add(std::move(struct_elem));
+        }
+        TFF_TRY(CheckNotCancelled(cancellation));
+        ScopedBlockingRegion blocking;
+        grpc::Status status =
+            this->stub_->CreateStruct(&context, request, &response);
+        TFF_TRY(grpc_to_absl(status));
+        return std::make_shared<ExecutorValue>(std::move(response.value_ref()),
+                                               this->executor_pb_, this->stub_);
+      });
 }
 
 absl::StatusOr<ValueFuture> RemoteExecutor::CreateSelection(
     ValueFuture value, const uint32_t index) {
   TFF_TRY(EnsureInitialized());
-  return ThreadRun([source = std::move(value), index = index, this,
-                    this_keepalive = shared_from_this()]()
-                       -> absl::StatusOr<std::shared_ptr<ExecutorValue>> {
-    std::shared_ptr<ExecutorValue> source_value = TFF_TRY(Wait(source));
-    v0::CreateSelectionRequest request;
-    v0::CreateSelectionResponse response;
-    grpc::ClientContext context;
-    *request.mutable_executor() = this->executor_pb_;
-    *request.mutable_source_ref() = source_value->Get();
-    request.set_index(index);
-    grpc::Status status =
-        this->stub_->CreateSelection(&context, request, &response);
-    TFF_TRY(grpc_to_absl(status));
-    return std::make_shared<ExecutorValue>(std::move(response.value_ref()),
-                                           this->executor_pb_, this->stub_);
-  });
+  return MapCancellable(
+      std::vector<ValueFuture>({std::move(value)}),
+      [index, this, this_keepalive = shared_from_this()](
+          const CancellationToken& cancellation,
+          std::vector<std::shared_ptr<ExecutorValue>>&& source_in_vec)
+          -> absl::StatusOr<std::shared_ptr<ExecutorValue>> {
+        v0::CreateSelectionRequest request;
+        v0::CreateSelectionResponse response;
+        grpc::ClientContext context;
+        *request.mutable_executor() = this->executor_pb_;
+        *request.mutable_source_ref() = source_in_vec[0]->Get();
+        request.set_index(index);
+        TFF_TRY(CheckNotCancelled(cancellation));
+        ScopedBlockingRegion blocking;
+        grpc::Status status =
+            this->stub_->CreateSelection(&context, request, &response);
+        TFF_TRY(grpc_to_absl(status));
+        return std::make_shared<ExecutorValue>(std::move(response.value_ref()),
+                                               this->executor_pb_, this->stub_);
+      });
 }
 
 absl::Status RemoteExecutor::Materialize(ValueFuture value,
@@ -286,12 +365,166 @@ absl::Status RemoteExecutor::Materialize(ValueFuture value,
 
   v0::ComputeResponse compute_response;
   grpc::ClientContext client_context;
+  ScopedBlockingRegion blocking;
   grpc::Status status =
       stub_->Compute(&client_context, request, &compute_response);
   *value_pb = std::move(*compute_response.mutable_value());
   return grpc_to_absl(status);
 }
 
+absl::Status RemoteExecutor::MaterializeClients(
+    ValueFuture value, absl::Span<const int32_t> client_indices,
+    absl::FunctionRef<absl::Status(int32_t, v0::Value)> consume) {
+  std::shared_ptr<ExecutorValue> value_ref = TFF_TRY(Wait(value));
+  v0::ComputeClientsRequest request;
+  *request.mutable_executor() = executor_pb_;
+  *request.mutable_value_ref() = value_ref->Get();
+  request.mutable_client_index()->Add(client_indices.begin(),
+                                      client_indices.end());
+
+  grpc::ClientContext client_context;
+  std::unique_ptr<grpc::ClientReaderInterface<v0::ComputeClientsResponse>>
+      reader = stub_->ComputeClients(&client_context, request);
+  auto read = [&reader](v0::ComputeClientsResponse* response) {
+    ScopedBlockingRegion blocking;
+    return reader->Read(response);
+  };
+  v0::ComputeClientsResponse response;
+  while (read(&response)) {
+    absl::Status status = consume(response.client_index(),
+                                  std::move(*response.mutable_value()));
+    if (!status.ok()) {
+      // Stop the remaining clients, and drain the stream so that it can be
+      // finished.
+      client_context.TryCancel();
+      while (read(&response)) {
+      }
+      grpc::Status finish_status = reader->Finish();
+      VLOG(1) << "Cancelled `ComputeClients`: "
+              << finish_status.error_message();
+      return status;
+    }
+  }
+  return grpc_to_absl(reader->Finish());
+}
+
+template <typename Request, typename Response>
+std::vector<ValueFuture> RemoteExecutor::DispatchBatch(
+    std::vector<std::vector<ValueFuture>> inputs,
+    std::function<void(size_t,
+                       const std::vector<std::shared_ptr<ExecutorValue>>&,
+                       Request*)>
+        prepare,
+    AsyncMethod<Request, Response> method) {
+  using Values = absl::StatusOr<std::vector<std::shared_ptr<ExecutorValue>>>;
+  using Result = absl::StatusOr<std::shared_ptr<ExecutorValue>>;
+  struct Rpc {
+    grpc::ClientContext context;
+    Request request;
+    Response response;
+  };
+  auto shared_prepare = std::make_shared<decltype(prepare)>(std::move(prepare));
+  std::vector<ValueFuture> results;
+  results.reserve(inputs.size());
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    CancellationToken cancellation;
+    ContinuationPromise<Result> promise;
+    results.emplace_back(promise.GetFuture(), cancellation);
+    // Runs on whichever thread resolves the last input; issuing an
+    // asynchronous RPC does not block it.
+    WhenAll(std::move(inputs[i]))
+        .WhenReady([i, cancellation, promise, prepare = shared_prepare,
+                    method, executor_pb = executor_pb_,
+                    stub = stub_](const ContinuationFuture<Values>&
+                                      values) mutable {
+          absl::Status status = values.get().status();
+          if (status.ok()) {
+            status = CheckNotCancelled(cancellation);
+          }
+          if (!status.ok()) {
+            promise.SetValue(std::move(status));
+            return;
+          }
+          auto rpc = std::make_shared<Rpc>();
+          *rpc->request.mutable_executor() = executor_pb;
+          (*prepare)(i, *values.get(), &rpc->request);
+          (stub->async()->*method)(
+              &rpc->context, &rpc->request, &rpc->response,
+              [rpc, promise, executor_pb, stub](grpc::Status status) mutable {
+                if (!status.ok()) {
+                  promise.SetValue(grpc_to_absl(status));
+                  return;
+                }
+                promise.SetValue(std::make_shared<ExecutorValue>(
+                    std::move(*rpc->response.mutable_value_ref()),
+                    executor_pb, stub));
+              });
+        });
+  }
+  return results;
+}
+
+absl::StatusOr<std::vector<ValueFuture>> RemoteExecutor::CreateCallBatch(
+    std::vector<std::pair<ValueFuture, std::optional<ValueFuture>>> calls) {
+  TFF_TRY(EnsureInitialized());
+  std::vector<std::vector<ValueFuture>> inputs;
+  inputs.reserve(calls.size());
+  for (auto& [function, argument] : calls) {
+    std::vector<ValueFuture>& call_inputs = inputs.emplace_back();
+    call_inputs.push_back(std::move(function));
+    if (argument.has_value()) {
+      call_inputs.push_back(std::move(*argument));
+    }
+  }
+  return DispatchBatch<v0::CreateCallRequest, v0::CreateCallResponse>(
+      std::move(inputs),
+      [](size_t, const std::vector<std::shared_ptr<ExecutorValue>>& values,
+         v0::CreateCallRequest* request) {
+        *request->mutable_function_ref() = values[0]->Get();
+        if (values.size() == 2) {
+          *request->mutable_argument_ref() = values[1]->Get();
+        }
+      },
+      &AsyncStub::CreateCall);
+}
+
+absl::StatusOr<std::vector<ValueFuture>> RemoteExecutor::CreateStructBatch(
+    std::vector<std::vector<ValueFuture>> structs) {
+  TFF_TRY(EnsureInitialized());
+  return DispatchBatch<v0::CreateStructRequest, v0::CreateStructResponse>(
+      std::move(structs),
+      [](size_t, const std::vector<std::shared_ptr<ExecutorValue>>& members,
+         v0::CreateStructRequest* request) {
+        for (const std::shared_ptr<ExecutorValue>& member : members) {
+          *request->add_element()->mutable_value_ref() = member->Get();
+        }
+      },
+      &AsyncStub::CreateStruct);
+}
+
+absl::StatusOr<std::vector<ValueFuture>> RemoteExecutor::CreateSelectionBatch(
+    std::vector<std::pair<ValueFuture, uint32_t>> selections) {
+  TFF_TRY(EnsureInitialized());
+  std::vector<std::vector<ValueFuture>> inputs;
+  std::vector<uint32_t> indices;
+  inputs.reserve(selections.size());
+  indices.reserve(selections.size());
+  for (auto& [source, index] : selections) {
+    inputs.push_back({std::move(source)});
+    indices.push_back(index);
+  }
+  return DispatchBatch<v0::CreateSelectionRequest,
+                       v0::CreateSelectionResponse>(
+      std::move(inputs),
+      [indices = std::move(indices)](
+          size_t i, const std::vector<std::shared_ptr<ExecutorValue>>& source,
+          v0::CreateSelectionRequest* request) {
+        *request->mutable_source_ref() = source[0]->Get();
+        request->set_index(indices[i]);
+      },
+      &AsyncStub::CreateSelection);
+}
+
 std::shared_ptr<Executor> CreateRemoteExecutor(
     std::unique_ptr<v0::ExecutorGroup::StubInterface> stub,
     const CardinalityMap& cardinalities) {
@@ -15,6 +15,7 @@ limitations under the License
 
 #include "tensorflow_federated/cc/core/impl/executors/remote_executor.h"
 
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <optional>
@@ -30,6 +31,7 @@ limitations under the License
 #include "absl/status/statusor.h"
 #include "absl/strings/string_view.h"
 #include "absl/synchronization/notification.h"
+#include "absl/time/clock.h"
 #include "absl/time/time.h"
 #include "include/grpcpp/channel.h"
 #include "include/grpcpp/create_channel.h"
@@ -247,6 +249,60 @@ TEST_F(RemoteExecutorTest, CreateValueTensor) {
   WaitForDisposeExecutor(dispose_notification);
 }
 
+TEST_F(RemoteExecutorTest, MaterializeClientsStreamsRequestedClients) {
+  absl::Notification dispose_notification;
+  ExpectGetAndDisposeExecutor(dispose_notification);
+
+  v0::Value clients_value = testing::ClientsV(
+      {testing::TensorV(1.0f), testing::TensorV(2.0f), testing::TensorV(3.0f)});
+  std::vector<std::pair<int32_t, v0::Value>> materialized;
+  absl::Status materialize_status;
+  {
+    EXPECT_CALL(*mock_executor_service_,
+                CreateValue(::testing::_, ::testing::_, ::testing::_))
+        .WillOnce(ReturnOkWithResponseId<v0::CreateValueResponse>("value_ref"));
+    EXPECT_CALL(*mock_executor_service_,
+                Dispose(::testing::_, ::testing::_, ::testing::_))
+        .WillOnce(::testing::Return(grpc::Status::OK));
+    OwnedValueId value_ref =
+        TFF_ASSERT_OK(test_executor_->CreateValue(clients_value));
+
+    v0::ComputeClientsRequest expected_request;
+    expected_request.mutable_executor()->set_id(kExecutorId);
+    expected_request.mutable_value_ref()->set_id("value_ref");
+    expected_request.add_client_index(2);
+    expected_request.add_client_index(0);
+    EXPECT_CALL(*mock_executor_service_,
+                ComputeClients(::testing::_, EqualsProto(expected_request),
+                               ::testing::_))
+        .WillOnce(
+            [](grpc::ServerContext*, const v0::ComputeClientsRequest*,
+               grpc::ServerWriter<v0::ComputeClientsResponse>* writer) {
+              // The service streams the clients as they complete.
+              for (int32_t index : {0, 2}) {
+                v0::ComputeClientsResponse response;
+                response.set_client_index(index);
+                *response.mutable_value() = testing::TensorV(index + 1.0f);
+                writer->Write(response);
+              }
+              return grpc::Status::OK;
+            });
+    materialize_status = test_executor_->MaterializeClients(
+        value_ref, {2, 0}, [&materialized](int32_t index, v0::Value value_pb) {
+          materialized.emplace_back(index, std::move(value_pb));
+          return absl::OkStatus();
+        });
+  }
+
+  TFF_EXPECT_OK(materialize_status);
+  ASSERT_EQ(materialized.size(), 2);
+  EXPECT_EQ(materialized[0].first, 0);
+  EXPECT_THAT(materialized[0].second, EqualsProto(testing::TensorV(1.0f)));
+  EXPECT_EQ(materialized[1].first, 2);
+  EXPECT_THAT(materialized[1].second, EqualsProto(testing::TensorV(3.0f)));
+  WaitForDisposeExecutor(dispose_notification);
+}
+
 TEST_F(RemoteExecutorTest, CreateValueWithError) {
   absl::Notification dispose_notification;
   ExpectGetAndDisposeExecutor(dispose_notification);
@@ -270,6 +326,44 @@ TEST_F(RemoteExecutorTest, CreateValueWithError) {
   WaitForDisposeExecutor(dispose_notification);
 }
 
+TEST_F(RemoteExecutorTest, DisposingPendingValueSkipsUnsentRpc) {
+  absl::Notification dispose_notification;
+  ExpectGetAndDisposeExecutor(dispose_notification);
+  v0::Value tensor_two = testing::TensorV(2.0f);
+
+  absl::Notification release_function;
+  EXPECT_CALL(*mock_executor_service_,
+              CreateValue(::testing::_, ::testing::_, ::testing::_))
+      .WillOnce([&release_function](grpc::ServerContext*,
+                                    const v0::CreateValueRequest*,
+                                    v0::CreateValueResponse* response) {
+        release_function.WaitForNotification();
+        response->mutable_value_ref()->set_id("function_ref");
+        return grpc::Status::OK;
+      });
+  // The call is dropped while its function is still pending, so its RPC must
+  // never be sent.
+  EXPECT_CALL(*mock_executor_service_,
+              CreateCall(::testing::_, ::testing::_, ::testing::_))
+      .Times(0);
+  // The in-flight `CreateValue` is not cancelled, so the function it creates
+  // is disposed of rather than leaked.
+  v0::DisposeRequest expected_dispose_request;
+  expected_dispose_request.mutable_executor()->set_id(kExecutorId);
+  expected_dispose_request.mutable_value_ref()->Add()->set_id("function_ref");
+  EXPECT_CALL(*mock_executor_service_,
+              Dispose(::testing::_, EqualsProto(expected_dispose_request),
+                      ::testing::_))
+      .WillOnce(::testing::Return(grpc::Status::OK));
+  {
+    OwnedValueId fn = TFF_ASSERT_OK(test_executor_->CreateValue(tensor_two));
+    OwnedValueId call_result =
+        TFF_ASSERT_OK(test_executor_->CreateCall(fn, std::nullopt));
+  }
+  release_function.Notify();
+  WaitForDisposeExecutor(dispose_notification);
+}
+
 TEST_F(RemoteExecutorTest, MaterializeWithError) {
   absl::Notification dispose_notification;
   ExpectGetAndDisposeExecutor(dispose_notification);
@@ -427,6 +521,74 @@ TEST_F(RemoteExecutorTest, CreateCallError) {
   WaitForDisposeExecutor(dispose_notification);
 }
 
+TEST_F(RemoteExecutorTest, CreateCallBatch) {
+  absl::Notification dispose_notification;
+  ExpectGetAndDisposeExecutor(dispose_notification);
+  v0::Value tensor_two = testing::TensorV(2.0f);
+  v0::Value tensor_three = testing::TensorV(3.0f);
+
+  std::vector<v0::Value> materialized_values(2);
+  {
+    EXPECT_CALL(*mock_executor_service_,
+                CreateValue(::testing::_,
+                            EqualsProto(CreateValueRequestForValue(tensor_two)),
+                            ::testing::_))
+        .WillOnce(
+            ReturnOkWithResponseId<v0::CreateValueResponse>("function_ref"));
+    EXPECT_CALL(
+        *mock_executor_service_,
+        CreateValue(::testing::_,
+                    EqualsProto(CreateValueRequestForValue(tensor_three)),
+                    ::testing::_))
+        .WillOnce(
+            ReturnOkWithResponseId<v0::CreateValueResponse>("argument_ref"));
+    OwnedValueId fn = TFF_ASSERT_OK(test_executor_->CreateValue(tensor_two));
+    OwnedValueId arg = TFF_ASSERT_OK(test_executor_->CreateValue(tensor_three));
+
+    v0::CreateCallRequest expected_request_with_arg;
+    expected_request_with_arg.mutable_executor()->set_id(kExecutorId);
+    expected_request_with_arg.mutable_function_ref()->set_id("function_ref");
+    expected_request_with_arg.mutable_argument_ref()->set_id("argument_ref");
+    v0::CreateCallRequest expected_request_no_arg;
+    expected_request_no_arg.mutable_executor()->set_id(kExecutorId);
+    expected_request_no_arg.mutable_function_ref()->set_id("function_ref");
+    EXPECT_CALL(*mock_executor_service_,
+                CreateCall(::testing::_,
+                           EqualsProto(expected_request_with_arg),
+                           ::testing::_))
+        .WillOnce(ReturnOkWithResponseId<v0::CreateCallResponse>("call_0"));
+    EXPECT_CALL(
+        *mock_executor_service_,
+        CreateCall(::testing::_, EqualsProto(expected_request_no_arg),
+                   ::testing::_))
+        .WillOnce(ReturnOkWithResponseId<v0::CreateCallResponse>("call_1"));
+
+    std::vector<CallArgs> calls = {{fn.ref(), arg.ref()},
+                                   {fn.ref(), std::nullopt}};
+    std::vector<OwnedValueId> results =
+        TFF_ASSERT_OK(test_executor_->CreateCallBatch(calls));
+    ASSERT_EQ(results.size(), 2);
+
+    EXPECT_CALL(
+        *mock_executor_service_,
+        Compute(::testing::_, EqualsProto(ComputeRequestForId("call_0")),
+                ::testing::_))
+        .WillOnce(ReturnOkWithComputeResponse(tensor_two));
+    EXPECT_CALL(
+        *mock_executor_service_,
+        Compute(::testing::_, EqualsProto(ComputeRequestForId("call_1")),
+                ::testing::_))
+        .WillOnce(ReturnOkWithComputeResponse(tensor_three));
+    TFF_ASSERT_OK(
+        test_executor_->Materialize(results[0], &materialized_values[0]));
+    TFF_ASSERT_OK(
+        test_executor_->Materialize(results[1], &materialized_values[1]));
+  }
+  EXPECT_THAT(materialized_values[0], EqualsProto(tensor_two));
+  EXPECT_THAT(materialized_values[1], EqualsProto(tensor_three));
+  WaitForDisposeExecutor(dispose_notification);
+}
+
 TEST_F(RemoteExecutorTest, CreateStructWithTwoElements) {
   absl::Notification dispose_notification;
   ExpectGetAndDisposeExecutor(dispose_notification);
@@ -20,7 +20,6 @@ limitations under the License
 #include <cstddef>
 #include <cstdint>
 #include <functional>
-#include <future>  // NOLINT
 #include <memory>
 #include <optional>
 #include <utility>
@@ -37,6 +36,7 @@ limitations under the License
 #include "absl/types/span.h"
 #include "federated_language/proto/array.pb.h"
 #include "federated_language/proto/computation.pb.h"
+#include "tensorflow_federated/cc/core/impl/executors/continuation_future.h"
 #include "tensorflow_federated/cc/core/impl/executors/executor.h"
 #include "tensorflow_federated/cc/core/impl/executors/sequence_intrinsics.h"
 #include "tensorflow_federated/cc/core/impl/executors/status_macros.h"
@@ -345,8 +345,14 @@ absl::Status CheckLenForUseAsArgument(const SequenceExecutorValue& value,
 }
 
 // We return futures since pulling elements from a sequence may be slow, and
-// otherwise would block.
-using ValueFuture = std::shared_future<absl::StatusOr<SequenceExecutorValue>>;
+// otherwise would block. Continuation futures let calls on pending values wait
+// for them without parking a thread.
+using ValueFuture = ContinuationFuture<absl::StatusOr<SequenceExecutorValue>>;
+
+ValueFuture ReadyValue(SequenceExecutorValue value) {
+  return ReadyContinuationFuture(
+      absl::StatusOr<SequenceExecutorValue>(std::move(value)));
+}
 
 class SequenceExecutor : public ExecutorBase<ValueFuture> {
  public:
@@ -364,7 +370,7 @@ class SequenceExecutor : public ExecutorBase<ValueFuture> {
         // lazy embedding in the lower-level executor if needed, e.g. in
         // response to a CreateCall, or construction of an iterable from this
         // sequence in the sequence executor itself.
-        return ReadyFuture(SequenceExecutorValue::CreateSequence(
+        return ReadyValue(SequenceExecutorValue::CreateSequence(
             std::make_shared<Sequence>(value_pb, target_executor_)));
       }
       case v0::Value::kComputation: {
@@ -374,7 +380,7 @@ class SequenceExecutor : public ExecutorBase<ValueFuture> {
           absl::StatusOr<SequenceIntrinsic> intrinsic_or_status =
               SequenceIntrinsicFromUri(intrinsic_uri);
           if (intrinsic_or_status.ok()) {
-            return ReadyFuture(SequenceExecutorValue::CreateIntrinsic(
+            return ReadyValue(SequenceExecutorValue::CreateIntrinsic(
                 SequenceIntrinsic(intrinsic_or_status.value())));
           }
         }
@@ -383,54 +389,67 @@ class SequenceExecutor : public ExecutorBase<ValueFuture> {
         // lower-level executors pass through.
         ABSL_FALLTHROUGH_INTENDED;
       default:
-        return ReadyFuture(SequenceExecutorValue::CreateEmbedded(
+        return ReadyValue(SequenceExecutorValue::CreateEmbedded(
             ShareValueId(TFF_TRY(target_executor_->CreateValue(value_pb)))));
     }
   }
 
   absl::StatusOr<ValueFuture> CreateCall(
       ValueFuture function, std::optional<ValueFuture> argument) final {
-    std::function<absl::StatusOr<SequenceExecutorValue>()> thread_fn =
-        [function = std::move(function), argument = std::move(argument), this,
-         this_keepalive =
-             shared_from_this()]() -> absl::StatusOr<SequenceExecutorValue> {
-      auto fn = TFF_TRY(Wait(function));
-      if (fn.type() != SequenceExecutorValue::ValueType::INTRINSIC) {
-        Embedded arg_owner;
-        std::optional<ValueId> embedded_arg = std::nullopt;
-        if (argument.has_value()) {
-          arg_owner = TFF_TRY(Embed(TFF_TRY(Wait(argument.value()))));
-          embedded_arg = arg_owner->ref();
-        }
-        return SequenceExecutorValue::CreateEmbedded(ShareValueId(TFF_TRY(
-            target_executor_->CreateCall(fn.embedded()->ref(), embedded_arg))));
-      }
-      // We know we are executing a sequence intrinsic; check the argument
-      // has a value.
-      if (!argument.has_value()) {
-        return absl::InvalidArgumentError(absl::StrCat(
-            "Must supply an argument when calling a sequence intrinsic; "
-            "called intrinsic ",
-            SequenceIntrinsicToUri(fn.intrinsic()), " without an argument."));
-      }
-      auto arg = TFF_TRY(Wait(argument.value()));
-      SequenceIntrinsic intrinsic = fn.intrinsic();
-      switch (intrinsic) {
-        case SequenceIntrinsic::REDUCE: {
-          return SequenceExecutorValue::CreateEmbedded(
-              TFF_TRY(ReduceSequence(arg)));
-        }
-        case SequenceIntrinsic::MAP: {
-          return SequenceExecutorValue::CreateSequence(
-              TFF_TRY(MapSequence(arg)));
-        }
-        default:
-          return absl::UnimplementedError(
-              absl::StrCat("Unimplemented sequence intrinsic: ",
-                           SequenceIntrinsicToUri(intrinsic)));
-      }
-    };
-    return ThreadRun(thread_fn);
+    std::vector<ValueFuture> futures = {std::move(function)};
+    if (argument.has_value()) {
+      futures.push_back(std::move(*argument));
+    }
+    // Calls may pull elements from sequences or wait on the target executor,
+    // so they run on the default pool once their inputs are ready.
+    return MapAsync(
+        std::move(futures),
+        [this, this_keepalive = shared_from_this()](
+            std::vector<SequenceExecutorValue>&& values)
+            -> absl::StatusOr<SequenceExecutorValue> {
+          // `values` holds the resolved `futures`, either `{function}` or
+          // `{function, argument}`.
+          SequenceExecutorValue fn = std::move(values[0]);
+          std::optional<SequenceExecutorValue> argument = std::nullopt;
+          if (values.size() == 2) {
+            argument = std::move(values[1]);
+          }
+          if (fn.type() != SequenceExecutorValue::ValueType::INTRINSIC) {
+            Embedded arg_owner;
+            std::optional<ValueId> embedded_arg = std::nullopt;
+            if (argument.has_value()) {
+              arg_owner = TFF_TRY(Embed(*argument));
+              embedded_arg = arg_owner->ref();
+            }
+            return SequenceExecutorValue::CreateEmbedded(
+                ShareValueId(TFF_TRY(target_executor_->CreateCall(
+                    fn.embedded()->ref(), embedded_arg))));
+          }
+          // We know we are executing a sequence intrinsic; check the argument
+          // has a value.
+          if (!argument.has_value()) {
+            return absl::InvalidArgumentError(absl::StrCat(
+                "Must supply an argument when calling a sequence intrinsic; "
+                "called intrinsic ",
+                SequenceIntrinsicToUri(fn.intrinsic()),
+                " without an argument."));
+          }
+          SequenceIntrinsic intrinsic = fn.intrinsic();
+          switch (intrinsic) {
+            case SequenceIntrinsic::REDUCE: {
+              return SequenceExecutorValue::CreateEmbedded(
+                  TFF_TRY(ReduceSequence(*argument)));
+            }
+            case SequenceIntrinsic::MAP: {
+              return SequenceExecutorValue::CreateSequence(
+                  TFF_TRY(MapSequence(*argument)));
+            }
+            default:
+              return absl::UnimplementedError(
+                  absl::StrCat("Unimplemented sequence intrinsic: ",
+                               SequenceIntrinsicToUri(intrinsic)));
+          }
+        });
   }
 
   absl::StatusOr<ValueFuture> CreateStruct(
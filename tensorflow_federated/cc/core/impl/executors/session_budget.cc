@@ -0,0 +1,160 @@
+/* Copyright 2026, The TensorFlow Federated Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+     http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License
+==============================================================================*/
+
+#include "tensorflow_federated/cc/core/impl/executors/session_budget.h"
+
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+#include "absl/synchronization/mutex.h"
+
+namespace tensorflow_federated {
+
+SessionBudget* SessionBudget::Global() {
+  // Intentionally leaked so that providers destroyed during static destruction
+  // can still release their sessions.
+  static SessionBudget* budget = new SessionBudget();
+  return budget;
+}
+
+void SessionBudget::set_max_sessions(int64_t max_sessions) {
+  absl::MutexLock lock(&mutex_);
+  max_sessions_ = max_sessions;
+}
+
+int64_t SessionBudget::max_sessions() {
+  absl::MutexLock lock(&mutex_);
+  return max_sessions_;
+}
+
+bool SessionBudget::Acquire(const std::function<bool()>& has_idle_session) {
+  // Declared before the lock, so that reclaimed sessions are destroyed after it
+  // is released.
+  std::vector<ReclaimedSession> reclaimed;
+  absl::MutexLock lock(&mutex_);
+  const uint64_t ticket = next_ticket_++;
+  bool waited = false;
+  while (true) {
+    if (now_serving_ != ticket) {
+      waited = true;
+      auto is_served = [this, ticket]() ABSL_SHARED_LOCKS_REQUIRED(mutex_) {
+        return now_serving_ == ticket;
+      };
+      mutex_.Await(absl::Condition(&is_served));
+      continue;
+    }
+    if (has_idle_session != nullptr && has_idle_session()) {
+      ++now_serving_;
+      return false;
+    }
+    if (HasSlot()) {
+      break;
+    }
+    ReclaimedSession session = ReclaimOne();
+    if (session != nullptr) {
+      reclaimed.push_back(std::move(session));
+      continue;
+    }
+    // Wait for a session to be released, or for a provider to gain an idle
+    // session that could be reclaimed.
+    waited = true;
+    const uint64_t idle_generation = idle_generation_;
+    auto can_progress = [this, idle_generation]()
+                            ABSL_SHARED_LOCKS_REQUIRED(mutex_) {
+                              return HasSlot() ||
+                                     idle_generation_ != idle_generation;
+                            };
+    mutex_.Await(absl::Condition(&can_progress));
+  }
+  ++live_sessions_;
+  ++now_serving_;
+  if (waited) {
+    ++waited_acquisitions_;
+  }
+  return true;
+}
+
+bool SessionBudget::TryAcquire() {
+  absl::MutexLock lock(&mutex_);
+  if (next_ticket_ != now_serving_ || !HasSlot()) {
+    return false;
+  }
+  ++live_sessions_;
+  return true;
+}
+
+void SessionBudget::Release(int64_t count) {
+  absl::MutexLock lock(&mutex_);
+  live_sessions_ -= count;
+}
+
+int64_t SessionBudget::RegisterReclaimer(ReclaimFn reclaim) {
+  absl::MutexLock lock(&mutex_);
+  const int64_t id = next_reclaimer_id_++;
+  reclaimers_.emplace(id, std::move(reclaim));
+  return id;
+}
+
+void SessionBudget::UnregisterReclaimer(int64_t id) {
+  absl::MutexLock lock(&mutex_);
+  reclaimers_.erase(id);
+}
+
+void SessionBudget::NotifyIdleSession() {
+  absl::MutexLock lock(&mutex_);
+  ++idle_generation_;
+}
+
+int64_t SessionBudget::live_sessions() {
+  absl::MutexLock lock(&mutex_);
+  return live_sessions_;
+}
+
+int64_t SessionBudget::reclaimed_sessions() {
+  absl::MutexLock lock(&mutex_);
+  return reclaimed_sessions_;
+}
+
+int64_t SessionBudget::waited_acquisitions() {
+  absl::MutexLock lock(&mutex_);
+  return waited_acquisitions_;
+}
+
+SessionBudget::ReclaimedSession SessionBudget::ReclaimOne() {
+  if (reclaimers_.empty()) {
+    return nullptr;
+  }
+  // Scan round-robin, starting after the last reclaimer that gave up a
+  // session, so that reclaims are spread across providers.
+  auto start = reclaimers_.upper_bound(last_reclaimed_id_);
+  for (size_t i = 0; i < reclaimers_.size(); ++i) {
+    if (start == reclaimers_.end()) {
+      start = reclaimers_.begin();
+    }
+    ReclaimedSession session = start->second();
+    if (session != nullptr) {
+      --live_sessions_;
+      ++reclaimed_sessions_;
+      last_reclaimed_id_ = start->first;
+      return session;
+    }
+    ++start;
+  }
+  return nullptr;
+}
+
+}  // namespace tensorflow_federated
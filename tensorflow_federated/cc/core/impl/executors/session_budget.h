@@ -0,0 +1,124 @@
+/* Copyright 2026, The TensorFlow Federated Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+     http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License
+==============================================================================*/
+
+#ifndef THIRD_PARTY_TENSORFLOW_FEDERATED_CC_CORE_IMPL_EXECUTORS_SESSION_BUDGET_H_
+#define THIRD_PARTY_TENSORFLOW_FEDERATED_CC_CORE_IMPL_EXECUTORS_SESSION_BUDGET_H_
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/synchronization/mutex.h"
+
+namespace tensorflow_federated {
+
+// Caps the number of live TensorFlow sessions shared by a set of
+// `SessionProvider`s, by default all of those in the process.
+//
+// Creating a session requires acquiring a slot from the budget. When the cap
+// is reached, callers wait for a slot in the order they arrived. While they
+// wait, idle sessions pooled by registered providers are reclaimed (destroyed)
+// to free slots, so that sessions cached for rarely used computations cannot
+// starve the others.
+class SessionBudget {
+ public:
+  // An idle session detached from its provider. The budget destroys it once
+  // its own lock is released, since destroying a session can be slow.
+  using ReclaimedSession = std::shared_ptr<void>;
+  // Detaches one idle session held by a provider, returning it, or `nullptr`
+  // if there was none. Called with the budget's lock held, so it must not call
+  // back into the budget.
+  using ReclaimFn = std::function<ReclaimedSession()>;
+
+  // Creates a budget allowing `max_sessions` live sessions. Non-positive
+  // values allow any number of sessions.
+  explicit SessionBudget(int64_t max_sessions = -1)
+      : max_sessions_(max_sessions) {}
+
+  SessionBudget(const SessionBudget&) = delete;
+  SessionBudget& operator=(const SessionBudget&) = delete;
+
+  // The budget shared by all `SessionProvider`s in the process, unlimited
+  // unless changed with `set_max_sessions`.
+  static SessionBudget* Global();
+
+  // Changes the cap. Lowering it below the number of live sessions does not
+  // destroy any, but prevents new ones from being created until enough have
+  // been released.
+  void set_max_sessions(int64_t max_sessions);
+  int64_t max_sessions();
+
+  // Blocks until a session may be created, and reserves a slot for it,
+  // returning true. Callers are served first-come, first-served.
+  //
+  // Once it is the caller's turn, and before any session is reclaimed for it,
+  // `has_idle_session` (if set) is called with the budget's lock held. If it
+  // returns true, e.g. because a session of the caller's own provider was
+  // returned while it waited, no slot is reserved and false is returned: the
+  // caller should use that session instead.
+  bool Acquire(const std::function<bool()>& has_idle_session = nullptr);
+  // Reserves a slot if one is available without waiting for or reclaiming
+  // other sessions, and no other caller is waiting.
+  bool TryAcquire();
+  // Releases the slots of `count` sessions that were destroyed.
+  void Release(int64_t count = 1);
+
+  // Registers a provider's `reclaim` callback, returning an id for
+  // `UnregisterReclaimer`.
+  int64_t RegisterReclaimer(ReclaimFn reclaim);
+  // Unregisters a reclaimer. Once this returns, the callback is not running
+  // and will not be called again.
+  void UnregisterReclaimer(int64_t id);
+  // Notifies a waiting caller that a provider has a new idle session that
+  // might be reclaimed. Must not be called with the provider's lock held.
+  void NotifyIdleSession();
+
+  int64_t live_sessions();
+  // Number of sessions destroyed to make room for others.
+  int64_t reclaimed_sessions();
+  // Number of `Acquire` calls that had to wait for a slot.
+  int64_t waited_acquisitions();
+
+ private:
+  bool HasSlot() const ABSL_SHARED_LOCKS_REQUIRED(mutex_) {
+    return max_sessions_ <= 0 || live_sessions_ < max_sessions_;
+  }
+  // Reclaims an idle session from the next reclaimer in round-robin order,
+  // releasing its slot. Returns `nullptr` if no provider had one.
+  ReclaimedSession ReclaimOne() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  absl::Mutex mutex_;
+  int64_t max_sessions_ ABSL_GUARDED_BY(mutex_);
+  int64_t live_sessions_ ABSL_GUARDED_BY(mutex_) = 0;
+  int64_t reclaimed_sessions_ ABSL_GUARDED_BY(mutex_) = 0;
+  int64_t waited_acquisitions_ ABSL_GUARDED_BY(mutex_) = 0;
+  // Tickets implement first-come, first-served waiting: the caller holding
+  // `now_serving_` is the only one allowed to take the next free slot.
+  uint64_t next_ticket_ ABSL_GUARDED_BY(mutex_) = 0;
+  uint64_t now_serving_ ABSL_GUARDED_BY(mutex_) = 0;
+  std::map<int64_t, ReclaimFn> reclaimers_ ABSL_GUARDED_BY(mutex_);
+  int64_t next_reclaimer_id_ ABSL_GUARDED_BY(mutex_) = 0;
+  // The id after which to start the next round-robin reclaim scan.
+  int64_t last_reclaimed_id_ ABSL_GUARDED_BY(mutex_) = -1;
+  // Bumped whenever a provider gains an idle session, to wake the waiting
+  // caller so it can try to reclaim it.
+  uint64_t idle_generation_ ABSL_GUARDED_BY(mutex_) = 0;
+};
+
+}  // namespace tensorflow_federated
+
+#endif  // THIRD_PARTY_TENSORFLOW_FEDERATED_CC_CORE_IMPL_EXECUTORS_SESSION_BUDGET_H_
@@ -0,0 +1,233 @@
+/* Copyright 2026, The TensorFlow Federated Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+     http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License
+==============================================================================*/
+
+#include "tensorflow_federated/cc/core/impl/executors/session_budget.h"
+
+#include <functional>
+#include <memory>
+#include <thread>  // NOLINT
+#include <utility>
+#include <vector>
+
+#include "googletest/include/gtest/gtest.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/synchronization/notification.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+
+namespace tensorflow_federated {
+
+namespace {
+
+// A reclaimed session that runs `fn` when destroyed.
+struct OnDestruction {
+  explicit OnDestruction(std::function<void()> fn) : fn(std::move(fn)) {}
+  ~OnDestruction() { fn(); }
+  std::function<void()> fn;
+};
+
+TEST(SessionBudgetTest, UnlimitedNeverWaits) {
+  SessionBudget budget;
+  for (int i = 0; i < 100; ++i) {
+    budget.Acquire();
+  }
+  EXPECT_TRUE(budget.TryAcquire());
+  EXPECT_EQ(budget.live_sessions(), 101);
+  budget.Release(101);
+  EXPECT_EQ(budget.live_sessions(), 0);
+  EXPECT_EQ(budget.waited_acquisitions(), 0);
+}
+
+TEST(SessionBudgetTest, TryAcquireFailsAtCap) {
+  SessionBudget budget(2);
+  EXPECT_TRUE(budget.TryAcquire());
+  EXPECT_TRUE(budget.TryAcquire());
+  EXPECT_FALSE(budget.TryAcquire());
+  budget.Release();
+  EXPECT_TRUE(budget.TryAcquire());
+  EXPECT_EQ(budget.live_sessions(), 2);
+}
+
+TEST(SessionBudgetTest, AcquireWaitsForRelease) {
+  SessionBudget budget(1);
+  budget.Acquire();
+  absl::Notification acquired;
+  std::thread waiter([&budget, &acquired]() {
+    budget.Acquire();
+    acquired.Notify();
+  });
+  EXPECT_FALSE(acquired.WaitForNotificationWithTimeout(absl::Milliseconds(50)));
+  budget.Release();
+  acquired.WaitForNotification();
+  waiter.join();
+  EXPECT_EQ(budget.live_sessions(), 1);
+  EXPECT_EQ(budget.waited_acquisitions(), 1);
+}
+
+TEST(SessionBudgetTest, RaisingCapWakesWaiter) {
+  SessionBudget budget(1);
+  budget.Acquire();
+  std::thread waiter([&budget]() { budget.Acquire(); });
+  budget.set_max_sessions(2);
+  waiter.join();
+  EXPECT_EQ(budget.live_sessions(), 2);
+}
+
+TEST(SessionBudgetTest, WaitersAreServedInOrder) {
+  SessionBudget budget(1);
+  budget.Acquire();
+  absl::Mutex mutex;
+  std::vector<int> order;
+  std::vector<std::thread> waiters;
+  for (int i = 0; i < 3; ++i) {
+    waiters.emplace_back([&budget, &mutex, &order, i]() {
+      budget.Acquire();
+      absl::MutexLock lock(&mutex);
+      order.push_back(i);
+    });
+    // Give the waiter time to take its place in line before starting the
+    // next one.
+    absl::SleepFor(absl::Milliseconds(20));
+  }
+  for (int i = 0; i < 3; ++i) {
+    budget.Release();
+    absl::SleepFor(absl::Milliseconds(20));
+  }
+  for (std::thread& waiter : waiters) {
+    waiter.join();
+  }
+  EXPECT_EQ(order, std::vector<int>({0, 1, 2}));
+}
+
+TEST(SessionBudgetTest, AcquireReclaimsIdleSessions) {
+  SessionBudget budget(2);
+  budget.Acquire();
+  budget.Acquire();
+  int idle_sessions = 1;
+  int64_t id = budget.RegisterReclaimer(
+      [&idle_sessions]() -> SessionBudget::ReclaimedSession {
+        if (idle_sessions == 0) {
+          return nullptr;
+        }
+        --idle_sessions;
+        return std::make_shared<int>(0);
+      });
+  budget.Acquire();
+  EXPECT_EQ(idle_sessions, 0);
+  EXPECT_EQ(budget.live_sessions(), 2);
+  EXPECT_EQ(budget.reclaimed_sessions(), 1);
+  budget.UnregisterReclaimer(id);
+}
+
+TEST(SessionBudgetTest, WaiterReclaimsSessionsThatBecomeIdle) {
+  SessionBudget budget(1);
+  budget.Acquire();
+  absl::Mutex mutex;
+  bool idle = false;
+  int64_t id = budget.RegisterReclaimer(
+      [&mutex, &idle]() -> SessionBudget::ReclaimedSession {
+        absl::MutexLock lock(&mutex);
+        if (!idle) {
+          return nullptr;
+        }
+        idle = false;
+        return std::make_shared<int>(0);
+      });
+  absl::Notification acquired;
+  std::thread waiter([&budget, &acquired]() {
+    budget.Acquire();
+    acquired.Notify();
+  });
+  EXPECT_FALSE(acquired.WaitForNotificationWithTimeout(absl::Milliseconds(50)));
+  {
+    absl::MutexLock lock(&mutex);
+    idle = true;
+  }
+  budget.NotifyIdleSession();
+  acquired.WaitForNotification();
+  waiter.join();
+  EXPECT_EQ(budget.reclaimed_sessions(), 1);
+  EXPECT_EQ(budget.live_sessions(), 1);
+  budget.UnregisterReclaimer(id);
+}
+
+TEST(SessionBudgetTest, DestroysReclaimedSessionsWithoutLock) {
+  SessionBudget budget(1);
+  budget.Acquire();
+  int64_t live_sessions_at_destruction = -1;
+  int64_t id = budget.RegisterReclaimer(
+      [&budget, &live_sessions_at_destruction, reclaimed = false]() mutable
+      -> SessionBudget::ReclaimedSession {
+        if (reclaimed) {
+          return nullptr;
+        }
+        reclaimed = true;
+        // Reading the budget from the session's destructor would deadlock if
+        // the session were destroyed with the budget's lock held.
+        return std::make_shared<OnDestruction>(
+            [&budget, &live_sessions_at_destruction]() {
+              live_sessions_at_destruction = budget.live_sessions();
+            });
+      });
+  budget.Acquire();
+  EXPECT_EQ(live_sessions_at_destruction, 1);
+  EXPECT_EQ(budget.reclaimed_sessions(), 1);
+  budget.UnregisterReclaimer(id);
+}
+
+TEST(SessionBudgetTest, WaiterUsesOwnIdleSessionInsteadOfReclaiming) {
+  SessionBudget budget(1);
+  budget.Acquire();
+  absl::Mutex mutex;
+  bool own_idle = false;
+  int64_t id = budget.RegisterReclaimer(
+      [&mutex, &own_idle]() -> SessionBudget::ReclaimedSession {
+        absl::MutexLock lock(&mutex);
+        if (!own_idle) {
+          return nullptr;
+        }
+        own_idle = false;
+        return std::make_shared<int>(0);
+      });
+  absl::Notification done;
+  bool acquired = true;
+  std::thread waiter([&]() {
+    acquired = budget.Acquire([&mutex, &own_idle]() {
+      absl::MutexLock lock(&mutex);
+      return own_idle;
+    });
+    done.Notify();
+  });
+  EXPECT_FALSE(done.WaitForNotificationWithTimeout(absl::Milliseconds(50)));
+  {
+    absl::MutexLock lock(&mutex);
+    own_idle = true;
+  }
+  budget.NotifyIdleSession();
+  done.WaitForNotification();
+  waiter.join();
+  EXPECT_FALSE(acquired);
+  EXPECT_EQ(budget.reclaimed_sessions(), 0);
+  EXPECT_EQ(budget.live_sessions(), 1);
+  // The waiter gave up its turn, so later callers are not blocked behind it.
+  EXPECT_FALSE(budget.TryAcquire());
+  budget.Release();
+  EXPECT_TRUE(budget.TryAcquire());
+  budget.UnregisterReclaimer(id);
+}
+
+}  // namespace
+
+}  // namespace tensorflow_federated
@@ -15,6 +15,7 @@ limitations under the License
 
 #include "tensorflow_federated/cc/core/impl/executors/session_provider.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <cstring>
 #include <memory>
@@ -23,6 +24,7 @@ limitations under the License
 #include <vector>
 
 #include "absl/base/attributes.h"
+#include "absl/base/call_once.h"
 #include "absl/base/const_init.h"
 #include "absl/container/flat_hash_set.h"
 #include "absl/log/log.h"
@@ -33,15 +35,18 @@ limitations under the License
 #include "absl/strings/str_split.h"
 #include "absl/strings/string_view.h"
 #include "absl/synchronization/mutex.h"
+#include "tensorflow/compiler/jit/flags.h"
 #include "tensorflow/core/framework/attr_value.pb.h"
 #include "tensorflow/core/framework/device_factory.h"
 #include "tensorflow/core/framework/function.pb.h"
 #include "tensorflow/core/framework/op.h"
 #include "tensorflow/core/framework/op_kernel.h"
 #include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/protobuf/config.pb.h"
 #include "tensorflow/core/public/session.h"
 #include "tensorflow/core/public/session_options.h"
 #include "tensorflow_federated/cc/core/impl/executors/status_macros.h"
+#include "tensorflow_federated/cc/core/impl/executors/threading.h"
 
 namespace tensorflow_federated {
 
@@ -58,7 +63,7 @@ int32_t GetNextFunctionId() {
   return function_id++;
 }
 
-const tensorflow::SessionOptions& get_session_options() {
+const tensorflow::SessionOptions& get_default_session_options() {
   // Creates default SessionOptions on first call, and re-uses them for all
   // future calls.
   static tensorflow::SessionOptions* session_options = []() {
@@ -86,6 +91,50 @@ const tensorflow::SessionOptions& get_session_options() {
   return *session_options;
 }
 
+// `global_jit_level` only clusters ops placed on CPU if the process-wide
+// `tf_xla_cpu_global_jit` flag is set. The flag has no effect on sessions
+// whose jit level is off, so setting it once is safe.
+void EnableXlaCpuGlobalJit() {
+  static absl::once_flag once;
+  absl::call_once(once, []() {
+    tensorflow::GetMarkForCompilationPassFlags()->tf_xla_cpu_global_jit = true;
+  });
+}
+
+tensorflow::SessionOptions GetSessionOptions(
+    const SessionThreadingOptions& threading,
+    const SessionOptimizationOptions& optimization) {
+  tensorflow::SessionOptions options = get_default_session_options();
+  tensorflow::ConfigProto& config = options.config;
+  if (threading.inter_op_threads > 0) {
+    config.set_inter_op_parallelism_threads(threading.inter_op_threads);
+  }
+  if (threading.intra_op_threads > 0) {
+    config.set_intra_op_parallelism_threads(threading.intra_op_threads);
+  }
+  if (threading.use_per_session_threads) {
+    config.set_use_per_session_threads(true);
+  } else if (!threading.inter_op_pool_name.empty()) {
+    tensorflow::ThreadPoolOptionProto* pool_pb =
+        config.add_session_inter_op_thread_pool();
+    pool_pb->set_num_threads(std::max(threading.inter_op_threads, 0));
+    pool_pb->set_global_name(threading.inter_op_pool_name);
+  }
+  tensorflow::GraphOptions* graph_options_pb = config.mutable_graph_options();
+  if (optimization.enable_grappler) {
+    graph_options_pb->mutable_rewrite_options()->set_disable_meta_optimizer(
+        false);
+    graph_options_pb->mutable_optimizer_options()->set_opt_level(
+        tensorflow::OptimizerOptions::L1);
+  }
+  if (optimization.enable_xla_jit) {
+    EnableXlaCpuGlobalJit();
+    graph_options_pb->mutable_optimizer_options()->set_global_jit_level(
+        tensorflow::OptimizerOptions::ON_1);
+  }
+  return options;
+}
+
 struct AcceleratorDevices {
   const int16_t num_gpus = 0;
   const int16_t num_tpus = 0;
@@ -225,17 +274,53 @@ tensorflow::GraphDef ReplaceContainers(
   return graph;
 }
 
-SessionProvider::SessionProvider(tensorflow::GraphDef&& graph)
-    : graph_(graph), function_id_(GetNextFunctionId()) {}
+SessionProvider::SessionProvider(tensorflow::GraphDef&& graph,
+                                 SessionBudget* budget,
+                                 const SessionThreadingOptions& threading,
+                                 const SessionOptimizationOptions& optimization)
+    : graph_(graph),
+      session_options_(GetSessionOptions(threading, optimization)),
+      function_id_(GetNextFunctionId()),
+      budget_(budget) {
+  reclaimer_id_ =
+      budget_->RegisterReclaimer([this]() { return ReclaimIdleSession(); });
+}
+
+SessionProvider::~SessionProvider() {
+  // Unregister first, so that the budget can no longer call into this
+  // provider while it is being destroyed.
+  budget_->UnregisterReclaimer(reclaimer_id_);
+  int32_t live_sessions = 0;
+  {
+    absl::MutexLock lock(&mutex_);
+    sessions_.clear();
+    live_sessions = live_sessions_;
+  }
+  budget_->Release(live_sessions);
+}
+
+SessionBudget::ReclaimedSession SessionProvider::ReclaimIdleSession() {
+  absl::MutexLock lock(&mutex_);
+  if (sessions_.empty()) {
+    return nullptr;
+  }
+  VLOG(2) << "Reclaiming an idle session of function [" << function_id_
+          << "]";
+  auto session = std::make_shared<SessionWithResourceContainer>(
+      std::move(sessions_.back()));
+  sessions_.pop_back();
+  --live_sessions_;
+  return session;
+}
 
 absl::StatusOr<std::unique_ptr<tensorflow::Session>>
-SessionProvider::CreateSession(const int16_t session_id) {
+SessionProvider::CreateSession(const uint64_t session_id) {
   const std::string container = absl::StrCat(function_id_, "/", session_id);
   std::unique_ptr<tensorflow::Session> session;
   {
     tensorflow::Session* raw_session;
     absl::Status status =
-        tensorflow::NewSession(get_session_options(), &raw_session);
+        tensorflow::NewSession(session_options_, &raw_session);
     if (!status.ok()) {
       return absl::InternalError(absl::StrCat(
           "Failed to create TensorFlow session: ", status.message()));
@@ -254,7 +339,7 @@ SessionProvider::CreateSession(const int16_t session_id) {
   if (devices.num_gpus > 0) {
     // If we have GPUs, round robin the session by explicitly setting the
     // `device` attr of the GPU-capable kernels.
-    const int16_t device_id = session_id % devices.num_gpus;
+    const uint64_t device_id = session_id % devices.num_gpus;
     const std::string& device =
         absl::StrCat("/device:", tensorflow::DEVICE_GPU, ":", device_id);
     VLOG(2) << "Pinning function [" << function_id_ << "] session ["
@@ -264,7 +349,7 @@ SessionProvider::CreateSession(const int16_t session_id) {
   if (devices.num_tpus > 0) {
     // If we have TPUs, round robin the session by explicitly setting the
     // `device` attr of the TPU-capable kernels.
-    const int16_t device_id = session_id % devices.num_tpus;
+    const uint64_t device_id = session_id % devices.num_tpus;
     const std::string& device =
         absl::StrCat("/device:", tensorflow::DEVICE_TPU, ":", device_id);
     VLOG(2) << "Pinning function [" << function_id_ << "] session ["
@@ -285,31 +370,86 @@ SessionProvider::CreateSession(const int16_t session_id) {
 }
 
 absl::StatusOr<SessionProvider::SessionWithResourceContainer>
-SessionProvider::TakeSession() {
-  int16_t session_id = 0;
+SessionProvider::CreateAcquiredSession() {
+  uint64_t session_id = 0;
   {
     absl::MutexLock lock(&mutex_);
-    if (!sessions_.empty()) {
-      SessionProvider::SessionWithResourceContainer session(
-          std::move(sessions_.back()));
-      sessions_.pop_back();
-      return std::move(session);
-    }
     // Build a container name based on the number of sessions created so that
     // each session gets its own container.
     session_id = session_creation_counter_++;
+    ++live_sessions_;
+  }
+  absl::StatusOr<std::unique_ptr<tensorflow::Session>> session =
+      CreateSession(session_id);
+  if (!session.ok()) {
+    {
+      absl::MutexLock lock(&mutex_);
+      --live_sessions_;
+    }
+    budget_->Release();
+    return session.status();
   }
-  std::unique_ptr<tensorflow::Session> session =
-      TFF_TRY(CreateSession(session_id));
   return SessionProvider::SessionWithResourceContainer{
-      std::move(session), function_id_, session_id};
+      std::move(session).value(), function_id_, session_id};
+}
+
+absl::StatusOr<SessionProvider::SessionWithResourceContainer>
+SessionProvider::TakeSession() {
+  auto has_idle_session = [this]() {
+    absl::MutexLock lock(&mutex_);
+    return !sessions_.empty();
+  };
+  while (true) {
+    {
+      absl::MutexLock lock(&mutex_);
+      if (!sessions_.empty()) {
+        SessionProvider::SessionWithResourceContainer session(
+            std::move(sessions_.back()));
+        sessions_.pop_back();
+        return std::move(session);
+      }
+    }
+    // Must not hold `mutex_`: acquiring may reclaim this provider's sessions.
+    // If one of them is returned while waiting, it is used instead of creating
+    // a new session.
+    bool acquired;
+    {
+      // Waits for other callers to release sessions.
+      ScopedBlockingRegion blocking;
+      acquired = budget_->Acquire(has_idle_session);
+    }
+    if (acquired) {
+      return CreateAcquiredSession();
+    }
+  }
 }
 
 void SessionProvider::ReturnSession(
     SessionProvider::SessionWithResourceContainer&& session) {
   session.ClearResourceContainers();
-  absl::MutexLock lock(&mutex_);
-  sessions_.emplace_back(std::move(session));
+  {
+    absl::MutexLock lock(&mutex_);
+    sessions_.emplace_back(std::move(session));
+  }
+  budget_->NotifyIdleSession();
+}
+
+void SessionProvider::Prewarm(int32_t target_sessions) {
+  while (num_sessions() < target_sessions) {
+    if (!budget_->TryAcquire()) {
+      VLOG(1) << "Session budget exhausted while prewarming function ["
+              << function_id_ << "]";
+      return;
+    }
+    absl::StatusOr<SessionWithResourceContainer> session =
+        CreateAcquiredSession();
+    if (!session.ok()) {
+      LOG(WARNING) << "Failed to prewarm a session of function ["
+                   << function_id_ << "]: " << session.status();
+      return;
+    }
+    ReturnSession(std::move(session).value());
+  }
 }
 
 }  // namespace tensorflow_federated
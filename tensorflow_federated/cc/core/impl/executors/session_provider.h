@@ -16,6 +16,7 @@ limitations under the License
 #ifndef THIRD_PARTY_TENSORFLOW_FEDERATED_CC_CORE_IMPL_EXECUTORS_SESSION_PROVIDER_H_
 #define THIRD_PARTY_TENSORFLOW_FEDERATED_CC_CORE_IMPL_EXECUTORS_SESSION_PROVIDER_H_
 
+#include <atomic>
 #include <cstdint>
 #include <memory>
 #include <string>
@@ -23,18 +24,56 @@ limitations under the License
 #include <vector>
 
 #include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
 #include "absl/log/log.h"
+#include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
 #include "absl/synchronization/mutex.h"
 #include "tensorflow/core/common_runtime/device_mgr.h"
 #include "tensorflow/core/framework/graph.pb.h"
+#include "tensorflow/core/protobuf/config.pb.h"
 #include "tensorflow/core/protobuf/rewriter_config.pb.h"
 #include "tensorflow/core/public/session.h"
+#include "tensorflow/core/public/session_options.h"
+#include "tensorflow_federated/cc/core/impl/executors/session_budget.h"
 #include "tensorflow_federated/cc/core/impl/executors/status_macros.h"
 
 namespace tensorflow_federated {
 
+// How the sessions of a `SessionProvider` schedule their ops on threads.
+struct SessionThreadingOptions {
+  // Threads in the inter-op pool, which runs a session's ops. Non-positive
+  // values let TensorFlow choose (usually one per core).
+  int32_t inter_op_threads = 0;
+  // Threads each op may use to parallelize its own work. Non-positive values
+  // let TensorFlow choose (usually one per core).
+  int32_t intra_op_threads = 0;
+  // If set, ops run on the process-wide inter-op pool with this name, shared
+  // by every session configured with the same name. The pool is sized by
+  // `inter_op_threads` of the first session that uses it. Otherwise, sessions
+  // share TensorFlow's default global inter-op pool.
+  std::string inter_op_pool_name;
+  // If true, each session creates its own inter-op pool and
+  // `inter_op_pool_name` is ignored. On busy workers running many sessions,
+  // this oversubscribes the cores.
+  bool use_per_session_threads = false;
+};
+
+// Graph optimizations applied by the sessions of a `SessionProvider`. Both are
+// off by default: most computations run in few, short lived sessions, which
+// rarely recover the cost of optimizing. Sessions are pooled by the provider,
+// so a computation called many times pays for it once per session.
+struct SessionOptimizationOptions {
+  // If true, Grappler's meta optimizer rewrites the graph when a session is
+  // created, and the graph optimizer runs at `L1`.
+  bool enable_grappler = false;
+  // If true, clusters of ops are compiled with XLA JIT (`global_jit_level`
+  // `ON_1`), including on CPU. Clusters are compiled on their first run in
+  // each session.
+  bool enable_xla_jit = false;
+};
+
 // This class acts as a function from graph -> session, caching previously-
 // created sessions for later use.
 //
@@ -45,16 +84,25 @@ namespace tensorflow_federated {
 // functions and would run into issues (e.g. re-initialize lookup tables)
 // otherwise.
 //
+// Every session the provider creates holds a slot in a `SessionBudget`
+// (process-wide by default) until it is destroyed. When the budget is
+// exhausted, idle sessions pooled by this provider may be reclaimed by other
+// providers' callers.
+//
 // This class is intended only to serve as a dependency of the
 // TensorFlowExecutor.
 class SessionProvider {
  public:
-  SessionProvider(tensorflow::GraphDef&& graph);
+  explicit SessionProvider(tensorflow::GraphDef&& graph,
+                           SessionBudget* budget = SessionBudget::Global(),
+                           const SessionThreadingOptions& threading = {},
+                           const SessionOptimizationOptions& optimization = {});
+  ~SessionProvider();
 
   class SessionWithResourceContainer {
    public:
     SessionWithResourceContainer(std::unique_ptr<tensorflow::Session> session,
-                                 uint32_t function_id, int16_t session_id)
+                                 uint32_t function_id, uint64_t session_id)
         : session_(std::move(session)),
           container_name_(absl::StrCat(function_id, "/", session_id)) {
       absl::Status status = session_->LocalDeviceManager(&device_mgr_);
@@ -78,10 +126,35 @@ class SessionProvider {
 
     tensorflow::Session* session_ptr() { return session_.get(); }
 
+    // Returns the handle of this session's callable `id`, making it from
+    // `options` on first use. Callers must always pass the same `options` for
+    // an `id`. Callables feed and fetch tensors by position, so running them
+    // does not look up tensor names.
+    absl::StatusOr<tensorflow::Session::CallableHandle> GetCallable(
+        int32_t id, const tensorflow::CallableOptions& options) {
+      // A session is only used by one renter at a time, so `callables_` needs
+      // no lock.
+      auto it = callables_.find(id);
+      if (it != callables_.end()) {
+        return it->second;
+      }
+      tensorflow::Session::CallableHandle handle;
+      absl::Status status = session_->MakeCallable(options, &handle);
+      if (!status.ok()) {
+        return absl::InternalError(absl::StrCat(
+            "Failed to make callable for session: ", status.message()));
+      }
+      callables_.emplace(id, handle);
+      return handle;
+    }
+
    private:
     std::unique_ptr<tensorflow::Session> session_;
     const std::string container_name_;
     const tensorflow::DeviceMgr* device_mgr_;
+    // Released with the session.
+    absl::flat_hash_map<int32_t, tensorflow::Session::CallableHandle>
+        callables_;
   };
 
   // An RAII container which returns the session to the provider on destruction.
@@ -104,6 +177,12 @@ class SessionProvider {
 
     tensorflow::Session* operator->() { return session_.session_ptr(); }
 
+    // See `SessionWithResourceContainer::GetCallable`.
+    absl::StatusOr<tensorflow::Session::CallableHandle> GetCallable(
+        int32_t id, const tensorflow::CallableOptions& options) {
+      return session_.GetCallable(id, options);
+    }
+
    private:
     SessionWithResourceContainer session_;
     SessionProvider& provider_;
@@ -116,19 +195,38 @@ class SessionProvider {
   absl::StatusOr<SessionWithResourceContainer> TakeSession();
   void ReturnSession(SessionWithResourceContainer&& session);
 
+  // Creates idle sessions until this provider holds `target_sessions`, so
+  // that later calls do not pay for session creation. Stops early, without
+  // waiting, if the budget has no free slots.
+  void Prewarm(int32_t target_sessions);
+
+  // Returns the number of live sessions this provider holds, whether they are
+  // currently rented out or not. Does not lock, so that it is cheap enough to
+  // call on every lookup of a cached computation.
+  int32_t num_sessions() const {
+    return live_sessions_.load(std::memory_order_relaxed);
+  }
+
  private:
   absl::StatusOr<std::unique_ptr<tensorflow::Session>> CreateSession(
-      const int16_t session_id);
-
-  // Move-only.
-  SessionProvider(SessionProvider&& other) = default;
-  SessionProvider& operator=(SessionProvider&& other) = default;
+      const uint64_t session_id);
+  // Creates a session for a budget slot that was already acquired, releasing
+  // the slot on failure.
+  absl::StatusOr<SessionWithResourceContainer> CreateAcquiredSession();
+  // Detaches one idle session, returning it, or `nullptr` if there was none.
+  // Used as this provider's `SessionBudget::ReclaimFn`.
+  SessionBudget::ReclaimedSession ReclaimIdleSession();
+
+  // The budget holds a callback into this provider, so it cannot be moved.
+  SessionProvider(SessionProvider&& other) = delete;
+  SessionProvider& operator=(SessionProvider&& other) = delete;
   SessionProvider(const SessionProvider&) = delete;
   SessionProvider& operator=(const SessionProvider&) = delete;
 
-  absl::Mutex mutex_;
+  mutable absl::Mutex mutex_;
   std::vector<SessionWithResourceContainer> sessions_ ABSL_GUARDED_BY(mutex_);
   const tensorflow::GraphDef graph_;
+  const tensorflow::SessionOptions session_options_;
   // A prefix for all containers used by sessions created by this provider.
   const uint32_t function_id_;
   // A running count of the number of sessions created by this provider. This is
@@ -138,7 +236,12 @@ class SessionProvider {
   // - The accelerator device to pin this computation on. If a machine has
   //   multiple accelerators, sessions will be pinned to the
   //   `session_creation_counter_ % num_accelerators` device.
-  int16_t session_creation_counter_ ABSL_GUARDED_BY(mutex_) = 0;
+  uint64_t session_creation_counter_ ABSL_GUARDED_BY(mutex_) = 0;
+  // The number of sessions holding a slot in `budget_`, idle or rented out.
+  // Only modified while holding `mutex_`.
+  std::atomic<int32_t> live_sessions_{0};
+  SessionBudget* const budget_;
+  int64_t reclaimer_id_;
 };
 
 }  // namespace tensorflow_federated
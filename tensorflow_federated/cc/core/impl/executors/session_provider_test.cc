@@ -15,9 +15,20 @@ limitations under the License
 
 #include "tensorflow_federated/cc/core/impl/executors/session_provider.h"
 
+#include <cstdint>
 #include <utility>
+#include <vector>
 
 #include "googletest/include/gtest/gtest.h"
+#include "absl/strings/str_cat.h"
+#include "tensorflow/cc/framework/scope.h"
+#include "tensorflow/cc/ops/array_ops.h"
+#include "tensorflow/cc/ops/math_ops.h"
+#include "tensorflow/core/framework/graph.pb.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/types.pb.h"
+#include "tensorflow/core/protobuf/config.pb.h"
+#include "tensorflow_federated/cc/core/impl/executors/session_budget.h"
 #include "tensorflow_federated/cc/testing/status_matchers.h"
 
 namespace tensorflow_federated {
@@ -30,5 +41,98 @@ TEST(SessionProviderTest, TestStandaloneTakeSession) {
   TFF_ASSERT_OK(session_provider.TakeSession());
 }
 
+TEST(SessionProviderTest, PrewarmCreatesIdleSessions) {
+  SessionBudget budget;
+  SessionProvider session_provider(tensorflow::GraphDef(), &budget);
+  session_provider.Prewarm(3);
+  EXPECT_EQ(session_provider.num_sessions(), 3);
+  EXPECT_EQ(budget.live_sessions(), 3);
+  // Taking a prewarmed session does not create a new one.
+  TFF_ASSERT_OK(session_provider.BorrowSession());
+  EXPECT_EQ(session_provider.num_sessions(), 3);
+}
+
+TEST(SessionProviderTest, PrewarmStopsAtBudget) {
+  SessionBudget budget(2);
+  SessionProvider session_provider(tensorflow::GraphDef(), &budget);
+  session_provider.Prewarm(3);
+  EXPECT_EQ(session_provider.num_sessions(), 2);
+}
+
+TEST(SessionProviderTest, DestructionReleasesBudget) {
+  SessionBudget budget;
+  {
+    SessionProvider session_provider(tensorflow::GraphDef(), &budget);
+    session_provider.Prewarm(2);
+    EXPECT_EQ(budget.live_sessions(), 2);
+  }
+  EXPECT_EQ(budget.live_sessions(), 0);
+}
+
+TEST(SessionProviderTest, ReclaimsIdleSessionsOfOtherProviders) {
+  SessionBudget budget(1);
+  SessionProvider first(tensorflow::GraphDef(), &budget);
+  SessionProvider second(tensorflow::GraphDef(), &budget);
+  TFF_ASSERT_OK(first.BorrowSession());
+  EXPECT_EQ(first.num_sessions(), 1);
+  // `first`'s session is idle again, so `second` may reclaim its slot.
+  TFF_ASSERT_OK(second.BorrowSession());
+  EXPECT_EQ(first.num_sessions(), 0);
+  EXPECT_EQ(second.num_sessions(), 1);
+  EXPECT_EQ(budget.reclaimed_sessions(), 1);
+}
+
+TEST(SessionProviderTest, TakesSessionsWithThreadingOptions) {
+  SessionThreadingOptions per_session;
+  per_session.use_per_session_threads = true;
+  per_session.inter_op_threads = 2;
+  SessionProvider per_session_provider(tensorflow::GraphDef(),
+                                       SessionBudget::Global(), per_session);
+  TFF_ASSERT_OK(per_session_provider.TakeSession());
+
+  SessionThreadingOptions shared_pool;
+  shared_pool.inter_op_pool_name = "session_provider_test";
+  shared_pool.inter_op_threads = 2;
+  shared_pool.intra_op_threads = 1;
+  SessionProvider first(tensorflow::GraphDef(), SessionBudget::Global(),
+                        shared_pool);
+  SessionProvider second(tensorflow::GraphDef(), SessionBudget::Global(),
+                         shared_pool);
+  TFF_ASSERT_OK(first.TakeSession());
+  TFF_ASSERT_OK(second.TakeSession());
+}
+
+TEST(SessionProviderTest, TakesSessionsWithOptimizationOptions) {
+  SessionOptimizationOptions optimization;
+  optimization.enable_grappler = true;
+  optimization.enable_xla_jit = true;
+  SessionProvider session_provider(tensorflow::GraphDef(),
+                                   SessionBudget::Global(), {}, optimization);
+  TFF_ASSERT_OK(session_provider.TakeSession());
+}
+
+TEST(SessionProviderTest, ReusesCallablesOfASession) {
+  tensorflow::Scope root = tensorflow::Scope::NewRootScope();
+  tensorflow::ops::Placeholder x(root, tensorflow::DT_INT32);
+  tensorflow::ops::AddV2 out(root, x, x);
+  tensorflow::GraphDef graphdef_pb;
+  TFF_ASSERT_OK(root.ToGraphDef(&graphdef_pb));
+  SessionProvider session_provider(std::move(graphdef_pb));
+  tensorflow::CallableOptions options;
+  options.add_feed(absl::StrCat(x.node()->name(), ":0"));
+  options.add_fetch(absl::StrCat(out.node()->name(), ":0"));
+
+  SessionProvider::SessionRental session =
+      TFF_ASSERT_OK(session_provider.BorrowSession());
+  tensorflow::Session::CallableHandle callable =
+      TFF_ASSERT_OK(session.GetCallable(/*id=*/0, options));
+  EXPECT_EQ(TFF_ASSERT_OK(session.GetCallable(/*id=*/0, options)), callable);
+  std::vector<tensorflow::Tensor> outputs;
+  TFF_ASSERT_OK(session->RunCallable(callable, {tensorflow::Tensor(2)},
+                                     &outputs, /*run_metadata=*/nullptr));
+  ASSERT_EQ(outputs.size(), 1);
+  EXPECT_EQ(outputs[0].scalar<int32_t>()(), 4);
+}
+
 }  // namespace
 }  // namespace tensorflow_federated
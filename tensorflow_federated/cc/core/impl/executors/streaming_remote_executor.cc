@@ -39,6 +39,7 @@ limitations under the License
 #include "include/grpcpp/support/status.h"
 #include "federated_language/proto/computation.pb.h"
 #include "tensorflow_federated/cc/core/impl/executors/cardinalities.h"
+#include "tensorflow_federated/cc/core/impl/executors/continuation_future.h"
 #include "tensorflow_federated/cc/core/impl/executors/executor.h"
 #include "tensorflow_federated/cc/core/impl/executors/federated_intrinsics.h"
 #include "tensorflow_federated/cc/core/impl/executors/status_conversion.h"
@@ -52,8 +53,10 @@ namespace tensorflow_federated {
 
 class ExecutorValue;
 
+// Continuation futures let calls on pending values wait for them without
+// parking a thread.
 using ValueFuture =
-    std::shared_future<absl::StatusOr<std::shared_ptr<ExecutorValue>>>;
+    ContinuationFuture<absl::StatusOr<std::shared_ptr<ExecutorValue>>>;
 
 // Create a structure by extracting all the values inside the federated values
 // of a structure.
@@ -315,6 +318,7 @@ class StubDeleter {
         v0::DisposeExecutorResponse response;
         grpc::ClientContext context;
         *request.mutable_executor() = std::move(executor_pb);
+        ScopedBlockingRegion blocking;
         grpc::Status dispose_status =
             stub->DisposeExecutor(&context, request, &response);
         if (!dispose_status.ok()) {
@@ -405,6 +409,7 @@ class ExecutorValue {
       grpc::ClientContext context;
       *request.mutable_executor() = std::move(executor_pb);
       *request.add_value_ref() = value_ref;
+      ScopedBlockingRegion blocking;
       grpc::Status dispose_status = stub->Dispose(&context, request, &response);
       if (!dispose_status.ok()) {
         LOG(ERROR) << "Error disposing of ExecutorValue [" << value_ref.id()
@@ -440,6 +445,7 @@ absl::Status StreamingRemoteExecutor::EnsureInitialized() {
   }
   v0::GetExecutorResponse response;
   grpc::ClientContext client_context;
+  ScopedBlockingRegion blocking;
   auto result = stub_->GetExecutor(&client_context, request, &response);
   if (result.ok()) {
     executor_pb_ = response.executor();
@@ -531,14 +537,30 @@ StreamingRemoteExecutor::CreateExecutorValueStreaming(
 absl::StatusOr<ValueFuture> StreamingRemoteExecutor::CreateExecutorValue(
     const v0::Value& value_pb) {
   TFF_TRY(EnsureInitialized());
-  return ThreadRun([value_pb, this, this_keepalive = shared_from_this()]()
-                       -> absl::StatusOr<std::shared_ptr<ExecutorValue>> {
-    return TFF_TRY(Wait(TFF_TRY(this->CreateExecutorValueStreaming(value_pb))));
-  });
+  using Result = absl::StatusOr<std::shared_ptr<ExecutorValue>>;
+  ContinuationPromise<Result> promise;
+  ValueFuture result = promise.GetFuture();
+  // Streaming sends an RPC per element, so it runs on the default pool. The
+  // value it creates is forwarded to `result` once ready, without parking the
+  // thread on it.
+  ScheduleOnDefaultThreadPool(
+      [promise, value_pb, this, this_keepalive = shared_from_this()]() mutable {
+        absl::StatusOr<ValueFuture> streamed =
+            this->CreateExecutorValueStreaming(value_pb);
+        if (!streamed.ok()) {
+          promise.SetValue(streamed.status());
+          return;
+        }
+        streamed->WhenReady([promise](const ValueFuture& value) mutable {
+          promise.SetValue(value.get());
+        });
+      });
+  return result;
 }
 
 absl::StatusOr<ValueFuture> StreamingRemoteExecutor::CreateValueRPC(
     const v0::Value& value_pb) {
+  using Result = absl::StatusOr<std::shared_ptr<ExecutorValue>>;
   federated_language::Type type_pb = TFF_TRY(InferTypeFromValue(value_pb));
   VLOG(5) << "CreateValueRPC: [" << type_pb.ShortDebugString() << "]";
   if (type_pb.has_function() || type_pb.ShortDebugString().empty()) {
@@ -559,99 +581,110 @@ absl::StatusOr<ValueFuture> StreamingRemoteExecutor::CreateValueRPC(
   *request.mutable_value() = value_pb;
   v0::CreateValueResponse response;
   grpc::ClientContext client_context;
+  ScopedBlockingRegion blocking;
   grpc::Status status = stub_->CreateValue(&client_context, request, &response);
   TFF_TRY(grpc_to_absl(status));
-  return ReadyFuture(
+  return ReadyContinuationFuture(Result(
       std::make_shared<ExecutorValue>(std::move(response.value_ref()),
-                                      std::move(type_pb), executor_pb_, stub_));
+                                      std::move(type_pb), executor_pb_, stub_)));
 }
 
 absl::StatusOr<ValueFuture> StreamingRemoteExecutor::CreateCall(
     ValueFuture function, std::optional<ValueFuture> argument) {
   TFF_TRY(EnsureInitialized());
-  return ThreadRun([function = std::move(function),
-                    argument = std::move(argument), executor_pb = executor_pb_,
-                    this, this_keepalive = shared_from_this()]()
-                       -> absl::StatusOr<std::shared_ptr<ExecutorValue>> {
-    v0::CreateCallRequest request;
-    v0::CreateCallResponse response;
-    grpc::ClientContext context;
-    std::shared_ptr<ExecutorValue> fn = TFF_TRY(Wait(function));
-
-    *request.mutable_executor() = executor_pb;
-    *request.mutable_function_ref() = fn->Get();
-    if (argument.has_value()) {
-      std::shared_ptr<ExecutorValue> arg_value =
-          TFF_TRY(Wait(argument.value()));
-      *request.mutable_argument_ref() = arg_value->Get();
-    }
+  std::vector<ValueFuture> futures = {std::move(function)};
+  if (argument.has_value()) {
+    futures.push_back(std::move(*argument));
+  }
+  return MapAsync(
+      std::move(futures),
+      [executor_pb = executor_pb_, this, this_keepalive = shared_from_this()](
+          std::vector<std::shared_ptr<ExecutorValue>>&& values)
+          -> absl::StatusOr<std::shared_ptr<ExecutorValue>> {
+        // `values` holds the resolved `futures`, either `{function}` or
+        // `{function, argument}`.
+        const std::shared_ptr<ExecutorValue>& fn = values[0];
+        v0::CreateCallRequest request;
+        v0::CreateCallResponse response;
+        grpc::ClientContext context;
+        *request.mutable_executor() = executor_pb;
+        *request.mutable_function_ref() = fn->Get();
+        if (values.size() == 2) {
+          *request.mutable_argument_ref() = values[1]->Get();
+        }
 
-    grpc::Status status = this->stub_->CreateCall(&context, request, &response);
-    TFF_TRY(grpc_to_absl(status));
-    return std::make_shared<ExecutorValue>(std::move(response.value_ref()),
-                                           fn->Type().function().result(),
-                                           executor_pb, this->stub_);
-  });
+        ScopedBlockingRegion blocking;
+        grpc::Status status =
+            this->stub_->CreateCall(&context, request, &response);
+        TFF_TRY(grpc_to_absl(status));
+        return std::make_shared<ExecutorValue>(std::move(response.value_ref()),
+                                               fn->Type().function().result(),
+                                               executor_pb, this->stub_);
+      });
 }
 
 absl::StatusOr<ValueFuture> StreamingRemoteExecutor::CreateStruct(
     std::vector<ValueFuture> members) {
   TFF_TRY(EnsureInitialized());
-  return ThreadRun([futures = std::move(members), this,
-                    this_keepalive = shared_from_this()]()
-                       -> absl::StatusOr<std::shared_ptr<ExecutorValue>> {
-    v0::CreateStructRequest request;
-    *request.mutable_executor() = this->executor_pb_;
-    v0::CreateStructResponse response;
-    grpc::ClientContext context;
-    std::vector<std::shared_ptr<ExecutorValue>> values =
-        TFF_TRY(WaitAll(futures));
-    federated_language::Type result_type;
-    federated_language::StructType* struct_type = result_type.mutable_struct_();
-    for (const std::shared_ptr<ExecutorValue>& element : values) {
-      v0::CreateStructRequest_Element struct_elem;
-      *struct_elem.mutable_value_ref() = element->Get();
-      *struct_type->add_element()->mutable_value() = element->Type();
-      request.mutable_element()->Add(std::move(struct_elem));
-    }
-    grpc::Status status =
-        this->stub_->CreateStruct(&context, request, &response);
-    TFF_TRY(grpc_to_absl(status));
-    auto result = std::make_shared<ExecutorValue>(
-        std::move(response.value_ref()), std::move(result_type),
-        this->executor_pb_, this->stub_);
-    return result;
-  });
+  return MapAsync(
+      std::move(members),
+      [this, this_keepalive = shared_from_this()](
+          std::vector<std::shared_ptr<ExecutorValue>>&& values)
+          -> absl::StatusOr<std::shared_ptr<ExecutorValue>> {
+        v0::CreateStructRequest request;
+        *request.mutable_executor() = this->executor_pb_;
+        v0::CreateStructResponse response;
+        grpc::ClientContext context;
+        federated_language::Type result_type;
+        federated_language::StructType* struct_type =
+            result_type.mutable_struct_();
+        for (const std::shared_ptr<ExecutorValue>& element : values) {
+          v0::CreateStructRequest_Element struct_elem;
+          *struct_elem.mutable_value_ref() = element->Get();
+          *struct_type->add_element()->mutable_value() = element->Type();
+          request.mutable_element()->Add(std::move(struct_elem));
+        }
+        ScopedBlockingRegion blocking;
+        grpc::Status status =
+            this->stub_->CreateStruct(&context, request, &response);
+        TFF_TRY(grpc_to_absl(status));
+        return std::make_shared<ExecutorValue>(
+            std::move(response.value_ref()), std::move(result_type),
+            this->executor_pb_, this->stub_);
+      });
 }
 
 absl::StatusOr<ValueFuture> StreamingRemoteExecutor::CreateSelection(
     ValueFuture value, const uint32_t index) {
   TFF_TRY(EnsureInitialized());
-  return ThreadRun([source = std::move(value), index = index, this,
-                    this_keepalive = shared_from_this()]()
-                       -> absl::StatusOr<std::shared_ptr<ExecutorValue>> {
-    std::shared_ptr<ExecutorValue> source_value = TFF_TRY(Wait(source));
-    const federated_language::Type& source_type_pb = source_value->Type();
-    if (!source_type_pb.has_struct_()) {
-      return absl::InvalidArgumentError(
-          absl::StrCat("Error selecting from non-Struct value: ",
-                       source_type_pb.ShortDebugString()));
-    }
-    v0::CreateSelectionRequest request;
-    v0::CreateSelectionResponse response;
-    grpc::ClientContext context;
-    *request.mutable_executor() = this->executor_pb_;
-    *request.mutable_source_ref() = source_value->Get();
-    request.set_index(index);
-    grpc::Status status =
-        this->stub_->CreateSelection(&context, request, &response);
-    const federated_language::Type element_type_pb =
-        source_type_pb.struct_().element(index).value();
-    TFF_TRY(grpc_to_absl(status));
-    return std::make_shared<ExecutorValue>(std::move(response.value_ref()),
-                                           std::move(element_type_pb),
-                                           this->executor_pb_, this->stub_);
-  });
+  return MapAsync(
+      std::vector<ValueFuture>({std::move(value)}),
+      [index, this, this_keepalive = shared_from_this()](
+          std::vector<std::shared_ptr<ExecutorValue>>&& source_in_vec)
+          -> absl::StatusOr<std::shared_ptr<ExecutorValue>> {
+        const std::shared_ptr<ExecutorValue>& source_value = source_in_vec[0];
+        const federated_language::Type& source_type_pb = source_value->Type();
+        if (!source_type_pb.has_struct_()) {
+          return absl::InvalidArgumentError(
+              absl::StrCat("Error selecting from non-Struct value: ",
+                           source_type_pb.ShortDebugString()));
+        }
+        v0::CreateSelectionRequest request;
+        v0::CreateSelectionResponse response;
+        grpc::ClientContext context;
+        *request.mutable_executor() = this->executor_pb_;
+        *request.mutable_source_ref() = source_value->Get();
+        request.set_index(index);
+        ScopedBlockingRegion blocking;
+        grpc::Status status =
+            this->stub_->CreateSelection(&context, request, &response);
+        const federated_language::Type element_type_pb =
+            source_type_pb.struct_().element(index).value();
+        TFF_TRY(grpc_to_absl(status));
+        return std::make_shared<ExecutorValue>(std::move(response.value_ref()),
+                                               std::move(element_type_pb),
+                                               this->executor_pb_, this->stub_);
+      });
 }
 
 absl::Status StreamingRemoteExecutor::Materialize(ValueFuture value,
@@ -759,6 +792,7 @@ absl::Status StreamingRemoteExecutor::MaterializeRPC(ValueFuture value,
 
   v0::ComputeResponse compute_response;
   grpc::ClientContext client_context;
+  ScopedBlockingRegion blocking;
   grpc::Status status =
       stub_->Compute(&client_context, request, &compute_response);
   *value_pb = std::move(*compute_response.mutable_value());
@@ -15,6 +15,8 @@ limitations under the License
 
 #include "tensorflow_federated/cc/core/impl/executors/tensor_serialization.h"
 
+#include <utility>
+
 #include "absl/log/log.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
@@ -64,4 +66,12 @@ absl::StatusOr<tensorflow::Tensor> DeserializeTensorValue(
   }
 }
 
+absl::StatusOr<tensorflow::Tensor> DeserializeTensorValue(
+    v0::Value&& value_pb) {
+  if (!value_pb.has_array() || !value_pb.array().has_content()) {
+    return DeserializeTensorValue(value_pb);
+  }
+  return TensorFromArrayContent(std::move(*value_pb.mutable_array()));
+}
+
 }  // namespace tensorflow_federated
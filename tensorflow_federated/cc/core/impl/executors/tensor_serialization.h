@@ -30,6 +30,9 @@ absl::Status SerializeTensorValue(const tensorflow::Tensor tensor,
 // Deserializes a TFF Value protobuf back to a tf::Tensor.
 absl::StatusOr<tensorflow::Tensor> DeserializeTensorValue(
     const v0::Value& value_pb);
+// As above, but the returned tensor may take over the buffer of `value_pb`
+// instead of copying it.
+absl::StatusOr<tensorflow::Tensor> DeserializeTensorValue(v0::Value&& value_pb);
 
 }  // namespace tensorflow_federated
 
@@ -22,6 +22,9 @@ limitations under the License
 //     The only logic that may exist here is parameter/result conversions (e.g.
 //     `OwnedValueId` -> `ValueId`, etc).
 
+#include <cstdint>
+#include <memory>
+
 #include "absl/log/log.h"
 #include "absl/status/status.h"
 #include "federated_language/proto/computation.pb.h"
@@ -39,6 +42,8 @@ limitations under the License
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/python/lib/core/ndarray_tensor.h"
 #include "tensorflow/python/lib/core/ndarray_tensor_bridge.h"
+#include "tensorflow_federated/cc/core/impl/executors/memory_budget.h"
+#include "tensorflow_federated/cc/core/impl/executors/session_budget.h"
 #include "tensorflow_federated/cc/core/impl/executors/tensorflow_executor.h"
 #include "tensorflow_federated/proto/v0/executor.pb.h"
 
@@ -71,9 +76,26 @@ PYBIND11_MODULE(tensorflow_bindings, m) {
   m.doc() = "Bindings for the C++ ";
 
   // Executor construction methods.
-  m.def("create_tensorflow_executor", &CreateTensorFlowExecutor,
+  m.def("create_tensorflow_executor",
+        py::overload_cast<int32_t, std::shared_ptr<MemoryBudget>>(
+            &CreateTensorFlowExecutor),
         py::arg("max_concurrent_computation_calls") = -1,
+        py::arg("memory_budget").none(true) = nullptr,
         "Creates a TensorFlowExecutor.");
+
+  // Session configuration.
+  m.def(
+      "set_max_sessions",
+      [](int64_t max_sessions) {
+        SessionBudget::Global()->set_max_sessions(max_sessions);
+      },
+      py::arg("max_sessions"),
+      "Caps the live TensorFlow sessions of all TensorFlowExecutors in the "
+      "process. Non-positive values remove the cap.");
+  m.def(
+      "get_max_sessions",
+      []() { return SessionBudget::Global()->max_sessions(); },
+      "Returns the cap on the live TensorFlow sessions of the process.");
 }
 
 }  // namespace
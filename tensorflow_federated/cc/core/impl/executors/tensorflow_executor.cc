@@ -17,6 +17,7 @@ limitations under the License
 
 #include <algorithm>
 #include <cstdint>
+#include <deque>
 #include <future>  // NOLINT
 #include <memory>
 #include <optional>
@@ -28,11 +29,12 @@ limitations under the License
 
 #include "google/protobuf/any.pb.h"
 #include "absl/base/attributes.h"
-#include "absl/base/thread_annotations.h"
 #include "absl/container/flat_hash_map.h"
+#include "absl/functional/function_ref.h"
 #include "absl/log/log.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/strings/match.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_join.h"
 #include "absl/strings/string_view.h"
@@ -40,18 +42,26 @@ limitations under the License
 #include "absl/types/span.h"
 #include "tensorflow/core/data/standalone.h"
 #include "tensorflow/core/framework/attr_value.pb.h"
+#include "tensorflow/core/framework/function.pb.h"
 #include "tensorflow/core/framework/graph.pb.h"
 #include "tensorflow/core/framework/node_def.pb.h"
+#include "tensorflow/core/framework/op.h"
+#include "tensorflow/core/framework/op_def.pb.h"
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/framework/tensor.pb.h"
 #include "tensorflow/core/framework/tensor_shape.h"
 #include "tensorflow/core/framework/types.h"
 #include "tensorflow/core/framework/types.pb.h"
+#include "tensorflow/core/protobuf/config.pb.h"
 #include "tensorflow/core/public/session.h"
+#include "federated_language/proto/array.pb.h"
 #include "federated_language/proto/computation.pb.h"
 #include "tensorflow_federated/cc/core/impl/executors/dataset_from_tensor_structures.h"
 #include "tensorflow_federated/cc/core/impl/executors/dataset_utils.h"
 #include "tensorflow_federated/cc/core/impl/executors/executor.h"
+#include "tensorflow_federated/cc/core/impl/executors/function_cache.h"
+#include "tensorflow_federated/cc/core/impl/executors/memory_budget.h"
+#include "tensorflow_federated/cc/core/impl/executors/session_budget.h"
 #include "tensorflow_federated/cc/core/impl/executors/session_provider.h"
 #include "tensorflow_federated/cc/core/impl/executors/status_macros.h"
 #include "tensorflow_federated/cc/core/impl/executors/tensor_serialization.h"
@@ -322,12 +332,195 @@ absl::Status AddDatasetSerializationToSequenceBindings(
   return absl::OkStatus();
 }
 
+// Returns the name of `tensor_name` in copy `index` of a graph built by
+// `ReplicateGraph`.
+std::string ReplicaTensorName(size_t index, absl::string_view tensor_name) {
+  return absl::StrCat("replica_", index, "/", tensor_name);
+}
+
+// Returns whether running several copies of `graph` side by side in one
+// session is equivalent to running them in separate sessions. This is not the
+// case for stateful ops, which may share resources (e.g. variables with a
+// `shared_name`) between the copies.
+bool CanReplicateGraph(const tensorflow::GraphDef& graph) {
+  auto is_stateful = [](const tensorflow::NodeDef& node_pb) {
+    const tensorflow::OpDef* op_def = nullptr;
+    if (!tensorflow::OpRegistry::Global()->LookUpOpDef(node_pb.op(), &op_def)
+             .ok()) {
+      // Unknown ops (e.g. calls to library functions) are checked below.
+      return false;
+    }
+    return op_def->is_stateful();
+  };
+  for (const tensorflow::NodeDef& node_pb : graph.node()) {
+    if (is_stateful(node_pb)) {
+      return false;
+    }
+  }
+  for (const tensorflow::FunctionDef& function_pb :
+       graph.library().function()) {
+    for (const tensorflow::NodeDef& node_pb : function_pb.node_def()) {
+      if (is_stateful(node_pb)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+// Returns a graph holding `num_replicas` independent copies of `graph`, with
+// the nodes (and while loop frames) of copy `i` renamed as by
+// `ReplicaTensorName(i, ...)`. The function library is shared by the copies.
+tensorflow::GraphDef ReplicateGraph(const tensorflow::GraphDef& graph,
+                                    int32_t num_replicas) {
+  tensorflow::GraphDef replicated_graph;
+  *replicated_graph.mutable_versions() = graph.versions();
+  *replicated_graph.mutable_library() = graph.library();
+  for (int32_t i = 0; i < num_replicas; ++i) {
+    for (const tensorflow::NodeDef& node_pb : graph.node()) {
+      tensorflow::NodeDef* replica_pb = replicated_graph.add_node();
+      *replica_pb = node_pb;
+      replica_pb->set_name(ReplicaTensorName(i, node_pb.name()));
+      for (std::string& input : *replica_pb->mutable_input()) {
+        if (absl::StartsWith(input, "^")) {
+          input = absl::StrCat("^", ReplicaTensorName(i, input.substr(1)));
+        } else {
+          input = ReplicaTensorName(i, input);
+        }
+      }
+      // Colocation constraints refer to other nodes by name.
+      auto colocation = replica_pb->mutable_attr()->find("_class");
+      if (colocation != replica_pb->mutable_attr()->end()) {
+        for (std::string& location :
+             *colocation->second.mutable_list()->mutable_s()) {
+          if (absl::StartsWith(location, "loc:@")) {
+            location = absl::StrCat(
+                "loc:@", ReplicaTensorName(i, location.substr(5)));
+          }
+        }
+      }
+      // TF1 while loops (`Enter` ops) name the control-flow frame they run
+      // in, and copies sharing a frame would mix up their iterations.
+      auto frame_name = replica_pb->mutable_attr()->find("frame_name");
+      if (frame_name != replica_pb->mutable_attr()->end()) {
+        frame_name->second.set_s(
+            ReplicaTensorName(i, frame_name->second.s()));
+      }
+    }
+  }
+  return replicated_graph;
+}
+
+// Options for running a `Computation`, shared by all computations of an
+// executor.
+struct ComputationOptions {
+  // Budget for the sessions created to run the computation.
+  SessionBudget* session_budget = SessionBudget::Global();
+  // Maximum number of concurrent calls run together in one session run. See
+  // `Computation::Call`.
+  int32_t max_call_batch_size = 1;
+  SessionThreadingOptions threading;
+  SessionOptimizationOptions optimization;
+};
+
+// A binding compiled into the pre-order list of its nodes, so that calls
+// flatten arguments and rebuild results without walking the binding proto.
+class BindingPlan {
+ public:
+  static absl::StatusOr<BindingPlan> Compile(
+      const federated_language::TensorFlow::Binding& binding) {
+    BindingPlan plan;
+    TFF_TRY(plan.AddNode(binding));
+    return plan;
+  }
+
+  // Names of the tensors of the binding, in the order they are flattened.
+  const std::vector<std::string>& tensor_names() const {
+    return tensor_names_;
+  }
+
+  // Appends the tensors `value` binds to the binding to `tensors`, in the
+  // order of `tensor_names()`.
+  absl::Status Flatten(const ExecutorValue& value,
+                       std::vector<tensorflow::Tensor>& tensors) const;
+
+  // Builds the value of the binding from `tensors`, one per name of
+  // `tensor_names()`, moving the tensors out.
+  absl::StatusOr<ExecutorValue> Unflatten(
+      absl::Span<tensorflow::Tensor> tensors) const;
+
+ private:
+  struct Node {
+    enum class Kind { kTensor, kSequence, kStruct };
+    Kind kind;
+    // Number of elements of a struct, whose nodes follow this one.
+    int32_t num_elements = 0;
+  };
+
+  BindingPlan() = default;
+
+  absl::Status AddNode(const federated_language::TensorFlow::Binding& binding) {
+    switch (binding.binding_case()) {
+      case federated_language::TensorFlow::Binding::kTensor: {
+        nodes_.push_back({Node::Kind::kTensor});
+        tensor_names_.push_back(binding.tensor().tensor_name());
+        return absl::OkStatus();
+      }
+      case federated_language::TensorFlow::Binding::kSequence: {
+        nodes_.push_back({Node::Kind::kSequence});
+        tensor_names_.push_back(binding.sequence().graph_def_tensor_name());
+        return absl::OkStatus();
+      }
+      case federated_language::TensorFlow::Binding::kStruct: {
+        nodes_.push_back(
+            {Node::Kind::kStruct, binding.struct_().element_size()});
+        for (const auto& element : binding.struct_().element()) {
+          TFF_TRY(AddNode(element));
+        }
+        return absl::OkStatus();
+      }
+      default: {
+        return absl::UnimplementedError(
+            absl::StrCat("Cannot parse binding type ", binding.binding_case()));
+      }
+    }
+  }
+
+  absl::Status FlattenNode(const ExecutorValue& value, size_t& node,
+                           std::vector<tensorflow::Tensor>& tensors) const;
+  absl::StatusOr<ExecutorValue> UnflattenNode(
+      size_t& node, absl::Span<tensorflow::Tensor>& tensors) const;
+
+  static absl::Status KindMismatch(absl::string_view value_kind,
+                                   const Node& node) {
+    absl::string_view node_kind;
+    switch (node.kind) {
+      case Node::Kind::kTensor:
+        node_kind = "tensor";
+        break;
+      case Node::Kind::kSequence:
+        node_kind = "sequence";
+        break;
+      case Node::Kind::kStruct:
+        node_kind = "struct";
+        break;
+    }
+    return absl::InvalidArgumentError(absl::StrCat(
+        "Attempted to bind ", value_kind, " value to argument of kind ",
+        node_kind));
+  }
+
+  std::vector<Node> nodes_;
+  std::vector<std::string> tensor_names_;
+};
+
 // A `Computation` is a TensorFlow function consisting of a graph to execute
 // as well as a set of labeled tensor inputs and outputs.
 class Computation {
  public:
   static absl::StatusOr<std::shared_ptr<Computation>> FromProto(
-      const federated_language::TensorFlow& comp_pb) {
+      const federated_language::TensorFlow& comp_pb,
+      const ComputationOptions& options) {
     tensorflow::GraphDef graphdef_pb;
     if (!comp_pb.graph_def().UnpackTo(&graphdef_pb)) {
       return absl::InternalError(ERR_LOG("Could not unpack graphdef proto"));
@@ -339,26 +532,81 @@ class Computation {
     federated_language::TensorFlow::Binding result_shape = comp_pb.result();
     TFF_TRY(AddDatasetSerializationToSequenceBindings(
         graphdef_pb, parameter_shape, result_shape));
-    std::vector<std::string> output_tensor_names;
-    TFF_TRY(TensorNamesFromBinding(result_shape, &output_tensor_names));
+    std::optional<BindingPlan> parameter_plan;
+    if (parameter_shape.has_value()) {
+      parameter_plan = TFF_TRY(BindingPlan::Compile(*parameter_shape));
+    }
+    BindingPlan result_plan = TFF_TRY(BindingPlan::Compile(result_shape));
     return std::make_shared<Computation>(
         std::move(graphdef_pb), comp_pb.initialize_op(),
         std::move(parameter_shape), comp_pb.result(),
-        std::move(output_tensor_names));
+        std::move(parameter_plan), std::move(result_plan), options);
   }
 
-  absl::StatusOr<ExecutorValue> Call(std::optional<ExecutorValue> arg);
+  // Runs the computation on `arg`. Returns a `Cancelled` error instead of
+  // starting a session run once `cancellation` has been cancelled.
+  //
+  // If call batching is enabled, calls made while other calls of this
+  // computation are running are queued, and run together once one of them
+  // finishes: a single session run feeds and fetches one copy of the graph per
+  // call.
+  // This amortizes the fixed cost of a session run over many small calls
+  // (e.g. the clients of a `federated_map`).
+  absl::StatusOr<ExecutorValue> Call(std::optional<ExecutorValue> arg,
+                                     const CancellationToken& cancellation);
 
   Computation(
       tensorflow::GraphDef graph, std::string init_op,
       std::optional<federated_language::TensorFlow::Binding> parameter_shape,
       federated_language::TensorFlow::Binding output_shape,
-      std::vector<std::string> output_tensor_names)
-      : session_provider_(std::move(graph)),
+      std::optional<BindingPlan> parameter_plan, BindingPlan result_plan,
+      const ComputationOptions& options)
+      : graph_bytes_(graph.ByteSizeLong()),
+        max_batch_size_(
+            (options.max_call_batch_size > 1 && init_op.empty() &&
+             CanReplicateGraph(graph))
+                ? options.max_call_batch_size
+                : 1),
+        batch_session_provider_(
+            max_batch_size_ > 1
+                ? std::make_unique<SessionProvider>(
+                      ReplicateGraph(graph, max_batch_size_),
+                      options.session_budget, options.threading,
+                      options.optimization)
+                : nullptr),
+        session_provider_(std::move(graph), options.session_budget,
+                          options.threading, options.optimization),
         init_op_(std::move(init_op)),
         parameter_shape_(std::move(parameter_shape)),
         output_shape_(std::move(output_shape)),
-        output_tensor_names_(std::move(output_tensor_names)) {}
+        parameter_plan_(std::move(parameter_plan)),
+        result_plan_(std::move(result_plan)),
+        callable_options_(MakeCallableOptions(/*num_replicas=*/0)) {
+    if (max_batch_size_ > 1) {
+      // The replicated graph holds `max_batch_size_` more copies.
+      graph_bytes_ += graph_bytes_ * max_batch_size_;
+      for (int32_t batch_size = 2; batch_size <= max_batch_size_;
+           ++batch_size) {
+        batch_callable_options_.push_back(MakeCallableOptions(batch_size));
+      }
+    }
+  }
+
+  // Creates idle sessions until `num_sessions` are ready to run calls.
+  void Prewarm(int32_t num_sessions) {
+    session_provider_.Prewarm(num_sessions);
+  }
+
+  // Returns the resources held by this computation while it is cached.
+  FunctionCacheCost CacheCost() const {
+    FunctionCacheCost cost;
+    cost.bytes = graph_bytes_;
+    cost.sessions = session_provider_.num_sessions();
+    if (batch_session_provider_ != nullptr) {
+      cost.sessions += batch_session_provider_->num_sessions();
+    }
+    return cost;
+  }
 
   std::string DebugString() const {
     return absl::StrCat("(",
@@ -369,53 +617,176 @@ class Computation {
   }
 
  private:
-  static absl::Status TensorNamesFromBinding(
-      const federated_language::TensorFlow::Binding& binding,
-      std::vector<std::string>* tensor_names) {
-    switch (binding.binding_case()) {
-      case federated_language::TensorFlow::Binding::kTensor: {
-        tensor_names->push_back(binding.tensor().tensor_name());
-        return absl::OkStatus();
-      }
-      case federated_language::TensorFlow::Binding::kStruct: {
-        for (const auto& member : binding.struct_().element()) {
-          TFF_TRY(TensorNamesFromBinding(member, tensor_names));
+  struct PendingCall;
+
+  // Id of the session callable running one call. Callables running a batch
+  // use the batch size as their id.
+  static constexpr int32_t kCallableId = 0;
+
+  // Returns options feeding the parameter tensors and fetching the result
+  // tensors of the first `num_replicas` copies of the replicated graph, or of
+  // the graph itself if `num_replicas` is zero.
+  tensorflow::CallableOptions MakeCallableOptions(int32_t num_replicas) const {
+    tensorflow::CallableOptions options;
+    const int32_t num_copies = std::max(num_replicas, 1);
+    for (int32_t i = 0; i < num_copies; ++i) {
+      auto copy_name = [num_replicas, i](const std::string& name) {
+        return num_replicas > 0 ? ReplicaTensorName(i, name) : name;
+      };
+      if (parameter_plan_.has_value()) {
+        for (const std::string& name : parameter_plan_->tensor_names()) {
+          options.add_feed(copy_name(name));
         }
-        return absl::OkStatus();
-      }
-      case federated_language::TensorFlow::Binding::kSequence: {
-        tensor_names->push_back(binding.sequence().graph_def_tensor_name());
-        return absl::OkStatus();
       }
-      default: {
-        return absl::UnimplementedError(
-            absl::StrCat("Cannot parse binding type ", binding.binding_case()));
+      for (const std::string& name : result_plan_.tensor_names()) {
+        options.add_fetch(copy_name(name));
       }
     }
+    return options;
   }
 
+  // Runs the computation on `inputs`, the flattened tensors of its parameter.
+  absl::StatusOr<ExecutorValue> Run(
+      const std::vector<tensorflow::Tensor>& inputs,
+      const CancellationToken& cancellation);
+  // Queues a call on `inputs`, runs it in a batch with other queued calls and
+  // returns its result.
+  absl::StatusOr<ExecutorValue> RunBatched(
+      std::vector<tensorflow::Tensor> inputs,
+      const CancellationToken& cancellation);
+  // Makes the oldest queued call, if any, lead the next batch.
+  void PromoteNextLeader() ABSL_EXCLUSIVE_LOCKS_REQUIRED(batch_mutex_);
+  // Runs the calls of `queued` that were not cancelled in one session run,
+  // setting the result of each call. If the session run fails, the calls are
+  // retried one at a time, so that only the failing calls fail.
+  void RunBatch(absl::Span<PendingCall* const> queued);
+
   // Move-only.
   Computation(Computation&& other) = default;
   Computation& operator=(Computation&& other) = default;
   Computation(const Computation&) = delete;
   Computation& operator=(const Computation&) = delete;
 
+  int64_t graph_bytes_;
+  // Greater than one if call batching is enabled.
+  const int32_t max_batch_size_;
+  // Provides sessions of a graph holding `max_batch_size_` copies of the
+  // computation's graph, which run batches of calls.
+  std::unique_ptr<SessionProvider> batch_session_provider_;
   SessionProvider session_provider_;
   std::string init_op_;
   std::optional<federated_language::TensorFlow::Binding> parameter_shape_;
   federated_language::TensorFlow::Binding output_shape_;
-  std::vector<std::string> output_tensor_names_;
+  std::optional<BindingPlan> parameter_plan_;
+  BindingPlan result_plan_;
+  const tensorflow::CallableOptions callable_options_;
+  // Element `i` runs a batch of `i + 2` calls on the replicated graph.
+  std::vector<tensorflow::CallableOptions> batch_callable_options_;
+  absl::Mutex batch_mutex_;
+  // Calls waiting to run, in arrival order.
+  std::deque<PendingCall*> pending_calls_ ABSL_GUARDED_BY(batch_mutex_);
+  // Number of calls leading a batch. Calls arriving while a batch runs are
+  // queued, so that they accumulate into the next batch. More batches only run
+  // concurrently once there are more queued calls than fit in one batch.
+  int32_t leading_calls_ ABSL_GUARDED_BY(batch_mutex_) = 0;
 };
 
-// A tensor that holds sequence data.
-class SequenceTensor {
+// Sequence data, held either as a string tensor of a serialized dataset
+// GraphDef (as produced and consumed by TensorFlow computations), or as the
+// flattened tensors of each of its elements.
+//
+// Sequences created from protos or by `args_into_sequence` are held in memory,
+// and are only lowered to a dataset GraphDef when bound to a computation. The
+// lowered tensor is shared by all copies of the sequence. Copies are shallow.
+class Sequence {
  public:
-  explicit SequenceTensor(tensorflow::Tensor&& tensor)
-      : tensor_(std::move(tensor)) {}
-  const tensorflow::Tensor& as_tensor() const { return tensor_; }
+  using Elements = std::vector<std::vector<tensorflow::Tensor>>;
+
+  static Sequence FromGraphDefTensor(tensorflow::Tensor&& tensor) {
+    auto state = std::make_shared<State>();
+    state->graph_def_tensor = std::move(tensor);
+    return Sequence(std::move(state));
+  }
+
+  // Requires that `elements` is not empty and passes `CheckTensorStructures`.
+  static Sequence FromElements(Elements&& elements) {
+    auto state = std::make_shared<State>();
+    state->elements = std::move(elements);
+    return Sequence(std::move(state));
+  }
+
+  // Returns the elements of a sequence held in memory, or nullptr if the
+  // sequence is only available as a dataset GraphDef.
+  const Elements* elements() const {
+    return state_->elements.has_value() ? &*state_->elements : nullptr;
+  }
+
+  // Returns the serialized dataset GraphDef tensor, building it from the
+  // elements on first use.
+  absl::StatusOr<tensorflow::Tensor> graph_def_tensor() const {
+    absl::MutexLock lock(&state_->mutex);
+    if (!state_->graph_def_tensor.has_value()) {
+      state_->graph_def_tensor =
+          TFF_TRY(DatasetFromTensorStructures(*state_->elements));
+      if (state_->budget != nullptr) {
+        state_->graph_def_charge =
+            state_->budget->Charge(state_->graph_def_tensor->TotalBytes());
+      }
+    }
+    return *state_->graph_def_tensor;
+  }
+
+  // Charges the GraphDef tensor built from the elements of a sequence held in
+  // memory to `budget`, once it is built, until the last copy of the sequence
+  // is destroyed. The tensor holds a second copy of the elements, which
+  // `TotalBytes` does not count.
+  void ChargeGraphDefTensorTo(std::shared_ptr<MemoryBudget> budget) const {
+    if (elements() == nullptr) {
+      return;
+    }
+    absl::MutexLock lock(&state_->mutex);
+    if (state_->budget != nullptr) {
+      return;
+    }
+    state_->budget = std::move(budget);
+    if (state_->graph_def_tensor.has_value()) {
+      state_->graph_def_charge =
+          state_->budget->Charge(state_->graph_def_tensor->TotalBytes());
+    }
+  }
+
+  // Returns the bytes of the elements, or of the GraphDef tensor if the
+  // sequence was not created in memory.
+  int64_t TotalBytes() const {
+    if (const Elements* sequence_elements = elements()) {
+      int64_t bytes = 0;
+      for (const std::vector<tensorflow::Tensor>& tensors :
+           *sequence_elements) {
+        for (const tensorflow::Tensor& tensor : tensors) {
+          bytes += tensor.TotalBytes();
+        }
+      }
+      return bytes;
+    }
+    absl::MutexLock lock(&state_->mutex);
+    return state_->graph_def_tensor->TotalBytes();
+  }
 
  private:
-  tensorflow::Tensor tensor_;
+  struct State {
+    // Set at construction and never modified.
+    std::optional<Elements> elements;
+    absl::Mutex mutex;
+    std::optional<tensorflow::Tensor> graph_def_tensor
+        ABSL_GUARDED_BY(mutex);
+    // Set for sequences held in memory once they are charged to a budget.
+    std::shared_ptr<MemoryBudget> budget ABSL_GUARDED_BY(mutex);
+    std::shared_ptr<const MemoryCharge> graph_def_charge ABSL_GUARDED_BY(mutex);
+  };
+
+  explicit Sequence(std::shared_ptr<State> state) : state_(std::move(state)) {}
+
+  std::shared_ptr<State> state_;
 };
 
 enum class Intrinsic { kArgsIntoSequence };
@@ -451,8 +822,9 @@ class ExecutorValue {
   // inexpensive.
   explicit ExecutorValue(const tensorflow::Tensor t) : value_(std::move(t)) {}
 
-  // Constructs an `ExecutorValue` from a `SequenceTensor`.
-  explicit ExecutorValue(const SequenceTensor st) : value_(std::move(st)) {}
+  // Constructs an `ExecutorValue` from a `Sequence`.
+  explicit ExecutorValue(const Sequence sequence)
+      : value_(std::move(sequence)) {}
 
   // Constructs a structural `ExecutorValue from a list of elements.
   explicit ExecutorValue(std::shared_ptr<std::vector<ExecutorValue>> elements)
@@ -473,10 +845,12 @@ class ExecutorValue {
   ExecutorValue(const ExecutorValue& other) = default;
 
   // Move constructor.
-  ExecutorValue(ExecutorValue&& other) : value_(std::move(other.value_)) {}
+  ExecutorValue(ExecutorValue&& other)
+      : value_(std::move(other.value_)), charge_(std::move(other.charge_)) {}
   // Move assignment.
   ExecutorValue& operator=(ExecutorValue&& other) {
     this->value_ = std::move(other.value_);
+    this->charge_ = std::move(other.charge_);
     return *this;
   }
 
@@ -486,7 +860,7 @@ class ExecutorValue {
       return ValueType::TENSOR;
     } else if (std::holds_alternative<std::shared_ptr<Computation>>(value_)) {
       return ValueType::COMPUTATION;
-    } else if (std::holds_alternative<SequenceTensor>(value_)) {
+    } else if (std::holds_alternative<Sequence>(value_)) {
       return ValueType::SEQUENCE;
     } else if (std::holds_alternative<Intrinsic>(value_)) {
       return ValueType::INTRINSIC;
@@ -511,60 +885,43 @@ class ExecutorValue {
     return std::get<std::shared_ptr<Computation>>(value_);
   }
 
-  const tensorflow::Tensor& sequence() const {
-    return std::get<SequenceTensor>(value_).as_tensor();
-  }
+  const Sequence& sequence() const { return std::get<Sequence>(value_); }
 
   Intrinsic intrinsic() const { return std::get<Intrinsic>(value_); }
 
-  absl::Status Bind(
-      const federated_language::TensorFlow::Binding& shape,
-      std::vector<std::pair<std::string, tensorflow::Tensor>>* bindings) const {
+  // Returns the bytes of tensor data held by this value that are not already
+  // charged to a `MemoryBudget` through this value or one of its elements.
+  //
+  // NOTE: tensor buffers may be shared between values (e.g. a selection and
+  // its source), in which case they are charged once per holding value.
+  int64_t UnchargedBytes() const {
+    if (charge_ != nullptr) {
+      return 0;
+    }
     switch (type()) {
-      case ValueType::TENSOR: {
-        if (!shape.has_tensor()) {
-          return BindKindMismatch("tensor", shape);
-        }
-        bindings->emplace_back(shape.tensor().tensor_name(), tensor());
-        return absl::OkStatus();
-      }
+      case ValueType::TENSOR:
+        return tensor().TotalBytes();
+      case ValueType::SEQUENCE:
+        return sequence().TotalBytes();
       case ValueType::STRUCT: {
-        if (!shape.has_struct_()) {
-          return BindKindMismatch("struct", shape);
-        }
-        if (shape.struct_().element_size() != elements().size()) {
-          return absl::InvalidArgumentError(
-              absl::StrCat("Attempted to bind struct with ", elements().size(),
-                           " fields to an argument struct with ",
-                           shape.struct_().element_size(), " fields."));
-        }
-        for (int i = 0; i < elements().size(); i++) {
-          TFF_TRY(elements()[i].Bind(shape.struct_().element(i), bindings));
-        }
-        return absl::OkStatus();
-      }
-      case ValueType::COMPUTATION: {
-        return absl::InvalidArgumentError(
-            "Attempted to bind computation value as argument to a TensorFlow "
-            "computation. This is not supported.");
-      }
-      case ValueType::SEQUENCE: {
-        if (!shape.has_sequence()) {
-          return BindKindMismatch("sequence", shape);
+        int64_t bytes = 0;
+        for (const ExecutorValue& element : elements()) {
+          bytes += element.UnchargedBytes();
         }
-        bindings->emplace_back(shape.sequence().graph_def_tensor_name(),
-                               sequence());
-        return absl::OkStatus();
-      }
-      case ValueType::INTRINSIC: {
-        return absl::InvalidArgumentError(absl::StrCat(
-            "Attempted to bind intrinsic ", IntrinsicToUri(intrinsic()),
-            " as argument to a TensorFlow computation. This is not "
-            "supported."));
+        return bytes;
       }
       default:
-        return absl::InvalidArgumentError(
-            absl::StrCat("Unable to bind unknown value type: ", type()));
+        return 0;
+    }
+  }
+
+  // Charges the uncharged bytes of this value to `budget` for as long as this
+  // value or any copy of it is alive. The sequences in this value charge their
+  // dataset GraphDef tensors to `budget` when they are lowered.
+  void ChargeTo(MemoryBudget& budget) {
+    if (charge_ == nullptr) {
+      charge_ = budget.Charge(UnchargedBytes());
+      ChargeSequencesTo(budget);
     }
   }
 
@@ -596,53 +953,19 @@ class ExecutorValue {
     return out;
   }
 
-  static absl::StatusOr<ExecutorValue> FromTensorsAndBindingStructure(
-      const federated_language::TensorFlow::Binding& binding_structure,
-      absl::Span<tensorflow::Tensor>* tensors) {
-    bool is_sequence = false;
-    switch (binding_structure.binding_case()) {
-      case federated_language::TensorFlow::Binding::kSequence: {
-        is_sequence = true;
-      }
-        ABSL_FALLTHROUGH_INTENDED;
-      case federated_language::TensorFlow::Binding::kTensor: {
-        if (tensors->empty()) {
-          return absl::InternalError(
-              "TensorFlow computation had fewer output tensors than expected.");
-        }
-        tensorflow::Tensor& tensor = tensors->front();
-        tensors->remove_prefix(1);
-        if (is_sequence) {
-          return ExecutorValue(SequenceTensor(std::move(tensor)));
-        } else {
-          return ExecutorValue(std::move(tensor));
-        }
-      }
-      case federated_language::TensorFlow::Binding::kStruct: {
-        auto elements = std::make_shared<std::vector<ExecutorValue>>();
-        elements->reserve(binding_structure.struct_().element_size());
-        for (const auto& e_structure : binding_structure.struct_().element()) {
-          elements->push_back(
-              TFF_TRY(FromTensorsAndBindingStructure(e_structure, tensors)));
-        }
-        return ExecutorValue(elements);
-      }
-      default: {
-        return absl::UnimplementedError(absl::StrCat(
-            "Unknown output binding kind: ", binding_structure.binding_case()));
-      }
-    }
-  }
-
   std::string DebugString() const {
     if (std::holds_alternative<tensorflow::Tensor>(value_)) {
       return absl::StrCat(tensorflow::DataTypeString(tensor().dtype()),
                           tensor().shape().DebugString());
     } else if (std::holds_alternative<std::shared_ptr<Computation>>(value_)) {
       return computation()->DebugString();
-    } else if (std::holds_alternative<SequenceTensor>(value_)) {
-      return absl::StrCat(tensorflow::DataTypeString(tensor().dtype()),
-                          tensor().shape().DebugString(), "*");
+    } else if (std::holds_alternative<Sequence>(value_)) {
+      if (const Sequence::Elements* sequence_elements =
+              sequence().elements()) {
+        return absl::StrCat("Sequence(", sequence_elements->size(),
+                            " elements)");
+      }
+      return "Sequence(dataset)";
     } else if (std::holds_alternative<Intrinsic>(value_)) {
       return absl::StrCat("Intrinsic(\"", IntrinsicToUri(intrinsic()), "\")");
     } else {
@@ -657,28 +980,153 @@ class ExecutorValue {
  private:
   ExecutorValue() = delete;
 
-  std::variant<tensorflow::Tensor, SequenceTensor, std::shared_ptr<Computation>,
+  // See `Sequence::ChargeGraphDefTensorTo`.
+  void ChargeSequencesTo(MemoryBudget& budget) const {
+    switch (type()) {
+      case ValueType::SEQUENCE:
+        sequence().ChargeGraphDefTensorTo(budget.shared_from_this());
+        return;
+      case ValueType::STRUCT:
+        for (const ExecutorValue& element : elements()) {
+          element.ChargeSequencesTo(budget);
+        }
+        return;
+      default:
+        return;
+    }
+  }
+
+  std::variant<tensorflow::Tensor, Sequence, std::shared_ptr<Computation>,
                std::shared_ptr<std::vector<ExecutorValue>>, Intrinsic>
       value_;
+  // Shared by copies, so that the bytes are released with the last copy.
+  std::shared_ptr<const MemoryCharge> charge_;
+};
 
-  static absl::Status BindKindMismatch(
-      const absl::string_view value_kind,
-      const federated_language::TensorFlow::Binding& shape) {
-    return absl::InvalidArgumentError(
-        absl::StrCat("Attempted to bind ", value_kind,
-                     " value to argument of kind ", shape.Utf8DebugString()));
+absl::Status BindingPlan::Flatten(
+    const ExecutorValue& value,
+    std::vector<tensorflow::Tensor>& tensors) const {
+  tensors.reserve(tensors.size() + tensor_names_.size());
+  size_t node = 0;
+  return FlattenNode(value, node, tensors);
+}
+
+absl::Status BindingPlan::FlattenNode(
+    const ExecutorValue& value, size_t& node,
+    std::vector<tensorflow::Tensor>& tensors) const {
+  const Node& plan_node = nodes_[node++];
+  switch (value.type()) {
+    case ExecutorValue::ValueType::TENSOR: {
+      if (plan_node.kind != Node::Kind::kTensor) {
+        return KindMismatch("tensor", plan_node);
+      }
+      tensors.push_back(value.tensor());
+      return absl::OkStatus();
+    }
+    case ExecutorValue::ValueType::STRUCT: {
+      if (plan_node.kind != Node::Kind::kStruct) {
+        return KindMismatch("struct", plan_node);
+      }
+      if (static_cast<size_t>(plan_node.num_elements) !=
+          value.elements().size()) {
+        return absl::InvalidArgumentError(absl::StrCat(
+            "Attempted to bind struct with ", value.elements().size(),
+            " fields to an argument struct with ", plan_node.num_elements,
+            " fields."));
+      }
+      for (const ExecutorValue& element : value.elements()) {
+        TFF_TRY(FlattenNode(element, node, tensors));
+      }
+      return absl::OkStatus();
+    }
+    case ExecutorValue::ValueType::COMPUTATION: {
+      return absl::InvalidArgumentError(
+          "Attempted to bind computation value as argument to a TensorFlow "
+          "computation. This is not supported.");
+    }
+    case ExecutorValue::ValueType::SEQUENCE: {
+      if (plan_node.kind != Node::Kind::kSequence) {
+        return KindMismatch("sequence", plan_node);
+      }
+      tensors.push_back(TFF_TRY(value.sequence().graph_def_tensor()));
+      return absl::OkStatus();
+    }
+    case ExecutorValue::ValueType::INTRINSIC: {
+      return absl::InvalidArgumentError(absl::StrCat(
+          "Attempted to bind intrinsic ", IntrinsicToUri(value.intrinsic()),
+          " as argument to a TensorFlow computation. This is not "
+          "supported."));
+    }
+    default:
+      return absl::InvalidArgumentError(
+          absl::StrCat("Unable to bind unknown value type: ", value.type()));
+  }
+}
+
+absl::StatusOr<ExecutorValue> BindingPlan::Unflatten(
+    absl::Span<tensorflow::Tensor> tensors) const {
+  if (tensors.size() != tensor_names_.size()) {
+    return absl::InternalError(absl::StrCat(
+        "TensorFlow computation had ", tensors.size(),
+        " output tensors, but ", tensor_names_.size(), " were expected."));
+  }
+  size_t node = 0;
+  return UnflattenNode(node, tensors);
+}
+
+absl::StatusOr<ExecutorValue> BindingPlan::UnflattenNode(
+    size_t& node, absl::Span<tensorflow::Tensor>& tensors) const {
+  const Node& plan_node = nodes_[node++];
+  switch (plan_node.kind) {
+    case Node::Kind::kTensor: {
+      ExecutorValue value(std::move(tensors.front()));
+      tensors.remove_prefix(1);
+      return value;
+    }
+    case Node::Kind::kSequence: {
+      ExecutorValue value(
+          Sequence::FromGraphDefTensor(std::move(tensors.front())));
+      tensors.remove_prefix(1);
+      return value;
+    }
+    case Node::Kind::kStruct: {
+      auto elements = std::make_shared<std::vector<ExecutorValue>>();
+      elements->reserve(plan_node.num_elements);
+      for (int32_t i = 0; i < plan_node.num_elements; ++i) {
+        elements->push_back(TFF_TRY(UnflattenNode(node, tensors)));
+      }
+      return ExecutorValue(std::move(elements));
+    }
   }
+}
+
+struct Computation::PendingCall {
+  enum class State {
+    // Waiting in `pending_calls_`.
+    kQueued,
+    // Responsible for running the next batch.
+    kLeading,
+    kDone,
+  };
+
+  PendingCall(std::vector<tensorflow::Tensor> inputs,
+              const CancellationToken& cancellation)
+      : inputs(std::move(inputs)), cancellation(cancellation) {}
+
+  const std::vector<tensorflow::Tensor> inputs;
+  const CancellationToken cancellation;
+  State state = State::kQueued;
+  absl::StatusOr<ExecutorValue> result;
 };
 
 absl::StatusOr<ExecutorValue> Computation::Call(
-    std::optional<ExecutorValue> arg) {
+    std::optional<ExecutorValue> arg, const CancellationToken& cancellation) {
   // Skip everything if there are no outputs.
-  // If `output_tensor_names` is empty, TF raises an error, so we must bypass it
+  // If there are no output tensors, TF raises an error, so we must bypass it
   // entirely.
-  if (output_tensor_names_.empty()) {
-    return ExecutorValue::FromTensorsAndBindingStructure(output_shape_, {});
+  if (result_plan_.tensor_names().empty()) {
+    return result_plan_.Unflatten({});
   }
-  auto session = TFF_TRY(this->session_provider_.BorrowSession());
   if (arg.has_value() != parameter_shape_.has_value()) {
     auto actual = arg.has_value()
                       ? absl::StrCat("of type '", arg->DebugString(), "' was")
@@ -693,12 +1141,33 @@ absl::StatusOr<ExecutorValue> Computation::Call(
                      " provided to tensorflow computation, but an argument ",
                      expected, " expected."));
   }
-  std::vector<std::pair<std::string, tensorflow::Tensor>> inputs;
+  std::vector<tensorflow::Tensor> inputs;
   if (arg.has_value()) {
-    TFF_TRY(arg.value().Bind(parameter_shape_.value(), &inputs));
+    TFF_TRY(parameter_plan_->Flatten(arg.value(), inputs));
   }
+  if (cancellation.IsCancelled()) {
+    return absl::CancelledError(
+        "Computation result was disposed of before the session was run.");
+  }
+  if (max_batch_size_ > 1) {
+    return RunBatched(std::move(inputs), cancellation);
+  }
+  return Run(inputs, cancellation);
+}
+
+absl::StatusOr<ExecutorValue> Computation::Run(
+    const std::vector<tensorflow::Tensor>& inputs,
+    const CancellationToken& cancellation) {
+  auto session = TFF_TRY(this->session_provider_.BorrowSession());
   if (!init_op_.empty()) {
-    absl::Status status = session->Run(inputs,
+    // Initialization runs a target rather than fetching tensors, so it feeds
+    // the inputs by name.
+    std::vector<std::pair<std::string, tensorflow::Tensor>> named_inputs;
+    named_inputs.reserve(inputs.size());
+    for (size_t i = 0; i < inputs.size(); ++i) {
+      named_inputs.emplace_back(parameter_plan_->tensor_names()[i], inputs[i]);
+    }
+    absl::Status status = session->Run(named_inputs,
                                        /*output_tensor_names=*/{},
                                        /*target_tensor_names=*/{init_op_},
                                        /*outputs=*/nullptr);
@@ -707,17 +1176,146 @@ absl::StatusOr<ExecutorValue> Computation::Call(
           "Failed to initialize the computation: ", status.message())));
     }
   }
+  if (cancellation.IsCancelled()) {
+    return absl::CancelledError(
+        "Computation result was disposed of before the session was run.");
+  }
+  const tensorflow::Session::CallableHandle callable =
+      TFF_TRY(session.GetCallable(kCallableId, callable_options_));
   std::vector<tensorflow::Tensor> outputs;
-  absl::Status status = session->Run(inputs, output_tensor_names_,
-                                     /*target_tensor_names=*/{}, &outputs);
+  absl::Status status = session->RunCallable(callable, inputs, &outputs,
+                                             /*run_metadata=*/nullptr);
   if (!status.ok()) {
     return absl::InternalError(
         ERR_LOG(absl::StrCat("Failed to run computation: ", status.message())));
   }
   // Return the session rental before computing the final ExecutorValue.
   session.ReturnRental();
-  absl::Span<tensorflow::Tensor> slice(outputs);
-  return ExecutorValue::FromTensorsAndBindingStructure(output_shape_, &slice);
+  return result_plan_.Unflatten(absl::MakeSpan(outputs));
+}
+
+absl::StatusOr<ExecutorValue> Computation::RunBatched(
+    std::vector<tensorflow::Tensor> inputs,
+    const CancellationToken& cancellation) {
+  PendingCall call(std::move(inputs), cancellation);
+  std::vector<PendingCall*> batch;
+  {
+    absl::MutexLock lock(&batch_mutex_);
+    pending_calls_.push_back(&call);
+    if (leading_calls_ == 0) {
+      call.state = PendingCall::State::kLeading;
+      ++leading_calls_;
+    } else {
+      auto is_dequeued = [&call]() {
+        return call.state != PendingCall::State::kQueued;
+      };
+      {
+        // Waits for the leading call to run this call's batch.
+        ScopedBlockingRegion blocking;
+        batch_mutex_.Await(absl::Condition(&is_dequeued));
+      }
+      if (call.state == PendingCall::State::kDone) {
+        return std::move(call.result);
+      }
+    }
+    // Only the front of the queue is ever made a leader, so the batch
+    // includes this call.
+    const size_t batch_size =
+        std::min<size_t>(pending_calls_.size(), max_batch_size_);
+    batch.assign(pending_calls_.begin(), pending_calls_.begin() + batch_size);
+    pending_calls_.erase(pending_calls_.begin(),
+                         pending_calls_.begin() + batch_size);
+    // If the queue overflows a batch, run the next batch concurrently.
+    PromoteNextLeader();
+  }
+  RunBatch(batch);
+  {
+    absl::MutexLock lock(&batch_mutex_);
+    for (PendingCall* batched_call : batch) {
+      batched_call->state = PendingCall::State::kDone;
+    }
+    --leading_calls_;
+    PromoteNextLeader();
+  }
+  return std::move(call.result);
+}
+
+void Computation::PromoteNextLeader() {
+  if (!pending_calls_.empty() &&
+      pending_calls_.front()->state == PendingCall::State::kQueued) {
+    pending_calls_.front()->state = PendingCall::State::kLeading;
+    ++leading_calls_;
+  }
+}
+
+void Computation::RunBatch(absl::Span<PendingCall* const> queued) {
+  // Calls cancelled while queued are dropped, rather than run for results
+  // nobody will read.
+  std::vector<PendingCall*> batch;
+  batch.reserve(queued.size());
+  for (PendingCall* call : queued) {
+    if (call->cancellation.IsCancelled()) {
+      call->result = absl::CancelledError(
+          "Computation result was disposed of before the session was run.");
+    } else {
+      batch.push_back(call);
+    }
+  }
+  if (batch.empty()) {
+    return;
+  }
+  if (batch.size() == 1) {
+    batch[0]->result = Run(batch[0]->inputs, batch[0]->cancellation);
+    return;
+  }
+  auto set_results = [&batch](const absl::Status& status) {
+    for (PendingCall* call : batch) {
+      call->result = status;
+    }
+  };
+  // Feed and fetch one copy of the graph per call. Session runs only execute
+  // the nodes needed for the fetches, so unused copies are not run.
+  std::vector<tensorflow::Tensor> inputs;
+  inputs.reserve(batch.size() * batch[0]->inputs.size());
+  for (PendingCall* call : batch) {
+    inputs.insert(inputs.end(), call->inputs.begin(), call->inputs.end());
+  }
+  absl::StatusOr<SessionProvider::SessionRental> session =
+      batch_session_provider_->BorrowSession();
+  if (!session.ok()) {
+    set_results(session.status());
+    return;
+  }
+  const int32_t batch_size = batch.size();
+  absl::StatusOr<tensorflow::Session::CallableHandle> callable =
+      session->GetCallable(batch_size,
+                           batch_callable_options_[batch_size - 2]);
+  if (!callable.ok()) {
+    set_results(callable.status());
+    return;
+  }
+  std::vector<tensorflow::Tensor> outputs;
+  absl::Status status = (*session)->RunCallable(*callable, inputs, &outputs,
+                                                /*run_metadata=*/nullptr);
+  session->ReturnRental();
+  if (!status.ok()) {
+    // The error may come from the inputs of a single call (e.g. a failed
+    // check), which must not fail the other calls of the batch.
+    LOG_EVERY_N_SEC(WARNING, 60)
+        << "Failed to run batch of " << batch.size()
+        << " computation calls, retrying them one at a time: "
+        << status.message();
+    for (PendingCall* call : batch) {
+      call->result = Run(call->inputs, call->cancellation);
+    }
+    return;
+  }
+  const size_t num_outputs = result_plan_.tensor_names().size();
+  absl::Span<tensorflow::Tensor> remaining(outputs);
+  for (PendingCall* call : batch) {
+    call->result = result_plan_.Unflatten(remaining.subspan(0, num_outputs));
+    remaining.remove_prefix(num_outputs);
+  }
 }
 
 absl::StatusOr<ExecutorValue> CallIntrinsic(Intrinsic intrinsic,
@@ -739,14 +1337,14 @@ absl::StatusOr<ExecutorValue> CallIntrinsic(Intrinsic intrinsic,
             "\"args_into_sequence\" cannot be used to create zero-length "
             "datasets.");
       }
-      std::vector<std::vector<tensorflow::Tensor>> tensor_structures;
+      Sequence::Elements tensor_structures;
       tensor_structures.reserve(arg->elements().size());
       for (const ExecutorValue& structure : arg->elements()) {
         tensor_structures.push_back(TFF_TRY(structure.Flatten()));
       }
-      tensorflow::Tensor dataset_tensor =
-          TFF_TRY(DatasetFromTensorStructures(tensor_structures));
-      return ExecutorValue(SequenceTensor(std::move(dataset_tensor)));
+      TFF_TRY(CheckTensorStructures(tensor_structures));
+      return ExecutorValue(
+          Sequence::FromElements(std::move(tensor_structures)));
     }
     default: {
       return absl::UnimplementedError(absl::StrCat(
@@ -755,10 +1353,57 @@ absl::StatusOr<ExecutorValue> CallIntrinsic(Intrinsic intrinsic,
   }
 }
 
-using ValueFuture = std::shared_future<absl::StatusOr<ExecutorValue>>;
+// Dropping the last reference to a pending value cancels its computation.
+using ValueFuture = CancellableFuture<absl::StatusOr<ExecutorValue>>;
 
-absl::Status MaterializeSequence(const tensorflow::Tensor& graph_def_tensor,
-                                 v0::Value::Sequence* sequence_value_pb) {
+// Converts the tensors of `elements` to the arrays of `chunk_pb`, in parallel.
+absl::Status ConvertSequenceChunk(
+    absl::Span<const std::vector<tensorflow::Tensor>> elements,
+    v0::Value::Sequence& chunk_pb) {
+  chunk_pb.mutable_element()->Reserve(elements.size());
+  for (const std::vector<tensorflow::Tensor>& tensors : elements) {
+    chunk_pb.add_element()->mutable_flat_value()->Reserve(tensors.size());
+  }
+  // NOTE: this may run on a task of the executor's own pool, so the
+  // conversions are scheduled on the process-wide pool, which grows rather
+  // than deadlocking when all of its threads are waiting.
+  ParallelTasks tasks;
+  for (size_t i = 0; i < elements.size(); ++i) {
+    v0::Value::Sequence::Element* element_pb = chunk_pb.mutable_element(i);
+    TFF_TRY(tasks.add_task([&tensors = elements[i], element_pb]() {
+      for (const tensorflow::Tensor& tensor : tensors) {
+        *element_pb->add_flat_value() = TFF_TRY(ArrayFromTensor(tensor));
+      }
+      return absl::OkStatus();
+    }));
+  }
+  return tasks.WaitAll();
+}
+
+// Passes the elements of `sequence` to `consume` in chunks of at most
+// `chunk_size` elements. The tensors of each chunk are converted to arrays in
+// parallel. Sequences not held in memory are read from their dataset one chunk
+// at a time, and each chunk is released before the next one is read.
+absl::Status MaterializeSequenceInChunks(
+    const Sequence& sequence, int32_t chunk_size,
+    absl::FunctionRef<absl::Status(v0::Value::Sequence)> consume) {
+  if (chunk_size <= 0) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Chunk size must be positive, found ", chunk_size));
+  }
+  if (const Sequence::Elements* elements = sequence.elements()) {
+    absl::Span<const std::vector<tensorflow::Tensor>> remaining(*elements);
+    while (!remaining.empty()) {
+      v0::Value::Sequence chunk_pb;
+      TFF_TRY(ConvertSequenceChunk(remaining.subspan(0, chunk_size), chunk_pb));
+      remaining.remove_prefix(std::min<size_t>(chunk_size, remaining.size()));
+      TFF_TRY(consume(std::move(chunk_pb)));
+    }
+    return absl::OkStatus();
+  }
+
+  const tensorflow::Tensor graph_def_tensor =
+      TFF_TRY(sequence.graph_def_tensor());
   std::unique_ptr<tensorflow::data::standalone::Dataset> dataset =
       TFF_TRY(DatasetFromGraphDefTensor(graph_def_tensor));
   std::unique_ptr<tensorflow::data::standalone::Iterator> iterator;
@@ -768,77 +1413,123 @@ absl::Status MaterializeSequence(const tensorflow::Tensor& graph_def_tensor,
         "Error creating iterator from dataset: ", iter_status.message()));
   }
 
-  std::vector<tensorflow::Tensor> tensors;
+  Sequence::Elements chunk;
+  chunk.reserve(chunk_size);
   bool end_of_input = false;
-  while (true) {
-    auto status = iterator->GetNext(&tensors, &end_of_input);
-    if (!status.ok()) {
-      return absl::InternalError(absl::StrCat(
-          "Error getting the next element from dataset: ", status.message()));
+  while (!end_of_input) {
+    chunk.clear();
+    while (static_cast<int32_t>(chunk.size()) < chunk_size) {
+      std::vector<tensorflow::Tensor> tensors;
+      auto status = iterator->GetNext(&tensors, &end_of_input);
+      if (!status.ok()) {
+        return absl::InternalError(absl::StrCat(
+            "Error getting the next element from dataset: ", status.message()));
+      }
+      if (end_of_input) {
+        break;
+      }
+      chunk.push_back(std::move(tensors));
     }
-    if (end_of_input) {
+    if (chunk.empty()) {
       break;
     }
-
-    v0::Value::Sequence::Element* element_pb = sequence_value_pb->add_element();
-    for (const tensorflow::Tensor& tensor : tensors) {
-      element_pb->mutable_flat_value()->Add(TFF_TRY(ArrayFromTensor(tensor)));
-    }
+    v0::Value::Sequence chunk_pb;
+    TFF_TRY(ConvertSequenceChunk(chunk, chunk_pb));
+    TFF_TRY(consume(std::move(chunk_pb)));
   }
   return absl::OkStatus();
 }
 
+absl::Status MaterializeSequence(const Sequence& sequence, int32_t chunk_size,
+                                 v0::Value::Sequence* sequence_value_pb) {
+  return MaterializeSequenceInChunks(
+      sequence, chunk_size,
+      [sequence_value_pb](v0::Value::Sequence chunk_pb) {
+        for (v0::Value::Sequence::Element& element_pb :
+             *chunk_pb.mutable_element()) {
+          *sequence_value_pb->add_element() = std::move(element_pb);
+        }
+        return absl::OkStatus();
+      });
+}
+
 class TensorFlowExecutor : public ExecutorBase<ValueFuture> {
  public:
-  // Setting max_concurrent_computation_calls to a positive value limits the
-  // concurrent invocations of session.run to that number. Zero or negative
-  // provides effectively unlimited concurrency.
-  explicit TensorFlowExecutor(int32_t max_concurrent_computation_calls)
-      : thread_pool_(
+  // See `TensorFlowExecutorOptions` for the meaning of each option.
+  explicit TensorFlowExecutor(TensorFlowExecutorOptions options)
+      : function_cache_(std::move(options.function_cache),
+                        [](const Computation& computation) {
+                          return computation.CacheCost();
+                        }),
+        memory_budget_(options.memory_budget != nullptr
+                           ? std::move(options.memory_budget)
+                           : MemoryBudget::Create()),
+        computation_session_threading_(
+            std::move(options.computation_session_threading)),
+        computation_session_optimization_(
+            std::move(options.computation_session_optimization)),
+        prewarm_sessions_(options.prewarm_sessions),
+        sequence_chunk_size_(std::max(options.sequence_chunk_size, 1)),
+        thread_pool_(
             // Use a threadpool with CPU * 4 or the user specified
             // maximum.
-            ((max_concurrent_computation_calls > 0)
-                 ? max_concurrent_computation_calls
+            ((options.max_concurrent_computation_calls > 0)
+                 ? options.max_concurrent_computation_calls
                  : std::thread::hardware_concurrency() * 4),
             ExecutorName()) {
+    if (options.session_budget != nullptr) {
+      computation_options_.session_budget = options.session_budget;
+    }
+    computation_options_.max_call_batch_size = options.max_call_batch_size;
+    computation_options_.threading = options.session_threading;
+    computation_options_.optimization = options.session_optimization;
     VLOG(2) << "thread pool size: "
-            << ((max_concurrent_computation_calls > 0)
-                    ? max_concurrent_computation_calls
+            << ((options.max_concurrent_computation_calls > 0)
+                    ? options.max_concurrent_computation_calls
                     : std::thread::hardware_concurrency() * 4);
   }
 
  private:
-  // A hash map of compiler generated TensorFlow function ids to already
-  // construction Computation objects.
-  absl::flat_hash_map<uint64_t, std::shared_ptr<Computation>> function_cache_
-      ABSL_GUARDED_BY(function_cache_mutex_);
-  absl::Mutex function_cache_mutex_;
+  // Compiler generated TensorFlow function ids to already constructed
+  // Computation objects.
+  FunctionCache<Computation> function_cache_;
+  std::shared_ptr<MemoryBudget> memory_budget_;
+  ComputationOptions computation_options_;
+  absl::flat_hash_map<uint64_t, SessionThreadingOptions>
+      computation_session_threading_;
+  absl::flat_hash_map<uint64_t, SessionOptimizationOptions>
+      computation_session_optimization_;
+  const int32_t prewarm_sessions_;
+  const int32_t sequence_chunk_size_;
   ThreadPool thread_pool_;
 
-  absl::StatusOr<ExecutorValue> CreateValueAny(const v0::Value& value_pb) {
+  // Consumes `value_pb`, so that the buffers of large arrays can be taken
+  // over rather than copied.
+  absl::StatusOr<ExecutorValue> CreateValueAny(v0::Value&& value_pb) {
     switch (value_pb.value_case()) {
       case v0::Value::kArray:
-        return CreateValueArray(value_pb);
+        return ExecutorValue(
+            TFF_TRY(DeserializeTensorValue(std::move(value_pb))));
       case v0::Value::kComputation:
         return CreateValueComputation(value_pb.computation());
       case v0::Value::kStruct:
-        return CreateValueStruct(value_pb.struct_());
+        return CreateValueStruct(std::move(*value_pb.mutable_struct_()));
       case v0::Value::kSequence:
-        return CreateValueSequence(value_pb.sequence());
+        return CreateValueSequence(std::move(*value_pb.mutable_sequence()));
       default:
         return absl::UnimplementedError(
             absl::StrCat("Unknown value proto type ", value_pb.value_case()));
     }
   }
 
-  absl::StatusOr<ExecutorValue> CreateValueArray(const v0::Value& value_pb) {
-    tensorflow::Tensor tensor;
-    if (value_pb.array().has_content()) {
-      tensor = TFF_TRY(TensorFromArrayContent(value_pb.array()));
-    } else {
-      tensor = TFF_TRY(TensorFromArray(value_pb.array()));
+  // Consumes `array_pb`, so that its content can be taken over rather than
+  // copied.
+  static absl::StatusOr<tensorflow::Tensor> TensorFromArrayProto(
+      federated_language::Array&& array_pb) {
+    if (array_pb.has_content()) {
+      return TensorFromArrayContent(std::move(array_pb));
     }
-    return ExecutorValue(std::move(tensor));
+    return TensorFromArray(array_pb);
   }
 
   absl::StatusOr<ExecutorValue> CreateValueComputation(
@@ -852,33 +1543,44 @@ class TensorFlowExecutor : public ExecutorBase<ValueFuture> {
           LOG_FIRST_N(WARNING, 10)
               << "Skipped caching computation, no cache_key:\n"
               << comp_pb.type().Utf8DebugString();
+          // Calls of uncached computations are not batched, since each is
+          // usually called only once.
+          ComputationOptions options = computation_options_;
+          options.max_call_batch_size = 1;
           return ExecutorValue(
-              TFF_TRY(Computation::FromProto(comp_pb.tensorflow())));
+              TFF_TRY(Computation::FromProto(comp_pb.tensorflow(), options)));
         }
         const uint64_t function_id = comp_pb.tensorflow().cache_key().id();
-        // Try the fast path first, reader locks are much cheaper.
-        {
-          absl::ReaderMutexLock reader_lock(&function_cache_mutex_);
-          auto cache_iter = function_cache_.find(function_id);
-          if (cache_iter != function_cache_.end()) {
-            VLOG(2) << "Cache hit for function id: " << function_id;
-            return ExecutorValue(cache_iter->second);
-          }
+        std::shared_ptr<Computation> computation =
+            function_cache_.Get(function_id);
+        if (computation != nullptr) {
+          VLOG(2) << "Cache hit for function id: " << function_id;
+          return ExecutorValue(std::move(computation));
         }
         // Otherwise build the cached value and insert it into the cache.
         VLOG(2) << "Cache MISS for function id: " << function_id;
-        std::shared_ptr<Computation> computation =
-            TFF_TRY(Computation::FromProto(comp_pb.tensorflow()));
-        {
-          absl::WriterMutexLock writer_lock(&function_cache_mutex_);
-          auto result = function_cache_.try_emplace(function_id, computation);
-          if (!result.second) {
-            // Another thread beat us to creating the cache value. We end up
-            // throwing away our value here, but this is fine because its cheap.
-            computation = result.first->second;
-          }
+        // If another thread beat us to creating the cache value, we end up
+        // throwing away our value here, but this is fine because its cheap.
+        ComputationOptions options = computation_options_;
+        auto threading = computation_session_threading_.find(function_id);
+        if (threading != computation_session_threading_.end()) {
+          options.threading = threading->second;
+        }
+        auto optimization = computation_session_optimization_.find(function_id);
+        if (optimization != computation_session_optimization_.end()) {
+          options.optimization = optimization->second;
         }
-        return ExecutorValue(computation);
+        computation = function_cache_.Insert(
+            function_id,
+            TFF_TRY(Computation::FromProto(comp_pb.tensorflow(), options)));
+        if (prewarm_sessions_ > 0) {
+          ThreadRun(
+              [computation, num_sessions = prewarm_sessions_]() {
+                computation->Prewarm(num_sessions);
+              },
+              &thread_pool_);
+        }
+        return ExecutorValue(std::move(computation));
       }
       case federated_language::Computation::kLiteral: {
         const tensorflow::Tensor tensor =
@@ -900,20 +1602,40 @@ class TensorFlowExecutor : public ExecutorBase<ValueFuture> {
   }
 
   absl::StatusOr<ExecutorValue> CreateValueStruct(
-      const v0::Value::Struct& struct_pb) {
+      v0::Value::Struct&& struct_pb) {
     auto elements = std::make_shared<std::vector<ExecutorValue>>();
     elements->reserve(struct_pb.element_size());
-    for (const v0::Value::Struct::Element& element_pb : struct_pb.element()) {
-      elements->push_back(TFF_TRY(CreateValueAny(element_pb.value())));
+    for (v0::Value::Struct::Element& element_pb :
+         *struct_pb.mutable_element()) {
+      elements->push_back(
+          TFF_TRY(CreateValueAny(std::move(*element_pb.mutable_value()))));
     }
     return ExecutorValue(std::move(elements));
   }
 
+  // Keeps the elements in memory; the sequence is only serialized into a
+  // dataset if it is passed to a computation.
   absl::StatusOr<ExecutorValue> CreateValueSequence(
-      const v0::Value::Sequence& sequence_pb) const {
-    tensorflow::Tensor tensor =
-        TFF_TRY(GraphDefTensorFromSequence(sequence_pb));
-    return ExecutorValue(SequenceTensor(std::move(tensor)));
+      v0::Value::Sequence&& sequence_pb) const {
+    // A dataset cannot be built from zero elements, so an empty sequence
+    // could never be bound to a computation.
+    if (sequence_pb.element_size() == 0) {
+      return absl::InvalidArgumentError(
+          "Cannot create a sequence value with zero elements.");
+    }
+    Sequence::Elements elements;
+    elements.reserve(sequence_pb.element_size());
+    for (v0::Value::Sequence::Element& element_pb :
+         *sequence_pb.mutable_element()) {
+      std::vector<tensorflow::Tensor>& tensors = elements.emplace_back();
+      tensors.reserve(element_pb.flat_value_size());
+      for (federated_language::Array& array_pb :
+           *element_pb.mutable_flat_value()) {
+        tensors.push_back(TFF_TRY(TensorFromArrayProto(std::move(array_pb))));
+      }
+    }
+    TFF_TRY(CheckTensorStructures(elements));
+    return ExecutorValue(Sequence::FromElements(std::move(elements)));
   }
 
   // NOTE: `value` reference must be valid until `tasks.WaitAll` is called.
@@ -927,8 +1649,8 @@ class TensorFlowExecutor : public ExecutorBase<ValueFuture> {
         });
       }
       case ExecutorValue::ValueType::SEQUENCE: {
-        return tasks.add_task([&value, value_pb]() {
-          return MaterializeSequence(value.sequence(),
+        return tasks.add_task([this, &value, value_pb]() {
+          return MaterializeSequence(value.sequence(), sequence_chunk_size_,
                                      value_pb->mutable_sequence());
         });
       }
@@ -960,27 +1682,43 @@ class TensorFlowExecutor : public ExecutorBase<ValueFuture> {
 
   absl::StatusOr<ValueFuture> CreateExecutorValue(
       const v0::Value& value_pb) final {
-    return ThreadRun(
-        [value_pb, this]() -> absl::StatusOr<ExecutorValue> {
-          return TFF_TRY(CreateValueAny(value_pb));
+    return ThreadRunCancellable(
+        [value_pb, this](const CancellationToken&) mutable
+            -> absl::StatusOr<ExecutorValue> {
+          ExecutorValue value = TFF_TRY(CreateValueAny(std::move(value_pb)));
+          value.ChargeTo(*memory_budget_);
+          return value;
         },
         &thread_pool_);
   }
 
   absl::StatusOr<ValueFuture> CreateCall(
       ValueFuture function, std::optional<ValueFuture> argument) final {
-    return ThreadRun(
-        [function = std::move(function),
-         argument = std::move(argument)]() -> absl::StatusOr<ExecutorValue> {
+    return ThreadRunCancellable(
+        [function = std::move(function), argument = std::move(argument),
+         memory_budget = memory_budget_](
+            const CancellationToken& cancellation)
+            -> absl::StatusOr<ExecutorValue> {
           ExecutorValue fn = TFF_TRY(Wait(function));
           std::optional<ExecutorValue> arg = std::nullopt;
           if (argument.has_value()) {
             arg = TFF_TRY(Wait(argument.value()));
           }
+          {
+            // Waits for other calls to release their results.
+            ScopedBlockingRegion blocking;
+            memory_budget->WaitForCapacity();
+          }
           if (fn.type() == ExecutorValue::ValueType::COMPUTATION) {
-            return fn.computation()->Call(std::move(arg));
+            ExecutorValue result = TFF_TRY(
+                fn.computation()->Call(std::move(arg), cancellation));
+            result.ChargeTo(*memory_budget);
+            return result;
           } else if (fn.type() == ExecutorValue::ValueType::INTRINSIC) {
-            return CallIntrinsic(fn.intrinsic(), std::move(arg));
+            ExecutorValue result =
+                TFF_TRY(CallIntrinsic(fn.intrinsic(), std::move(arg)));
+            result.ChargeTo(*memory_budget);
+            return result;
           } else {
             return absl::InvalidArgumentError(absl::StrCat(
                 "Expected `function` argument to "
@@ -1006,7 +1744,8 @@ class TensorFlowExecutor : public ExecutorBase<ValueFuture> {
                                               const uint32_t index) final {
     return Map(
         std::vector<ValueFuture>({value}),
-        [index](std::vector<ExecutorValue>&& values)
+        [index, memory_budget = memory_budget_](
+            std::vector<ExecutorValue>&& values)
             -> absl::StatusOr<ExecutorValue> {
           ExecutorValue& value = values[0];
           if (value.type() != ExecutorValue::ValueType::STRUCT) {
@@ -1018,7 +1757,9 @@ class TensorFlowExecutor : public ExecutorBase<ValueFuture> {
                 absl::StrCat("Attempted to access index ", index, " of a ",
                              value.elements().size(), "-length struct.")));
           }
-          return ExecutorValue(value.elements()[index]);
+          ExecutorValue selection(value.elements()[index]);
+          selection.ChargeTo(*memory_budget);
+          return selection;
         },
         &thread_pool_);
   }
@@ -1029,13 +1770,32 @@ class TensorFlowExecutor : public ExecutorBase<ValueFuture> {
     TFF_TRY(tasks.WaitAll());
     return absl::OkStatus();
   }
+  absl::Status MaterializeSequenceChunks(
+      ValueFuture value_fut, int32_t chunk_size,
+      absl::FunctionRef<absl::Status(v0::Value::Sequence)> consume) final {
+    ExecutorValue value = TFF_TRY(Wait(std::move(value_fut)));
+    if (value.type() != ExecutorValue::ValueType::SEQUENCE) {
+      return absl::InvalidArgumentError(
+          "Cannot materialize a non-sequence value in chunks");
+    }
+    return MaterializeSequenceInChunks(value.sequence(), chunk_size, consume);
+  }
 };
 
 }  // namespace
 
 std::shared_ptr<Executor> CreateTensorFlowExecutor(
-    int32_t max_concurrent_computation_calls) {
-  return std::make_shared<TensorFlowExecutor>(max_concurrent_computation_calls);
+    int32_t max_concurrent_computation_calls,
+    std::shared_ptr<MemoryBudget> memory_budget) {
+  TensorFlowExecutorOptions options;
+  options.max_concurrent_computation_calls = max_concurrent_computation_calls;
+  options.memory_budget = std::move(memory_budget);
+  return CreateTensorFlowExecutor(std::move(options));
+}
+
+std::shared_ptr<Executor> CreateTensorFlowExecutor(
+    TensorFlowExecutorOptions options) {
+  return std::make_shared<TensorFlowExecutor>(std::move(options));
 }
 
 }  // namespace tensorflow_federated
@@ -19,16 +19,74 @@ limitations under the License
 #include <cstdint>
 #include <memory>
 
+#include "absl/container/flat_hash_map.h"
+
 #include "tensorflow_federated/cc/core/impl/executors/executor.h"
+#include "tensorflow_federated/cc/core/impl/executors/function_cache.h"
+#include "tensorflow_federated/cc/core/impl/executors/memory_budget.h"
+#include "tensorflow_federated/cc/core/impl/executors/session_budget.h"
+#include "tensorflow_federated/cc/core/impl/executors/session_provider.h"
 
 namespace tensorflow_federated {
 
+struct TensorFlowExecutorOptions {
+  // Limits the number of TensorFlow sessions executing in parallel;
+  // non-positive values indicate no max.
+  int32_t max_concurrent_computation_calls = -1;
+  // The bytes of the tensors held by the executor's values are charged to this
+  // budget, and calls are delayed while it is over its high-water mark. If not
+  // set, the executor accounts its memory in a budget without a high-water
+  // mark.
+  std::shared_ptr<MemoryBudget> memory_budget;
+  // Bounds the cache of computations by `cache_key`. Each cached computation
+  // holds its graph and the sessions created to run it. Unbounded by default.
+  // Computations are pinned by `cache_key` through `function_cache.pinned_keys`
+  // when the executor is created, or at any time through a `FunctionCachePins`
+  // passed in `function_cache.pins`.
+  FunctionCacheOptions function_cache;
+  // Caps the live sessions of all computations. If not set, sessions count
+  // against the process-wide `SessionBudget::Global()`.
+  SessionBudget* session_budget = nullptr;
+  // Number of sessions created in the background for each newly cached
+  // computation, so that its first calls do not pay for session creation.
+  // Prewarming never waits for the session budget.
+  int32_t prewarm_sessions = 0;
+  // Maximum number of concurrent calls of the same cached computation that
+  // are run together in a single session run, over a graph holding one copy
+  // of the computation per call. Calls are only queued for a batch while
+  // other calls of the computation are running, so a lone call is never
+  // delayed. Computations with stateful ops or an initialize op are never
+  // batched. Values of one or less disable batching.
+  int32_t max_call_batch_size = 1;
+  // How the sessions of all computations schedule their ops on threads. By
+  // default, sessions share TensorFlow's global inter-op pool.
+  SessionThreadingOptions session_threading;
+  // Overrides `session_threading` for the computations with these cache keys,
+  // e.g. to give a large model its own inter-op pool.
+  absl::flat_hash_map<uint64_t, SessionThreadingOptions>
+      computation_session_threading;
+  // Graph optimizations (Grappler, XLA JIT) for the sessions of all
+  // computations. Off by default.
+  SessionOptimizationOptions session_optimization;
+  // Overrides `session_optimization` for the computations with these cache
+  // keys, e.g. to compile a client update called thousands of times per round.
+  absl::flat_hash_map<uint64_t, SessionOptimizationOptions>
+      computation_session_optimization;
+  // Number of elements read from a dataset and converted in parallel at a time
+  // when materializing a sequence. Each chunk is released before the next one
+  // is read when the sequence is consumed with `MaterializeSequenceChunks`.
+  int32_t sequence_chunk_size = 64;
+};
+
 // Returns an executor that can resolve TensorFlow computations and structures
-// of tensors. `max_concurrent_computation_calls` can be used to limit the
-// maximum number of TensorFlow sessions executing in parallel; non-positive
-// values indicate no max.
+// of tensors.
+std::shared_ptr<Executor> CreateTensorFlowExecutor(
+    TensorFlowExecutorOptions options);
+
+// As above, with the remaining options left at their defaults.
 std::shared_ptr<Executor> CreateTensorFlowExecutor(
-    int32_t max_concurrent_computation_calls = -1);
+    int32_t max_concurrent_computation_calls = -1,
+    std::shared_ptr<MemoryBudget> memory_budget = nullptr);
 
 }  // namespace tensorflow_federated
 
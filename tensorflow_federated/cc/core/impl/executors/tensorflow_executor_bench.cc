@@ -0,0 +1,196 @@
+/* Copyright 2026, The TensorFlow Federated Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+     http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License
+==============================================================================*/
+
+// Benchmarks of `TensorFlowExecutor` running many calls of one computation,
+// the pattern of a `federated_map` over many clients, under each session
+// threading and graph optimization configuration.
+
+#include <cstdint>
+#include <memory>
+#include <thread>  // NOLINT
+#include <utility>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "absl/log/check.h"
+#include "absl/status/status.h"
+#include "tensorflow/cc/framework/scope.h"
+#include "tensorflow/cc/ops/array_ops.h"
+#include "tensorflow/cc/ops/math_ops.h"
+#include "tensorflow/core/framework/graph.pb.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/framework/types.pb.h"
+#include "federated_language/proto/computation.pb.h"
+#include "tensorflow_federated/cc/core/impl/executors/executor.h"
+#include "tensorflow_federated/cc/core/impl/executors/session_provider.h"
+#include "tensorflow_federated/cc/core/impl/executors/tensorflow_executor.h"
+#include "tensorflow_federated/cc/core/impl/executors/tensorflow_test_utils.h"
+#include "tensorflow_federated/proto/v0/executor.pb.h"
+
+namespace tensorflow_federated {
+namespace {
+
+using ::tensorflow_federated::testing::TensorV;
+
+enum ThreadingConfig {
+  // Sessions share TensorFlow's default global inter-op pool.
+  kDefault = 0,
+  // Each session creates its own inter-op pool.
+  kPerSession = 1,
+  // Sessions share a named inter-op pool with one thread per core, and ops
+  // run single-threaded.
+  kSharedPool = 2,
+};
+
+SessionThreadingOptions GetThreadingOptions(ThreadingConfig config) {
+  SessionThreadingOptions threading;
+  switch (config) {
+    case kDefault:
+      break;
+    case kPerSession:
+      threading.use_per_session_threads = true;
+      break;
+    case kSharedPool:
+      threading.inter_op_pool_name = "tensorflow_executor_bench";
+      threading.inter_op_threads = std::thread::hardware_concurrency();
+      threading.intra_op_threads = 1;
+      break;
+  }
+  return threading;
+}
+
+// A cached computation multiplying a square float matrix by itself.
+v0::Value MatMulComputationV() {
+  tensorflow::Scope root = tensorflow::Scope::NewRootScope();
+  tensorflow::ops::Placeholder x(root, tensorflow::DT_FLOAT);
+  tensorflow::ops::MatMul out(root, x, x);
+  tensorflow::GraphDef graphdef_pb;
+  absl::Status status = root.ToGraphDef(&graphdef_pb);
+  CHECK(status.ok()) << status;
+  v0::Value value_pb;
+  federated_language::TensorFlow* tensorflow_pb =
+      value_pb.mutable_computation()->mutable_tensorflow();
+  tensorflow_pb->mutable_graph_def()->PackFrom(graphdef_pb);
+  tensorflow_pb->mutable_parameter()->mutable_tensor()->set_tensor_name(
+      x.node()->name());
+  tensorflow_pb->mutable_result()->mutable_tensor()->set_tensor_name(
+      out.node()->name());
+  tensorflow_pb->mutable_cache_key()->set_id(1);
+  return value_pb;
+}
+
+// Runs 256 concurrent calls per iteration. Arguments are the threading
+// configuration and the matrix size.
+void BM_ConcurrentCalls(benchmark::State& state) {
+  constexpr int32_t kNumCalls = 256;
+  const int64_t size = state.range(1);
+  TensorFlowExecutorOptions options;
+  options.session_threading =
+      GetThreadingOptions(static_cast<ThreadingConfig>(state.range(0)));
+  std::shared_ptr<Executor> executor = CreateTensorFlowExecutor(options);
+  OwnedValueId fn = executor->CreateValue(MatMulComputationV()).value();
+  tensorflow::Tensor matrix(tensorflow::DT_FLOAT,
+                            tensorflow::TensorShape({size, size}));
+  matrix.flat<float>().setConstant(1.0f);
+  OwnedValueId arg = executor->CreateValue(TensorV(matrix)).value();
+  for (auto s : state) {
+    std::vector<OwnedValueId> results;
+    results.reserve(kNumCalls);
+    for (int32_t i = 0; i < kNumCalls; ++i) {
+      results.push_back(executor->CreateCall(fn, arg).value());
+    }
+    for (const OwnedValueId& result : results) {
+      CHECK(executor->Materialize(result).ok());
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kNumCalls);
+}
+
+BENCHMARK(BM_ConcurrentCalls)
+    ->ArgsProduct({{kDefault, kPerSession, kSharedPool}, {16, 256}})
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+enum OptimizationConfig {
+  kNone = 0,
+  kGrappler = 1,
+  kXlaJit = 2,
+  kGrapplerAndXlaJit = 3,
+};
+
+SessionOptimizationOptions GetOptimizationOptions(OptimizationConfig config) {
+  SessionOptimizationOptions optimization;
+  optimization.enable_grappler = (config & kGrappler) != 0;
+  optimization.enable_xla_jit = (config & kXlaJit) != 0;
+  return optimization;
+}
+
+// A cached computation of a dense layer with a residual connection,
+// `tanh(x * x + x) * x`, over a square float matrix. Its elementwise ops are
+// candidates for fusion.
+v0::Value DenseLayerComputationV() {
+  tensorflow::Scope root = tensorflow::Scope::NewRootScope();
+  tensorflow::ops::Placeholder x(root, tensorflow::DT_FLOAT);
+  tensorflow::ops::MatMul product(root, x, x);
+  tensorflow::ops::AddV2 residual(root, product, x);
+  tensorflow::ops::Tanh activation(root, residual);
+  tensorflow::ops::Mul out(root, activation, x);
+  tensorflow::GraphDef graphdef_pb;
+  absl::Status status = root.ToGraphDef(&graphdef_pb);
+  CHECK(status.ok()) << status;
+  v0::Value value_pb;
+  federated_language::TensorFlow* tensorflow_pb =
+      value_pb.mutable_computation()->mutable_tensorflow();
+  tensorflow_pb->mutable_graph_def()->PackFrom(graphdef_pb);
+  tensorflow_pb->mutable_parameter()->mutable_tensor()->set_tensor_name(
+      x.node()->name());
+  tensorflow_pb->mutable_result()->mutable_tensor()->set_tensor_name(
+      out.node()->name());
+  tensorflow_pb->mutable_cache_key()->set_id(1);
+  return value_pb;
+}
+
+// Measures the latency of one call once sessions are optimized: a first call
+// outside of the timed loop pays for optimization and compilation. Arguments
+// are the optimization configuration and the matrix size.
+void BM_OptimizedCallLatency(benchmark::State& state) {
+  const int64_t size = state.range(1);
+  TensorFlowExecutorOptions options;
+  options.session_optimization =
+      GetOptimizationOptions(static_cast<OptimizationConfig>(state.range(0)));
+  std::shared_ptr<Executor> executor = CreateTensorFlowExecutor(options);
+  OwnedValueId fn = executor->CreateValue(DenseLayerComputationV()).value();
+  tensorflow::Tensor matrix(tensorflow::DT_FLOAT,
+                            tensorflow::TensorShape({size, size}));
+  matrix.flat<float>().setConstant(1.0f / size);
+  OwnedValueId arg = executor->CreateValue(TensorV(matrix)).value();
+  CHECK(executor->Materialize(executor->CreateCall(fn, arg).value()).ok());
+  for (auto s : state) {
+    CHECK(executor->Materialize(executor->CreateCall(fn, arg).value()).ok());
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_OptimizedCallLatency)
+    ->ArgsProduct({{kNone, kGrappler, kXlaJit, kGrapplerAndXlaJit}, {16, 256}})
+    ->UseRealTime()
+    ->Unit(benchmark::kMicrosecond);
+
+}  // namespace
+}  // namespace tensorflow_federated
+
+// Run the benchmark
+BENCHMARK_MAIN();
@@ -17,6 +17,7 @@ limitations under the License
 
 #include <cstdint>
 #include <future>  // NOLINT
+#include <limits>
 #include <memory>
 #include <optional>
 #include <string>
@@ -28,6 +29,8 @@ limitations under the License
 #include "absl/log/check.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
 #include "absl/types/span.h"
 #include "google/protobuf/io/zero_copy_stream_impl.h"
 #include "federated_language/proto/array.pb.h"
@@ -42,13 +45,18 @@ limitations under the License
 #include "tensorflow/cc/ops/const_op.h"
 #include "tensorflow/cc/ops/math_ops.h"
 #include "tensorflow/cc/ops/resource_variable_ops.h"
+#include "tensorflow/cc/ops/while_loop.h"
 #include "tensorflow/core/framework/graph.pb.h"
 #include "tensorflow/core/framework/tensor_shape.h"
 #include "tensorflow/core/framework/types.pb.h"
 #include "tensorflow/core/graph/graph.h"
 #include "tensorflow_federated/cc/core/impl/executors/array_shape_test_utils.h"
 #include "tensorflow_federated/cc/core/impl/executors/array_test_utils.h"
+#include "tensorflow_federated/cc/core/impl/executors/eager_tensorflow_executor.h"
 #include "tensorflow_federated/cc/core/impl/executors/executor.h"
+#include "tensorflow_federated/cc/core/impl/executors/function_cache.h"
+#include "tensorflow_federated/cc/core/impl/executors/memory_budget.h"
+#include "tensorflow_federated/cc/core/impl/executors/session_budget.h"
 #include "tensorflow_federated/cc/core/impl/executors/status_macros.h"
 #include "tensorflow_federated/cc/core/impl/executors/tensorflow_executor.h"
 #include "tensorflow_federated/cc/core/impl/executors/tensorflow_test_utils.h"
@@ -101,6 +109,7 @@ inline federated_language::TensorFlow::Binding StructB(
 
 // Placeholder Classes for parameterized testing
 class TensorflowExecutor {};
+class EagerTensorflowExecutor {};
 
 template <class T>
 std::shared_ptr<Executor> CreateExecutor(TFE_Context* context);
@@ -111,8 +120,15 @@ std::shared_ptr<Executor> CreateExecutor<TensorflowExecutor>(
   return CreateTensorFlowExecutor(/*max_concurrent_computation_calls=*/10);
 }
 
+template <>
+std::shared_ptr<Executor> CreateExecutor<EagerTensorflowExecutor>(
+    TFE_Context* context) {
+  return CreateEagerTensorFlowExecutor(
+      /*max_concurrent_computation_calls=*/10, context);
+}
+
 // Enum for Parameterized typed tests.
-enum ExecutorId { kTensorFlowExecutor };
+enum ExecutorId { kTensorFlowExecutor, kEagerTensorFlowExecutor };
 
 template <class T>
 ExecutorId ExecutorType() {}
@@ -121,6 +137,11 @@ template <>
 ExecutorId ExecutorType<TensorflowExecutor>() {
   return kTensorFlowExecutor;
 }
+
+template <>
+ExecutorId ExecutorType<EagerTensorflowExecutor>() {
+  return kEagerTensorFlowExecutor;
+}
 inline v0::Value ComputationV(
     std::optional<federated_language::TensorFlow::Binding> in_binding,
     federated_language::TensorFlow::Binding out_binding,
@@ -157,7 +178,11 @@ class TensorFlowBasedExecutorsTest : public ::testing::Test {
     test_executor_ = CreateExecutor<T>(context_);
   }
 
-  ~TensorFlowBasedExecutorsTest() override { TFE_DeleteContext(context_); }
+  ~TensorFlowBasedExecutorsTest() override {
+    // The executor's tensor handles must be deleted before the context.
+    test_executor_.reset();
+    TFE_DeleteContext(context_);
+  }
 
   std::shared_ptr<Executor> test_executor_;
   TFE_Context* context_;
@@ -242,7 +267,7 @@ class TensorFlowBasedExecutorsTest : public ::testing::Test {
   }
 };
 
-typedef Types<TensorflowExecutor> Implementations;
+typedef Types<TensorflowExecutor, EagerTensorflowExecutor> Implementations;
 
 TYPED_TEST_SUITE(TensorFlowBasedExecutorsTest, Implementations);
 
@@ -297,6 +322,9 @@ v0::Value CreateDatasetReduceComputationV() {
 }
 
 TYPED_TEST(TensorFlowBasedExecutorsTest, CallReduceOnSequence) {
+  if (this->Type() == kEagerTensorFlowExecutor) {
+    GTEST_SKIP() << "Sequences are not supported by the eager executor.";
+  }
   int64_t start = 0;
   int64_t stop = 10;
   int64_t step = 2;
@@ -307,6 +335,34 @@ TYPED_TEST(TensorFlowBasedExecutorsTest, CallReduceOnSequence) {
                              TensorV(expected_sum));
 }
 
+TYPED_TEST(TensorFlowBasedExecutorsTest,
+           UncachedComputationsAreRemovedFromEagerContext) {
+  if (this->Type() != kEagerTensorFlowExecutor) {
+    GTEST_SKIP() << "Only the eager executor registers functions with a "
+                    "context.";
+  }
+  auto num_functions = [this]() {
+    return tensorflow::unwrap(this->context_)->ListFunctionNames().size();
+  };
+  const size_t num_functions_before = num_functions();
+  tensorflow::Scope root = tensorflow::Scope::NewRootScope();
+  tensorflow::ops::Placeholder x(root, tensorflow::DT_INT32);
+  tensorflow::ops::Placeholder y(root, tensorflow::DT_INT32);
+  tensorflow::ops::AddV2 out(root, x, y);
+  // Without a cache key, each value registers its own function.
+  v0::Value add_fn =
+      ComputationV(StructB({TensorB(x), TensorB(y)}), TensorB(out), root);
+  this->CheckCallEqualsProto(add_fn, StructV({TensorV(1), TensorV(2)}),
+                             TensorV(3));
+  // The function is removed once the last reference to it, which pending
+  // tasks may briefly hold, is dropped.
+  const absl::Time deadline = absl::Now() + absl::Seconds(30);
+  while (num_functions() != num_functions_before && absl::Now() < deadline) {
+    absl::SleepFor(absl::Milliseconds(10));
+  }
+  EXPECT_EQ(num_functions(), num_functions_before);
+}
+
 TYPED_TEST(TensorFlowBasedExecutorsTest, RoundTripEmptyStruct) {
   v0::Value input_pb;
   input_pb.mutable_struct_();
@@ -333,6 +389,9 @@ TYPED_TEST(TensorFlowBasedExecutorsTest, RoundTripStructOfNestedTensors) {
 }
 
 TYPED_TEST(TensorFlowBasedExecutorsTest, RoundTripSequence) {
+  if (this->Type() == kEagerTensorFlowExecutor) {
+    GTEST_SKIP() << "Sequences are not supported by the eager executor.";
+  }
   v0::Value value_pb = SequenceV(0, 2, 1);
   // We can't simply `this->CheckRoundTrip` because the serialized graph defs
   // don't have deterministic node orders.
@@ -348,6 +407,83 @@ TYPED_TEST(TensorFlowBasedExecutorsTest, RoundTripSequence) {
                              EqualsProto(value_pb)));
 }
 
+TYPED_TEST(TensorFlowBasedExecutorsTest, CreateValueEmptySequenceFails) {
+  if (this->Type() == kEagerTensorFlowExecutor) {
+    GTEST_SKIP() << "Sequences are not supported by the eager executor.";
+  }
+  TFF_ASSERT_OK_AND_ASSIGN(
+      OwnedValueId id,
+      this->test_executor_->CreateValue(SequenceV(0, 0, 1)));
+  v0::Value output_pb;
+  EXPECT_THAT(this->test_executor_->Materialize(id, &output_pb),
+              StatusIs(StatusCode::kInvalidArgument,
+                       HasSubstr("zero elements")));
+}
+
+TYPED_TEST(TensorFlowBasedExecutorsTest,
+           CreateValueSequenceFailsOnMismatchedElements) {
+  if (this->Type() == kEagerTensorFlowExecutor) {
+    GTEST_SKIP() << "Sequences are not supported by the eager executor.";
+  }
+  TFF_ASSERT_OK_AND_ASSIGN(
+      OwnedValueId id,
+      this->test_executor_->CreateValue(SequenceV({{1}, {2, 3}})));
+  v0::Value output_pb;
+  EXPECT_THAT(this->test_executor_->Materialize(id, &output_pb),
+              StatusIs(StatusCode::kInvalidArgument));
+}
+
+TYPED_TEST(TensorFlowBasedExecutorsTest, MaterializeSequenceChunks) {
+  if (this->Type() == kEagerTensorFlowExecutor) {
+    GTEST_SKIP() << "Sequences are not supported by the eager executor.";
+  }
+  v0::Value value_pb = SequenceV(0, 5, 1);
+  TFF_ASSERT_OK_AND_ASSIGN(OwnedValueId id,
+                           this->test_executor_->CreateValue(value_pb));
+  std::vector<int> chunk_sizes;
+  v0::Value output_pb;
+  EXPECT_THAT(this->test_executor_->MaterializeSequenceChunks(
+                  id, /*chunk_size=*/2,
+                  [&](v0::Value::Sequence chunk_pb) {
+                    chunk_sizes.push_back(chunk_pb.element_size());
+                    output_pb.mutable_sequence()->MergeFrom(chunk_pb);
+                    return absl::OkStatus();
+                  }),
+              IsOk());
+  EXPECT_THAT(chunk_sizes, ::testing::ElementsAre(2, 2, 1));
+  value_pb.mutable_sequence()->mutable_element_type()->Clear();
+  EXPECT_THAT(output_pb, testing::proto::IgnoringRepeatedFieldOrdering(
+                             EqualsProto(value_pb)));
+}
+
+TYPED_TEST(TensorFlowBasedExecutorsTest,
+           MaterializeSequenceChunksStopsOnConsumerError) {
+  if (this->Type() == kEagerTensorFlowExecutor) {
+    GTEST_SKIP() << "Sequences are not supported by the eager executor.";
+  }
+  TFF_ASSERT_OK_AND_ASSIGN(
+      OwnedValueId id, this->test_executor_->CreateValue(SequenceV(0, 5, 1)));
+  int num_chunks = 0;
+  EXPECT_THAT(this->test_executor_->MaterializeSequenceChunks(
+                  id, /*chunk_size=*/2,
+                  [&](v0::Value::Sequence chunk_pb) {
+                    ++num_chunks;
+                    return absl::CancelledError("stop");
+                  }),
+              StatusIs(StatusCode::kCancelled));
+  EXPECT_EQ(num_chunks, 1);
+}
+
+TYPED_TEST(TensorFlowBasedExecutorsTest,
+           MaterializeSequenceChunksFailsOnNonSequence) {
+  TFF_ASSERT_OK_AND_ASSIGN(OwnedValueId id,
+                           this->test_executor_->CreateValue(TensorV(1)));
+  EXPECT_THAT(this->test_executor_->MaterializeSequenceChunks(
+                  id, /*chunk_size=*/2,
+                  [](v0::Value::Sequence) { return absl::OkStatus(); }),
+              StatusIs(StatusCode::kInvalidArgument));
+}
+
 TYPED_TEST(TensorFlowBasedExecutorsTest, CreateStructOneElement) {
   v0::Value input = TensorV(5);
   TFF_ASSERT_OK_AND_ASSIGN(auto value,
@@ -503,6 +639,26 @@ TYPED_TEST(TensorFlowBasedExecutorsTest, CallAdd) {
   this->CheckCallEqualsProto(fn, arg, expected);
 }
 
+TYPED_TEST(TensorFlowBasedExecutorsTest, CallFailsOnMismatchedArgument) {
+  tensorflow::Scope root = tensorflow::Scope::NewRootScope();
+  tensorflow::ops::Placeholder x(root, tensorflow::DT_INT32);
+  tensorflow::ops::Placeholder y(root, tensorflow::DT_INT32);
+  tensorflow::ops::AddV2 out(root, x, y);
+  v0::Value fn =
+      ComputationV(StructB({TensorB(x), TensorB(y)}), TensorB(out), root);
+  OwnedValueId fn_id = TFF_ASSERT_OK(this->test_executor_->CreateValue(fn));
+  for (const v0::Value& arg : {StructV({TensorV(1)}), TensorV(1),
+                               StructV({TensorV(1), StructV({})})}) {
+    OwnedValueId arg_id =
+        TFF_ASSERT_OK(this->test_executor_->CreateValue(arg));
+    OwnedValueId result_id =
+        TFF_ASSERT_OK(this->test_executor_->CreateCall(fn_id, arg_id));
+    EXPECT_THAT(this->test_executor_->Materialize(result_id),
+                StatusIs(StatusCode::kInvalidArgument,
+                         HasSubstr("Attempted to bind")));
+  }
+}
+
 TYPED_TEST(TensorFlowBasedExecutorsTest, StatefulCallGetsReinitialized) {
   tensorflow::Scope root = tensorflow::Scope::NewRootScope();
   tensorflow::TensorShape shape({});
@@ -541,6 +697,9 @@ TYPED_TEST(TensorFlowBasedExecutorsTest, CallWithComputationId) {
 
 TYPED_TEST(TensorFlowBasedExecutorsTest,
            CallArgsIntoSequenceRequiresAtLeastOneArgument) {
+  if (this->Type() == kEagerTensorFlowExecutor) {
+    GTEST_SKIP() << "Sequences are not supported by the eager executor.";
+  }
   OwnedValueId args_into_sequence =
       TFF_ASSERT_OK(this->test_executor_->CreateValue(ArgsIntoSequenceV()));
   OwnedValueId structures =
@@ -553,6 +712,9 @@ TYPED_TEST(TensorFlowBasedExecutorsTest,
 
 TYPED_TEST(TensorFlowBasedExecutorsTest,
            CallArgsIntoSequenceStructureReturnsSequence) {
+  if (this->Type() == kEagerTensorFlowExecutor) {
+    GTEST_SKIP() << "Sequences are not supported by the eager executor.";
+  }
   OwnedValueId args_into_sequence =
       TFF_ASSERT_OK(this->test_executor_->CreateValue(ArgsIntoSequenceV()));
   OwnedValueId structures =
@@ -568,6 +730,9 @@ TYPED_TEST(TensorFlowBasedExecutorsTest,
 }
 
 TYPED_TEST(TensorFlowBasedExecutorsTest, ArgsIntoSequenceReturnsReducible) {
+  if (this->Type() == kEagerTensorFlowExecutor) {
+    GTEST_SKIP() << "Sequences are not supported by the eager executor.";
+  }
   v0::Value elements_pb =
       StructV({TensorV(int64_t{1}), TensorV(int64_t{10}), TensorV(int64_t{100}),
                TensorV(int64_t{1000})});
@@ -618,5 +783,302 @@ TEST_F(TensorFlowExecutorTest, CreateValueComputationLiteralReturnsResult) {
   CheckMaterializeEqual(embedded_fn, expected_pb);
 }
 
+TEST(TensorFlowExecutorMemoryTest, ChargesTensorsToMemoryBudget) {
+  std::shared_ptr<MemoryBudget> memory_budget = MemoryBudget::Create();
+  std::shared_ptr<Executor> executor =
+      CreateTensorFlowExecutor(/*max_concurrent_computation_calls=*/10,
+                               memory_budget);
+  // Each value is a scalar int32, holding 4 bytes of tensor data.
+  OwnedValueId id = TFF_ASSERT_OK(executor->CreateValue(TensorV(1)));
+  TFF_ASSERT_OK(executor->Materialize(id));
+  EXPECT_EQ(memory_budget->used_bytes(), 4);
+  OwnedValueId source = TFF_ASSERT_OK(
+      executor->CreateValue(StructV({TensorV(2), TensorV(3)})));
+  OwnedValueId selection = TFF_ASSERT_OK(executor->CreateSelection(source, 0));
+  TFF_ASSERT_OK(executor->Materialize(selection));
+  // The struct and the selection from it are charged independently.
+  EXPECT_EQ(memory_budget->used_bytes(), 4 + 8 + 4);
+}
+
+TEST(TensorFlowExecutorMemoryTest, ChargesLoweredSequencesToMemoryBudget) {
+  std::shared_ptr<MemoryBudget> memory_budget = MemoryBudget::Create();
+  std::shared_ptr<Executor> executor =
+      CreateTensorFlowExecutor(/*max_concurrent_computation_calls=*/10,
+                               memory_budget);
+  // Five scalar int64 elements, holding 40 bytes of tensor data.
+  OwnedValueId sequence =
+      TFF_ASSERT_OK(executor->CreateValue(SequenceV(0, 10, 2)));
+  TFF_ASSERT_OK(executor->Materialize(sequence));
+  EXPECT_EQ(memory_budget->used_bytes(), 40);
+  OwnedValueId reduce =
+      TFF_ASSERT_OK(executor->CreateValue(CreateDatasetReduceComputationV()));
+  OwnedValueId result = TFF_ASSERT_OK(executor->CreateCall(reduce, sequence));
+  TFF_ASSERT_OK(executor->Materialize(result));
+  // Calling the computation lowers the sequence to a dataset GraphDef tensor,
+  // which is charged on top of the elements and the 8-byte result.
+  EXPECT_GT(memory_budget->used_bytes(), 40 + 8);
+}
+
+TEST(TensorFlowExecutorCacheTest, EvictedComputationsRemainCallable) {
+  TensorFlowExecutorOptions options;
+  // Any graph exceeds the limit, so each new computation evicts the others.
+  options.function_cache.max_bytes = 1;
+  auto stats = std::make_shared<FunctionCacheStats>();
+  options.function_cache.stats = stats;
+  std::shared_ptr<Executor> executor = CreateTensorFlowExecutor(options);
+
+  tensorflow::Scope root = tensorflow::Scope::NewRootScope();
+  tensorflow::ops::Placeholder x(root, tensorflow::DT_INT32);
+  tensorflow::ops::Placeholder y(root, tensorflow::DT_INT32);
+  tensorflow::ops::AddV2 out(root, x, y);
+  v0::Value add_fn =
+      ComputationV(StructB({TensorB(x), TensorB(y)}), TensorB(out), root);
+  add_fn.mutable_computation()
+      ->mutable_tensorflow()
+      ->mutable_cache_key()
+      ->set_id(1);
+  v0::Value other_fn = add_fn;
+  other_fn.mutable_computation()
+      ->mutable_tensorflow()
+      ->mutable_cache_key()
+      ->set_id(2);
+
+  OwnedValueId add = TFF_ASSERT_OK(executor->CreateValue(add_fn));
+  OwnedValueId other = TFF_ASSERT_OK(executor->CreateValue(other_fn));
+  EXPECT_EQ(stats->evictions.load(), 1);
+  EXPECT_EQ(stats->entries.load(), 1);
+
+  OwnedValueId arg = TFF_ASSERT_OK(
+      executor->CreateValue(StructV({TensorV(1), TensorV(2)})));
+  OwnedValueId result = TFF_ASSERT_OK(executor->CreateCall(add, arg));
+  EXPECT_THAT(TFF_ASSERT_OK(executor->Materialize(result)),
+              EqualsProto(TensorV(3)));
+}
+
+TEST(TensorFlowExecutorCacheTest, KeepsPinnedComputations) {
+  TensorFlowExecutorOptions options;
+  options.function_cache.max_bytes = 1;
+  auto pins = std::make_shared<FunctionCachePins>();
+  options.function_cache.pins = pins;
+  auto stats = std::make_shared<FunctionCacheStats>();
+  options.function_cache.stats = stats;
+  std::shared_ptr<Executor> executor = CreateTensorFlowExecutor(options);
+
+  tensorflow::Scope root = tensorflow::Scope::NewRootScope();
+  tensorflow::ops::Placeholder x(root, tensorflow::DT_INT32);
+  tensorflow::ops::Placeholder y(root, tensorflow::DT_INT32);
+  tensorflow::ops::AddV2 out(root, x, y);
+  v0::Value add_fn =
+      ComputationV(StructB({TensorB(x), TensorB(y)}), TensorB(out), root);
+  add_fn.mutable_computation()
+      ->mutable_tensorflow()
+      ->mutable_cache_key()
+      ->set_id(1);
+  v0::Value other_fn = add_fn;
+  other_fn.mutable_computation()
+      ->mutable_tensorflow()
+      ->mutable_cache_key()
+      ->set_id(2);
+
+  pins->Pin(1);
+  OwnedValueId add = TFF_ASSERT_OK(executor->CreateValue(add_fn));
+  OwnedValueId other = TFF_ASSERT_OK(executor->CreateValue(other_fn));
+  OwnedValueId add_again = TFF_ASSERT_OK(executor->CreateValue(add_fn));
+  // The pinned computation survives the insertion of another one over the
+  // limit.
+  EXPECT_EQ(stats->evictions.load(), 0);
+  EXPECT_EQ(stats->entries.load(), 2);
+  EXPECT_EQ(stats->hits.load(), 1);
+}
+
+TEST(TensorFlowExecutorSessionTest, PrewarmsCachedComputationsWithinBudget) {
+  SessionBudget session_budget(/*max_sessions=*/2);
+  TensorFlowExecutorOptions options;
+  options.session_budget = &session_budget;
+  options.prewarm_sessions = 3;
+  std::shared_ptr<Executor> executor = CreateTensorFlowExecutor(options);
+
+  tensorflow::Scope root = tensorflow::Scope::NewRootScope();
+  tensorflow::ops::Placeholder x(root, tensorflow::DT_INT32);
+  tensorflow::ops::Placeholder y(root, tensorflow::DT_INT32);
+  tensorflow::ops::AddV2 out(root, x, y);
+  v0::Value add_fn =
+      ComputationV(StructB({TensorB(x), TensorB(y)}), TensorB(out), root);
+  add_fn.mutable_computation()
+      ->mutable_tensorflow()
+      ->mutable_cache_key()
+      ->set_id(1);
+  OwnedValueId add = TFF_ASSERT_OK(executor->CreateValue(add_fn));
+  // Sessions are prewarmed in the background, up to the budget's cap.
+  const absl::Time deadline = absl::Now() + absl::Seconds(30);
+  while (session_budget.live_sessions() < 2 && absl::Now() < deadline) {
+    absl::SleepFor(absl::Milliseconds(10));
+  }
+  EXPECT_EQ(session_budget.live_sessions(), 2);
+
+  OwnedValueId arg = TFF_ASSERT_OK(
+      executor->CreateValue(StructV({TensorV(1), TensorV(2)})));
+  OwnedValueId result = TFF_ASSERT_OK(executor->CreateCall(add, arg));
+  EXPECT_THAT(TFF_ASSERT_OK(executor->Materialize(result)),
+              EqualsProto(TensorV(3)));
+  // The call ran on a prewarmed session.
+  EXPECT_EQ(session_budget.live_sessions(), 2);
+}
+
+TEST(TensorFlowExecutorSessionTest, CallsComputationsWithOptimizations) {
+  TensorFlowExecutorOptions options;
+  options.session_optimization.enable_grappler = true;
+  // The computation with cache key 2 is also compiled with XLA.
+  SessionOptimizationOptions& compiled =
+      options.computation_session_optimization[2];
+  compiled.enable_grappler = true;
+  compiled.enable_xla_jit = true;
+  std::shared_ptr<Executor> executor = CreateTensorFlowExecutor(options);
+
+  tensorflow::Scope root = tensorflow::Scope::NewRootScope();
+  tensorflow::ops::Placeholder x(root, tensorflow::DT_FLOAT);
+  tensorflow::ops::Placeholder y(root, tensorflow::DT_FLOAT);
+  tensorflow::ops::AddV2 sum(root, x, y);
+  tensorflow::ops::Mul out(root, sum, sum);
+  v0::Value fn =
+      ComputationV(StructB({TensorB(x), TensorB(y)}), TensorB(out), root);
+  OwnedValueId arg = TFF_ASSERT_OK(
+      executor->CreateValue(StructV({TensorV(1.0f), TensorV(2.0f)})));
+  for (uint64_t cache_key : {1, 2}) {
+    fn.mutable_computation()
+        ->mutable_tensorflow()
+        ->mutable_cache_key()
+        ->set_id(cache_key);
+    OwnedValueId fn_id = TFF_ASSERT_OK(executor->CreateValue(fn));
+    // Call repeatedly to run on an already optimized session.
+    for (int i = 0; i < 3; ++i) {
+      OwnedValueId result = TFF_ASSERT_OK(executor->CreateCall(fn_id, arg));
+      EXPECT_THAT(TFF_ASSERT_OK(executor->Materialize(result)),
+                  EqualsProto(TensorV(9.0f)));
+    }
+  }
+}
+
+TEST(TensorFlowExecutorBatchTest, BatchedCallsReturnTheirOwnResults) {
+  TensorFlowExecutorOptions options;
+  options.max_call_batch_size = 4;
+  std::shared_ptr<Executor> executor = CreateTensorFlowExecutor(options);
+
+  tensorflow::Scope root = tensorflow::Scope::NewRootScope();
+  tensorflow::ops::Placeholder x(root, tensorflow::DT_INT32);
+  tensorflow::ops::Placeholder y(root, tensorflow::DT_INT32);
+  tensorflow::ops::AddV2 out(root, x, y);
+  v0::Value add_fn =
+      ComputationV(StructB({TensorB(x), TensorB(y)}), TensorB(out), root);
+  add_fn.mutable_computation()
+      ->mutable_tensorflow()
+      ->mutable_cache_key()
+      ->set_id(1);
+  OwnedValueId add = TFF_ASSERT_OK(executor->CreateValue(add_fn));
+
+  constexpr int kNumCalls = 32;
+  std::vector<OwnedValueId> results;
+  for (int i = 0; i < kNumCalls; ++i) {
+    OwnedValueId arg = TFF_ASSERT_OK(
+        executor->CreateValue(StructV({TensorV(i), TensorV(1000)})));
+    results.push_back(TFF_ASSERT_OK(executor->CreateCall(add, arg)));
+  }
+  for (int i = 0; i < kNumCalls; ++i) {
+    EXPECT_THAT(TFF_ASSERT_OK(executor->Materialize(results[i])),
+                EqualsProto(TensorV(i + 1000)));
+  }
+}
+
+TEST(TensorFlowExecutorBatchTest, BatchedWhileLoopsRunInTheirOwnFrames) {
+  TensorFlowExecutorOptions options;
+  options.max_call_batch_size = 4;
+  std::shared_ptr<Executor> executor = CreateTensorFlowExecutor(options);
+
+  // Sums `x` over `n` iterations of a TF1 while loop (`Enter`, `Merge`,
+  // `Switch`, `NextIteration` and `Exit` ops in a named frame).
+  tensorflow::Scope root = tensorflow::Scope::NewRootScope();
+  tensorflow::ops::Placeholder x(root, tensorflow::DT_INT32);
+  tensorflow::ops::Placeholder n(root, tensorflow::DT_INT32);
+  tensorflow::Output zero = tensorflow::ops::Const(root, 0);
+  tensorflow::OutputList loop_outputs;
+  ASSERT_TRUE(
+      tensorflow::ops::BuildWhileLoop(
+          root, {zero, n, x, zero},
+          [](const tensorflow::Scope& scope,
+             const std::vector<tensorflow::Output>& inputs,
+             tensorflow::Output* output) {
+            *output = tensorflow::ops::Less(scope, inputs[0], inputs[1]);
+            return scope.status();
+          },
+          [](const tensorflow::Scope& scope,
+             const std::vector<tensorflow::Output>& inputs,
+             std::vector<tensorflow::Output>* outputs) {
+            *outputs = {tensorflow::ops::AddV2(scope, inputs[0], 1), inputs[1],
+                        inputs[2],
+                        tensorflow::ops::AddV2(scope, inputs[3], inputs[2])};
+            return scope.status();
+          },
+          "sum_loop", &loop_outputs)
+          .ok());
+  v0::Value sum_fn = ComputationV(StructB({TensorB(x), TensorB(n)}),
+                                  TensorB(loop_outputs[3]), root);
+  sum_fn.mutable_computation()
+      ->mutable_tensorflow()
+      ->mutable_cache_key()
+      ->set_id(1);
+  OwnedValueId sum = TFF_ASSERT_OK(executor->CreateValue(sum_fn));
+
+  constexpr int kNumCalls = 32;
+  std::vector<OwnedValueId> results;
+  for (int i = 0; i < kNumCalls; ++i) {
+    OwnedValueId arg = TFF_ASSERT_OK(
+        executor->CreateValue(StructV({TensorV(i), TensorV(i % 5)})));
+    results.push_back(TFF_ASSERT_OK(executor->CreateCall(sum, arg)));
+  }
+  for (int i = 0; i < kNumCalls; ++i) {
+    EXPECT_THAT(TFF_ASSERT_OK(executor->Materialize(results[i])),
+                EqualsProto(TensorV(i * (i % 5))));
+  }
+}
+
+TEST(TensorFlowExecutorBatchTest, FailingCallDoesNotFailItsBatch) {
+  TensorFlowExecutorOptions options;
+  options.max_call_batch_size = 4;
+  std::shared_ptr<Executor> executor = CreateTensorFlowExecutor(options);
+
+  tensorflow::Scope root = tensorflow::Scope::NewRootScope();
+  tensorflow::ops::Placeholder x(root, tensorflow::DT_FLOAT);
+  tensorflow::ops::Placeholder y(root, tensorflow::DT_FLOAT);
+  tensorflow::ops::AddV2 sum(root, x, y);
+  tensorflow::ops::CheckNumerics out(root, sum, "sum is not finite");
+  v0::Value add_fn =
+      ComputationV(StructB({TensorB(x), TensorB(y)}), TensorB(out), root);
+  add_fn.mutable_computation()
+      ->mutable_tensorflow()
+      ->mutable_cache_key()
+      ->set_id(1);
+  OwnedValueId add = TFF_ASSERT_OK(executor->CreateValue(add_fn));
+
+  constexpr int kNumCalls = 32;
+  constexpr int kFailingCall = 5;
+  std::vector<OwnedValueId> results;
+  for (int i = 0; i < kNumCalls; ++i) {
+    const float x_value = i == kFailingCall
+                              ? std::numeric_limits<float>::quiet_NaN()
+                              : static_cast<float>(i);
+    OwnedValueId arg = TFF_ASSERT_OK(
+        executor->CreateValue(StructV({TensorV(x_value), TensorV(1.0f)})));
+    results.push_back(TFF_ASSERT_OK(executor->CreateCall(add, arg)));
+  }
+  for (int i = 0; i < kNumCalls; ++i) {
+    if (i == kFailingCall) {
+      EXPECT_FALSE(executor->Materialize(results[i]).ok());
+    } else {
+      EXPECT_THAT(TFF_ASSERT_OK(executor->Materialize(results[i])),
+                  EqualsProto(TensorV(i + 1.0f)));
+    }
+  }
+}
+
 }  // namespace
 }  // namespace tensorflow_federated
@@ -18,7 +18,10 @@ limitations under the License
 #include <algorithm>
 #include <complex>
 #include <cstdint>
+#include <cstring>
+#include <memory>
 #include <string>
+#include <utility>
 
 #include "absl/log/log.h"
 #include "absl/status/status.h"
@@ -30,6 +33,7 @@ limitations under the License
 #include "Eigen/Core"
 #include "federated_language/proto/array.pb.h"
 #include "federated_language/proto/data_type.pb.h"
+#include "tensorflow/core/framework/allocation_description.pb.h"
 #include "tensorflow/core/framework/attr_value.pb.h"
 #include "tensorflow/core/framework/graph.pb.h"
 #include "tensorflow/core/framework/node_def.pb.h"
@@ -161,6 +165,40 @@ tensorflow::PartialTensorShape PartialTensorShapeFromArrayShape(
   }
 }
 
+// Assigns the elements of `tensor`, converted to the field's element type, to
+// `field`, without an intermediate `tensorflow::TensorProto`.
+template <typename T, typename FieldType>
+static void AssignFromTensor(
+    const tensorflow::Tensor& tensor,
+    google::protobuf::RepeatedField<FieldType>* field) {
+  auto flat = tensor.flat<T>();
+  field->Assign(flat.data(), flat.data() + flat.size());
+}
+
+// Overload for complex, whose elements are stored as interleaved real and
+// imaginary parts.
+template <typename T>
+static void AssignFromComplexTensor(const tensorflow::Tensor& tensor,
+                                    google::protobuf::RepeatedField<T>* field) {
+  auto flat = tensor.flat<std::complex<T>>();
+  const T* parts = reinterpret_cast<const T*>(flat.data());
+  field->Assign(parts, parts + 2 * flat.size());
+}
+
+// Overload for 16-bit floating point types, whose bit patterns are stored in an
+// int32 field (see `CopyFromRepeatedField` below).
+template <typename T>
+static void AssignFromHalfTensor(
+    const tensorflow::Tensor& tensor,
+    google::protobuf::RepeatedField<int32_t>* field) {
+  auto flat = tensor.flat<T>();
+  field->Clear();
+  field->Reserve(flat.size());
+  for (int64_t i = 0; i < flat.size(); ++i) {
+    field->AddAlreadyReserved(Eigen::numext::bit_cast<uint16_t>(flat(i)));
+  }
+}
+
 absl::StatusOr<federated_language::Array> ArrayFromTensor(
     const tensorflow::Tensor& tensor) {
   federated_language::Array array_pb;
@@ -171,93 +209,95 @@ absl::StatusOr<federated_language::Array> ArrayFromTensor(
       TFF_TRY(ArrayShapeFromTensorShape(tensor.shape()));
   array_pb.mutable_shape()->Swap(&shape_pb);
 
-  tensorflow::TensorProto tensor_pb;
-  tensor.AsProtoField(&tensor_pb);
-
-  switch (tensor_pb.dtype()) {
+  switch (tensor.dtype()) {
     case tensorflow::DataType::DT_BOOL: {
-      array_pb.mutable_bool_list()->mutable_value()->Assign(
-          tensor_pb.bool_val().begin(), tensor_pb.bool_val().end());
+      AssignFromTensor<bool>(tensor,
+                             array_pb.mutable_bool_list()->mutable_value());
       break;
     }
     case tensorflow::DataType::DT_INT8: {
-      array_pb.mutable_int8_list()->mutable_value()->Assign(
-          tensor_pb.int_val().begin(), tensor_pb.int_val().end());
+      AssignFromTensor<int8_t>(tensor,
+                               array_pb.mutable_int8_list()->mutable_value());
       break;
     }
     case tensorflow::DataType::DT_INT16: {
-      array_pb.mutable_int16_list()->mutable_value()->Assign(
-          tensor_pb.int_val().begin(), tensor_pb.int_val().end());
+      AssignFromTensor<int16_t>(tensor,
+                                array_pb.mutable_int16_list()->mutable_value());
       break;
     }
     case tensorflow::DataType::DT_INT32: {
-      array_pb.mutable_int32_list()->mutable_value()->Assign(
-          tensor_pb.int_val().begin(), tensor_pb.int_val().end());
+      AssignFromTensor<int32_t>(tensor,
+                                array_pb.mutable_int32_list()->mutable_value());
       break;
     }
     case tensorflow::DataType::DT_INT64: {
-      array_pb.mutable_int64_list()->mutable_value()->Assign(
-          tensor_pb.int64_val().begin(), tensor_pb.int64_val().end());
+      AssignFromTensor<int64_t>(tensor,
+                                array_pb.mutable_int64_list()->mutable_value());
       break;
     }
     case tensorflow::DataType::DT_UINT8: {
-      array_pb.mutable_uint8_list()->mutable_value()->Assign(
-          tensor_pb.int_val().begin(), tensor_pb.int_val().end());
+      AssignFromTensor<uint8_t>(tensor,
+                                array_pb.mutable_uint8_list()->mutable_value());
       break;
     }
     case tensorflow::DataType::DT_UINT16: {
-      array_pb.mutable_uint16_list()->mutable_value()->Assign(
-          tensor_pb.int_val().begin(), tensor_pb.int_val().end());
+      AssignFromTensor<uint16_t>(
+          tensor, array_pb.mutable_uint16_list()->mutable_value());
       break;
     }
     case tensorflow::DataType::DT_UINT32: {
-      array_pb.mutable_uint32_list()->mutable_value()->Assign(
-          tensor_pb.uint32_val().begin(), tensor_pb.uint32_val().end());
+      AssignFromTensor<uint32_t>(
+          tensor, array_pb.mutable_uint32_list()->mutable_value());
       break;
     }
     case tensorflow::DataType::DT_UINT64: {
-      array_pb.mutable_uint64_list()->mutable_value()->Assign(
-          tensor_pb.uint64_val().begin(), tensor_pb.uint64_val().end());
+      AssignFromTensor<uint64_t>(
+          tensor, array_pb.mutable_uint64_list()->mutable_value());
       break;
     }
     case tensorflow::DataType::DT_HALF: {
-      array_pb.mutable_float16_list()->mutable_value()->Assign(
-          tensor_pb.half_val().begin(), tensor_pb.half_val().end());
+      AssignFromHalfTensor<Eigen::half>(
+          tensor, array_pb.mutable_float16_list()->mutable_value());
       break;
     }
     case tensorflow::DataType::DT_FLOAT: {
-      array_pb.mutable_float32_list()->mutable_value()->Assign(
-          tensor_pb.float_val().begin(), tensor_pb.float_val().end());
+      AssignFromTensor<float>(tensor,
+                              array_pb.mutable_float32_list()->mutable_value());
       break;
     }
     case tensorflow::DataType::DT_DOUBLE: {
-      array_pb.mutable_float64_list()->mutable_value()->Assign(
-          tensor_pb.double_val().begin(), tensor_pb.double_val().end());
+      AssignFromTensor<double>(
+          tensor, array_pb.mutable_float64_list()->mutable_value());
       break;
     }
     case tensorflow::DataType::DT_COMPLEX64: {
-      array_pb.mutable_complex64_list()->mutable_value()->Assign(
-          tensor_pb.scomplex_val().begin(), tensor_pb.scomplex_val().end());
+      AssignFromComplexTensor<float>(
+          tensor, array_pb.mutable_complex64_list()->mutable_value());
       break;
     }
     case tensorflow::DataType::DT_COMPLEX128: {
-      array_pb.mutable_complex128_list()->mutable_value()->Assign(
-          tensor_pb.dcomplex_val().begin(), tensor_pb.dcomplex_val().end());
+      AssignFromComplexTensor<double>(
+          tensor, array_pb.mutable_complex128_list()->mutable_value());
       break;
     }
     case tensorflow::DataType::DT_BFLOAT16: {
-      array_pb.mutable_bfloat16_list()->mutable_value()->Assign(
-          tensor_pb.half_val().begin(), tensor_pb.half_val().end());
+      AssignFromHalfTensor<Eigen::bfloat16>(
+          tensor, array_pb.mutable_bfloat16_list()->mutable_value());
       break;
     }
     case tensorflow::DataType::DT_STRING: {
-      array_pb.mutable_string_list()->mutable_value()->Assign(
-          tensor_pb.string_val().begin(), tensor_pb.string_val().end());
+      auto flat = tensor.flat<tensorflow::tstring>();
+      google::protobuf::RepeatedPtrField<std::string>* values =
+          array_pb.mutable_string_list()->mutable_value();
+      values->Reserve(flat.size());
+      for (int64_t i = 0; i < flat.size(); ++i) {
+        values->Add(std::string(flat(i).data(), flat(i).size()));
+      }
       break;
     }
     default:
       return absl::UnimplementedError(
-          absl::StrCat("Unexpected DataType found:", tensor_pb.dtype()));
+          absl::StrCat("Unexpected DataType found:", tensor.dtype()));
   }
 
   return array_pb;
@@ -464,36 +504,113 @@ absl::StatusOr<federated_language::Array> ArrayContentFromTensor(
   federated_language::ArrayShape shape_pb =
       TFF_TRY(ArrayShapeFromTensorShape(tensor.shape()));
   array_pb.mutable_shape()->Swap(&shape_pb);
-  tensorflow::TensorProto tensor_pb;
-  tensor.AsProtoTensorContent(&tensor_pb);
-  *array_pb.mutable_content() = tensor_pb.tensor_content();
+  if (tensorflow::DataTypeCanUseMemcpy(tensor.dtype())) {
+    // The content of numeric tensors is their buffer, copied once.
+    absl::string_view data = tensor.tensor_data();
+    array_pb.mutable_content()->assign(data.data(), data.size());
+  } else {
+    tensorflow::TensorProto tensor_pb;
+    tensor.AsProtoTensorContent(&tensor_pb);
+    array_pb.mutable_content()->swap(*tensor_pb.mutable_tensor_content());
+  }
 
   return array_pb;
 }
 
-absl::StatusOr<tensorflow::Tensor> TensorFromArrayContent(
-    const federated_language::Array& array_pb) {
+namespace {
+
+// A tensor buffer that takes ownership of the content of an `Array`, so that
+// a tensor can alias the content instead of copying it.
+class ArrayContentBuffer : public tensorflow::TensorBuffer {
+ public:
+  explicit ArrayContentBuffer(std::unique_ptr<std::string> content)
+      : TensorBuffer(content->data()), content_(std::move(content)) {}
+
+  size_t size() const override { return content_->size(); }
+  TensorBuffer* root_buffer() override { return this; }
+  void FillAllocationDescription(
+      tensorflow::AllocationDescription* proto) const override {
+    proto->set_requested_bytes(size());
+    proto->set_allocator_name("array_content");
+  }
+
+ private:
+  const std::unique_ptr<std::string> content_;
+};
+
+bool IsAligned(const void* data) {
+  return reinterpret_cast<uintptr_t>(data) % EIGEN_MAX_ALIGN_BYTES == 0;
+}
+
+}  // namespace
+
+// Returns the tensor described by `array_pb`. If `content` is set, it is
+// `array_pb`'s content, which the tensor takes over instead of copying it.
+static absl::StatusOr<tensorflow::Tensor> TensorFromArrayContentImpl(
+    const federated_language::Array& array_pb, std::string* content) {
   if (!array_pb.has_content()) {
     return absl::InvalidArgumentError("Expected a content field, found none.");
   }
-
-  tensorflow::TensorProto tensor_pb;
   tensorflow::DataType data_type =
       TFF_TRY(TensorFlowDataTypeFromDataType(array_pb.dtype()));
-  tensor_pb.set_dtype(data_type);
-  tensorflow::TensorShapeProto shape_pb =
-      TFF_TRY(TensorShapeFromArrayShape(array_pb.shape())).AsProto();
-  tensor_pb.mutable_tensor_shape()->Swap(&shape_pb);
-  *tensor_pb.mutable_tensor_content() = array_pb.content();
-
-  tensorflow::Tensor tensor;
-  if (!tensor.FromProto(tensor_pb)) {
-    return absl::InvalidArgumentError(
-        "Seriailzed tensor proto could not be parsed into Tensor.");
+  tensorflow::TensorShape shape =
+      TFF_TRY(TensorShapeFromArrayShape(array_pb.shape()));
+
+  if (!tensorflow::DataTypeCanUseMemcpy(data_type)) {
+    tensorflow::TensorProto tensor_pb;
+    tensor_pb.set_dtype(data_type);
+    shape.AsProto(tensor_pb.mutable_tensor_shape());
+    *tensor_pb.mutable_tensor_content() = array_pb.content();
+    tensorflow::Tensor tensor;
+    if (!tensor.FromProto(tensor_pb)) {
+      return absl::InvalidArgumentError(
+          "Seriailzed tensor proto could not be parsed into Tensor.");
+    }
+    return tensor;
+  }
+
+  const int64_t num_bytes =
+      shape.num_elements() * tensorflow::DataTypeSize(data_type);
+  if (static_cast<int64_t>(array_pb.content().size()) != num_bytes) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "Expected ", num_bytes, " bytes of content for an array of shape ",
+        shape.DebugString(), ", found ", array_pb.content().size(), "."));
   }
+  if (num_bytes == 0) {
+    return tensorflow::Tensor(data_type, shape);
+  }
+  std::unique_ptr<std::string> owned_content;
+  absl::string_view source = array_pb.content();
+  if (content != nullptr) {
+    owned_content = std::make_unique<std::string>(std::move(*content));
+    source = *owned_content;
+    // TensorFlow requires tensor buffers to be aligned for vectorized kernels,
+    // so only aligned content can be aliased.
+    if (IsAligned(owned_content->data())) {
+      auto* buffer = new ArrayContentBuffer(std::move(owned_content));
+      tensorflow::Tensor tensor(data_type, shape, buffer);
+      buffer->Unref();
+      return tensor;
+    }
+  }
+  tensorflow::Tensor tensor(data_type, shape);
+  std::memcpy(tensor.data(), source.data(), num_bytes);
   return tensor;
 }
 
+absl::StatusOr<tensorflow::Tensor> TensorFromArrayContent(
+    const federated_language::Array& array_pb) {
+  return TensorFromArrayContentImpl(array_pb, /*content=*/nullptr);
+}
+
+absl::StatusOr<tensorflow::Tensor> TensorFromArrayContent(
+    federated_language::Array&& array_pb) {
+  // `content` is part of a oneof, so only take it if it is set.
+  std::string* content =
+      array_pb.has_content() ? array_pb.mutable_content() : nullptr;
+  return TensorFromArrayContentImpl(array_pb, content);
+}
+
 std::string GetNodeName(absl::string_view tensor_name) {
   absl::string_view::size_type pos = tensor_name.find(':');
   if (pos == absl::string_view::npos) {
@@ -46,6 +46,10 @@ absl::StatusOr<tensorflow::Tensor> TensorFromArray(
     const federated_language::Array& array_pb);
 absl::StatusOr<tensorflow::Tensor> TensorFromArrayContent(
     const federated_language::Array& array_pb);
+// As above, but takes over the content of `array_pb`: when its buffer is
+// suitably aligned, the returned tensor aliases it rather than copying it.
+absl::StatusOr<tensorflow::Tensor> TensorFromArrayContent(
+    federated_language::Array&& array_pb);
 
 std::string GetNodeName(absl::string_view tensor_name);
 
@@ -0,0 +1,119 @@
+/* Copyright 2026, The TensorFlow Federated Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+     http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License
+==============================================================================*/
+
+// Benchmarks of converting large tensors to and from
+// `federated_language::Array`, as done for every value crossing an executor
+// boundary.
+
+#include <cstdint>
+#include <utility>
+
+#include "benchmark/benchmark.h"
+#include "federated_language/proto/array.pb.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/framework/types.pb.h"
+#include "tensorflow_federated/cc/core/impl/executors/tensor_serialization.h"
+#include "tensorflow_federated/cc/core/impl/executors/tensorflow_utils.h"
+#include "tensorflow_federated/proto/v0/executor.pb.h"
+
+namespace tensorflow_federated {
+namespace {
+
+constexpr int64_t kOneMegabyte = 1 << 20;
+constexpr int64_t kHundredMegabytes = 100 << 20;
+
+// A float tensor of `num_bytes` bytes.
+tensorflow::Tensor FloatTensor(int64_t num_bytes) {
+  const int64_t num_elements = num_bytes / sizeof(float);
+  tensorflow::Tensor tensor(tensorflow::DT_FLOAT,
+                            tensorflow::TensorShape({num_elements}));
+  tensor.flat<float>().setConstant(1.0f);
+  return tensor;
+}
+
+void BM_ArrayFromTensor(benchmark::State& state) {
+  tensorflow::Tensor tensor = FloatTensor(state.range(0));
+  for (auto s : state) {
+    benchmark::DoNotOptimize(ArrayFromTensor(tensor));
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_ArrayFromTensor)->Arg(kOneMegabyte)->Arg(kHundredMegabytes);
+
+void BM_ArrayContentFromTensor(benchmark::State& state) {
+  tensorflow::Tensor tensor = FloatTensor(state.range(0));
+  for (auto s : state) {
+    benchmark::DoNotOptimize(ArrayContentFromTensor(tensor));
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_ArrayContentFromTensor)
+    ->Arg(kOneMegabyte)
+    ->Arg(kHundredMegabytes);
+
+void BM_TensorFromArrayContent(benchmark::State& state) {
+  const federated_language::Array array_pb =
+      ArrayContentFromTensor(FloatTensor(state.range(0))).value();
+  for (auto s : state) {
+    benchmark::DoNotOptimize(TensorFromArrayContent(array_pb));
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_TensorFromArrayContent)
+    ->Arg(kOneMegabyte)
+    ->Arg(kHundredMegabytes);
+
+// Converts an array the caller no longer needs, whose content the tensor may
+// take over. Copying the array for each iteration is not timed.
+void BM_TensorFromMovedArrayContent(benchmark::State& state) {
+  const federated_language::Array array_pb =
+      ArrayContentFromTensor(FloatTensor(state.range(0))).value();
+  for (auto s : state) {
+    state.PauseTiming();
+    federated_language::Array moved_array_pb = array_pb;
+    state.ResumeTiming();
+    benchmark::DoNotOptimize(TensorFromArrayContent(std::move(moved_array_pb)));
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_TensorFromMovedArrayContent)
+    ->Arg(kOneMegabyte)
+    ->Arg(kHundredMegabytes);
+
+// Serializes and deserializes a value, as for a hop between executors.
+void BM_SerializeDeserializeTensorValue(benchmark::State& state) {
+  tensorflow::Tensor tensor = FloatTensor(state.range(0));
+  for (auto s : state) {
+    v0::Value value_pb;
+    benchmark::DoNotOptimize(SerializeTensorValue(tensor, &value_pb));
+    benchmark::DoNotOptimize(DeserializeTensorValue(std::move(value_pb)));
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_SerializeDeserializeTensorValue)
+    ->Arg(kOneMegabyte)
+    ->Arg(kHundredMegabytes);
+
+}  // namespace
+}  // namespace tensorflow_federated
+
+// Run the benchmark
+BENCHMARK_MAIN();
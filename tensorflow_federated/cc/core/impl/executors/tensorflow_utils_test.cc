@@ -18,6 +18,7 @@ limitations under the License
 #include <complex>
 #include <cstdint>
 #include <string>
+#include <utility>
 
 #include "googlemock/include/gmock/gmock.h"
 #include "googletest/include/gtest/gtest.h"
@@ -617,6 +618,16 @@ TEST_P(TensorFromArrayContentTest, TestReturnsTensor) {
   tensorflow::test::ExpectEqual(actual_tensor, test_case.expected_tensor);
 }
 
+TEST_P(TensorFromArrayContentTest, TestReturnsTensorFromMovedArray) {
+  const TensorFromArrayContentTestCase& test_case = GetParam();
+  federated_language::Array array_pb = test_case.array_pb;
+
+  const tensorflow::Tensor& actual_tensor =
+      TFF_ASSERT_OK(TensorFromArrayContent(std::move(array_pb)));
+
+  tensorflow::test::ExpectEqual(actual_tensor, test_case.expected_tensor);
+}
+
 #define CONTENT(s) absl::string_view(s, sizeof(s) - 1)
 
 INSTANTIATE_TEST_SUITE_P(
@@ -763,5 +774,41 @@ INSTANTIATE_TEST_SUITE_P(
     [](const ::testing::TestParamInfo<TensorFromArrayContentTest::ParamType>&
            info) { return info.param.test_name; });
 
+TEST(TensorFromArrayContentErrorTest, TestFailsOnContentOfWrongSize) {
+  const federated_language::Array array_pb = TFF_ASSERT_OK(
+      testing::CreateArrayContent(federated_language::DataType::DT_INT32,
+                                  testing::CreateArrayShape({2}),
+                                  CONTENT("\001\000\000\000")));
+
+  EXPECT_THAT(TensorFromArrayContent(array_pb),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST(ArrayContentRoundTripTest, TestLargeTensorRoundTrips) {
+  // Large enough for the content to be heap allocated, so that moving the
+  // content keeps its buffer.
+  tensorflow::Tensor tensor(tensorflow::DT_FLOAT,
+                            tensorflow::TensorShape({512, 512}));
+  auto flat = tensor.flat<float>();
+  for (int64_t i = 0; i < flat.size(); ++i) {
+    flat(i) = static_cast<float>(i);
+  }
+
+  federated_language::Array array_pb =
+      TFF_ASSERT_OK(ArrayContentFromTensor(tensor));
+  EXPECT_EQ(array_pb.content().size(), tensor.TotalBytes());
+  const char* content_data = array_pb.content().data();
+  const tensorflow::Tensor& actual_tensor =
+      TFF_ASSERT_OK(TensorFromArrayContent(std::move(array_pb)));
+
+  tensorflow::test::ExpectEqual(actual_tensor, tensor);
+  // Aligned content is aliased by the tensor, anything else is copied.
+  if (reinterpret_cast<uintptr_t>(content_data) % EIGEN_MAX_ALIGN_BYTES == 0) {
+    EXPECT_EQ(actual_tensor.tensor_data().data(), content_data);
+  } else {
+    EXPECT_NE(actual_tensor.tensor_data().data(), content_data);
+  }
+}
+
 }  // namespace
 }  // namespace tensorflow_federated
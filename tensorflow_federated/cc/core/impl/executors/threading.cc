@@ -15,40 +15,242 @@ limitations under the License
 
 #include "tensorflow_federated/cc/core/impl/executors/threading.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
 #include <cstdint>
+#include <deque>
 #include <functional>
+#include <memory>
+#include <optional>
 #include <thread>  // NOLINT
 #include <utility>
 
 #include "absl/base/thread_annotations.h"
+#include "absl/functional/function_ref.h"
 #include "absl/log/log.h"
 #include "absl/status/status.h"
 #include "absl/strings/string_view.h"
 #include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
 
 namespace tensorflow_federated {
 
+namespace {
+
+// The pool and worker index of the current thread, if it is a pool worker.
+thread_local const ThreadPool* current_pool = nullptr;
+thread_local int32_t current_worker_index = -1;
+// Whether the current thread is a default pool worker, and how deeply it is
+// nested in `ScopedBlockingRegion`s.
+thread_local bool is_default_pool_worker = false;
+thread_local int32_t blocking_region_depth = 0;
+
+// How long queued work on the default pool may go without any task starting
+// before the pool adds threads.
+constexpr absl::Duration kDefaultPoolStallInterval = absl::Milliseconds(10);
+// How long a default pool thread waits for work before checking whether it is
+// surplus to the configured size.
+constexpr absl::Duration kDefaultPoolIdleTimeout = absl::Seconds(10);
+
+int32_t DefaultThreadPoolSizeForMachine() {
+  return std::max<int32_t>(4 * std::thread::hardware_concurrency(), 16);
+}
+
+// The name under which the default pool reports its `ThreadPoolStats`.
+constexpr absl::string_view kDefaultPoolName = "DefaultThreadPool";
+
+// The process-wide pool behind `ScheduleOnDefaultThreadPool`.
+//
+// Threads are created on demand up to `size_`, and are reused rather than
+// exiting after each task. Work scheduled beyond `size_` is queued. A monitor
+// thread watches for queued work that is not being started while workers are
+// blocked in a `ScopedBlockingRegion` (e.g. waiting on queued work), and adds
+// one thread per blocked worker to break the stall, so that up to `size_`
+// workers are not blocked. Threads above `size_` exit after being idle for
+// `kDefaultPoolIdleTimeout`.
+class DefaultThreadPool {
+ public:
+  static DefaultThreadPool& Get() {
+    // Intentionally leaked: threads are detached and may outlive `main`.
+    static DefaultThreadPool* pool = new DefaultThreadPool();
+    return *pool;
+  }
+
+  void Schedule(std::function<void()> task) {
+    QueuedTask queued_task{std::move(task)};
+    if (ThreadPoolStatsEnabled()) {
+      queued_task.scheduled_time = absl::Now();
+    }
+    absl::MutexLock lock(&mutex_);
+    queue_.push_back(std::move(queued_task));
+    if (queue_.back().scheduled_time.has_value()) {
+      stats_->RecordScheduled(queue_.size());
+    }
+    if (idle_threads_ >= static_cast<int64_t>(queue_.size())) {
+      // An idle thread will pick up the task when `mutex_` is released.
+      return;
+    }
+    if (num_threads_ < size_) {
+      AddThreadLocked();
+      return;
+    }
+    if (!monitor_started_) {
+      monitor_started_ = true;
+      std::thread(&DefaultThreadPool::RunMonitor, this).detach();
+    }
+  }
+
+  void SetSize(int32_t num_threads) {
+    absl::MutexLock lock(&mutex_);
+    size_ = num_threads > 0 ? num_threads : DefaultThreadPoolSizeForMachine();
+  }
+
+  int32_t size() {
+    absl::MutexLock lock(&mutex_);
+    return size_;
+  }
+
+  void AddBlockedThreads(int32_t delta) { blocked_threads_.fetch_add(delta); }
+
+ private:
+  DefaultThreadPool()
+      : stats_(GetThreadPoolStats(kDefaultPoolName)),
+        size_(DefaultThreadPoolSizeForMachine()) {}
+
+  struct QueuedTask {
+    std::function<void()> task;
+    // Only set if the task was recorded in `stats_` when it was scheduled.
+    std::optional<absl::Time> scheduled_time;
+  };
+
+  bool has_work() ABSL_SHARED_LOCKS_REQUIRED(mutex_) { return !queue_.empty(); }
+
+  void AddThreadLocked() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_) {
+    ++num_threads_;
+    stats_->AddThreads(1);
+    std::thread(&DefaultThreadPool::RunWorker, this).detach();
+  }
+
+  void RunWorker() {
+    is_default_pool_worker = true;
+    while (true) {
+      mutex_.Lock();
+      ++idle_threads_;
+      bool found_work = mutex_.AwaitWithTimeout(
+          absl::Condition(this, &DefaultThreadPool::has_work),
+          kDefaultPoolIdleTimeout);
+      --idle_threads_;
+      if (!found_work) {
+        if (num_threads_ > size_) {
+          --num_threads_;
+          stats_->RemoveThreads(1);
+          mutex_.Unlock();
+          return;
+        }
+        mutex_.Unlock();
+        continue;
+      }
+      QueuedTask task = std::move(queue_.front());
+      queue_.pop_front();
+      ++started_tasks_;
+      std::optional<absl::Time> start_time;
+      if (task.scheduled_time.has_value()) {
+        start_time = absl::Now();
+        stats_->RecordStarted(*start_time - *task.scheduled_time,
+                              num_threads_ - idle_threads_);
+      }
+      mutex_.Unlock();
+      task.task();
+      if (start_time.has_value()) {
+        stats_->RecordCompleted(absl::Now() - *start_time);
+      }
+    }
+  }
+
+  void RunMonitor() {
+    uint64_t last_started_tasks = 0;
+    while (true) {
+      absl::SleepFor(kDefaultPoolStallInterval);
+      absl::MutexLock lock(&mutex_);
+      const int32_t blocked_threads = blocked_threads_.load();
+      if (!queue_.empty() && idle_threads_ == 0 && blocked_threads > 0 &&
+          started_tasks_ == last_started_tasks) {
+        // Replace blocked workers only: the pool may grow without bound while
+        // its workers are blocked, but never runs more than `size_` workers
+        // that are not blocked.
+        const int64_t unblocked_threads = num_threads_ - blocked_threads;
+        const int64_t num_new_threads =
+            std::min<int64_t>(static_cast<int64_t>(queue_.size()),
+                              size_ - unblocked_threads);
+        if (num_new_threads > 0) {
+          VLOG(1) << "Default thread pool stalled with " << queue_.size()
+                  << " queued tasks on " << num_threads_ << " threads ("
+                  << blocked_threads << " blocked); adding "
+                  << num_new_threads << " threads.";
+          for (int64_t i = 0; i < num_new_threads; ++i) {
+            AddThreadLocked();
+          }
+        }
+      }
+      last_started_tasks = started_tasks_;
+    }
+  }
+
+  ThreadPoolStats* const stats_;
+  absl::Mutex mutex_;
+  std::deque<QueuedTask> queue_ ABSL_GUARDED_BY(mutex_);
+  int32_t size_ ABSL_GUARDED_BY(mutex_);
+  int32_t num_threads_ ABSL_GUARDED_BY(mutex_) = 0;
+  int64_t idle_threads_ ABSL_GUARDED_BY(mutex_) = 0;
+  uint64_t started_tasks_ ABSL_GUARDED_BY(mutex_) = 0;
+  bool monitor_started_ ABSL_GUARDED_BY(mutex_) = false;
+  // Number of workers inside a `ScopedBlockingRegion`.
+  std::atomic<int32_t> blocked_threads_{0};
+};
+
+}  // namespace
+
+void SetDefaultThreadPoolSize(int32_t num_threads) {
+  DefaultThreadPool::Get().SetSize(num_threads);
+}
+
+int32_t GetDefaultThreadPoolSize() { return DefaultThreadPool::Get().size(); }
+
+void ScheduleOnDefaultThreadPool(std::function<void()> task) {
+  DefaultThreadPool::Get().Schedule(std::move(task));
+}
+
+ScopedBlockingRegion::ScopedBlockingRegion() {
+  if (!is_default_pool_worker) {
+    return;
+  }
+  active_ = true;
+  if (blocking_region_depth++ == 0) {
+    DefaultThreadPool::Get().AddBlockedThreads(1);
+  }
+}
+
+ScopedBlockingRegion::~ScopedBlockingRegion() {
+  if (active_ && --blocking_region_depth == 0) {
+    DefaultThreadPool::Get().AddBlockedThreads(-1);
+  }
+}
+
 ThreadPool::ThreadPool(int32_t num_threads, absl::string_view name)
-    : pool_name_(name) {
+    : pool_name_(name), stats_(GetThreadPoolStats(name)) {
   if (num_threads < 1) {
     LOG(QFATAL) << "num_threads must be positive";
   }
-  absl::MutexLock lock(&pool_mutex_);
+  stats_->AddThreads(num_threads);
+  queues_.reserve(num_threads);
   for (int32_t i = 0; i < num_threads; ++i) {
-    threads_.emplace_back([this]() {
-      while (true) {
-        pool_mutex_.LockWhen(
-            absl::Condition(this, &ThreadPool::has_work_or_closed));
-        if (work_queue_.empty() && closed_) {
-          pool_mutex_.Unlock();
-          return;
-        }
-        const std::function<void()> f = std::move(work_queue_.front());
-        work_queue_.pop_front();
-        pool_mutex_.Unlock();
-        f();
-      }
-    });
+    queues_.emplace_back(std::make_unique<WorkerQueue>());
+  }
+  threads_.reserve(num_threads);
+  for (int32_t i = 0; i < num_threads; ++i) {
+    threads_.emplace_back([this, i]() { RunWorker(i); });
   }
 }
 
@@ -57,25 +259,196 @@ ThreadPool::~ThreadPool() {
   for (std::thread& t : threads_) {
     t.join();
   }
+  stats_->RemoveThreads(threads_.size());
 }
 
 absl::Status ThreadPool::Schedule(std::function<void()> task) {
-  absl::MutexLock lock(&pool_mutex_);
-  if (closed_) {
+  schedules_in_progress_.fetch_add(1);
+  if (closed_.load()) {
+    schedules_in_progress_.fetch_sub(1);
+    if (ThreadPoolStatsEnabled()) {
+      stats_->RecordRejected();
+    }
+    // Workers may be waiting for this call to finish before exiting.
+    WakeOne();
     return absl::FailedPreconditionError(
         "Called Schedule() on a ThreadPool that is closed.");
   }
-  work_queue_.push_back(std::move(task));
+  QueuedTask queued_task{std::move(task)};
+  if (ThreadPoolStatsEnabled()) {
+    queued_task.scheduled_time = absl::Now();
+  }
+  const bool record = queued_task.scheduled_time.has_value();
+  int64_t queue_depth;
+  if (current_pool == this) {
+    WorkerQueue& queue = *queues_[current_worker_index];
+    absl::MutexLock lock(&queue.mutex);
+    queued_task.sequence = next_sequence_.fetch_add(1);
+    queue.local.push_back(std::move(queued_task));
+    queue_depth = queued_tasks_.fetch_add(1) + 1;
+  } else {
+    WorkerQueue& queue = *queues_[next_inbox_.fetch_add(1) % queues_.size()];
+    absl::MutexLock lock(&queue.mutex);
+    queued_task.sequence = next_sequence_.fetch_add(1);
+    queue.inbox.push_back(std::move(queued_task));
+    queue_depth = queued_tasks_.fetch_add(1) + 1;
+  }
+  if (record) {
+    stats_->RecordScheduled(queue_depth);
+  }
+  schedules_in_progress_.fetch_sub(1);
+  WakeOne();
   return absl::OkStatus();
 }
 
-bool ThreadPool::has_work_or_closed() ABSL_SHARED_LOCKS_REQUIRED(pool_mutex_) {
-  return !work_queue_.empty() || closed_;
+void ThreadPool::Close() {
+  closed_.store(true);
+  WakeAll();
 }
 
-void ThreadPool::Close() {
-  absl::MutexLock lock(&pool_mutex_);
-  closed_ = true;
+bool ThreadPool::has_work_or_done() const {
+  return queued_tasks_.load() > 0 ||
+         (closed_.load() && schedules_in_progress_.load() == 0);
+}
+
+void ThreadPool::WakeOne() {
+  if (sleeping_workers_.load() == 0) {
+    return;
+  }
+  // Claims a parked worker, so that concurrent calls wake different workers
+  // and only contend on the mutex of the worker they wake.
+  for (const std::unique_ptr<WorkerQueue>& queue : queues_) {
+    if (queue->parked.exchange(false)) {
+      absl::MutexLock lock(&queue->park_mutex);
+      queue->woken = true;
+      queue->park_cond_var.Signal();
+      return;
+    }
+  }
+}
+
+void ThreadPool::WakeAll() {
+  for (const std::unique_ptr<WorkerQueue>& queue : queues_) {
+    queue->parked.store(false);
+    absl::MutexLock lock(&queue->park_mutex);
+    queue->woken = true;
+    queue->park_cond_var.Signal();
+  }
+}
+
+void ThreadPool::Park(int32_t worker_index) {
+  WorkerQueue& queue = *queues_[worker_index];
+  // Parking is published before the work check, and `Schedule` publishes its
+  // task before checking for parked workers, so either this worker sees the
+  // task or `WakeOne` sees this worker.
+  queue.parked.store(true);
+  sleeping_workers_.fetch_add(1);
+  {
+    absl::MutexLock lock(&queue.park_mutex);
+    while (!queue.woken && !has_work_or_done()) {
+      queue.park_cond_var.Wait(&queue.park_mutex);
+    }
+    queue.woken = false;
+  }
+  sleeping_workers_.fetch_sub(1);
+  queue.parked.store(false);
+}
+
+bool ThreadPool::TryPopOldest(WorkerQueue& queue, QueuedTask* task) {
+  absl::MutexLock lock(&queue.mutex);
+  std::deque<QueuedTask>* source;
+  if (queue.local.empty()) {
+    if (queue.inbox.empty()) {
+      return false;
+    }
+    source = &queue.inbox;
+  } else if (queue.inbox.empty() ||
+             queue.local.front().sequence < queue.inbox.front().sequence) {
+    source = &queue.local;
+  } else {
+    source = &queue.inbox;
+  }
+  *task = std::move(source->front());
+  source->pop_front();
+  queued_tasks_.fetch_sub(1);
+  return true;
+}
+
+bool ThreadPool::TryGetTask(int32_t worker_index, QueuedTask* task) {
+  if (TryPopOldest(*queues_[worker_index], task)) {
+    return true;
+  }
+  const int32_t num_queues = queues_.size();
+  for (int32_t offset = 1; offset < num_queues; ++offset) {
+    if (TryPopOldest(*queues_[(worker_index + offset) % num_queues], task)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void ThreadPool::RunWorker(int32_t worker_index) {
+  current_pool = this;
+  current_worker_index = worker_index;
+  QueuedTask task;
+  while (true) {
+    if (TryGetTask(worker_index, &task)) {
+      if (!task.scheduled_time.has_value()) {
+        task.task();
+        task.task = nullptr;
+        continue;
+      }
+      const absl::Time start_time = absl::Now();
+      stats_->RecordStarted(
+          start_time - *task.scheduled_time,
+          static_cast<int64_t>(queues_.size()) - sleeping_workers_.load());
+      task.task();
+      task.task = nullptr;
+      stats_->RecordCompleted(absl::Now() - start_time);
+      continue;
+    }
+    Park(worker_index);
+    if (queued_tasks_.load() == 0 && closed_.load() &&
+        schedules_in_progress_.load() == 0) {
+      // Closed, drained, and no `Schedule` call can add more work.
+      WakeAll();
+      return;
+    }
+  }
+}
+
+void CancellationToken::Cancel() const {
+  absl::MutexLock lock(&state_->mutex);
+  if (state_->cancelled.exchange(true, std::memory_order_acq_rel)) {
+    return;
+  }
+  // Run under the lock, so that `~CancellationCallback` waits for a callback
+  // which is running concurrently.
+  for (auto& [id, callback] : state_->callbacks) {
+    callback();
+  }
+  state_->callbacks.clear();
+}
+
+CancellationCallback::CancellationCallback(const CancellationToken& token,
+                                           std::function<void()> callback)
+    : state_(token.state_) {
+  {
+    absl::MutexLock lock(&state_->mutex);
+    if (!state_->cancelled.load(std::memory_order_acquire)) {
+      id_ = state_->next_callback_id++;
+      state_->callbacks.emplace(*id_, std::move(callback));
+      return;
+    }
+  }
+  callback();
+}
+
+CancellationCallback::~CancellationCallback() {
+  if (id_.has_value()) {
+    absl::MutexLock lock(&state_->mutex);
+    state_->callbacks.erase(*id_);
+  }
 }
 
 bool ParallelTasksInner_::AllDone_() ABSL_SHARED_LOCKS_REQUIRED(mutex_) {
@@ -87,17 +460,35 @@ absl::Status ParallelTasks::add_task(std::function<absl::Status()> task) {
     absl::WriterMutexLock lock(&shared_inner_->mutex_);
     shared_inner_->remaining_tasks_ += 1;
   }
-  auto void_task = [inner = shared_inner_, task = std::move(task)]() {
-    absl::Status result = task();
+  auto void_task = [inner = shared_inner_, task = std::move(task)]() mutable {
+    absl::Status result;
+    if (inner->cancellation_token_.IsCancelled()) {
+      result = absl::CancelledError("ParallelTasks cancelled before task ran.");
+    } else {
+      result = task();
+    }
+    // Release the task's captures before `WaitAll` can return, so that they
+    // are destroyed while the caller's state is still alive.
+    task = nullptr;
     absl::WriterMutexLock lock(&inner->mutex_);
+    if (!result.ok() && inner->cancel_on_error_) {
+      inner->cancellation_token_.Cancel();
+    }
     inner->status_.Update(std::move(result));
     inner->remaining_tasks_ -= 1;
   };
   if (thread_pool_ != nullptr) {
-    return thread_pool_->Schedule(std::move(void_task));
+    absl::Status status = thread_pool_->Schedule(std::move(void_task));
+    if (!status.ok()) {
+      // The task will never run, so account for it here to keep `WaitAll`
+      // from waiting on it forever.
+      absl::WriterMutexLock lock(&shared_inner_->mutex_);
+      shared_inner_->status_.Update(status);
+      shared_inner_->remaining_tasks_ -= 1;
+    }
+    return status;
   } else {
-    std::thread th(std::move(void_task));
-    th.detach();
+    ScheduleOnDefaultThreadPool(std::move(void_task));
     return absl::OkStatus();
   }
 }
@@ -106,6 +497,7 @@ absl::Status ParallelTasks::WaitAll() {
   // NOTE: we must not short-circuit on errors, as the threaded tasks must not
   // be allowed to outlive any temporary variables they reference from the
   // scope that called `WaitAll`.
+  ScopedBlockingRegion blocking;
   shared_inner_->mutex_.ReaderLockWhen(
       absl::Condition(&*shared_inner_, &ParallelTasksInner_::AllDone_));
   absl::Status status = shared_inner_->status_;
@@ -113,4 +505,35 @@ absl::Status ParallelTasks::WaitAll() {
   return status;
 }
 
+absl::Status ParallelTasks::WaitAllFailFast() {
+  {
+    absl::WriterMutexLock lock(&shared_inner_->mutex_);
+    shared_inner_->cancel_on_error_ = true;
+    if (!shared_inner_->status_.ok()) {
+      shared_inner_->cancellation_token_.Cancel();
+    }
+  }
+  return WaitAll();
+}
+
+absl::Status ParallelFor(size_t n,
+                         absl::FunctionRef<absl::Status(size_t)> fn) {
+  const size_t num_tasks =
+      std::min<size_t>(n, std::max<int32_t>(GetDefaultThreadPoolSize(), 1));
+  std::atomic<size_t> next_index = 0;
+  ParallelTasks tasks;
+  const CancellationToken& cancellation = tasks.cancellation_token();
+  for (size_t t = 0; t < num_tasks; ++t) {
+    TFF_TRY(tasks.add_task(
+        [&fn, &next_index, &cancellation, n]() -> absl::Status {
+          for (size_t i = next_index++; i < n && !cancellation.IsCancelled();
+               i = next_index++) {
+            TFF_TRY(fn(i));
+          }
+          return absl::OkStatus();
+        }));
+  }
+  return tasks.WaitAllFailFast();
+}
+
 }  // namespace tensorflow_federated
@@ -16,12 +16,15 @@ limitations under the License
 #ifndef THIRD_PARTY_TENSORFLOW_FEDERATED_CC_CORE_IMPL_EXECUTORS_THREADING_H_
 #define THIRD_PARTY_TENSORFLOW_FEDERATED_CC_CORE_IMPL_EXECUTORS_THREADING_H_
 
+#include <atomic>
 #include <chrono>  // NOLINT
+#include <cstddef>
 #include <cstdint>
 #include <deque>
 #include <functional>
 #include <future>  // NOLINT
 #include <memory>
+#include <optional>
 #include <string>
 #include <thread>  // NOLINT
 #include <type_traits>
@@ -29,23 +32,45 @@ limitations under the License
 #include <vector>
 
 #include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/functional/function_ref.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/string_view.h"
 #include "absl/synchronization/mutex.h"
 #include "absl/types/span.h"
+#include "absl/time/time.h"
 #include "absl/utility/utility.h"
+#include "tensorflow_federated/cc/core/impl/base/thread_pool_stats.h"
 #include "tensorflow_federated/cc/core/impl/executors/status_macros.h"
 
 namespace tensorflow_federated {
 
-// A simple thread pool with a single FIFO work-queue.
+// A work-stealing thread pool.
 //
-// This thread pool is safe for tasks that for DAGs of dependencies, as it
-// guarantees that work added to the pool will be run threads in the order added
-// to the pool. The pool is _NOT_ safe from other forms of synchronization and
-// communication, and callers are responsible ensuring threads do not deadlock
-// in such cases.
+// Each worker thread owns two queues: an "inbox" of tasks scheduled from
+// outside the pool (assigned round-robin across workers), and a "local" queue
+// of tasks scheduled by the worker itself while running another task, which
+// keeps nested work on the thread that produced it. Every task is numbered in
+// the order it was scheduled. A worker pops whichever of its two queues holds
+// the older task, and when both are empty steals the older of another
+// worker's two oldest tasks. Each queue is guarded by its own mutex, so
+// workers only contend with each other when stealing.
+//
+// A worker never starts a task while an older one is waiting in its own
+// queues, so whenever a task is waiting, the worker it is queued on is running
+// an older task. This makes the pool safe for tasks that form DAGs of
+// dependencies, where a task only blocks on tasks scheduled before it
+// (including a nested task blocking on a task scheduled earlier from outside
+// the pool): the oldest running task never waits on work that has not
+// started. The pool is _NOT_
+// safe from other forms of synchronization and communication, and callers are
+// responsible ensuring threads do not deadlock in such cases.
+//
+// While `SetThreadPoolStatsEnabled(true)` is in effect, the pool reports queue
+// depth, queueing and run times, active workers and rejected tasks to the
+// process-wide `ThreadPoolStats` for its `name`, shared with every other pool
+// of the same name (see `GetAllThreadPoolStats`).
 class ThreadPool {
  public:
   ThreadPool(int32_t num_threads, absl::string_view name);
@@ -62,35 +87,135 @@ class ThreadPool {
   // being destructed).
   absl::Status Schedule(std::function<void()> task);
 
-  // Returns true iff the work_queue_ has items to process, or the ThreadPool
-  // is closed. Intended to be used in a `absl::Condition`.
-  bool has_work_or_closed() ABSL_SHARED_LOCKS_REQUIRED(pool_mutex_);
-
   // Closes the ThreadPool to future work. After this call, all
-  // `Schedule` invocations will return FailedPrecondition errors.
+  // `Schedule` invocations will return FailedPrecondition errors. Work already
+  // scheduled will still be run.
   void Close();
 
+  // Returns the telemetry shared by all pools with this pool's name.
+  const ThreadPoolStats& stats() const { return *stats_; }
+
  private:
+  struct QueuedTask {
+    std::function<void()> task;
+    // Only set if the task was recorded in `stats_` when it was scheduled.
+    std::optional<absl::Time> scheduled_time;
+    // Position of the task in the pool-wide scheduling order.
+    uint64_t sequence = 0;
+  };
+
+  struct WorkerQueue {
+    absl::Mutex mutex;
+    std::deque<QueuedTask> local ABSL_GUARDED_BY(mutex);
+    std::deque<QueuedTask> inbox ABSL_GUARDED_BY(mutex);
+    // Set while the worker is about to sleep or sleeping, and cleared by
+    // whoever claims it to be woken.
+    std::atomic<bool> parked{false};
+    absl::Mutex park_mutex;
+    absl::CondVar park_cond_var;
+    bool woken ABSL_GUARDED_BY(park_mutex) = false;
+  };
+
+  // The body of the worker thread at `worker_index`.
+  void RunWorker(int32_t worker_index);
+  // Pops the next task for `worker_index` from its own queues, or steals one
+  // from another worker. Returns false if no task was found.
+  bool TryGetTask(int32_t worker_index, QueuedTask* task);
+  // Pops the older of the front tasks of `queue`'s local queue and inbox.
+  // Returns false if both are empty.
+  bool TryPopOldest(WorkerQueue& queue, QueuedTask* task);
+  // Wakes one sleeping worker, if any.
+  void WakeOne();
+  // Wakes every sleeping worker.
+  void WakeAll();
+  // Sleeps until `worker_index` is woken or has work to do.
+  void Park(int32_t worker_index);
+
+  // Returns true iff there are queued tasks, or the pool is closed and no
+  // `Schedule` call is in progress.
+  bool has_work_or_done() const;
+
   const std::string pool_name_;
-  absl::Mutex pool_mutex_;
-  bool closed_ ABSL_GUARDED_BY(pool_mutex_) = false;
-  std::vector<std::thread> threads_ ABSL_GUARDED_BY(pool_mutex_);
-  std::deque<std::function<void()>> work_queue_ ABSL_GUARDED_BY(pool_mutex_);
+  ThreadPoolStats* const stats_;
+  std::vector<std::unique_ptr<WorkerQueue>> queues_;
+  std::vector<std::thread> threads_;
+  // Round-robin counter for assigning externally scheduled tasks to inboxes.
+  std::atomic<uint32_t> next_inbox_{0};
+  // Source of `QueuedTask::sequence`. Only incremented while holding the lock
+  // of the queue the task is pushed to, so every queue is sorted by sequence.
+  std::atomic<uint64_t> next_sequence_{0};
+  // Number of tasks pushed to a queue and not yet popped.
+  std::atomic<int64_t> queued_tasks_{0};
+  // Number of `Schedule` calls that have passed the `closed_` check but not
+  // yet enqueued their task.
+  std::atomic<int32_t> schedules_in_progress_{0};
+  std::atomic<bool> closed_{false};
+  // Number of parked workers. Lets `Schedule` skip waking anyone without
+  // touching the per-worker parking state while all workers are busy.
+  std::atomic<int32_t> sleeping_workers_{0};
+};
+
+// Sets the number of threads kept by the process-wide default pool.
+//
+// The default pool runs work passed to `ThreadRun`, `Map` and `ParallelTasks`
+// without an explicit `ThreadPool`. It keeps up to `num_threads` threads alive
+// and queues work beyond that. Because work on the default pool may block on
+// other queued work (e.g. a `ThreadRun` waiting on another `ThreadRun`'s
+// future), the pool adds threads beyond `num_threads` when queued work makes
+// no progress for a short interval while some of its threads are inside a
+// `ScopedBlockingRegion`. Threads are added until `num_threads` threads are
+// not blocked, however many are blocked, and the extra threads exit once
+// idle.
+//
+// Non-positive values restore the default of four threads per CPU, and at
+// least 16 threads.
+void SetDefaultThreadPoolSize(int32_t num_threads);
+
+// Returns the number of threads kept by the process-wide default pool.
+int32_t GetDefaultThreadPoolSize();
+
+// Schedules `task` on the process-wide default pool.
+void ScheduleOnDefaultThreadPool(std::function<void()> task);
+
+// Marks the current thread as blocked on other work for the lifetime of this
+// object.
+//
+// The default pool only adds threads to replace workers that are blocked in
+// such a region; a worker that is merely running a long task is not replaced.
+// `Wait`, `WaitAll` and `ParallelTasks::WaitAll` enter a region themselves, so
+// code only needs to use this directly when it blocks by other means (e.g. on
+// an `absl::Notification`). Regions may nest. Outside the default pool this is
+// a no-op.
+class ScopedBlockingRegion {
+ public:
+  ScopedBlockingRegion();
+  ~ScopedBlockingRegion();
+
+  ScopedBlockingRegion(const ScopedBlockingRegion&) = delete;
+  ScopedBlockingRegion& operator=(const ScopedBlockingRegion&) = delete;
+
+ private:
+  bool active_ = false;
 };
 
 // Runs the provided provided no-arg function on another thread, returning a
 // future to the result.
 //
-// If `thread_pool` is `nullptr`, each task will be scheduled on a newly
-// created thread.  If `thread_pool` is not `nullptr`, will use the thread
-// pool to schedule tasks.
+// If `thread_pool` is `nullptr`, the task will be scheduled on the
+// process-wide default pool (see `SetDefaultThreadPoolSize`). If `thread_pool`
+// is not `nullptr`, will use the thread pool to schedule tasks.
 //
-// IMPORTANT: if the `thread_pool` argument is not nullptr, this method
+// IMPORTANT: either way the task runs on a shared pool, so this method
 // _requires_ that work scheduled to run only depends on (communicates with)
 // other `ThreadRun` calls via the returned futures. This ensures that the
 // threads won't arrive in deadlock because they form a DAG of dependencies and
 // are scheduled first-to-last. Introducing additional synchronization mechanism
-// between the work scheduled here needs to be _very_ careful.
+// between the work scheduled here needs to be _very_ careful; on the default
+// pool, any other blocking must happen inside a `ScopedBlockingRegion`.
+//
+// If `thread_pool` rejects the task (e.g. because it is closed), the returned
+// future holds the rejection status when the result is a `Status` or
+// `StatusOr`, and throws `std::future_error` otherwise.
 template <typename Func,
           typename ReturnValue = typename std::result_of_t<Func()>>
 std::shared_future<ReturnValue> ThreadRun(Func lambda,
@@ -98,18 +223,23 @@ std::shared_future<ReturnValue> ThreadRun(Func lambda,
   using TaskT = std::packaged_task<ReturnValue()>;
   TaskT task(std::move(lambda));
   auto future_ptr = std::shared_future<ReturnValue>(task.get_future());
+  // Attempting to directly move the task results in a compiler error,
+  // possibly when trying to construct the `std::function<void()>` which may
+  // be trying to make a _copy_ of the lambda capture values which are not
+  // always copy constructable (especially in the case of ExecutorValue).
+  // Wrapping in a `shared_ptr` makes this possible.
+  auto run = [t = std::make_shared<TaskT>(std::move(task))]() { (*t)(); };
   if (thread_pool != nullptr) {
-    // Attempting to directly move the task results in a compiler error,
-    // possibly when trying to construct the `std::function<void()>` which may
-    // be trying to make a _copy_ of the lambda capture values which are not
-    // always copy constructable (especially in the case of ExecutorValue).
-    // Wrapping in a `shared_ptr` makes this possible.
-    thread_pool
-        ->Schedule([t = std::make_shared<TaskT>(std::move(task))]() { (*t)(); })
-        .IgnoreError();
+    absl::Status status = thread_pool->Schedule(std::move(run));
+    if constexpr (std::is_constructible_v<ReturnValue, absl::Status>) {
+      if (!status.ok()) {
+        std::promise<ReturnValue> rejected;
+        rejected.set_value(ReturnValue(std::move(status)));
+        return rejected.get_future().share();
+      }
+    }
   } else {
-    std::thread th(std::move(task));
-    th.detach();
+    ScheduleOnDefaultThreadPool(std::move(run));
   }
   return future_ptr;
 }
@@ -119,7 +249,10 @@ std::shared_future<ReturnValue> ThreadRun(Func lambda,
 // as a StatusOr.
 template <typename ValueFuture>
 auto Wait(const ValueFuture& future) {
-  future.wait();
+  {
+    ScopedBlockingRegion blocking;
+    future.wait();
+  }
   const auto& result = future.get();
   using StatusOrValue = typename std::remove_reference<decltype(result)>::type;
   if (!result.ok()) {
@@ -129,10 +262,11 @@ auto Wait(const ValueFuture& future) {
 }
 
 // Extracts the `ExecutorValue`s from `successfully_completed_futures`.
-template <typename ExecutorValue>
-std::vector<ExecutorValue> GetAll(
-    const absl::Span<const std::shared_future<absl::StatusOr<ExecutorValue>>>
-        successfully_completed_futures) {
+template <typename ValueFuture>
+auto GetAll(
+    const absl::Span<const ValueFuture> successfully_completed_futures) {
+  using ExecutorValue = std::decay_t<
+      decltype(successfully_completed_futures[0].get().value())>;
   std::vector<ExecutorValue> out;
   out.reserve(successfully_completed_futures.size());
   for (auto& future : successfully_completed_futures) {
@@ -149,10 +283,10 @@ auto GetAll(const std::vector<ValueFuture>& futures) {
 
 // Waits for all of the futures in `futures` to complete, returning an error if
 // any of them fail.
-template <typename ExecutorValue>
-absl::StatusOr<std::vector<ExecutorValue>> WaitAll(
-    const absl::Span<const std::shared_future<absl::StatusOr<ExecutorValue>>>
-        futures) {
+template <typename ValueFuture>
+auto WaitAll(const absl::Span<const ValueFuture> futures)
+    -> absl::StatusOr<decltype(GetAll(futures))> {
+  ScopedBlockingRegion blocking;
   for (const auto& future : futures) {
     future.wait();
     if (!future.get().ok()) {
@@ -212,9 +346,13 @@ auto AllReady(const std::vector<ValueFuture>& futures) {
 // thread to await their results, and the `lambda` argument will be run on that
 // thread if and when `futures` all complete successfully.
 //
-// If `thread_pool` is `nullptr`, a new thread will be created for the lambda
-// that will await results. If `thread_pool` is not `nullptr`, the newly created
-// waiting lambda will be scheduled on the thread pool.
+// If `thread_pool` is `nullptr`, the waiting lambda will be scheduled on the
+// process-wide default pool. If `thread_pool` is not `nullptr`, the newly
+// created waiting lambda will be scheduled on the thread pool.
+//
+// The waiting lambda parks a thread until `futures` complete. Executors whose
+// values are `ContinuationFuture`s get the non-blocking `Map`, `MapAsync` and
+// `MapCancellable` from `continuation_future.h` instead.
 template <typename Func, typename ValueFuture>
 absl::StatusOr<ValueFuture> Map(std::vector<ValueFuture>&& futures, Func lambda,
                                 ThreadPool* thread_pool = nullptr) {
@@ -231,6 +369,140 @@ absl::StatusOr<ValueFuture> Map(std::vector<ValueFuture>&& futures, Func lambda,
       thread_pool);
 }
 
+// A cancellation flag shared between a group of tasks and their owner.
+//
+// Copies share the same flag. Cancellation is cooperative: long-running tasks
+// are expected to poll `IsCancelled` and return early, or to register a
+// `CancellationCallback` which interrupts blocking work (e.g. an RPC).
+class CancellationToken {
+ public:
+  CancellationToken() : state_(std::make_shared<State>()) {}
+
+  // Signals cancellation to all holders of this token, running any registered
+  // `CancellationCallback`s on this thread. Only the first call has an effect.
+  void Cancel() const;
+
+  // Returns true iff `Cancel` has been called on any copy of this token.
+  bool IsCancelled() const {
+    return state_->cancelled.load(std::memory_order_acquire);
+  }
+
+ private:
+  friend class CancellationCallback;
+
+  struct State {
+    std::atomic<bool> cancelled{false};
+    absl::Mutex mutex;
+    uint64_t next_callback_id ABSL_GUARDED_BY(mutex) = 0;
+    absl::flat_hash_map<uint64_t, std::function<void()>> callbacks
+        ABSL_GUARDED_BY(mutex);
+  };
+
+  std::shared_ptr<State> state_;
+};
+
+// Runs a callback if a `CancellationToken` is cancelled while this object is
+// alive.
+//
+// If the token is already cancelled, the callback runs immediately in the
+// constructor. Otherwise it runs on the thread calling `Cancel`. The destructor
+// waits for a concurrently running callback to finish, so the callback may
+// safely reference objects which outlive this `CancellationCallback`. The
+// callback must not itself cancel the token or destroy this object.
+class CancellationCallback {
+ public:
+  CancellationCallback(const CancellationToken& token,
+                       std::function<void()> callback);
+  ~CancellationCallback();
+
+  CancellationCallback(const CancellationCallback&) = delete;
+  CancellationCallback& operator=(const CancellationCallback&) = delete;
+
+ private:
+  std::shared_ptr<CancellationToken::State> state_;
+  // Unset if the callback ran in the constructor.
+  std::optional<uint64_t> id_;
+};
+
+// A shared future which cancels the work producing its value once every copy
+// of it has been destroyed.
+//
+// `Future` is the wrapped future type: a `std::shared_future` by default, or a
+// `ContinuationFuture` (see `CancellableContinuationFuture`). The `valid`,
+// `wait`, `wait_for` and `get` methods mirror `std::shared_future`, so `Wait`,
+// `WaitAll`, `AllReady` and `Map` accept `CancellableFuture`s as well. A
+// `CancellableFuture` may also wrap a plain `Future` (e.g. from `ReadyFuture`
+// or `ThreadRun`), in which case dropping it cancels nothing.
+//
+// Work that depends on a pending value should capture a copy of its future, or
+// of its `keep_alive()` handle, which keeps the value's computation from being
+// cancelled until the dependent work is done with it.
+template <typename T, typename Future = std::shared_future<T>>
+class CancellableFuture {
+ public:
+  CancellableFuture() = default;
+  // Implicit so that `Future`-returning helpers can produce uncancellable
+  // values.
+  CancellableFuture(Future future)  // NOLINT
+      : future_(std::move(future)) {}
+  // Cancels `token` when the last copy of this future is destroyed.
+  CancellableFuture(Future future, CancellationToken token)
+      : future_(std::move(future)),
+        canceller_(std::make_shared<Canceller>(std::move(token))) {}
+
+  bool valid() const { return future_.valid(); }
+  void wait() const { future_.wait(); }
+  template <typename Rep, typename Period>
+  std::future_status wait_for(
+      const std::chrono::duration<Rep, Period>& timeout) const {
+    return future_.wait_for(timeout);
+  }
+  const T& get() const { return future_.get(); }
+
+  // Returns the wrapped future.
+  const Future& future() const { return future_; }
+
+  // Returns a handle which, while held, keeps the work producing this value
+  // from being cancelled. Unlike a copy of this future, it does not refer to
+  // the value itself.
+  std::shared_ptr<const void> keep_alive() const { return canceller_; }
+
+ private:
+  struct Canceller {
+    explicit Canceller(CancellationToken token) : token(std::move(token)) {}
+    ~Canceller() { token.Cancel(); }
+    CancellationToken token;
+  };
+
+  Future future_;
+  std::shared_ptr<Canceller> canceller_;
+};
+
+// Like `ThreadRun`, but the work is cancelled once every copy of the returned
+// future has been destroyed, e.g. when the value it produces is disposed of
+// before being used.
+//
+// `lambda` is passed a `CancellationToken` which it may poll, or attach a
+// `CancellationCallback` to, in order to abandon work that is no longer
+// needed. If the token is cancelled before `lambda` starts, `lambda` is not run
+// at all and the future holds a `Cancelled` error.
+template <typename Func, typename ReturnValue = typename std::invoke_result_t<
+                             Func, const CancellationToken&>>
+CancellableFuture<ReturnValue> ThreadRunCancellable(
+    Func lambda, ThreadPool* thread_pool = nullptr) {
+  CancellationToken token;
+  std::shared_future<ReturnValue> future = ThreadRun(
+      [token, lambda = std::move(lambda)]() mutable -> ReturnValue {
+        if (token.IsCancelled()) {
+          return absl::CancelledError(
+              "Value was disposed of before its computation started.");
+        }
+        return lambda(token);
+      },
+      thread_pool);
+  return CancellableFuture<ReturnValue>(std::move(future), std::move(token));
+}
+
 class ParallelTasksInner_ {
  private:
   friend class ParallelTasks;
@@ -238,6 +510,9 @@ class ParallelTasksInner_ {
   absl::Mutex mutex_;
   absl::Status status_ ABSL_GUARDED_BY(mutex_) = absl::OkStatus();
   uint32_t remaining_tasks_ ABSL_GUARDED_BY(mutex_) = 0;
+  // When set, the first task error cancels `cancellation_token_`.
+  bool cancel_on_error_ ABSL_GUARDED_BY(mutex_) = false;
+  const CancellationToken cancellation_token_;
 };
 
 // A group of `absl::Status`-returning functions to be run in parallel.
@@ -245,23 +520,26 @@ class ParallelTasks {
  public:
   // Creates a ParallelTasks object.
   //
-  // If `thread_pool` is `nullptr`, each task will be scheduled on a newly
-  // created thread.  If `thread_pool` is not `nullptr`, will use the thread
-  // pool to schedule tasks.
+  // If `thread_pool` is `nullptr`, each task will be scheduled on the
+  // process-wide default pool. If `thread_pool` is not `nullptr`, will use the
+  // thread pool to schedule tasks.
   //
-  // IMPORTANT: if the `thread_pool` argument is not nullptr, this method
+  // IMPORTANT: either way the tasks run on a shared pool, so this method
   // _requires_ that work scheduled to run only depends on (communicates with)
   // other `ThreadRun` calls via the returned futures. This ensures that the
   // threads won't arrive in deadlock because they form a DAG of dependencies
   // and are scheduled first-to-last. Introducing additional synchronization
-  // mechanism between the work scheduled here needs to be _very_ careful.
+  // mechanism between the work scheduled here needs to be _very_ careful; on
+  // the default pool, any other blocking must happen inside a
+  // `ScopedBlockingRegion`.
   explicit ParallelTasks(ThreadPool* thread_pool = nullptr)
       : shared_inner_(std::make_shared<ParallelTasksInner_>()),
         thread_pool_(thread_pool) {}
 
   // Move constructor.
   ParallelTasks(ParallelTasks&& other)
-      : shared_inner_(std::move(other.shared_inner_)) {}
+      : shared_inner_(std::move(other.shared_inner_)),
+        thread_pool_(other.thread_pool_) {}
 
   // Move assignment not provided.
   // Note: this would need to wait for the previous tasks (if any) to complete
@@ -278,8 +556,21 @@ class ParallelTasks {
   }
 
   // Spawns a thread to run a function and adds it to the parallel task group.
+  //
+  // If the group has been cancelled by the time the task is started, the task
+  // is not run and records a `Cancelled` error instead.
   absl::Status add_task(std::function<absl::Status()> task);
 
+  // Returns the token cancelled by `Cancel` or a failing task during
+  // `WaitAllFailFast`. Tasks may capture a copy and poll it to stop early.
+  const CancellationToken& cancellation_token() const {
+    return shared_inner_->cancellation_token_;
+  }
+
+  // Cancels the group: tasks which have not started yet are skipped, and
+  // running tasks observe `cancellation_token().IsCancelled()`.
+  void Cancel() { shared_inner_->cancellation_token_.Cancel(); }
+
   // Waits until all tasks passed to `add_task` have successfully completed.
   //
   // Returns an `absl::Status` containing the first non-`ok` result of a task,
@@ -290,11 +581,29 @@ class ParallelTasks {
   // which `WaitAll` was invoked.
   absl::Status WaitAll();
 
+  // Like `WaitAll`, but cancels the group as soon as any task fails (including
+  // failures that happened before this call), so that remaining tasks are
+  // skipped or can stop early.
+  //
+  // Note: like `WaitAll`, this still waits for every task to finish or be
+  // skipped before returning, so tasks may continue to reference local
+  // variables of the calling scope.
+  absl::Status WaitAllFailFast();
+
  private:
   std::shared_ptr<ParallelTasksInner_> shared_inner_;
   ThreadPool* thread_pool_ = nullptr;
 };
 
+// Calls `fn(i)` for each `i` in `[0, n)` in parallel on the process-wide
+// default pool, on no more tasks than the pool keeps threads, rather than
+// queueing one task per index. Once a call fails, the remaining indices are
+// skipped and its error returned.
+//
+// Like `ParallelTasks::WaitAll`, this returns only once no call of `fn` is
+// running, so `fn` may reference local variables of the caller.
+absl::Status ParallelFor(size_t n, absl::FunctionRef<absl::Status(size_t)> fn);
+
 }  // namespace tensorflow_federated
 
 #endif  // THIRD_PARTY_TENSORFLOW_FEDERATED_CC_CORE_IMPL_EXECUTORS_THREADING_H_
@@ -16,18 +16,23 @@ limitations under the License
 #include "tensorflow_federated/cc/core/impl/executors/threading.h"
 
 #include <atomic>
+#include <cstddef>
 #include <cstdint>
+#include <future>  // NOLINT
+#include <thread>  // NOLINT
 #include <vector>
 
 #include "googlemock/include/gmock/gmock.h"
 #include "googletest/include/gtest/gtest.h"
 #include "absl/base/thread_annotations.h"
 #include "absl/status/status.h"
+#include "absl/status/statusor.h"
 #include "absl/synchronization/blocking_counter.h"
 #include "absl/synchronization/mutex.h"
 #include "absl/synchronization/notification.h"
 #include "absl/time/clock.h"
 #include "absl/time/time.h"
+#include "tensorflow_federated/cc/core/impl/base/thread_pool_stats.h"
 #include "tensorflow_federated/cc/testing/status_matchers.h"
 
 namespace tensorflow_federated {
@@ -108,6 +113,72 @@ TEST_F(ThreadPoolTest, MultipleThreads) {
   ASSERT_THAT(results, testing::UnorderedElementsAreArray(expected_results));
 }
 
+TEST_F(ThreadPoolTest, SingleThreadNestedWorkIsFIFO) {
+  constexpr int32_t NUM_WORK = 5;
+  ThreadPool pool(/*num_threads=*/1, /*name=*/"test");
+  std::vector<int32_t> results;
+  absl::BlockingCounter blocking_counter(NUM_WORK);
+  TFF_ASSERT_OK(pool.Schedule([&pool, &results, &blocking_counter]() {
+    for (int i = 0; i < NUM_WORK; ++i) {
+      TFF_ASSERT_OK(pool.Schedule([&results, &blocking_counter, i]() {
+        results.push_back(i);
+        blocking_counter.DecrementCount();
+      }));
+    }
+  }));
+  blocking_counter.Wait();
+  EXPECT_THAT(results, testing::ElementsAre(0, 1, 2, 3, 4));
+}
+
+TEST_F(ThreadPoolTest, SingleThreadNestedWorkRunsAfterEarlierExternalWork) {
+  ThreadPool pool(/*num_threads=*/1, /*name=*/"test");
+  absl::Notification external_scheduled;
+  std::shared_future<int32_t> external;
+  std::shared_future<int32_t> nested;
+  absl::Notification nested_scheduled;
+  TFF_ASSERT_OK(pool.Schedule(
+      [&pool, &external_scheduled, &external, &nested, &nested_scheduled]() {
+        external_scheduled.WaitForNotification();
+        // Scheduled after `external`, and blocks on it, so `external` must
+        // run first even though this task lands on the worker's local queue.
+        nested = ThreadRun([&external]() { return external.get() + 1; },
+                           &pool);
+        nested_scheduled.Notify();
+      }));
+  external = ThreadRun([]() -> int32_t { return 1; }, &pool);
+  external_scheduled.Notify();
+  nested_scheduled.WaitForNotification();
+  EXPECT_EQ(nested.get(), 2);
+}
+
+TEST_F(ThreadPoolTest, IdleWorkerStealsNestedWork) {
+  ThreadPool pool(/*num_threads=*/2, /*name=*/"test");
+  absl::Notification stolen_task_ran;
+  absl::Notification done;
+  TFF_ASSERT_OK(pool.Schedule([&pool, &stolen_task_ran, &done]() {
+    // The nested task lands on this worker's local queue; since this worker
+    // blocks until it has run, it must be stolen by the other worker.
+    TFF_ASSERT_OK(
+        pool.Schedule([&stolen_task_ran]() { stolen_task_ran.Notify(); }));
+    stolen_task_ran.WaitForNotification();
+    done.Notify();
+  }));
+  done.WaitForNotification();
+}
+
+TEST_F(ThreadPoolTest, CloseRunsAlreadyScheduledWork) {
+  constexpr int32_t NUM_WORK = 100;
+  std::atomic<int32_t> counter(0);
+  {
+    ThreadPool pool(/*num_threads=*/4, /*name=*/"test");
+    for (int i = 0; i < NUM_WORK; ++i) {
+      TFF_ASSERT_OK(pool.Schedule([&counter]() { counter.fetch_add(1); }));
+    }
+    pool.Close();
+  }
+  EXPECT_EQ(counter.load(), NUM_WORK);
+}
+
 TEST_F(ThreadPoolTest, ShuttingDownPoolErrorsOnSchedule) {
   ThreadPool pool(/*num_threads=*/1, /*name=*/"test");
   pool.Close();
@@ -116,6 +187,142 @@ TEST_F(ThreadPoolTest, ShuttingDownPoolErrorsOnSchedule) {
                        testing::HasSubstr("closed")));
 }
 
+TEST_F(ThreadPoolTest, ThreadRunOnClosedPoolReturnsRejection) {
+  ThreadPool pool(/*num_threads=*/1, /*name=*/"test");
+  pool.Close();
+  EXPECT_THAT(ThreadRun([]() -> absl::StatusOr<int32_t> { return 1; }, &pool)
+                  .get(),
+              StatusIs(absl::StatusCode::kFailedPrecondition,
+                       testing::HasSubstr("closed")));
+  EXPECT_THAT(ThreadRun([]() { return absl::OkStatus(); }, &pool).get(),
+              StatusIs(absl::StatusCode::kFailedPrecondition));
+}
+
+TEST_F(ThreadPoolTest, ReportsStats) {
+  constexpr int32_t NUM_WORK = 10;
+  SetThreadPoolStatsEnabled(true);
+  {
+    ThreadPool pool(/*num_threads=*/2, /*name=*/"stats_test");
+    EXPECT_EQ(pool.stats().Snapshot().num_threads, 2);
+    for (int i = 0; i < NUM_WORK; ++i) {
+      TFF_ASSERT_OK(pool.Schedule(
+          []() { absl::SleepFor(absl::Milliseconds(1)); }));
+    }
+    pool.Close();
+    EXPECT_THAT(pool.Schedule([]() {}),
+                StatusIs(absl::StatusCode::kFailedPrecondition));
+  }
+  ThreadPoolStatsSnapshot stats = GetThreadPoolStats("stats_test")->Snapshot();
+  EXPECT_EQ(stats.num_threads, 0);
+  EXPECT_EQ(stats.scheduled_tasks, NUM_WORK);
+  EXPECT_EQ(stats.completed_tasks, NUM_WORK);
+  EXPECT_EQ(stats.rejected_tasks, 1);
+  EXPECT_EQ(stats.queue_depth, 0);
+  EXPECT_EQ(stats.active_workers, 0);
+  EXPECT_GE(stats.max_queue_depth, 1);
+  EXPECT_LE(stats.max_active_workers, 2);
+  EXPECT_EQ(stats.queue_time_us.count, NUM_WORK);
+  EXPECT_GE(stats.run_time_us.sum, NUM_WORK * 1000);
+  SetThreadPoolStatsEnabled(false);
+}
+
+TEST_F(ThreadPoolTest, DoesNotRecordTasksWhileStatsAreDisabled) {
+  {
+    ThreadPool pool(/*num_threads=*/2, /*name=*/"disabled_stats_test");
+    EXPECT_EQ(pool.stats().Snapshot().num_threads, 2);
+    for (int i = 0; i < 10; ++i) {
+      TFF_ASSERT_OK(pool.Schedule([]() {}));
+    }
+    pool.Close();
+  }
+  ThreadPoolStatsSnapshot stats =
+      GetThreadPoolStats("disabled_stats_test")->Snapshot();
+  EXPECT_EQ(stats.num_threads, 0);
+  EXPECT_EQ(stats.scheduled_tasks, 0);
+  EXPECT_EQ(stats.completed_tasks, 0);
+  EXPECT_EQ(stats.run_time_us.count, 0);
+}
+
+class DefaultThreadPoolTest : public ::testing::Test {
+ protected:
+  ~DefaultThreadPoolTest() override {
+    SetDefaultThreadPoolSize(/*num_threads=*/0);
+  }
+};
+
+TEST_F(DefaultThreadPoolTest, SetSize) {
+  SetDefaultThreadPoolSize(/*num_threads=*/3);
+  EXPECT_EQ(GetDefaultThreadPoolSize(), 3);
+  SetDefaultThreadPoolSize(/*num_threads=*/0);
+  EXPECT_GT(GetDefaultThreadPoolSize(), 0);
+}
+
+TEST_F(DefaultThreadPoolTest, GrowsWhenAllThreadsBlockOnQueuedWork) {
+  SetDefaultThreadPoolSize(/*num_threads=*/1);
+  absl::Notification event;
+  absl::BlockingCounter counter(2);
+  // The first task occupies the only thread until the second task runs, which
+  // requires the pool to grow.
+  ScheduleOnDefaultThreadPool([&event, &counter]() {
+    ScopedBlockingRegion blocking;
+    event.WaitForNotification();
+    counter.DecrementCount();
+  });
+  ScheduleOnDefaultThreadPool([&event, &counter]() {
+    event.Notify();
+    counter.DecrementCount();
+  });
+  counter.Wait();
+}
+
+TEST_F(DefaultThreadPoolTest, GrowsWhileAllThreadsBlockOnMutexAwait) {
+  constexpr int32_t NUM_WORK = 16;
+  SetDefaultThreadPoolSize(/*num_threads=*/4);
+  // Like a batched call waiting for its batch, every task waits on a mutex
+  // condition that only holds once all of them are running.
+  absl::Mutex mutex;
+  int32_t arrived = 0;
+  absl::BlockingCounter counter(NUM_WORK);
+  for (int32_t i = 0; i < NUM_WORK; ++i) {
+    ScheduleOnDefaultThreadPool([&mutex, &arrived, &counter]() {
+      {
+        absl::MutexLock lock(&mutex);
+        ++arrived;
+        auto all_arrived = [&arrived]() { return arrived == NUM_WORK; };
+        ScopedBlockingRegion blocking;
+        mutex.Await(absl::Condition(&all_arrived));
+      }
+      counter.DecrementCount();
+    });
+  }
+  counter.Wait();
+}
+
+TEST_F(DefaultThreadPoolTest, GrowsWhileAllThreadsBlockOnNestedWork) {
+  constexpr int32_t NUM_WORK = 64;
+  SetDefaultThreadPoolSize(/*num_threads=*/2);
+  // Every task blocks on a task queued behind all of the others, so all of
+  // them must be running at once before any can finish.
+  ParallelTasks tasks;
+  for (int32_t i = 0; i < NUM_WORK; ++i) {
+    TFF_ASSERT_OK(tasks.add_task([i]() -> absl::Status {
+      int32_t result = Wait(ThreadRun([i]() -> absl::StatusOr<int32_t> {
+                              return i;
+                            })).value();
+      if (result != i) {
+        return absl::InternalError("Unexpected result");
+      }
+      return absl::OkStatus();
+    }));
+  }
+  EXPECT_THAT(tasks.WaitAll(), IsOk());
+}
+
+TEST_F(DefaultThreadPoolTest, ThreadRunWithoutPool) {
+  std::shared_future<int32_t> future = ThreadRun([]() { return 5; });
+  EXPECT_EQ(future.get(), 5);
+}
+
 class ParallelTasksTest : public ::testing::Test {};
 
 TEST_F(ParallelTasksTest, EmptyIsOk) {
@@ -142,6 +349,15 @@ TEST_F(ParallelTasksTest, OneOkOneErrorIsError) {
   EXPECT_THAT(tasks.WaitAll(), StatusIs(StatusCode::kUnimplemented));
 }
 
+TEST_F(ParallelTasksTest, ScheduleFailureDoesNotHangWaitAll) {
+  ThreadPool pool(/*num_threads=*/1, /*name=*/"test");
+  pool.Close();
+  ParallelTasks tasks(&pool);
+  EXPECT_THAT(tasks.add_task([]() { return absl::OkStatus(); }),
+              StatusIs(StatusCode::kFailedPrecondition));
+  EXPECT_THAT(tasks.WaitAll(), StatusIs(StatusCode::kFailedPrecondition));
+}
+
 TEST_F(ParallelTasksTest, ParallelTasksWaitsForAll) {
   const int32_t NUM_TASKS = 5000;
   std::atomic<int32_t> counter(0);
@@ -181,6 +397,229 @@ TEST_F(ParallelTasksTest, WithThreadPool) {
   EXPECT_EQ(counter.load(), NUM_THREADS * 2);
 }
 
+TEST_F(ParallelTasksTest, CancelSkipsTasksNotYetStarted) {
+  ThreadPool thread_pool(/*num_threads=*/1, /*name=*/"test");
+  absl::Notification started;
+  absl::Notification release;
+  std::atomic<int32_t> counter(0);
+  ParallelTasks tasks(&thread_pool);
+  TFF_ASSERT_OK(tasks.add_task([&started, &release]() {
+    started.Notify();
+    release.WaitForNotification();
+    return absl::OkStatus();
+  }));
+  TFF_ASSERT_OK(tasks.add_task([&counter]() {
+    counter.fetch_add(1);
+    return absl::OkStatus();
+  }));
+  started.WaitForNotification();
+  tasks.Cancel();
+  release.Notify();
+  EXPECT_THAT(tasks.WaitAll(), StatusIs(StatusCode::kCancelled));
+  EXPECT_EQ(counter.load(), 0);
+}
+
+TEST_F(ParallelTasksTest, WaitAllFailFastSkipsRemainingTasks) {
+  constexpr int32_t NUM_TASKS = 10;
+  ThreadPool thread_pool(/*num_threads=*/1, /*name=*/"test");
+  absl::Notification release;
+  std::atomic<int32_t> counter(0);
+  ParallelTasks tasks(&thread_pool);
+  TFF_ASSERT_OK(tasks.add_task([&release]() {
+    release.WaitForNotification();
+    return absl::OkStatus();
+  }));
+  TFF_ASSERT_OK(tasks.add_task([]() { return absl::UnimplementedError(""); }));
+  for (int32_t i = 0; i < NUM_TASKS; i++) {
+    TFF_ASSERT_OK(tasks.add_task([&counter]() {
+      counter.fetch_add(1);
+      return absl::OkStatus();
+    }));
+  }
+  std::thread releaser([&release]() {
+    absl::SleepFor(absl::Milliseconds(100));
+    release.Notify();
+  });
+  EXPECT_THAT(tasks.WaitAllFailFast(), StatusIs(StatusCode::kUnimplemented));
+  releaser.join();
+  EXPECT_EQ(counter.load(), 0);
+  EXPECT_TRUE(tasks.cancellation_token().IsCancelled());
+}
+
+TEST_F(ParallelTasksTest, WaitAllFailFastCancelsRunningTasks) {
+  ParallelTasks tasks;
+  CancellationToken token = tasks.cancellation_token();
+  TFF_ASSERT_OK(tasks.add_task([token]() {
+    while (!token.IsCancelled()) {
+      absl::SleepFor(absl::Milliseconds(1));
+    }
+    return absl::CancelledError("");
+  }));
+  TFF_ASSERT_OK(tasks.add_task([]() { return absl::UnimplementedError(""); }));
+  EXPECT_THAT(tasks.WaitAllFailFast(), StatusIs(StatusCode::kUnimplemented));
+}
+
+TEST_F(ParallelTasksTest, WaitAllDoesNotCancelOnError) {
+  std::atomic<int32_t> counter(0);
+  ParallelTasks tasks;
+  TFF_ASSERT_OK(tasks.add_task([]() { return absl::UnimplementedError(""); }));
+  TFF_ASSERT_OK(tasks.add_task([&counter]() {
+    counter.fetch_add(1);
+    return absl::OkStatus();
+  }));
+  EXPECT_THAT(tasks.WaitAll(), StatusIs(StatusCode::kUnimplemented));
+  EXPECT_EQ(counter.load(), 1);
+  EXPECT_FALSE(tasks.cancellation_token().IsCancelled());
+}
+
+class ParallelForTest : public ::testing::Test {};
+
+TEST_F(ParallelForTest, CallsEachIndexOnce) {
+  constexpr int32_t NUM_WORK = 1000;
+  std::vector<std::atomic<int32_t>> calls(NUM_WORK);
+  EXPECT_THAT(ParallelFor(NUM_WORK,
+                          [&calls](size_t i) {
+                            calls[i].fetch_add(1);
+                            return absl::OkStatus();
+                          }),
+              IsOk());
+  for (const std::atomic<int32_t>& count : calls) {
+    EXPECT_EQ(count.load(), 1);
+  }
+}
+
+TEST_F(ParallelForTest, EmptyIsOk) {
+  EXPECT_THAT(ParallelFor(0, [](size_t) { return absl::InternalError(""); }),
+              IsOk());
+}
+
+TEST_F(ParallelForTest, ErrorSkipsRemainingIndices) {
+  constexpr int32_t NUM_WORK = 100000;
+  std::atomic<int32_t> num_calls(0);
+  EXPECT_THAT(ParallelFor(NUM_WORK,
+                          [&num_calls](size_t i) -> absl::Status {
+                            num_calls.fetch_add(1);
+                            if (i == 0) {
+                              return absl::InternalError("first");
+                            }
+                            absl::SleepFor(absl::Microseconds(10));
+                            return absl::OkStatus();
+                          }),
+              StatusIs(StatusCode::kInternal, "first"));
+  EXPECT_LT(num_calls.load(), NUM_WORK);
+}
+
+class CancellationTest : public ::testing::Test {};
+
+TEST_F(CancellationTest, CallbackRunsOnCancel) {
+  CancellationToken token;
+  int32_t calls = 0;
+  {
+    CancellationCallback callback(token, [&calls]() { ++calls; });
+    EXPECT_EQ(calls, 0);
+    token.Cancel();
+    EXPECT_EQ(calls, 1);
+    token.Cancel();
+    EXPECT_EQ(calls, 1);
+  }
+  EXPECT_TRUE(token.IsCancelled());
+}
+
+TEST_F(CancellationTest, CallbackRunsImmediatelyIfAlreadyCancelled) {
+  CancellationToken token;
+  token.Cancel();
+  int32_t calls = 0;
+  CancellationCallback callback(token, [&calls]() { ++calls; });
+  EXPECT_EQ(calls, 1);
+}
+
+TEST_F(CancellationTest, DestroyedCallbackDoesNotRun) {
+  CancellationToken token;
+  int32_t calls = 0;
+  { CancellationCallback callback(token, [&calls]() { ++calls; }); }
+  token.Cancel();
+  EXPECT_EQ(calls, 0);
+}
+
+TEST_F(CancellationTest, DroppingFutureSkipsQueuedWork) {
+  ThreadPool pool(/*num_threads=*/1, /*name=*/"test");
+  absl::Notification release;
+  auto blocker = ThreadRun([&release]() { release.WaitForNotification(); },
+                           &pool);
+  std::atomic<int32_t> runs(0);
+  {
+    CancellableFuture<absl::Status> future = ThreadRunCancellable(
+        [&runs](const CancellationToken&) {
+          runs.fetch_add(1);
+          return absl::OkStatus();
+        },
+        &pool);
+  }
+  release.Notify();
+  // The pool runs tasks in order, so this completes after the skipped task.
+  ThreadRun([]() {}, &pool).wait();
+  EXPECT_EQ(runs.load(), 0);
+}
+
+TEST_F(CancellationTest, CopiesKeepWorkAlive) {
+  ThreadPool pool(/*num_threads=*/1, /*name=*/"test");
+  absl::Notification release;
+  auto blocker = ThreadRun([&release]() { release.WaitForNotification(); },
+                           &pool);
+  CancellableFuture<absl::StatusOr<int32_t>> copy;
+  {
+    CancellableFuture<absl::StatusOr<int32_t>> future = ThreadRunCancellable(
+        [](const CancellationToken&) -> absl::StatusOr<int32_t> { return 7; },
+        &pool);
+    copy = future;
+  }
+  release.Notify();
+  EXPECT_THAT(Wait(copy), IsOkAndHolds(7));
+}
+
+TEST_F(CancellationTest, DroppingFutureCancelsRunningWork) {
+  absl::Notification started;
+  absl::Notification cancelled;
+  {
+    CancellableFuture<absl::Status> future = ThreadRunCancellable(
+        [&started, &cancelled](const CancellationToken& token) {
+          CancellationCallback callback(token,
+                                        [&cancelled]() { cancelled.Notify(); });
+          started.Notify();
+          cancelled.WaitForNotification();
+          return absl::CancelledError("");
+        });
+    started.WaitForNotification();
+  }
+  EXPECT_TRUE(cancelled.WaitForNotificationWithTimeout(absl::Seconds(10)));
+}
+
+TEST_F(CancellationTest, WaitAllAcceptsCancellableFutures) {
+  std::vector<CancellableFuture<absl::StatusOr<int32_t>>> futures;
+  for (int32_t i = 0; i < 3; ++i) {
+    futures.push_back(ThreadRunCancellable(
+        [i](const CancellationToken&) -> absl::StatusOr<int32_t> {
+          return i;
+        }));
+  }
+  EXPECT_THAT(WaitAll(futures),
+              IsOkAndHolds(::testing::ElementsAre(0, 1, 2)));
+}
+
+TEST_F(CancellationTest, MapAcceptsCancellableFutures) {
+  using IntFuture = CancellableFuture<absl::StatusOr<int32_t>>;
+  std::vector<IntFuture> futures;
+  futures.push_back(ThreadRunCancellable(
+      [](const CancellationToken&) -> absl::StatusOr<int32_t> { return 2; }));
+  absl::StatusOr<IntFuture> mapped =
+      Map(std::move(futures),
+          [](std::vector<int32_t>&& values) -> absl::StatusOr<int32_t> {
+            return values[0] * 3;
+          });
+  TFF_ASSERT_OK(mapped);
+  EXPECT_THAT(Wait(*mapped), IsOkAndHolds(6));
+}
+
 }  // namespace
 
 }  // namespace tensorflow_federated
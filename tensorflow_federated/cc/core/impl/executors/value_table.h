@@ -0,0 +1,143 @@
+/* Copyright 2026, The TensorFlow Federated Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+     http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License
+==============================================================================*/
+
+#ifndef THIRD_PARTY_TENSORFLOW_FEDERATED_CC_CORE_IMPL_EXECUTORS_VALUE_TABLE_H_
+#define THIRD_PARTY_TENSORFLOW_FEDERATED_CC_CORE_IMPL_EXECUTORS_VALUE_TABLE_H_
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
+
+namespace tensorflow_federated {
+
+// A thread-safe table assigning sequential integer IDs to values.
+//
+// The table is split into `kNumShards` shards, each a hash map guarded by its
+// own mutex, and consecutive IDs are assigned to consecutive shards. Threads
+// creating, reading and disposing of different values therefore rarely contend
+// on the same lock, and allocating an ID is a single atomic increment. Erased
+// values are destroyed after their shard's lock is released, so destructors
+// that cascade into other work do not block other users of the shard.
+template <typename Id, typename Value>
+class ShardedValueTable {
+ public:
+  static constexpr size_t kNumShards = 16;
+
+  ShardedValueTable() = default;
+  ShardedValueTable(const ShardedValueTable&) = delete;
+  ShardedValueTable& operator=(const ShardedValueTable&) = delete;
+
+  // Stores `value` under a newly allocated ID and returns that ID.
+  Id Insert(Value value) {
+    const Id id = next_id_.fetch_add(1, std::memory_order_relaxed);
+    Shard& shard = ShardFor(id);
+    absl::MutexLock lock(&shard.mutex);
+    shard.values.emplace(id, std::move(value));
+    return id;
+  }
+
+  // Stores `values` under consecutive newly allocated IDs and returns the ID
+  // of the first. Each shard is locked once for the whole batch.
+  Id InsertBatch(std::vector<Value> values) {
+    const size_t num_values = values.size();
+    const Id first_id =
+        next_id_.fetch_add(num_values, std::memory_order_relaxed);
+    for (size_t offset = 0; offset < kNumShards && offset < num_values;
+         ++offset) {
+      Shard& shard = ShardFor(first_id + offset);
+      absl::MutexLock lock(&shard.mutex);
+      for (size_t i = offset; i < num_values; i += kNumShards) {
+        shard.values.emplace(first_id + i, std::move(values[i]));
+      }
+    }
+    return first_id;
+  }
+
+  // Returns a copy of the value stored under `id`, or `std::nullopt` if there
+  // is none.
+  std::optional<Value> Get(Id id) const {
+    const Shard& shard = ShardFor(id);
+    absl::ReaderMutexLock lock(&shard.mutex);
+    auto iter = shard.values.find(id);
+    if (iter == shard.values.end()) {
+      return std::nullopt;
+    }
+    return iter->second;
+  }
+
+  // Removes the value stored under `id`. Returns false if there was none.
+  bool Erase(Id id) {
+    Shard& shard = ShardFor(id);
+    typename Map::node_type node;
+    {
+      absl::MutexLock lock(&shard.mutex);
+      auto iter = shard.values.find(id);
+      if (iter == shard.values.end()) {
+        return false;
+      }
+      node = shard.values.extract(iter);
+    }
+    // `node` (and the value it owns) is destroyed here, outside the lock.
+    return true;
+  }
+
+  // Removes all values. IDs are not reused.
+  void Clear() {
+    for (Shard& shard : shards_) {
+      Map values;
+      {
+        absl::MutexLock lock(&shard.mutex);
+        values.swap(shard.values);
+      }
+    }
+  }
+
+  // Returns the number of values currently stored. Only approximate while
+  // other threads are modifying the table.
+  size_t size() const {
+    size_t total = 0;
+    for (const Shard& shard : shards_) {
+      absl::ReaderMutexLock lock(&shard.mutex);
+      total += shard.values.size();
+    }
+    return total;
+  }
+
+ private:
+  using Map = absl::flat_hash_map<Id, Value>;
+
+  // Aligned to avoid false sharing between the mutexes of adjacent shards.
+  struct alignas(64) Shard {
+    mutable absl::Mutex mutex;
+    Map values ABSL_GUARDED_BY(mutex);
+  };
+
+  Shard& ShardFor(Id id) { return shards_[id % kNumShards]; }
+  const Shard& ShardFor(Id id) const { return shards_[id % kNumShards]; }
+
+  std::atomic<Id> next_id_{0};
+  std::array<Shard, kNumShards> shards_;
+};
+
+}  // namespace tensorflow_federated
+
+#endif  // THIRD_PARTY_TENSORFLOW_FEDERATED_CC_CORE_IMPL_EXECUTORS_VALUE_TABLE_H_
@@ -0,0 +1,115 @@
+/* Copyright 2026, The TensorFlow Federated Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+     http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License
+==============================================================================*/
+
+#include "tensorflow_federated/cc/core/impl/executors/value_table.h"
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "googlemock/include/gmock/gmock.h"
+#include "googletest/include/gtest/gtest.h"
+
+namespace tensorflow_federated {
+
+namespace {
+
+using Table = ShardedValueTable<uint64_t, std::shared_ptr<int32_t>>;
+
+TEST(ShardedValueTableTest, InsertAssignsSequentialIds) {
+  Table table;
+  EXPECT_EQ(table.Insert(std::make_shared<int32_t>(1)), 0);
+  EXPECT_EQ(table.Insert(std::make_shared<int32_t>(2)), 1);
+  EXPECT_EQ(table.size(), 2);
+}
+
+TEST(ShardedValueTableTest, GetReturnsInsertedValue) {
+  Table table;
+  uint64_t id = table.Insert(std::make_shared<int32_t>(5));
+  std::optional<std::shared_ptr<int32_t>> value = table.Get(id);
+  ASSERT_TRUE(value.has_value());
+  EXPECT_EQ(**value, 5);
+  EXPECT_FALSE(table.Get(id + 1).has_value());
+}
+
+TEST(ShardedValueTableTest, EraseReleasesValue) {
+  Table table;
+  auto value = std::make_shared<int32_t>(5);
+  uint64_t id = table.Insert(value);
+  EXPECT_EQ(value.use_count(), 2);
+  EXPECT_TRUE(table.Erase(id));
+  EXPECT_EQ(value.use_count(), 1);
+  EXPECT_FALSE(table.Get(id).has_value());
+  EXPECT_FALSE(table.Erase(id));
+}
+
+TEST(ShardedValueTableTest, ClearRemovesAllValuesWithoutReusingIds) {
+  Table table;
+  for (int32_t i = 0; i < 100; ++i) {
+    table.Insert(std::make_shared<int32_t>(i));
+  }
+  table.Clear();
+  EXPECT_EQ(table.size(), 0);
+  EXPECT_EQ(table.Insert(std::make_shared<int32_t>(0)), 100);
+}
+
+TEST(ShardedValueTableTest, InsertBatchAssignsConsecutiveIds) {
+  Table table;
+  table.Insert(std::make_shared<int32_t>(-1));
+  std::vector<std::shared_ptr<int32_t>> values;
+  for (int32_t i = 0; i < 40; ++i) {
+    values.push_back(std::make_shared<int32_t>(i));
+  }
+  uint64_t first_id = table.InsertBatch(std::move(values));
+  EXPECT_EQ(first_id, 1);
+  EXPECT_EQ(table.size(), 41);
+  for (int32_t i = 0; i < 40; ++i) {
+    std::optional<std::shared_ptr<int32_t>> value = table.Get(first_id + i);
+    ASSERT_TRUE(value.has_value());
+    EXPECT_EQ(**value, i);
+  }
+  EXPECT_EQ(table.InsertBatch({}), 41);
+  EXPECT_EQ(table.Insert(std::make_shared<int32_t>(0)), 41);
+}
+
+TEST(ShardedValueTableTest, ConcurrentInsertGetErase) {
+  constexpr int32_t kNumThreads = 8;
+  constexpr int32_t kValuesPerThread = 1000;
+  Table table;
+  std::vector<std::thread> threads;
+  for (int32_t t = 0; t < kNumThreads; ++t) {
+    threads.emplace_back([&table, t]() {
+      for (int32_t i = 0; i < kValuesPerThread; ++i) {
+        uint64_t id = table.Insert(std::make_shared<int32_t>(t));
+        std::optional<std::shared_ptr<int32_t>> value = table.Get(id);
+        ASSERT_TRUE(value.has_value());
+        EXPECT_EQ(**value, t);
+        if (i % 2 == 0) {
+          EXPECT_TRUE(table.Erase(id));
+        }
+      }
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(table.size(), kNumThreads * kValuesPerThread / 2);
+}
+
+}  // namespace
+
+}  // namespace tensorflow_federated
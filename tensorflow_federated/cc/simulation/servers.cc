@@ -30,6 +30,7 @@ limitations under the License
 #include "tensorflow_federated/cc/core/impl/executors/cardinalities.h"
 #include "tensorflow_federated/cc/core/impl/executors/executor.h"
 #include "tensorflow_federated/cc/core/impl/executors/executor_service.h"
+#include "tensorflow_federated/cc/core/impl/executors/memory_budget.h"
 #include "tensorflow_federated/cc/core/impl/executors/tensorflow_executor.h"
 
 constexpr int MegabytesToBytes(int megabytes) {
@@ -74,16 +75,22 @@ void RunServer(std::function<absl::StatusOr<std::shared_ptr<Executor>>(
 
 void RunWorker(int port, std::shared_ptr<grpc::ServerCredentials> credentials,
                int grpc_max_message_length_megabytes,
-               int32_t max_concurrent_computation_calls) {
+               int32_t max_concurrent_computation_calls,
+               int64_t memory_high_water_mark_bytes) {
+  std::shared_ptr<MemoryBudget> memory_budget =
+      MemoryBudget::Create(memory_high_water_mark_bytes);
   auto create_tf_executor_fn =
-      [max_concurrent_computation_calls](
+      [max_concurrent_computation_calls, memory_budget](
           int32_t unused) -> std::shared_ptr<Executor> {
-    return CreateTensorFlowExecutor(max_concurrent_computation_calls);
+    return CreateTensorFlowExecutor(max_concurrent_computation_calls,
+                                    memory_budget);
   };
   auto create_local_executor_fn =
-      [create_tf_executor_fn](const CardinalityMap& cardinality_map)
+      [create_tf_executor_fn,
+       memory_budget](const CardinalityMap& cardinality_map)
       -> absl::StatusOr<std::shared_ptr<Executor>> {
-    return CreateLocalExecutor(cardinality_map, create_tf_executor_fn);
+    return CreateLocalExecutor(cardinality_map, create_tf_executor_fn,
+                               memory_budget);
   };
   RunServer(create_local_executor_fn, port, credentials,
             grpc_max_message_length_megabytes);
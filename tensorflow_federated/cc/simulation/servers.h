@@ -39,9 +39,14 @@ void RunServer(std::function<absl::StatusOr<std::shared_ptr<Executor>>(
 
 // Runs a specialized version of RunServer above; the running executor service
 // will execute federated computations on the local machine.
+//
+// The values held by all of the worker's executors are charged to one
+// `MemoryBudget` with the given high-water mark; non-positive values only
+// track usage.
 void RunWorker(int port, std::shared_ptr<grpc::ServerCredentials> credentials,
                int grpc_max_message_length_megabytes,
-               int32_t max_concurrent_computation_calls = -1);
+               int32_t max_concurrent_computation_calls = -1,
+               int64_t memory_high_water_mark_bytes = -1);
 
 }  // namespace tensorflow_federated
 #endif  // THIRD_PARTY_TENSORFLOW_FEDERATED_CC_SIMULATION_SERVERS_H_
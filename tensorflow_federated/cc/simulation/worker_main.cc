@@ -18,7 +18,10 @@ limitations under the License
 
 #include "absl/flags/flag.h"
 #include "absl/flags/parse.h"
+#include "absl/log/log.h"
 #include "include/grpcpp/security/server_credentials.h"
+#include "tensorflow_federated/cc/core/impl/executors/session_budget.h"
+#include "tensorflow_federated/cc/core/impl/executors/threading.h"
 #include "tensorflow_federated/cc/simulation/servers.h"
 
 ABSL_FLAG(int32_t, port, 10000, "Port to run the executor service on");
@@ -32,15 +35,47 @@ ABSL_FLAG(int32_t, max_concurrent_computation_calls, -1,
           "helpful for users running into OOMs when using GPUs. Non-positive"
           " values result in no limiting.");
 
+ABSL_FLAG(bool, use_eager_tensorflow_executor, false,
+          "Unsupported. Workers always run TensorFlow computations in graph "
+          "sessions; setting this flag is an error.");
+
+ABSL_FLAG(int32_t, default_thread_pool_size, 0,
+          "The number of threads kept by the process-wide thread pool that "
+          "runs executor work not bound to an executor-owned pool (e.g. "
+          "remote and sequence executor calls). Non-positive values use the "
+          "default of four threads per CPU, and at least 16.");
+
+ABSL_FLAG(int64_t, memory_high_water_mark_bytes, -1,
+          "The number of bytes held by the worker's values above which new "
+          "calls are delayed (for a bounded time) until memory is released. "
+          "Non-positive values disable the delay and only track usage.");
+
+ABSL_FLAG(int64_t, max_sessions, -1,
+          "The maximum number of live TensorFlow sessions across all "
+          "computations. Idle sessions of other computations are destroyed to "
+          "make room for new ones, and calls wait once all sessions are in "
+          "use. Non-positive values result in no limiting.");
+
 // TODO: b/234160632 - Add option for secure server connections here.
 
 namespace tff = ::tensorflow_federated;
 
 int main(int argc, char* argv[]) {
   absl::ParseCommandLine(argc, argv);
+  if (absl::GetFlag(FLAGS_use_eager_tensorflow_executor)) {
+    LOG(ERROR) << "--use_eager_tensorflow_executor is not supported by the "
+                  "TFF worker: the eager TensorFlow executor cannot run "
+                  "sequence values and does not honor "
+                  "--memory_high_water_mark_bytes.";
+    return 1;
+  }
+  tff::SetDefaultThreadPoolSize(absl::GetFlag(FLAGS_default_thread_pool_size));
+  tff::SessionBudget::Global()->set_max_sessions(
+      absl::GetFlag(FLAGS_max_sessions));
   std::shared_ptr<grpc::ServerCredentials> credentials =
       grpc::InsecureServerCredentials();
   tff::RunWorker(absl::GetFlag(FLAGS_port), credentials,
                  absl::GetFlag(FLAGS_grpc_max_message_length_megabytes),
-                 absl::GetFlag(FLAGS_max_concurrent_computation_calls));
+                 absl::GetFlag(FLAGS_max_concurrent_computation_calls),
+                 absl::GetFlag(FLAGS_memory_high_water_mark_bytes));
 }
@@ -19,3 +19,7 @@ import tensorflow as tf  # pylint: disable=unused-import
 from tensorflow_federated.cc.core.impl.executors import tensorflow_bindings
 
 create_tensorflow_executor = tensorflow_bindings.create_tensorflow_executor
+
+# Import session configuration.
+set_max_sessions = tensorflow_bindings.set_max_sessions
+get_max_sessions = tensorflow_bindings.get_max_sessions
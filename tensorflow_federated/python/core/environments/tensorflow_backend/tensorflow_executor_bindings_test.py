@@ -70,6 +70,14 @@ class TensorFlowExecutorBindingsTest(parameterized.TestCase, tf.test.TestCase):
     except Exception:  # pylint: disable=broad-except
       self.fail('Raised `Exception` unexpectedly.')
 
+  def test_set_max_sessions(self):
+    original = tensorflow_executor_bindings.get_max_sessions()
+    try:
+      tensorflow_executor_bindings.set_max_sessions(4)
+      self.assertEqual(tensorflow_executor_bindings.get_max_sessions(), 4)
+    finally:
+      tensorflow_executor_bindings.set_max_sessions(original)
+
   def test_create_value(self):
     executor = get_executor()
     # 1. Test a simple tensor.
@@ -188,6 +196,58 @@ class TensorFlowExecutorBindingsTest(parameterized.TestCase, tf.test.TestCase):
     )
     self.assertEqual(result, expected_result)
 
+  def test_materialize_sequence_chunks(self):
+    executor = tensorflow_executor_bindings.create_tensorflow_executor()
+    sequence_type = federated_language.SequenceType(np.int32)
+    value_pb, _ = value_serialization.serialize_value(
+        [0, 1, 2, 3, 4], sequence_type
+    )
+    value = executor.create_value(value_pb)
+    chunk_sizes = []
+    executor.materialize_sequence_chunks(
+        value.ref, 2, lambda chunk: chunk_sizes.append(len(chunk.element))
+    )
+    self.assertEqual(chunk_sizes, [2, 2, 1])
+
+  def test_materialize_clients(self):
+    executor = executor_bindings.create_federating_executor(
+        tensorflow_executor_bindings.create_tensorflow_executor(),
+        tensorflow_executor_bindings.create_tensorflow_executor(),
+        {federated_language.CLIENTS: 3},
+    )
+    clients_type = federated_language.FederatedType(
+        np.int32, federated_language.CLIENTS
+    )
+    value_pb, _ = value_serialization.serialize_value(
+        [10, 11, 12], clients_type
+    )
+    value = executor.create_value(value_pb)
+    materialized = {}
+
+    def consume(index, client_pb):
+      materialized[index], _ = value_serialization.deserialize_value(client_pb)
+
+    executor.materialize_clients(value.ref, [0, 2], consume)
+    self.assertEqual(materialized, {0: 10, 2: 12})
+
+  def test_create_clients_subset(self):
+    executor = executor_bindings.create_federating_executor(
+        tensorflow_executor_bindings.create_tensorflow_executor(),
+        tensorflow_executor_bindings.create_tensorflow_executor(),
+        {federated_language.CLIENTS: 3},
+    )
+    clients_type = federated_language.FederatedType(
+        np.int32, federated_language.CLIENTS
+    )
+    value_pb, _ = value_serialization.serialize_value(
+        [10, 11, 12], clients_type
+    )
+    value = executor.create_value(value_pb)
+    subset = executor.create_clients_subset(value.ref, [2, 0])
+    subset_pb = executor.materialize(subset.ref)
+    materialized, _ = value_serialization.deserialize_value(subset_pb)
+    self.assertEqual(materialized, [12, 10])
+
   def test_create_tuple_of_value_sequence(self):
     sequences = ([0, 1, 2, 3, 4], [0, 1, 2, 3, 4])
     executor = tensorflow_executor_bindings.create_tensorflow_executor()
@@ -112,6 +112,13 @@ def _check_num_clients_is_valid(default_num_clients: int):
     raise ValueError('Default number of clients must be nonnegative.')
 
 
+def _maybe_set_default_thread_pool_size(
+    default_thread_pool_size: Optional[int],
+):
+  if default_thread_pool_size is not None:
+    executor_bindings.set_default_thread_pool_size(default_thread_pool_size)
+
+
 def local_cpp_executor_factory(
     *,
     default_num_clients: int = 0,
@@ -120,9 +127,30 @@ def local_cpp_executor_factory(
     client_leaf_executor_fn: Optional[
         Callable[[int], executor_bindings.Executor]
     ] = None,
+    default_thread_pool_size: Optional[int] = None,
 ) -> federated_language.framework.ExecutorFactory:
-  """Local ExecutorFactory backed by C++ Executor bindings."""
+  """Local ExecutorFactory backed by C++ Executor bindings.
+
+  Args:
+    default_num_clients: The number of clients to use as the default
+      cardinality, if thus number cannot be inferred by the arguments of a
+      computation.
+    max_concurrent_computation_calls: The maximum number of concurrent calls to
+      a single computation in the C++ runtime. If nonpositive, there is no
+      limit.
+    leaf_executor_fn: A function constructing the leaf executor, given
+      `max_concurrent_computation_calls`.
+    client_leaf_executor_fn: An optional function constructing a separate leaf
+      executor for clients.
+    default_thread_pool_size: If set, the number of threads kept by the
+      process-wide C++ thread pool shared by executors that do not own a pool.
+      If nonpositive, the runtime default is restored.
+
+  Returns:
+    An `federated_language.framework.ExecutorFactory`.
+  """
   _check_num_clients_is_valid(default_num_clients)
+  _maybe_set_default_thread_pool_size(default_thread_pool_size)
 
   def _executor_fn(
       cardinalities: federated_language.framework.CardinalitiesType,
@@ -188,9 +216,28 @@ def remote_cpp_executor_factory(
     default_num_clients: int = 0,
     stream_structs: bool = False,
     max_concurrent_computation_calls: int = -1,
+    default_thread_pool_size: Optional[int] = None,
 ) -> federated_language.framework.ExecutorFactory:
-  """ExecutorFactory backed by C++ Executor bindings."""
+  """ExecutorFactory backed by C++ Executor bindings.
+
+  Args:
+    channels: The gRPC channels of the remote workers.
+    default_num_clients: The number of clients to use as the default
+      cardinality, if thus number cannot be inferred by the arguments of a
+      computation.
+    stream_structs: The flag to enable decomposing and streaming struct values.
+    max_concurrent_computation_calls: The maximum number of concurrent calls to
+      a single computation in the C++ runtime. If nonpositive, there is no
+      limit.
+    default_thread_pool_size: If set, the number of threads kept by the
+      process-wide C++ thread pool that runs remote calls. If nonpositive, the
+      runtime default is restored.
+
+  Returns:
+    An `federated_language.framework.ExecutorFactory`.
+  """
   _check_num_clients_is_valid(default_num_clients)
+  _maybe_set_default_thread_pool_size(default_thread_pool_size)
 
   def _executor_fn(
       cardinalities: federated_language.framework.CardinalitiesType,
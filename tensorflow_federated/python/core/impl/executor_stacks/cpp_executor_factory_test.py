@@ -68,6 +68,15 @@ class CPPExecutorFactoryTest(absltest.TestCase):
     )
     self.assertIsInstance(executor, federated_language.framework.Executor)
 
+  def test_create_local_cpp_factory_sets_default_thread_pool_size(self):
+    cpp_executor_factory.local_cpp_executor_factory(
+        default_num_clients=0,
+        leaf_executor_fn=_create_mock_execution_stack,
+        default_thread_pool_size=7,
+    )
+    self.assertEqual(executor_bindings.get_default_thread_pool_size(), 7)
+    executor_bindings.set_default_thread_pool_size(0)
+
   def test_create_remote_cpp_factory_constructs(self):
     targets = ['localhost:8000', 'localhost:8001']
     channels = [
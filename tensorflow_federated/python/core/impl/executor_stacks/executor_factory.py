@@ -44,6 +44,7 @@ def local_cpp_executor_factory(
     default_num_clients: int = 0,
     max_concurrent_computation_calls: int = -1,
     stream_structs: bool = False,
+    default_thread_pool_size: int = 0,
 ) -> federated_language.framework.ExecutorFactory:
   """Returns an execution context backed by C++ runtime.
 
@@ -55,6 +56,8 @@ def local_cpp_executor_factory(
       a single computation in the C++ runtime. If nonpositive, there is no
       limit.
     stream_structs: The flag to enable decomposing and streaming struct values.
+    default_thread_pool_size: The number of threads kept by the worker's
+      process-wide thread pool. If nonpositive, the worker uses its default.
 
   Raises:
     RuntimeError: If an internal C++ worker binary can not be found.
@@ -81,6 +84,7 @@ def local_cpp_executor_factory(
         binary_path,
         f'--port={port}',
         f'--max_concurrent_computation_calls={max_concurrent_computation_calls}',
+        f'--default_thread_pool_size={default_thread_pool_size}',
     ]
 
     def is_notebook():
@@ -14,6 +14,7 @@
 """Python interface to C++ Executor implementations."""
 
 from collections.abc import Mapping
+from typing import Optional
 
 import federated_language
 
@@ -23,6 +24,7 @@ from tensorflow_federated.python.core.impl.executors import data_conversions
 # Import classes.
 OwnedValueId = executor_bindings.OwnedValueId
 Executor = executor_bindings.Executor
+MemoryBudget = executor_bindings.MemoryBudget
 
 # Import executor constructors.
 create_reference_resolving_executor = (
@@ -31,6 +33,21 @@ create_reference_resolving_executor = (
 create_composing_executor = executor_bindings.create_composing_executor
 create_sequence_executor = executor_bindings.create_sequence_executor
 
+# Import threading configuration.
+set_default_thread_pool_size = executor_bindings.set_default_thread_pool_size
+get_default_thread_pool_size = executor_bindings.get_default_thread_pool_size
+
+# Import thread pool telemetry.
+ThreadPoolStats = executor_bindings.ThreadPoolStats
+get_thread_pool_stats = executor_bindings.get_thread_pool_stats
+reset_thread_pool_stats = executor_bindings.reset_thread_pool_stats
+set_thread_pool_stats_enabled = executor_bindings.set_thread_pool_stats_enabled
+
+# Import executor method metrics.
+ExecutorMethodMetrics = executor_bindings.ExecutorMethodMetrics
+get_executor_method_metrics = executor_bindings.get_executor_method_metrics
+reset_executor_method_metrics = executor_bindings.reset_executor_method_metrics
+
 # Import executor constructor helpers.
 create_insecure_grpc_channel = executor_bindings.create_insecure_grpc_channel
 GRPCChannel = executor_bindings.GRPCChannelInterface
@@ -42,13 +59,34 @@ def create_federating_executor(
     inner_server_executor: executor_bindings.Executor,
     inner_client_executor: executor_bindings.Executor,
     cardinalities: Mapping[federated_language.framework.PlacementLiteral, int],
+    memory_budget: Optional[executor_bindings.MemoryBudget] = None,
+    aggregate_partitions: int = 1,
 ) -> executor_bindings.Executor:
-  """Constructs a FederatingExecutor with a specified placement."""
+  """Constructs a FederatingExecutor with a specified placement.
+
+  Args:
+    inner_server_executor: The executor for server-placed values.
+    inner_client_executor: The executor for client-placed values.
+    cardinalities: The number of values at each placement.
+    memory_budget: An optional `MemoryBudget` the executor charges its values
+      to. While the budget is over its high-water mark, `create_call` blocks
+      for a bounded time before proceeding.
+    aggregate_partitions: The number of partitions `federated_aggregate` folds
+      the clients into. Must be positive; the default folds the clients in a
+      single chain.
+
+  Returns:
+    The FederatingExecutor.
+  """
   uri_cardinalities = (
       data_conversions.convert_cardinalities_dict_to_string_keyed(cardinalities)
   )
   return executor_bindings.create_federating_executor(
-      inner_server_executor, inner_client_executor, uri_cardinalities
+      inner_server_executor,
+      inner_client_executor,
+      uri_cardinalities,
+      memory_budget=memory_budget,
+      aggregate_partitions=aggregate_partitions,
   )
 
 
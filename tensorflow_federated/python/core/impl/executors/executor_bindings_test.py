@@ -49,6 +49,53 @@ class ComposingExecutorBindingsTest(absltest.TestCase):
       self.fail('Raised `Exception` unexpectedly.')
 
 
+class ThreadPoolStatsBindingsTest(absltest.TestCase):
+
+  def test_composing_executor_pool_is_reported(self):
+    mock_server_executor = executor_test_utils_bindings.create_mock_executor()
+    children = [
+        executor_bindings.create_composing_child(
+            executor_test_utils_bindings.create_mock_executor(),
+            {federated_language.CLIENTS: 0},
+        )
+    ]
+    executor = executor_bindings.create_composing_executor(
+        mock_server_executor, children
+    )
+    stats = {s.name: s for s in executor_bindings.get_thread_pool_stats()}
+    self.assertIn('ComposingExecutor', stats)
+    self.assertGreater(stats['ComposingExecutor'].num_threads, 0)
+    self.assertLen(
+        stats['ComposingExecutor'].queue_time_us.bucket_counts,
+        len(stats['ComposingExecutor'].queue_time_us.bucket_limits),
+    )
+    del executor
+
+  def test_reset(self):
+    executor_bindings.reset_thread_pool_stats()
+    for stats in executor_bindings.get_thread_pool_stats():
+      self.assertEqual(stats.completed_tasks, 0)
+      self.assertEqual(stats.rejected_tasks, 0)
+
+  def test_set_enabled(self):
+    executor_bindings.set_thread_pool_stats_enabled(True)
+    executor_bindings.set_thread_pool_stats_enabled(False)
+
+
+class ExecutorMethodMetricsBindingsTest(absltest.TestCase):
+
+  def test_reset(self):
+    executor_bindings.reset_executor_method_metrics()
+    for metrics in executor_bindings.get_executor_method_metrics():
+      self.assertEqual(metrics.calls, 0)
+      self.assertEqual(metrics.latency_us.sum, 0)
+
+  def test_metrics_are_sorted(self):
+    metrics = executor_bindings.get_executor_method_metrics()
+    names = [(m.executor_name, m.method_name) for m in metrics]
+    self.assertEqual(names, sorted(names))
+
+
 class SequenceExecutorBindingsTest(absltest.TestCase):
 
   def test_construction(self):
@@ -73,6 +120,23 @@ class FederatingExecutorBindingsTest(absltest.TestCase):
     except Exception:  # pylint: disable=broad-except
       self.fail('Raised `Exception` unexpectedly.')
 
+  def test_construction_with_memory_budget(self):
+    mock_server_executor = executor_test_utils_bindings.create_mock_executor()
+    mock_client_executor = executor_test_utils_bindings.create_mock_executor()
+    cardinalities = {federated_language.CLIENTS: 0}
+    memory_budget = executor_bindings.MemoryBudget(
+        high_water_mark_bytes=1 << 30
+    )
+    executor_bindings.create_federating_executor(
+        mock_server_executor,
+        mock_client_executor,
+        cardinalities,
+        memory_budget=memory_budget,
+    )
+    self.assertEqual(memory_budget.high_water_mark_bytes, 1 << 30)
+    self.assertEqual(memory_budget.used_bytes, 0)
+    self.assertEqual(memory_budget.delayed_calls, 0)
+
 
 class RemoteExecutorBindingsTest(absltest.TestCase):
 